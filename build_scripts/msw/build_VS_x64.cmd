@@ -43,6 +43,17 @@ cd ..
 cd xLights
 msbuild.exe /m xLights.sln /p:Configuration="Release" /p:Platform="x64"
 if %ERRORLEVEL% NEQ 0 goto error
+
+rem the sample sequences must still load and save without changing their effects
+set PATH=%CD%\..\bin64;%PATH%
+for /r ..\songs %%f in (*.xml) do (
+    start /wait x64\Release\xLights.exe --roundtrip "%%f"
+    if errorlevel 1 goto error
+)
+
+rem effect output and speed must match the checked in baseline, a baseline with no results is filled in by this run
+start /wait x64\Release\xLights.exe -b ..\effect_benchmark.json --baseline ..\benchmark\effect_baseline_msvc-x64.json
+if errorlevel 1 goto error
 cd ..
 
 cd build_scripts
@@ -4,9 +4,12 @@
 #include <wx/thread.h>
 #include <wx/socket.h>
 
+#include <vector>
+
 #include "xFadeMain.h"
 #include "Settings.h"
 #include "PacketData.h"
+#include "UniverseData.h"
 #include "../xLights/UtilFunctions.h"
 
 #include <log4cpp/Category.hh>
@@ -95,9 +98,20 @@ public:
             artNETSocketSend = nullptr;
         }
 
-        PacketData sendData;
         auto universes = _emitter->GetUniverses();
 
+        // one packet and one resolved address per universe so a frame can be built and then sent as a batch
+        std::vector<UniverseData*> targets;
+        std::vector<PacketData> sendData(universes.size());
+        std::vector<wxIPV4address> addresses(universes.size());
+        std::vector<long> addressTypes(universes.size(), -1);
+        for (const auto& it : universes)
+        {
+            targets.push_back(it.second);
+        }
+
+        FadeWeights weights;
+
         while (!_stop)
         {
             auto start = wxDateTime::UNow();
@@ -111,11 +125,23 @@ public:
             wxASSERT(rb >= 0 && rb <= 100);
             wxASSERT(pos >= 0.0 && pos <= 1.0);
 
-            // output the frames now
-            for (const auto& it : universes)
+            weights.Set(lb, rb, pos);
+
+            // build the whole frame first so we hold each universe lock as briefly as possible
+            for (size_t i = 0; i < targets.size(); ++i)
+            {
+                targets[i]->GetOutput(&sendData[i], weights);
+            }
+
+            // then output the frames now
+            for (size_t i = 0; i < targets.size(); ++i)
             {
-                it.second->GetOutput(&sendData, lb, rb, pos);
-                sendData.Send(e131SocketSend, artNETSocketSend, it.second->GetTargetIP());
+                if (addressTypes[i] != sendData[i]._type)
+                {
+                    sendData[i].ResolveAddress(addresses[i], targets[i]->GetTargetIP());
+                    addressTypes[i] = sendData[i]._type;
+                }
+                sendData[i].Send(e131SocketSend, artNETSocketSend, addresses[i]);
                 _emitter->IncrementSent();
             }
 
@@ -107,9 +107,8 @@ bool PacketData::Update(long type, uint8_t packet[], int len)
     return true;
 }
 
-void PacketData::Send(wxDatagramSocket* e131Socket, wxDatagramSocket* artNETSocket, const std::string& ip) const
+void PacketData::ResolveAddress(wxIPV4address& remoteaddr, const std::string& ip) const
 {
-    wxIPV4address remoteaddr;
     if (wxString(ip).StartsWith("239.255.") || ip == "MULTICAST")
     {
         // multicast - universe number must be in lower 2 bytes
@@ -120,15 +119,24 @@ void PacketData::Send(wxDatagramSocket* e131Socket, wxDatagramSocket* artNETSock
     {
         remoteaddr.Hostname(ip.c_str());
     }
+    remoteaddr.Service(_type == E131PORT ? E131PORT : ARTNETPORT);
+}
+
+void PacketData::Send(wxDatagramSocket* e131Socket, wxDatagramSocket* artNETSocket, const std::string& ip) const
+{
+    wxIPV4address remoteaddr;
+    ResolveAddress(remoteaddr, ip);
+    Send(e131Socket, artNETSocket, remoteaddr);
+}
 
+void PacketData::Send(wxDatagramSocket* e131Socket, wxDatagramSocket* artNETSocket, wxIPV4address& remoteaddr) const
+{
     if (_type == E131PORT)
     {
-        remoteaddr.Service(E131PORT);
         if (e131Socket != nullptr) e131Socket->SendTo(remoteaddr, _data, _length);
     }
     else
     {
-        remoteaddr.Service(ARTNETPORT);
         if (artNETSocket != nullptr) artNETSocket->SendTo(remoteaddr, _data, _length);
     }
 }
@@ -289,33 +297,29 @@ void PacketData::InitialiseLength(long type, int length, int universe)
     }
 }
 
-void PacketData::ApplyBrightness(int brightness, const std::list<int>& excludeChannels)
+void PacketData::ApplyBrightness(const uint8_t* brightnessLUT, const uint8_t* excludeChannels)
 {
-    if (brightness == 100) return;
+    // full brightness maps every value to itself
+    if (brightnessLUT[255] == 255) return;
 
-    if (excludeChannels.size() == 0)
+    uint8_t* p = GetDataPtr();
+    if (p == nullptr) return;
+    int len = GetDataLength();
+
+    if (excludeChannels == nullptr)
     {
-        if (brightness == 0)
+        for (int i = 0; i < len; i++)
         {
-            memset(GetDataPtr(), 0x00, GetDataLength());
-        }
-        else
-        {
-            uint8_t* p = GetDataPtr();
-            for (int i = 0; i < GetDataLength(); i++)
-            {
-                *(p + i) = (uint8_t)((int)*(p + i) * brightness / 100);
-            }
+            p[i] = brightnessLUT[p[i]];
         }
     }
     else
     {
-        uint8_t* p = GetDataPtr();
-        for (int i = 0; i < GetDataLength(); i++)
+        for (int i = 0; i < len; i++)
         {
-            if (std::find(excludeChannels.begin(), excludeChannels.end(), i + 1) == excludeChannels.end())
+            if (!excludeChannels[i])
             {
-                *(p + i) = (uint8_t)((int)*(p + i) * brightness / 100);
+                p[i] = brightnessLUT[p[i]];
             }
         }
     }
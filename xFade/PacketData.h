@@ -14,6 +14,7 @@
 #define E131_PACKET_LEN (E131_PACKET_HEADERLEN + 512)
 
 class wxDatagramSocket;
+class wxIPV4address;
 
 class PacketData
 {
@@ -32,6 +33,8 @@ public:
     void SetData(int c, uint8_t dd);
     bool Update(long type, uint8_t packet[], int len);
     void Send(wxDatagramSocket* e131Socket, wxDatagramSocket* artNETSocket, const std::string& ip) const;
+    void Send(wxDatagramSocket* e131Socket, wxDatagramSocket* artNETSocket, wxIPV4address& remoteaddr) const;
+    void ResolveAddress(wxIPV4address& remoteaddr, const std::string& ip) const;
     int GetDataLength() const;
     uint8_t UniverseHigh() const { return (_universe >> 8) & 0xFF; }
     uint8_t UniverseLow() const { return _universe & 0xFF; }
@@ -41,7 +44,7 @@ public:
     void InitialiseE131Header();
     int GetSequenceNum() const;
     void InitialiseLength(long type, int length, int universe);
-    void ApplyBrightness(int brightness, const std::list<int>& excludeChannels);
+    void ApplyBrightness(const uint8_t* brightnessLUT, const uint8_t* excludeChannels);
 };
 
 #endif 
@@ -3,11 +3,42 @@
 std::string UniverseData::__leftTag = "";
 std::string UniverseData::__rightTag = "";
 
-UniverseData::UniverseData(int universe, const std::string& targetIP, const std::string& targetProtocol, std::list<int> excludedChannels) :
+bool FadeWeights::Set(int leftBrightness, int rightBrightness, float pos)
+{
+    if (leftBrightness == _leftBrightness && rightBrightness == _rightBrightness && pos == _pos) return false;
+
+    _leftBrightness = leftBrightness;
+    _rightBrightness = rightBrightness;
+    _pos = pos;
+    _takeRight = pos >= 0.5;
+
+    // weights are in 1/256ths so the sum of the two sides always fits in 16 bits
+    uint32_t rw = (uint32_t)(pos * 256.0 + 0.5);
+    uint32_t lw = 256 - rw;
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+        _leftOnly[i] = (uint8_t)(i * leftBrightness / 100);
+        _rightOnly[i] = (uint8_t)(i * rightBrightness / 100);
+        _left[i] = (uint16_t)(_leftOnly[i] * lw);
+        _right[i] = (uint16_t)(_rightOnly[i] * rw);
+    }
+    return true;
+}
+
+UniverseData::UniverseData(int universe, const std::string& targetIP, const std::string& targetProtocol, const std::list<int>& excludedChannels) :
     _universe(universe),
-    _targetIP(targetIP),
-    _excludedChannels(excludedChannels)
+    _targetIP(targetIP)
 {
+    memset(_excluded, 0x00, sizeof(_excluded));
+    for (const auto& it : excludedChannels)
+    {
+        if (it >= 1 && it <= (int)sizeof(_excluded))
+        {
+            _excluded[it - 1] = 1;
+            _hasExcluded = true;
+        }
+    }
+
     if (targetProtocol == "As per input")
     {
         _targetProtocol = 0;
@@ -50,7 +81,7 @@ bool UniverseData::UpdateRight(int type, uint8_t* buffer, int size)
     return _right.Update(type, buffer, size);
 }
 
-PacketData* UniverseData::GetOutput(PacketData* output, int leftBrightness, int rightBrightness, float pos)
+PacketData* UniverseData::GetOutput(PacketData* output, const FadeWeights& weights)
 {
     std::unique_lock<std::mutex> lock(_lock);
 
@@ -63,50 +94,56 @@ PacketData* UniverseData::GetOutput(PacketData* output, int leftBrightness, int
         _right.InitialiseLength(_left._type, _left._length, _universe);
     }
 
-    if (pos == 0.0)
+    const uint8_t* excluded = _hasExcluded ? _excluded : nullptr;
+
+    if (weights._pos == 0.0)
     {
         PrepareData(output, &_left, _targetProtocol);
-        output->ApplyBrightness(leftBrightness, _excludedChannels);
+        output->ApplyBrightness(weights._leftOnly, excluded);
     }
-    else if (pos == 1.0)
+    else if (weights._pos == 1.0)
     {
         PrepareData(output, &_right, _targetProtocol);
-        output->ApplyBrightness(rightBrightness, _excludedChannels);
+        output->ApplyBrightness(weights._rightOnly, excluded);
     }
     else
     {
-        int sz = std::min(_left.GetDataLength(), _right.GetDataLength());
-
-        PacketData l = _left;
-        PacketData r = _right;
-        l.ApplyBrightness(leftBrightness, _excludedChannels);
-        r.ApplyBrightness(rightBrightness, _excludedChannels);
-
-        Blend(l.GetDataPtr(), r.GetDataPtr(), sz, pos, _excludedChannels);
-        PrepareData(output, &l, _targetProtocol);
+        // the header comes from the left but the data is blended straight into the output so we never copy the packets
+        PrepareData(output, &_left, _targetProtocol);
+        size_t sz = std::min(_left.GetDataLength(), _right.GetDataLength());
+        size_t leftSz = std::min(_left.GetDataLength(), output->GetDataLength());
+        Blend(output->GetDataPtr(), _left.GetDataPtr(), _right.GetDataPtr(), std::min(sz, leftSz), leftSz, weights);
     }
     return output;
 }
 
-void UniverseData::Blend(uint8_t* buffer, uint8_t* blendBuffer, size_t channels, float pos, std::list<int> excludeChannels)
+void UniverseData::Blend(uint8_t* buffer, const uint8_t* left, const uint8_t* right, size_t channels, size_t leftChannels, const FadeWeights& weights) const
 {
-    float inv = 1.0 - pos;
+    if (buffer == nullptr || left == nullptr || right == nullptr) return;
+
+    // tight loop with no branches so the compiler can vectorise it
     for (size_t i = 0; i < channels; ++i)
     {
-        if (std::find(excludeChannels.begin(), excludeChannels.end(), i + 1) != excludeChannels.end())
+        buffer[i] = (uint8_t)(((uint32_t)weights._left[left[i]] + (uint32_t)weights._right[right[i]]) >> 8);
+    }
+
+    // channels only present on the left just get the left brightness
+    for (size_t i = channels; i < leftChannels; ++i)
+    {
+        buffer[i] = weights._leftOnly[left[i]];
+    }
+
+    // excluded channels dont fade ... they jump from left to right half way through
+    if (_hasExcluded)
+    {
+        const uint8_t* src = weights._takeRight ? right : left;
+        for (size_t i = 0; i < channels; ++i)
         {
-            if (pos < 0.5)
-            {
-                // dont change anything
-            }
-            else
-            {
-                *(buffer + i) = *(blendBuffer + i);
-            }
+            if (_excluded[i]) buffer[i] = src[i];
         }
-        else
+        for (size_t i = channels; i < leftChannels; ++i)
         {
-            *(buffer + i) = (uint8_t)((float) * (buffer + i) * inv + (float) * (blendBuffer + i) * pos);
+            if (_excluded[i]) buffer[i] = left[i];
         }
     }
 }
@@ -4,6 +4,22 @@
 
 #include "PacketData.h"
 
+// Per frame lookup tables so a universe can be brightness adjusted and cross faded in a single pass
+class FadeWeights
+{
+public:
+    uint16_t _left[256];
+    uint16_t _right[256];
+    uint8_t _leftOnly[256];
+    uint8_t _rightOnly[256];
+    int _leftBrightness = -1;
+    int _rightBrightness = -1;
+    float _pos = -1.0;
+    bool _takeRight = false;
+
+    bool Set(int leftBrightness, int rightBrightness, float pos);
+};
+
 class UniverseData
 {
     int _universe = 0;
@@ -12,10 +28,11 @@ class UniverseData
     PacketData _left;
     PacketData _right;
     std::string _targetIP;
-    std::list<int> _excludedChannels;
+    uint8_t _excluded[512];
+    bool _hasExcluded = false;
 
     void PrepareData(PacketData* target, PacketData* source, int protocol);
-    void Blend(uint8_t* buffer, uint8_t* blendBuffer, size_t channels, float pos, std::list<int> excludeChannels);
+    void Blend(uint8_t* buffer, const uint8_t* left, const uint8_t* right, size_t channels, size_t leftChannels, const FadeWeights& weights) const;
 
 public:
 
@@ -33,7 +50,7 @@ public:
     int GetLeftSequenceNum();
     int GetRightSequenceNum();
     int GetOutputFormat() const { return _targetProtocol; }
-    UniverseData(int universe, const std::string& targetIP, const std::string& targetProtocol, std::list<int> excludedChannels);
+    UniverseData(int universe, const std::string& targetIP, const std::string& targetProtocol, const std::list<int>& excludedChannels);
     virtual ~UniverseData() {}
-    PacketData* GetOutput(PacketData* output, int leftBrightness, int rightBrightness, float pos);
+    PacketData* GetOutput(PacketData* output, const FadeWeights& weights);
 };
@@ -11,6 +11,7 @@
 #include <wx/wx.h>
 #include <wx/string.h>
 #include <wx/ffile.h>
+#include <wx/filename.h>
 #include <wx/log.h>
 
 #include <algorithm>
@@ -1172,6 +1173,14 @@ void AudioManager::SetPlaybackRate(float rate)
     __sdl.SetRate(rate);
 }
 
+// 513 taps is what note filters have always used, 1025 gives a sharper cut off now the filter is applied with an fft
+int AudioManager::_noteFilterOrder = 513;
+
+void AudioManager::SetHighQualityNoteFilters(bool hq)
+{
+    _noteFilterOrder = hq ? 1025 : 513;
+}
+
 MEDIAPLAYINGSTATE AudioManager::GetPlayingState() const
 {
     return _media_state;
@@ -1576,29 +1585,40 @@ void AudioManager::DoPolyphonicTranscription(wxProgressDialog* dlg, AudioManager
 
 // Frame Data Extraction Functions
 // process audio data and build data for each frame
+// High, low and spread are cheap so they are worked out and published first so effects that only need them
+// can start rendering. The spectrogram windows are then calculated in parallel and once the loudest window is
+// known the frames are normalised and published a range at a time. Readers only wait for the range holding
+// the frame they want. The results are cached under the frame data cache folder.
 void AudioManager::DoPrepareFrameData()
 {
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
     logger_base.info("DoPrepareFrameData: Start processing audio frame data.");
 
-	// lock the mutex
-    std::unique_lock<std::shared_timed_mutex> locker(_mutex);
-    logger_base.info("DoPrepareFrameData: Got mutex.");
-
-    if (_data[0] == nullptr)
+    // only one thread does the work ... anyone else asking just waits for the data to be published
+    std::unique_lock<std::mutex> preparing(_prepareFrameDataLock, std::try_to_lock);
+    if (!preparing.owns_lock())
     {
-        logger_base.warn("    DoPrepareFrameData: Exiting as there is no data.");
+        logger_base.info("DoPrepareFrameData: Frame data is already being prepared.");
         return;
     }
 
-    wxStopWatch sw;
+    {
+        std::shared_lock<std::shared_timed_mutex> locker(_mutex);
+        if (_data[0] == nullptr)
+        {
+            logger_base.warn("    DoPrepareFrameData: Exiting as there is no data.");
+            return;
+        }
 
-	// if we have already done it ... bail
-	if (_frameDataPrepared)
-	{
-		logger_base.info("DoPrepareFrameData: Aborting processing audio frame data ... it has already been done.");
-		return;
-	}
+        // if we have already done it ... bail
+        if (_frameDataPrepared)
+        {
+            logger_base.info("DoPrepareFrameData: Aborting processing audio frame data ... it has already been done.");
+            return;
+        }
+    }
+
+    wxStopWatch sw;
 
     // wait for the data to load
     while (!IsDataLoaded())
@@ -1624,166 +1644,319 @@ void AudioManager::DoPrepareFrameData()
     logger_base.info("    Frames %d", frames);
     logger_base.info("    Total samples %d", totalsamples);
 
+    std::string hash = Hash();
+    if (LoadFrameDataCache(hash, frames))
+    {
+        logger_base.info("DoPrepareFrameData: Audio frame data loaded from cache in %ld. Frames: %d", sw.Time(), frames);
+        return;
+    }
+
+    // past the end of the track reads as silence ... the same as GetLeftData
+    auto sample = [this](long offset) { return offset > _trackSize ? 0.0f : _data[0][offset]; };
+
+    {
+        // the frames are filled in place as they are published so pointers handed out stay valid
+        std::unique_lock<std::shared_timed_mutex> locker(_mutex);
+        _frameData.assign(frames, std::vector<std::list<float>>(5));
+        _frameDataAmplitudeFrames = 0;
+        _frameDataSpectrogramFrames = 0;
+    }
+
+    // raw data analysis for each frame
+    std::vector<float> maxs(frames);
+    std::vector<float> mins(frames);
+    std::vector<float> spreads(frames);
+    parallel_for(0, frames, [&](int i) {
+        float max = -100.0;
+        float min = 100.0;
+        float spread = -100;
+        for (int j = 0; j < samplesperframe; j++)
+        {
+            float data = sample((long)i * samplesperframe + j);
+            max = std::max(max, data);
+            min = std::min(min, data);
+            spread = std::max(spread, max - min);
+        }
+        maxs[i] = max;
+        mins[i] = min;
+        spreads[i] = spread;
+    }, 500);
+
 	// these are used to normalise output
-	_bigmax = -1;
-	_bigspread = -1;
-	_bigmin = 1;
-	_bigspectogrammax = -1;
+    float bigmax = -1;
+    float bigspread = -1;
+    float bigmin = 1;
+    for (int i = 0; i < frames; i++)
+    {
+        bigmax = std::max(bigmax, maxs[i]);
+        bigmin = std::min(bigmin, mins[i]);
+        bigspread = std::max(bigspread, spreads[i]);
+    }
 
-	size_t step = 2048;
-	float *pdata[2];
+	// normalise data ... basically scale the data so the highest value is the scale value.
+	float scale = 1.0; // 0-1 ... where 0.x means that the max value displayed would be x0% of model size
+	float bigmaxscale = 1 / (bigmax * scale);
+	float bigminscale = 1 / (bigmin * scale);
+	float bigspreadscale = 1 / (bigspread * scale);
+    {
+        std::unique_lock<std::shared_timed_mutex> locker(_mutex);
+        _bigmax = bigmax;
+        _bigmin = bigmin;
+        _bigspread = bigspread;
+        for (int i = 0; i < frames; i++)
+        {
+            _frameData[i][0].push_back(maxs[i] * bigmaxscale);
+            _frameData[i][1].push_back(mins[i] * bigminscale);
+            _frameData[i][2].push_back(spreads[i] * bigspreadscale);
+        }
+        _frameDataAmplitudeFrames = frames;
+    }
+    logger_base.info("DoPrepareFrameData: Audio amplitude data published after %ld.", sw.Time());
 
-	int pos = 0;
-	std::list<float> spectrogram;
+    // the spectrogram uses fixed windows that dont line up with our frames. Each window belongs to the frame
+    // it starts in and a frame with no windows of its own repeats the previous frame
+	const size_t step = 2048;
+    int windows = 0;
+    while ((size_t)windows * step + step < (size_t)totalsamples)
+    {
+        windows++;
+    }
+    std::vector<std::list<float>> windowData(windows);
+    std::vector<float> windowMax(windows, 0.0f);
+    parallel_for(0, windows, [&](int w) {
+        long pos = (long)w * step;
+        if (pos <= _trackSize)
+        {
+            windowData[w] = CalculateSpectrumAnalysis(&_data[0][pos], step, windowMax[w], pos / samplesperframe);
+        }
+    }, 16);
 
-	// process each frome of the song
-	for (int i = 0; i < frames; i++)
-	{
-		std::vector<std::list<float>> aFrameData;
-		aFrameData.resize(5); // preallocate the spots we will need
-
-		// accumulators
-		float max = -100.0;
-		float min = 100.0;
-		float spread = -100;
-
-		// clear the data if we are about to get new data ... dont clear it if we wont
-		// this happens because the spectrogram function has a fixed window based on the parameters we set and it
-		// does not match our time slices exactly so we have to select which one to use
-		if (pos < i * samplesperframe + samplesperframe  && pos + step < totalsamples)
-		{
-			spectrogram.clear();
-		}
+    float bigspectogrammax = -1;
+    for (const auto& it : windowMax)
+    {
+        bigspectogrammax = std::max(bigspectogrammax, it);
+    }
+	float bigspectrogramscale = 1 / (bigspectogrammax * scale);
 
-		// only get the data if we are not ahead of the music
-		while (pos < i * samplesperframe + samplesperframe && pos + step < totalsamples)
-		{
-			std::list<float> subspectrogram;
-			pdata[0] = GetLeftDataPtr(pos);
-			pdata[1] = GetRightDataPtr(pos);
-			float max2 = 0;
+    {
+        std::unique_lock<std::shared_timed_mutex> locker(_mutex);
+        _bigspectogrammax = bigspectogrammax;
+    }
 
-			if (pdata[0] == nullptr)
-			{
-				subspectrogram.clear();
-			}
-			else
-			{
-				subspectrogram = CalculateSpectrumAnalysis(pdata[0], step, max2, i);
-			}
+    // each window goes to the frame it starts in ... work out the first window of every frame
+    std::vector<int> firstWindow(frames + 1);
+    int w = 0;
+    for (int i = 0; i < frames; i++)
+    {
+        firstWindow[i] = w;
+        while (w < windows && (long)w * step < (long)(i + 1) * samplesperframe)
+        {
+            w++;
+        }
+    }
+    firstWindow[frames] = w;
 
-			// and keep track of the larges value so we can normalise it
-			if (max2 > _bigspectogrammax)
-			{
-				_bigspectogrammax = max2;
-			}
-			pos += step;
+    // fold the windows into frames and publish them a range at a time
+    static const int PUBLISH_FRAMES = 200;
+    std::list<float> spectrogram;
+    for (int start = 0; start < frames; start += PUBLISH_FRAMES)
+    {
+        int end = std::min(frames, start + PUBLISH_FRAMES);
+        std::vector<std::list<float>> spectrograms(end - start);
+        for (int i = start; i < end; i++)
+        {
+            // a frame with no windows of its own repeats the previous frame
+            if (firstWindow[i] < firstWindow[i + 1])
+            {
+                spectrogram.clear();
+            }
 
-			// either take the newly calculated values or if we are merging two results take the maximum of each value
-			if (spectrogram.size() == 0)
-			{
-				spectrogram = subspectrogram;
-			}
-			else
-			{
-				if (subspectrogram.size() > 0)
-				{
-					std::list<float>::iterator sub = subspectrogram.begin();
-					for (std::list<float>::iterator fr = spectrogram.begin(); fr != spectrogram.end(); ++fr)
-					{
-						if (*sub > *fr)
-						{
-							*fr = *sub;
-						}
-						++sub;
-					}
-				}
-			}
-		}
+            // either take the window values or if we are merging several windows take the maximum of each value
+            for (int fw = firstWindow[i]; fw < firstWindow[i + 1]; fw++)
+            {
+                const std::list<float>& subspectrogram = windowData[fw];
+                if (spectrogram.size() == 0)
+                {
+                    spectrogram = subspectrogram;
+                }
+                else if (subspectrogram.size() > 0)
+                {
+                    auto sub = subspectrogram.begin();
+                    for (auto fr = spectrogram.begin(); fr != spectrogram.end(); ++fr)
+                    {
+                        if (*sub > *fr)
+                        {
+                            *fr = *sub;
+                        }
+                        ++sub;
+                    }
+                }
+            }
 
-		// now do the raw data analysis for the frame
-		for (int j = 0; j < samplesperframe; j++)
-		{
-			float data = GetLeftData(i * samplesperframe + j);
+            spectrograms[i - start] = spectrogram;
+            for (auto& ff : spectrograms[i - start])
+            {
+                ff = ff * bigspectrogramscale;
+            }
+        }
 
-			// Max data
-			if (data > max)
-			{
-				max = data;
-			}
+        std::unique_lock<std::shared_timed_mutex> locker(_mutex);
+        for (int i = start; i < end; i++)
+        {
+            _frameData[i][3].swap(spectrograms[i - start]);
+        }
+        _frameDataSpectrogramFrames = end;
 
-			// Min data
-			if (data < min)
-			{
-				min = data;
-			}
+        // flag the fact that the data is all ready
+        if (end == frames)
+        {
+            _frameDataPrepared = true;
+        }
+    }
 
-			// Spread data
-			if (max - min > spread)
-			{
-				spread = max - min;
-			}
-		}
+	logger_base.info("DoPrepareFrameData: Audio frame data processing complete in %ld. Frames: %d", sw.Time(), frames);
 
-		if (max > _bigmax)
-		{
-			_bigmax = max;
-		}
-		if (min < _bigmin)
-		{
-			_bigmin = min;
-		}
-		if (spread > _bigspread)
-		{
-			_bigspread = spread;
-		}
+    SaveFrameDataCache(hash);
+}
 
-		// Now save the results for the frame
-		std::list<float> maxlist;
-		maxlist.push_back(max);
-		std::list<float> minlist;
-		minlist.push_back(min);
-		std::list<float> spreadlist;
-		spreadlist.push_back(spread);
-		aFrameData[0] = maxlist;
-		aFrameData[1] = minlist;
-		aFrameData[2] = spreadlist;
-		aFrameData[3] = spectrogram;
-
-		_frameData.push_back(aFrameData);
-	}
+std::string AudioManager::_frameDataCacheFolder;
+std::mutex AudioManager::_frameDataCacheFolderLock;
 
-	// normalise data ... basically scale the data so the highest value is the scale value.
-	float scale = 1.0; // 0-1 ... where 0.x means that the max value displayed would be x0% of model size
-	float bigmaxscale = 1 / (_bigmax * scale);
-	float bigminscale = 1 / (_bigmin * scale);
-	float bigspreadscale = 1 / (_bigspread * scale);
-	float bigspectrogramscale = 1 / (_bigspectogrammax * scale);
-	for (std::vector<std::vector<std::list<float>>>::iterator itframe = _frameData.begin(); itframe != _frameData.end(); ++itframe)
-	{
-		std::list<float>* fl = &(*itframe)[0];
-		std::list<float>::iterator f = fl->begin();
-		*f = (*f * bigmaxscale);
+void AudioManager::SetFrameDataCacheFolder(const std::string& folder)
+{
+    std::unique_lock<std::mutex> lock(_frameDataCacheFolderLock);
+    _frameDataCacheFolder = folder;
+}
+
+// Cached frame data is named for the audio hash and frame interval so any copy of the same audio shares it
+std::string AudioManager::GetFrameDataCacheFile(const std::string& hash) const
+{
+    std::unique_lock<std::mutex> lock(_frameDataCacheFolderLock);
+    if (_frameDataCacheFolder == "") return "";
+    return _frameDataCacheFolder + wxFileName::GetPathSeparator() + "AudioCache" + wxFileName::GetPathSeparator() +
+        hash + "_" + std::to_string(_intervalMS) + "ms.xframedata";
+}
 
-		fl = &(*itframe)[1];
-		f = fl->begin();
-		*f = (*f * bigminscale);
+static const int32_t FRAMEDATA_CACHE_VERSION = 1;
 
-		fl = &(*itframe)[2];
-		f = fl->begin();
-		*f = (*f * bigspreadscale);
+bool AudioManager::LoadFrameDataCache(const std::string& hash, int frames)
+{
+    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
 
-		fl = &(*itframe)[3];
-		for (std::list<float>::iterator ff = fl->begin(); ff != fl->end(); ++ff)
-		{
-			*ff = *ff * bigspectrogramscale;
-		}
-	}
+    std::string filename = GetFrameDataCacheFile(hash);
+    if (filename == "" || !wxFileExists(filename)) return false;
 
-	// flag the fact that the data is all ready
-	_frameDataPrepared = true;
+    wxFFile f;
+    if (!f.Open(filename, "rb")) return false;
 
-	logger_base.info("DoPrepareFrameData: Audio frame data processing complete in %ld. Frames: %d", sw.Time(), frames);
+    auto readInt = [&f](int32_t& v) { return f.Read(&v, sizeof(v)) == sizeof(v); };
+    auto readFloat = [&f](float& v) { return f.Read(&v, sizeof(v)) == sizeof(v); };
+
+    char magic[4];
+    int32_t version = 0;
+    int32_t hashLen = 0;
+    if (f.Read(magic, sizeof(magic)) != sizeof(magic) || memcmp(magic, "XLFD", 4) != 0 ||
+        !readInt(version) || version != FRAMEDATA_CACHE_VERSION || !readInt(hashLen) || hashLen != (int32_t)hash.size())
+    {
+        return false;
+    }
+    std::string fileHash(hashLen, ' ');
+    int32_t interval = 0;
+    int32_t fileFrames = 0;
+    if (f.Read(&fileHash[0], hashLen) != (size_t)hashLen || fileHash != hash ||
+        !readInt(interval) || interval != _intervalMS || !readInt(fileFrames) || fileFrames != frames)
+    {
+        logger_base.debug("Frame data cache %s does not match the audio ... ignoring it.", (const char*)filename.c_str());
+        return false;
+    }
+
+    float bigmax, bigmin, bigspread, bigspectogrammax;
+    if (!readFloat(bigmax) || !readFloat(bigmin) || !readFloat(bigspread) || !readFloat(bigspectogrammax)) return false;
+
+    std::vector<std::vector<std::list<float>>> frameData(frames);
+    for (auto& fd : frameData)
+    {
+        fd.resize(5);
+        for (int i = 0; i < 4; i++)
+        {
+            int32_t count = 0;
+            if (!readInt(count) || count < 0 || count > 1024) return false;
+            for (int j = 0; j < count; j++)
+            {
+                float v;
+                if (!readFloat(v)) return false;
+                fd[i].push_back(v);
+            }
+        }
+    }
+
+    std::unique_lock<std::shared_timed_mutex> locker(_mutex);
+    _bigmax = bigmax;
+    _bigmin = bigmin;
+    _bigspread = bigspread;
+    _bigspectogrammax = bigspectogrammax;
+    _frameData.swap(frameData);
+    _frameDataAmplitudeFrames = frames;
+    _frameDataSpectrogramFrames = frames;
+    _frameDataPrepared = true;
+    return true;
+}
+
+void AudioManager::SaveFrameDataCache(const std::string& hash)
+{
+    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    std::string filename = GetFrameDataCacheFile(hash);
+    if (filename == "") return;
+
+    wxFFile f;
+    {
+        // if the folder cant be written that is fine we just wont have a cache
+        wxLogNull logNo;
+        wxFileName fn(filename);
+        if (!fn.DirExists())
+        {
+            fn.Mkdir(wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
+        }
+        if (!f.Open(filename, "wb"))
+        {
+            logger_base.debug("Unable to write frame data cache %s.", (const char*)filename.c_str());
+            return;
+        }
+    }
+
+    auto writeInt = [&f](int32_t v) { f.Write(&v, sizeof(v)); };
+    auto writeFloat = [&f](float v) { f.Write(&v, sizeof(v)); };
+
+    std::shared_lock<std::shared_timed_mutex> locker(_mutex);
+    f.Write("XLFD", 4);
+    writeInt(FRAMEDATA_CACHE_VERSION);
+    writeInt(hash.size());
+    f.Write(hash.c_str(), hash.size());
+    writeInt(_intervalMS);
+    writeInt(_frameData.size());
+    writeFloat(_bigmax);
+    writeFloat(_bigmin);
+    writeFloat(_bigspread);
+    writeFloat(_bigspectogrammax);
+    for (const auto& fd : _frameData)
+    {
+        // the notes are only filled in on demand so they are not cached
+        for (int i = 0; i < 4; i++)
+        {
+            writeInt(fd[i].size());
+            for (const auto& v : fd[i])
+            {
+                writeFloat(v);
+            }
+        }
+    }
+    if (f.Error())
+    {
+        f.Close();
+        wxLogNull logNo;
+        wxRemoveFile(filename);
+    }
 }
 
 // Called to trigger frame data creation
@@ -1833,17 +2006,31 @@ const std::list<float>* AudioManager::GetFrameData(int frame, FRAMEDATATYPE fdt,
     // make sure we have audio data
     if (_data[0] == nullptr) return rc;
 
+    // frame data is published a range at a time so only wait for the frame we want
+    auto isReady = [this, fdt, frame]() {
+        if (_frameDataPrepared) return true;
+        switch (fdt)
+        {
+        case FRAMEDATA_VU:
+            return frame < _frameDataSpectrogramFrames;
+        case FRAMEDATA_NOTES:
+            return false;
+        default:
+            return frame < _frameDataAmplitudeFrames;
+        }
+    };
+
     // if the frame data has not been prepared
-    if (!_frameDataPrepared)
+    if (!isReady())
     {
         logger_base.debug("GetFrameData was called prior to the frame data being prepared.");
-        // prepare it
+        // prepare it ... unless another thread already is
         lock.unlock();
         PrepareFrameData(false);
 
         lock.lock();
-        // wait until the new thread grabs the lock
-        while (!_frameDataPrepared)
+        // wait until the data we need is published
+        while (!isReady())
         {
             lock.unlock();
             wxMilliSleep(5);
@@ -2326,6 +2513,7 @@ int AudioManager::OpenMediaFile()
 		_data[0] = nullptr;
 	}
     _loadedData = 0;
+    _rawMinMax.Clear();
 
     long size = sizeof(float)*(_trackSize + _extra);
 	_data[0] = (float*)calloc(size, 1);
@@ -2601,6 +2789,7 @@ void AudioManager::LoadResampledAudio( int sampleCount, int out_channels, uint8_
         }
     }
     read += sampleCount;
+    _rawMinMax.Update(_data[0], read);
     SetLoadedData(read);
     int progress = read * 100 / _trackSize;
     if (progress >= lastpct + 10)
@@ -2733,6 +2922,78 @@ std::string AudioManager::MidiToNote(int midi)
     return wxString::Format("%s%d", notes[offset], octave).ToStdString();
 }
 
+// Linear convolution of a signal with an FIR filter using FFT overlap-save.
+// out[n] = sum over k of taps[k] * in[n - k] for n in [0, count) with in treated as zero before the start.
+// Each block of output only depends on its own window of input so blocks are processed in parallel.
+static void FFTConvolve(const float* in, long count, const std::vector<float>& taps, float* out)
+{
+    if (count <= 0) return;
+
+    int m = taps.size();
+    int nfft = 1024;
+    while (nfft < 4 * m) {
+        nfft <<= 1;
+    }
+    int block = nfft - m + 1; // new output samples per transform
+    int bins = nfft / 2 + 1;
+
+    // the filter spectrum only needs to be worked out once
+    std::vector<kiss_fft_cpx> filter(bins);
+    {
+        std::vector<float> padded(nfft, 0.0f);
+        std::copy(taps.begin(), taps.end(), padded.begin());
+        kiss_fftr_cfg cfg = kiss_fftr_alloc(nfft, 0, nullptr, nullptr);
+        if (cfg == nullptr) return;
+        kiss_fftr(cfg, padded.data(), filter.data());
+        free(cfg);
+    }
+
+    // fold the inverse transform scaling into the filter
+    const float scale = 1.0f / nfft;
+    for (auto& f : filter) {
+        f.r *= scale;
+        f.i *= scale;
+    }
+
+    // kiss fft plans carry scratch space so each task needs its own ... make the tasks big enough to amortise them
+    const int blocksPerTask = 16;
+    long blocks = (count + block - 1) / block;
+    int tasks = (blocks + blocksPerTask - 1) / blocksPerTask;
+    parallel_for(0, tasks, [&](int task) {
+        kiss_fftr_cfg fwd = kiss_fftr_alloc(nfft, 0, nullptr, nullptr);
+        kiss_fftr_cfg inv = kiss_fftr_alloc(nfft, 1, nullptr, nullptr);
+        if (fwd != nullptr && inv != nullptr) {
+            std::vector<float> segment(nfft);
+            std::vector<kiss_fft_cpx> spectrum(bins);
+
+            long lastBlock = std::min(blocks, (long)(task + 1) * blocksPerTask);
+            for (long b = (long)task * blocksPerTask; b < lastBlock; b++) {
+                long start = b * block;
+                long first = start - (m - 1);
+                for (int i = 0; i < nfft; i++) {
+                    long idx = first + i;
+                    segment[i] = (idx >= 0 && idx < count) ? in[idx] : 0.0f;
+                }
+
+                kiss_fftr(fwd, segment.data(), spectrum.data());
+                for (int k = 0; k < bins; k++) {
+                    float r = spectrum[k].r * filter[k].r - spectrum[k].i * filter[k].i;
+                    float i = spectrum[k].r * filter[k].i + spectrum[k].i * filter[k].r;
+                    spectrum[k].r = r;
+                    spectrum[k].i = i;
+                }
+                kiss_fftri(inv, spectrum.data(), segment.data());
+
+                // the first m - 1 samples have wrapped around so only the tail is valid
+                long n = std::min((long)block, count - start);
+                std::copy(segment.begin() + (m - 1), segment.begin() + (m - 1) + n, out + start);
+            }
+        }
+        free(fwd);
+        free(inv);
+    });
+}
+
 void AudioManager::SwitchTo(AUDIOSAMPLETYPE type, int lowNote, int highNote) {
     while (!IsDataLoaded()) {
         static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
@@ -2808,6 +3069,7 @@ void AudioManager::SwitchTo(AUDIOSAMPLETYPE type, int lowNote, int highNote) {
                 fad->lowNote = 0;
                 fad->highNote = 0;
                 fad->type = type;
+                fad->minMax.Update(fad->data, _trackSize);
                 _filtered.push_back(fad);
             }
         }
@@ -2826,14 +3088,15 @@ void AudioManager::SwitchTo(AUDIOSAMPLETYPE type, int lowNote, int highNote) {
     case AUDIOSAMPLETYPE::CUSTOM:
     {
         // grab it from my cache if i have it
+        const int order = _noteFilterOrder;
         for (const auto& it : _filtered) {
-            if (it->lowNote == lowNote && it->highNote == highNote) {
+            if (it->lowNote == lowNote && it->highNote == highNote && it->order == order) {
                 fad = it;
             }
         }
 
         // if we didnt find it ... create it
-        if (fad == nullptr)  {
+        if (fad == nullptr && _trackSize > 0)  {
             double lowHz = MidiToFrequency(lowNote);
             double highHz = MidiToFrequency(highNote);
 
@@ -2845,8 +3108,7 @@ void AudioManager::SwitchTo(AUDIOSAMPLETYPE type, int lowNote, int highNote) {
             //Normalize f_c and w_c so that pi is equal to the Nyquist angular frequency
             float f1_c = lowHz / _rate;
             float f2_c = highHz / _rate;
-            const int order = 513; // 1025 is awesome but slow
-            float a[order];
+            std::vector<float> a(order);
             float w1_c = pi2 * f1_c;
             float w2_c = pi2 * f2_c;
             int middle = order / 2.0; /*Integer division, dropping remainder*/
@@ -2857,40 +3119,41 @@ void AudioManager::SwitchTo(AUDIOSAMPLETYPE type, int lowNote, int highNote) {
                     a[i + middle] = sin(w2_c * i) / (M_PI * i) - sin(w1_c * i) / (M_PI * i);
                 }
             }
-            //Now apply a windowing function to taper the edges of the filter, e.g.
-            parallel_for(0, _trackSize, [fad, this, a, order](int i) {
-                float lvalue = 0;
-                float rvalue = 0;
-                for (int j = 0; j < order; j++) {
-                    int jj = i + j - order;
-                    if (jj >= 0 && jj < _trackSize) {
-                        lvalue += _data[0][jj] * a[order - j - 1];
+
+            // output sample i is the filter applied to the samples before it ... hence the one sample shift
+            fad->data[0] = 0;
+            FFTConvolve(_data[0], _trackSize - 1, a, fad->data + 1);
+            std::vector<float> right;
+            if (_data[1]) {
+                right.resize(_trackSize);
+                right[0] = 0;
+                FFTConvolve(_data[1], _trackSize - 1, a, right.data() + 1);
+            }
+
+            parallel_for_range(0, _trackSize, [fad, this, &right](int iStart, int iEnd) {
+                for (int i = iStart; i < iEnd; i++) {
+                    float lvalue = fad->data[i] * 32768;
+                    int v2 = (int)lvalue;
+                    fad->pcmdata[i * _channels] = v2;
+                    if (_channels > 1)
+                    {
                         if (_data[1]) {
-                            rvalue += _data[1][jj] * a[order - j - 1];
+                            float rvalue = right[i] * 32768;
+                            v2 = (int)rvalue;
+                            fad->pcmdata[i * _channels + 1] = v2;
+                        }
+                        else {
+                            fad->pcmdata[i * _channels + 1] = v2;
                         }
                     }
                 }
-                fad->data[i] = lvalue;
-
-                lvalue = lvalue * 32768;
-                int v2 = (int)lvalue;
-                fad->pcmdata[i * _channels] = v2;
-                if (_channels > 1)
-                {
-                    if (_data[1]) {
-                        rvalue = rvalue * 32768;
-                        v2 = (int)rvalue;
-                        fad->pcmdata[i * _channels + 1] = v2;
-                    }
-                    else {
-                        fad->pcmdata[i * _channels + 1] = v2;
-                    }
-                }
-            });
+            }, 10000);
 
             fad->lowNote = lowNote;
             fad->highNote = highNote;
+            fad->order = order;
             fad->type = type;
+            fad->minMax.Update(fad->data, _trackSize);
             _filtered.push_back(fad);
         }
     }
@@ -2907,6 +3170,92 @@ void AudioManager::SwitchTo(AUDIOSAMPLETYPE type, int lowNote, int highNote) {
     }
 }
 
+void AudioMinMaxPyramid::Clear()
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    for (auto& level : _levels)
+    {
+        level.clear();
+    }
+}
+
+void AudioMinMaxPyramid::Update(const float* data, long count)
+{
+    if (data == nullptr) return;
+
+    std::unique_lock<std::mutex> lock(_lock);
+
+    // finest level straight from the samples
+    auto& base = _levels[0];
+    while ((long)(base.size() + 1) * BASE_BLOCK <= count)
+    {
+        const float* p = data + base.size() * BASE_BLOCK;
+        MinMax mm = { p[0], p[0] };
+        for (int i = 1; i < BASE_BLOCK; i++)
+        {
+            mm.min = std::min(mm.min, p[i]);
+            mm.max = std::max(mm.max, p[i]);
+        }
+        base.push_back(mm);
+    }
+
+    // each coarser level from the one below it
+    for (int l = 1; l < LEVELS; l++)
+    {
+        auto& below = _levels[l - 1];
+        auto& level = _levels[l];
+        while ((level.size() + 1) * LEVEL_FACTOR <= below.size())
+        {
+            const MinMax* p = &below[level.size() * LEVEL_FACTOR];
+            MinMax mm = p[0];
+            for (int i = 1; i < LEVEL_FACTOR; i++)
+            {
+                mm.min = std::min(mm.min, p[i].min);
+                mm.max = std::max(mm.max, p[i].max);
+            }
+            level.push_back(mm);
+        }
+    }
+}
+
+void AudioMinMaxPyramid::GetMinMax(const float* data, long start, long end, float& minimum, float& maximum) const
+{
+    if (data == nullptr) return;
+
+    std::unique_lock<std::mutex> lock(_lock);
+
+    long pos = std::max(0L, start);
+    while (pos < end)
+    {
+        // take the coarsest block which starts here and fits entirely in the range
+        bool used = false;
+        long size = (long)BASE_BLOCK * LEVEL_FACTOR * LEVEL_FACTOR;
+        for (int l = LEVELS - 1; l >= 0; l--, size /= LEVEL_FACTOR)
+        {
+            if (pos % size == 0 && pos + size <= end && pos / size < (long)_levels[l].size())
+            {
+                const MinMax& mm = _levels[l][pos / size];
+                minimum = std::min(minimum, mm.min);
+                maximum = std::max(maximum, mm.max);
+                pos += size;
+                used = true;
+                break;
+            }
+        }
+
+        if (!used)
+        {
+            // raw samples up to the next block boundary
+            long stop = std::min(end, (pos / BASE_BLOCK + 1) * BASE_BLOCK);
+            for (; pos < stop; pos++)
+            {
+                minimum = std::min(minimum, data[pos]);
+                maximum = std::max(maximum, data[pos]);
+            }
+        }
+    }
+}
+
 void AudioManager::GetLeftDataMinMax(long start, long end, float& minimum, float& maximum, AUDIOSAMPLETYPE type, int lowNote, int highNote)
 {
     static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
@@ -2950,17 +3299,11 @@ void AudioManager::GetLeftDataMinMax(long start, long end, float& minimum, float
     case AUDIOSAMPLETYPE::CUSTOM:
     case AUDIOSAMPLETYPE::NONVOCALS:
         if (fad != nullptr) {
-            for (int j = start; j < std::min(end, _trackSize); j++) {
-                minimum = std::min(minimum, fad->data[j]);
-                maximum = std::max(maximum, fad->data[j]);
-            }
+            fad->minMax.GetMinMax(fad->data, start, std::min(end, _trackSize), minimum, maximum);
         }
         break;
     case AUDIOSAMPLETYPE::RAW:
-        for (int j = start; j < std::min(end, _trackSize); j++) {
-            minimum = std::min(minimum, _data[0][j]);
-            maximum = std::max(maximum, _data[0][j]);
-        }
+        _rawMinMax.GetMinMax(_data[0], start, std::min(end, _trackSize), minimum, maximum);
         break;
     }
 }
@@ -14,6 +14,7 @@
 #include <string>
 #include <list>
 #include <shared_mutex>
+#include <mutex>
 #include <vector>
 #include <future>
 
@@ -186,13 +187,40 @@ public:
     bool IsListening();
 };
 
+// Precomputed minimums and maximums of a track at 256, 4096 and 65536 sample resolution so the waveform can be
+// drawn at any zoom without rescanning every sample. Blocks are added as the samples become available.
+class AudioMinMaxPyramid
+{
+public:
+    static const int LEVELS = 3;
+    static const int BASE_BLOCK = 256;
+    static const int LEVEL_FACTOR = 16;
+
+    void Clear();
+    // add any blocks now complete given the first count samples of data are valid
+    void Update(const float* data, long count);
+    // widens minimum and maximum by the samples in [start, end)
+    void GetMinMax(const float* data, long start, long end, float& minimum, float& maximum) const;
+
+private:
+    struct MinMax
+    {
+        float min;
+        float max;
+    };
+    mutable std::mutex _lock;
+    std::vector<MinMax> _levels[LEVELS];
+};
+
 struct FilteredAudioData
 {
     AUDIOSAMPLETYPE type;
     int lowNote = 0;
     int highNote = 127;
+    int order = 0;
     float* data = nullptr;
     int16_t *pcmdata = nullptr;
+    AudioMinMaxPyramid minMax;
 };
 
 class AudioManager
@@ -206,6 +234,7 @@ class AudioManager
 	long _rate = 44100;
 	int _channels = 0;
     long _trackSize = 0;
+    static int _noteFilterOrder;
 	int _bits = 0;
 	int _extra = 0;
 	std::string _resultMessage;
@@ -219,6 +248,11 @@ class AudioManager
 	int _intervalMS = 50;
 	long _lengthMS = 0;
 	bool _frameDataPrepared = false;
+    int _frameDataAmplitudeFrames = 0; // leading frames with high, low and spread published
+    int _frameDataSpectrogramFrames = 0; // leading frames with the spectrogram published
+    std::mutex _prepareFrameDataLock;
+    static std::string _frameDataCacheFolder;
+    static std::mutex _frameDataCacheFolderLock;
 	float _bigmax = 0;
 	float _bigspread = 0;
 	float _bigmin = 0;
@@ -226,6 +260,7 @@ class AudioManager
 	MEDIAPLAYINGSTATE _media_state;
 	bool _polyphonicTranscriptionDone = false;
     std::vector<FilteredAudioData*> _filtered;
+    AudioMinMaxPyramid _rawMinMax;
     int _sdlid = 0;
     bool _ok = false;
     std::string _hash;
@@ -244,6 +279,9 @@ class AudioManager
 	int decodesamplerateindex(int samplerateindex, int version) const;
     static int decodesideinfosize(int version, int mono);
 	std::list<float> CalculateSpectrumAnalysis(const float* in, int n, float& max, int id) const;
+    std::string GetFrameDataCacheFile(const std::string& hash) const;
+    bool LoadFrameDataCache(const std::string& hash, int frames);
+    void SaveFrameDataCache(const std::string& hash);
 
     void LoadAudioFromFrame( AVFormatContext* formatContext, AVCodecContext* codecContext, AVPacket* decodingPacket, AVFrame* frame, SwrContext* au_convert_ctx,
                              bool receivedEOF, int out_channels, uint8_t* out_buffer, long& read, int& lastpct );
@@ -269,6 +307,10 @@ public:
     long GetLoadedData();
     bool IsDataLoaded(long pos = -1);
     static void SetPlaybackRate(float rate);
+    // sharper note range filters ... off by default as it changes the audio effects react to, set in preferences
+    static void SetHighQualityNoteFilters(bool hq);
+    // analysed frame data is cached under this folder ... blank to not cache it
+    static void SetFrameDataCacheFolder(const std::string& folder);
 	MEDIAPLAYINGSTATE GetPlayingState() const;
 	long Tell() const;
 	xLightsVamp* GetVamp() { return &_vamp; };
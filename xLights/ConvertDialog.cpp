@@ -8,7 +8,10 @@
  * License: https://github.com/smeighan/xLights/blob/master/License.txt
  **************************************************************/
 
+#include <atomic>
 #include <map>
+#include <mutex>
+#include <thread>
 
 #include <wx/base64.h>
 #include <wx/confbase.h>
@@ -254,9 +257,16 @@ void ConvertDialog::OnButtonStartConversionClick(wxCommandEvent& event)
     }
     else
     {
-        for (size_t i = 0; i < FileNames.GetCount(); i++)
+        if (OutputFormat.Left(3) == "Fal" && FileNames.GetCount() > 1 && !showChannelMapping())
         {
-            DoConversion(FileNames[i], OutputFormat);
+            DoBatchFSEQConversion();
+        }
+        else
+        {
+            for (size_t i = 0; i < FileNames.GetCount(); i++)
+            {
+                DoConversion(FileNames[i], OutputFormat);
+            }
         }
         AppendConvertStatus(wxString("Finished converting all files\n"));
     }
@@ -1960,6 +1970,90 @@ void ConvertDialog::ReadLorFile(const wxString& filename, int LORImportInterval)
     SetStatusText(wxString("LOR sequence loaded successfully"));
 }
 
+// Converting several files to fseq doesn't need the main sequence data or the channel mapping display so
+// the files are converted side by side on background threads while this keeps the dialog responsive
+void ConvertDialog::DoBatchFSEQConversion()
+{
+    int interval = 50;
+    switch (LORImportTimeResolution->GetSelection()) {
+    case 0:
+        interval = 25;
+        break;
+    case 2:
+        interval = 100;
+        break;
+    default:
+        break;
+    }
+
+    std::vector<BatchConvertJob> jobs;
+    for (size_t i = 0; i < FileNames.GetCount(); i++)
+    {
+        wxFileName oName(FileNames[i]);
+        if (oName.GetExt() == "fseq")
+        {
+            AppendConvertStatus(wxString("Skipping ") + FileNames[i] + ": cannot convert from Falcon Player file to Falcon Player file!\n");
+            continue;
+        }
+        oName.SetPath(_parent->CurrentDir);
+        oName.SetExt("fseq");
+        jobs.emplace_back(FileNames[i], oName.GetFullPath());
+    }
+    if (jobs.empty()) return;
+
+    std::mutex doneLock;
+    std::vector<wxString> doneMessages;
+
+    BatchConvertOptions options;
+    options.xLightsFrm = _parent;
+    options.outputManager = _outputManager;
+    options.sequence_interval = interval;
+    options.channels_off_at_end = isSetOffAtEnd();
+    options.map_empty_channels = mapEmptyChannels();
+    options.map_no_network_channels = MapLORChannelsWithNoNetwork->IsChecked();
+    options.jobDone = [&doneLock, &doneMessages](const BatchConvertJob& job) {
+        wxString msg;
+        if (job.succeeded)
+        {
+            msg = wxString::Format("Finished writing new file: %s (%ldms)\n", job.out_filename, job.elapsedMS);
+        }
+        else
+        {
+            msg = wxString::Format("ERROR converting %s: %s\n", job.inp_filename, job.error_message);
+        }
+        std::unique_lock<std::mutex> lock(doneLock);
+        doneMessages.push_back(msg);
+    };
+
+    AppendConvertStatus(wxString::Format("Converting %d files to Falcon Player sequences\n", (int)jobs.size()));
+
+    std::atomic_bool finished(false);
+    std::thread batch([&jobs, &options, &finished]() {
+        FileConverter::ConvertToFSEQ(jobs, options);
+        finished = true;
+    });
+
+    auto showDone = [this, &doneLock, &doneMessages]() {
+        std::vector<wxString> msgs;
+        {
+            std::unique_lock<std::mutex> lock(doneLock);
+            msgs.swap(doneMessages);
+        }
+        for (const auto& m : msgs)
+        {
+            AppendConvertStatus(m);
+        }
+    };
+    while (!finished)
+    {
+        wxMilliSleep(50);
+        showDone();
+        wxYield();
+    }
+    batch.join();
+    showDone();
+}
+
 void ConvertDialog::DoConversion(const wxString& Filename, const wxString& OutputFormat)
 {
     wxString fullpath;
@@ -64,6 +64,7 @@ class ConvertDialog: public wxDialog
     void ReadHLSFile(const wxString& filename);
     void ReadLorFile(const wxString& filename, int LORImportInterval);
     void DoConversion(const wxString& Filename, const wxString& OutputFormat);
+    void DoBatchFSEQConversion();
     wxString FromAscii(const char *val);
     wxString getAttributeValueSafe(SP_XmlStartTagEvent * stagEvent, const char * name);
 
@@ -0,0 +1,342 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <chrono>
+#include <list>
+#include <map>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <wx/file.h>
+
+#include "xLightsMain.h"
+#include "xLightsApp.h"
+#include "RenderBuffer.h"
+#include "PixelBuffer.h"
+#include "effects/RenderableEffect.h"
+#include "sequencer/SequenceElements.h"
+#include "sequencer/Element.h"
+#include "sequencer/EffectLayer.h"
+#include "sequencer/Effect.h"
+#include "../xSchedule/wxJSON/jsonval.h"
+#include "../xSchedule/wxJSON/jsonreader.h"
+#include "../xSchedule/wxJSON/jsonwriter.h"
+
+#include <log4cpp/Category.hh>
+
+// Renders every effect with its default settings on synthetic buffers of a few typical sizes so we can
+// see if a change made rendering slower, and hashes the output so unintended visual changes show up too.
+// In builds with EFFECT_BENCHMARK_CHECKS it also checks the layer blur and roto zoom against the simpler code
+// they replaced. It also times the C library rand() against the per buffer generator with many threads
+// drawing at once.
+// Against a baseline it flags outputs whose hash changed and, when the baseline was recorded on the same
+// platform, effects that got more than BENCHMARK_SLOWDOWN_TOLERANCE times slower. Either makes the run fail.
+
+struct BenchmarkSize
+{
+    const char* name;
+    int width;
+    int height;
+};
+
+static const BenchmarkSize BENCHMARK_SIZES[] = {
+    { "1x50", 50, 1 },
+    { "50x50", 50, 50 },
+    { "300x150", 300, 150 },
+    { "1000 node group", 1000, 1 }
+};
+static const int BENCHMARK_FRAMES = 200;
+static const int BENCHMARK_FRAME_MS = 50;
+// timings on shared build machines wander by 10-15% from run to run so only flag a clear slowdown
+static const double BENCHMARK_SLOWDOWN_TOLERANCE = 1.25;
+// below this the timer resolution is a large part of the measurement
+static const double BENCHMARK_MIN_TIMED_NS = 0.5;
+// the float blur passes round ties differently to the old code so allow one step in any channel
+static const int BENCHMARK_POST_PROCESSING_TOLERANCE = 1;
+static const int BENCHMARK_RANDOM_THREADS[] = { 1, 4, 16, 32 };
+static const int BENCHMARK_RANDOM_DRAWS = 2000000;
+static const std::string BENCHMARK_MODEL = "xLights Effect Benchmark";
+static const std::string BENCHMARK_PALETTE = "C_BUTTON_Palette1=#FF0000,C_CHECKBOX_Palette1=1,"
+                                             "C_BUTTON_Palette2=#00FF00,C_CHECKBOX_Palette2=1,"
+                                             "C_BUTTON_Palette3=#0000FF,C_CHECKBOX_Palette3=1,"
+                                             "C_BUTTON_Palette4=#FFFFFF,C_CHECKBOX_Palette4=1";
+
+// these need media, pictures, faces, shaders or a real model none of which a synthetic buffer has
+static const std::set<std::string> BENCHMARK_SKIP = {
+    "DMX", "Faces", "Glediator", "Moving Head", "Music", "Piano", "Pictures", "Servo", "Shader", "State", "Video", "VU Meter"
+};
+
+// Floating point results differ between compilers and CPUs so hashes are only comparable with a baseline from the same build
+#if defined(_MSC_VER)
+static const std::string BENCHMARK_COMPILER = "msvc";
+#elif defined(__clang__)
+static const std::string BENCHMARK_COMPILER = "clang";
+#else
+static const std::string BENCHMARK_COMPILER = "gcc";
+#endif
+#if defined(__aarch64__) || defined(_M_ARM64)
+static const std::string BENCHMARK_PLATFORM = BENCHMARK_COMPILER + "-arm64";
+#else
+static const std::string BENCHMARK_PLATFORM = BENCHMARK_COMPILER + "-x64";
+#endif
+
+static uint64_t HashPixels(uint64_t hash, const xlColorVector& pixels)
+{
+    // FNV-1a
+    for (const auto& c : pixels) {
+        const uint8_t v[4] = { c.red, c.green, c.blue, c.alpha };
+        for (int i = 0; i < 4; i++) {
+            hash ^= v[i];
+            hash *= 1099511628211ULL;
+        }
+    }
+    return hash;
+}
+
+// wall clock ns per draw when every thread draws BENCHMARK_RANDOM_DRAWS numbers at the same time
+static double BenchmarkRandom(int threads, bool useRand)
+{
+    std::vector<std::thread> workers;
+    std::vector<uint32_t> sums(threads);
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([t, useRand, &sums]() {
+            RenderRandom random;
+            random.Seed(t);
+            uint32_t sum = 0;
+            for (int i = 0; i < BENCHMARK_RANDOM_DRAWS; i++) {
+                sum += useRand ? (uint32_t)rand() : (uint32_t)random.Rand();
+            }
+            // keep the draws from being optimised away
+            sums[t] = sum;
+        });
+    }
+    for (auto& it : workers) {
+        it.join();
+    }
+    std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - start;
+    return (double)elapsed.count() / (double)BENCHMARK_RANDOM_DRAWS;
+}
+
+struct BenchmarkBaselineResult
+{
+    std::string hash;
+    double nsPerPixelFrame = 0.0;
+};
+
+// timesComparable is only set when the baseline was recorded on this platform
+static std::map<std::string, BenchmarkBaselineResult> LoadBenchmarkBaseline(const wxString& baselineFile, bool& timesComparable)
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    std::map<std::string, BenchmarkBaselineResult> hashes;
+    timesComparable = false;
+    wxFile f;
+    if (baselineFile == "" || !f.Open(baselineFile)) {
+        if (baselineFile != "") {
+            logger_base.error("Unable to open benchmark baseline %s.", (const char*)baselineFile.c_str());
+        }
+        return hashes;
+    }
+    wxString str;
+    f.ReadAll(&str);
+
+    wxJSONValue baseline;
+    wxJSONReader reader;
+    if (reader.Parse(str, &baseline) > 0) {
+        logger_base.error("Unable to parse benchmark baseline %s.", (const char*)baselineFile.c_str());
+        return hashes;
+    }
+    if (baseline.HasMember("platform") && baseline["platform"].AsString() != BENCHMARK_PLATFORM) {
+        logger_base.warn("Benchmark baseline %s was recorded on %s, this is %s. Hashes may differ due to floating point differences and times are not compared.",
+                         (const char*)baselineFile.c_str(), (const char*)baseline["platform"].AsString().c_str(), BENCHMARK_PLATFORM.c_str());
+    } else {
+        timesComparable = true;
+    }
+    const wxJSONValue& results = baseline["results"];
+    for (int i = 0; i < results.Size(); i++) {
+        BenchmarkBaselineResult& r = hashes[(results[i]["effect"].AsString() + "|" + results[i]["size"].AsString()).ToStdString()];
+        r.hash = results[i]["hash"].AsString().ToStdString();
+        // whole numbers are written without a decimal point and read back as ints
+        const wxJSONValue& ns = results[i]["nsPerPixelFrame"];
+        r.nsPerPixelFrame = ns.IsDouble() ? ns.AsDouble() : (ns.IsInt() ? (double)ns.AsInt() : 0.0);
+    }
+    return hashes;
+}
+
+void xLightsFrame::RunEffectBenchmark(const wxString& reportFile, const wxString& baselineFile, bool exitOnDone)
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+    logger_base.info("Effect benchmark started.");
+
+    bool timesComparable = false;
+    auto baseline = LoadBenchmarkBaseline(baselineFile, timesComparable);
+    // the first run against a baseline that does not exist yet, or has no results yet, records it
+    bool recordBaseline = baselineFile != "" && baseline.empty();
+
+    SequenceElements els(this);
+    els.SetFrequency(1000 / BENCHMARK_FRAME_MS);
+    els.SetSequenceEnd(BENCHMARK_FRAMES * BENCHMARK_FRAME_MS);
+    Element* element = els.AddElement(BENCHMARK_MODEL, "model", false, false, false, false);
+    EffectLayer* layer = element->GetEffectLayerCount() == 0 ? element->AddEffectLayer() : element->GetEffectLayer(0);
+
+    wxJSONValue report;
+    report["frames"] = BENCHMARK_FRAMES;
+    report["platform"] = wxString(BENCHMARK_PLATFORM);
+    report["results"].SetType(wxJSONTYPE_ARRAY);
+    int mismatches = 0;
+    int slowdowns = 0;
+
+    printf("%-20s %-16s %14s %10s  %s\n", "Effect", "Buffer", "ns/pixel/frame", "Baseline", "Hash");
+    for (auto reff : effectManager) {
+        if (reff == nullptr || BENCHMARK_SKIP.find(reff->Name()) != BENCHMARK_SKIP.end()) {
+            continue;
+        }
+
+        Effect* effect = layer->AddEffect(0, reff->Name(), "", BENCHMARK_PALETTE, 0, BENCHMARK_FRAMES * BENCHMARK_FRAME_MS, 0, false);
+        xlColorVector colors;
+        xlColorCurveVector colorCurves;
+        effect->CopyPalette(colors, colorCurves);
+
+        for (const auto& size : BENCHMARK_SIZES) {
+            RenderBuffer buffer(this);
+            buffer.SetFrameTimeInMs(BENCHMARK_FRAME_MS);
+            buffer.InitBuffer(size.height, size.width, size.height, size.width, "None");
+            buffer.SetEffectDuration(0, BENCHMARK_FRAMES * BENCHMARK_FRAME_MS);
+            buffer.SetPalette(colors, colorCurves);
+            SettingsMap settings = effect->GetSettings();
+
+            uint64_t hash = 14695981039346656037ULL;
+            std::chrono::nanoseconds elapsed(0);
+            for (int frame = 0; frame < BENCHMARK_FRAMES; frame++) {
+                buffer.SetState(frame, frame == 0, BENCHMARK_MODEL);
+                buffer.Clear();
+                auto start = std::chrono::steady_clock::now();
+                reff->Render(effect, settings, buffer);
+                elapsed += std::chrono::steady_clock::now() - start;
+                hash = HashPixels(hash, buffer.pixels);
+            }
+
+            double nsPerPixelFrame = (double)elapsed.count() / ((double)size.width * size.height * BENCHMARK_FRAMES);
+            std::string hashStr = wxString::Format("%016llx", (unsigned long long)hash).ToStdString();
+
+            auto key = reff->Name() + "|" + size.name;
+            auto it = baseline.find(key);
+            bool changed = it != baseline.end() && it->second.hash != hashStr;
+            if (changed) {
+                mismatches++;
+                logger_base.warn("Effect benchmark: %s on %s output changed, was %s now %s.", (const char*)reff->Name().c_str(), size.name, (const char*)it->second.hash.c_str(), (const char*)hashStr.c_str());
+            }
+            double baselineNs = (timesComparable && it != baseline.end()) ? it->second.nsPerPixelFrame : 0.0;
+            bool slower = baselineNs >= BENCHMARK_MIN_TIMED_NS && nsPerPixelFrame > baselineNs * BENCHMARK_SLOWDOWN_TOLERANCE;
+            if (slower) {
+                slowdowns++;
+                logger_base.warn("Effect benchmark: %s on %s is slower, was %.3f now %.3f ns per pixel per frame.", (const char*)reff->Name().c_str(), size.name, baselineNs, nsPerPixelFrame);
+            }
+            printf("%-20s %-16s %14.3f %10.3f  %s%s%s\n", reff->Name().c_str(), size.name, nsPerPixelFrame, baselineNs, hashStr.c_str(), changed ? "  CHANGED" : "", slower ? "  SLOWER" : "");
+
+            wxJSONValue r;
+            r["effect"] = wxString(reff->Name());
+            r["size"] = wxString(size.name);
+            r["width"] = size.width;
+            r["height"] = size.height;
+            r["nsPerPixelFrame"] = nsPerPixelFrame;
+            r["hash"] = wxString(hashStr);
+            if (changed) {
+                r["baselineHash"] = wxString(it->second.hash);
+            }
+            if (baselineNs > 0.0) {
+                r["baselineNsPerPixelFrame"] = baselineNs;
+            }
+            r["slower"] = slower;
+            report["results"].Append(r);
+        }
+        layer->DeleteEffect(effect->GetID());
+    }
+    report["mismatches"] = mismatches;
+    report["slowdowns"] = slowdowns;
+
+    int toleranceFailures = 0;
+#ifdef EFFECT_BENCHMARK_CHECKS
+    report["postProcessing"].SetType(wxJSONTYPE_ARRAY);
+    printf("\n%-36s %-10s %8s %8s %8s\n", "Post processing", "Buffer", "Max diff", "Pixels", "Speedup");
+    for (const auto& it : PixelBufferClass::CheckPostProcessing(this)) {
+        std::string size = std::to_string(it.width) + "x" + std::to_string(it.height);
+        bool failed = it.maxDiff > BENCHMARK_POST_PROCESSING_TOLERANCE;
+        if (failed) {
+            toleranceFailures++;
+            logger_base.warn("Effect benchmark: %s on %s differs from the reference by up to %d in %d pixels.", it.name.c_str(), size.c_str(), it.maxDiff, it.pixelsDiffering);
+        }
+        double speedup = it.ns > 0 ? it.referenceNs / it.ns : 0.0;
+        printf("%-36s %-10s %8d %8d %7.1fx%s\n", it.name.c_str(), size.c_str(), it.maxDiff, it.pixelsDiffering, speedup, failed ? "  FAILED" : "");
+
+        wxJSONValue r;
+        r["check"] = wxString(it.name);
+        r["width"] = it.width;
+        r["height"] = it.height;
+        r["maxDiff"] = it.maxDiff;
+        r["pixelsDiffering"] = it.pixelsDiffering;
+        r["ns"] = it.ns;
+        r["referenceNs"] = it.referenceNs;
+        report["postProcessing"].Append(r);
+    }
+    report["postProcessingFailures"] = toleranceFailures;
+#else
+    printf("\nPost processing checks are only in builds with EFFECT_BENCHMARK_CHECKS\n");
+#endif
+
+    // rand() gets slower as threads are added because of its global lock, the buffer generator should stay
+    // flat until the threads outnumber the cores
+    report["random"].SetType(wxJSONTYPE_ARRAY);
+    printf("\n%-20s %14s %14s %8s\n", "Random threads", "rand() ns", "Buffer ns", "Speedup");
+    for (int threads : BENCHMARK_RANDOM_THREADS) {
+        double randNs = BenchmarkRandom(threads, true);
+        double bufferNs = BenchmarkRandom(threads, false);
+        printf("%-20d %14.3f %14.3f %7.1fx\n", threads, randNs, bufferNs, bufferNs > 0 ? randNs / bufferNs : 0.0);
+
+        wxJSONValue r;
+        r["threads"] = threads;
+        r["randNs"] = randNs;
+        r["bufferNs"] = bufferNs;
+        report["random"].Append(r);
+    }
+
+    wxString str;
+    wxJSONWriter writer(wxJSONWRITER_STYLED, 0, 3);
+    writer.Write(report, str);
+    std::list<wxString> outputs;
+    if (reportFile != "") {
+        outputs.push_back(reportFile);
+    }
+    if (recordBaseline) {
+        logger_base.info("Effect benchmark baseline %s did not exist, recording this run as the baseline.", (const char*)baselineFile.c_str());
+        outputs.push_back(baselineFile);
+    }
+    for (const auto& it : outputs) {
+        wxFile f;
+        if (f.Create(it, true) && f.IsOpened()) {
+            f.Write(str);
+            f.Close();
+        } else {
+            logger_base.error("Unable to write effect benchmark report %s.", (const char*)it.c_str());
+        }
+    }
+    logger_base.info("Effect benchmark done, %d outputs differ from the baseline, %d outputs are slower than the baseline, %d post processing checks out of tolerance.",
+                     mismatches, slowdowns, toleranceFailures);
+    printf("%d outputs differ from the baseline\n", mismatches);
+    printf("%d outputs are more than %.0f%% slower than the baseline\n", slowdowns, (BENCHMARK_SLOWDOWN_TOLERANCE - 1.0) * 100.0);
+    printf("%d post processing checks out of tolerance\n", toleranceFailures);
+
+    if (exitOnDone) {
+        xLightsApp::exitCode = (mismatches || slowdowns || toleranceFailures) ? 1 : 0;
+        Destroy();
+    }
+}
@@ -9,12 +9,16 @@
  **************************************************************/
 
 #include <algorithm>
+#include <atomic>
 #include <map>
+#include <thread>
 
 #include <wx/app.h>
 #include <wx/arrstr.h>
 #include <wx/file.h>
 #include <wx/filename.h>
+#include <wx/stopwatch.h>
+#include <wx/thread.h>
 #include <wx/xml/xml.h>
 
 #include "../include/spxml-0.5/spxmlparser.hpp"
@@ -39,13 +43,16 @@ static const int MAX_READ_BLOCK_SIZE = 4096 * 1024;
 
 void ConvertParameters::AppendConvertStatus(const wxString& msg, bool flushbuffer)
 {
-    if (convertDialog != nullptr)
-    {
-        convertDialog->AppendConvertStatus(msg + "\n", flushbuffer);
-    }
-    if (convertLogDialog != nullptr)
+    if (wxThread::IsMain())
     {
-        convertLogDialog->AppendConvertStatus(msg + "\n", flushbuffer);
+        if (convertDialog != nullptr)
+        {
+            convertDialog->AppendConvertStatus(msg + "\n", flushbuffer);
+        }
+        if (convertLogDialog != nullptr)
+        {
+            convertLogDialog->AppendConvertStatus(msg + "\n", flushbuffer);
+        }
     }
     static log4cpp::Category &logger_conversion = log4cpp::Category::getInstance(std::string("log_conversion"));
     logger_conversion.info("Convert Status: " + msg);
@@ -54,6 +61,8 @@ void ConvertParameters::AppendConvertStatus(const wxString& msg, bool flushbuffe
 
 void ConvertParameters::SetStatusText(wxString msg)
 {
+    if (!wxThread::IsMain()) return;
+
     if (xLightsFrm != nullptr)
     {
         xLightsFrm->SetStatusText(msg);
@@ -66,7 +75,13 @@ void ConvertParameters::SetStatusText(wxString msg)
 
 void ConvertParameters::ConversionError(wxString msg)
 {
-    if (convertDialog != nullptr)
+    error_message = msg;
+    if (!wxThread::IsMain())
+    {
+        static log4cpp::Category &logger_conversion = log4cpp::Category::getInstance(std::string("log_conversion"));
+        logger_conversion.error("Conversion error: " + msg);
+    }
+    else if (convertDialog != nullptr)
     {
         convertDialog->ConversionError(msg);
     }
@@ -78,7 +93,13 @@ void ConvertParameters::ConversionError(wxString msg)
 
 void ConvertParameters::PlayerError(wxString msg)
 {
-    if (convertDialog != nullptr)
+    error_message = msg;
+    if (!wxThread::IsMain())
+    {
+        static log4cpp::Category &logger_conversion = log4cpp::Category::getInstance(std::string("log_conversion"));
+        logger_conversion.error("Conversion error: " + msg);
+    }
+    else if (convertDialog != nullptr)
     {
         convertDialog->PlayerError(msg);
     }
@@ -87,6 +108,52 @@ void ConvertParameters::PlayerError(wxString msg)
         xLightsFrm->PlayerError(msg);
     }
 }
+
+void ConvertParameters::YieldToUI()
+{
+    if (wxThread::IsMain())
+    {
+        wxYield();
+    }
+}
+
+void ConvertParameters::InitSequenceData(unsigned int numChannels, unsigned int numFrames, unsigned int frameTime)
+{
+    if (memory_budget != nullptr)
+    {
+        ReleaseSequenceData();
+        memory_reserved = (size_t)roundTo4(numChannels) * (size_t)numFrames;
+        memory_budget->Reserve(memory_reserved);
+    }
+    seq_data.init(numChannels, numFrames, frameTime);
+}
+
+void ConvertParameters::ReleaseSequenceData()
+{
+    if (memory_budget != nullptr && memory_reserved != 0)
+    {
+        seq_data.init(0, 0, seq_data.FrameTime());
+        memory_budget->Release(memory_reserved);
+        memory_reserved = 0;
+    }
+}
+
+void ConvertMemoryBudget::Reserve(size_t bytes)
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    _released.wait(lock, [this, bytes] { return _used == 0 || _used + bytes <= _budget; });
+    _used += bytes;
+}
+
+void ConvertMemoryBudget::Release(size_t bytes)
+{
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        _used -= std::min(bytes, _used);
+    }
+    _released.notify_all();
+}
+
 ConvertParameters::ConvertParameters( wxString inp_filename_,
                                       SequenceData& seq_data_,
                                       OutputManager* outputManager_,
@@ -118,6 +185,11 @@ ConvertParameters::ConvertParameters( wxString inp_filename_,
 {
 }
 
+ConvertParameters::~ConvertParameters()
+{
+    ReleaseSequenceData();
+}
+
 FileConverter::FileConverter()
 {
     //ctor
@@ -263,7 +335,7 @@ void FileConverter::ReadLorFile(ConvertParameters& params)
         ChannelColors.push_back(0);
         ChannelNames.push_back("");
     }
-    params.seq_data.init(0, 0, params.sequence_interval);
+    params.InitSequenceData(0, 0, params.sequence_interval);
 
     params.AppendConvertStatus(string_format("Reading LOR sequence: %s", params.inp_filename));
     params.SetStatusText(string_format("Reading LOR sequence: %s\n", params.inp_filename));
@@ -314,7 +386,7 @@ void FileConverter::ReadLorFile(ConvertParameters& params)
                 if (nodecnt > 1000)
                 {
                     nodecnt = 0;
-                    wxYield();
+                    params.YieldToUI();
                 }
                 if (NodeName == wxString("track"))
                 {
@@ -407,7 +479,7 @@ void FileConverter::ReadLorFile(ConvertParameters& params)
         {
             numFrames = 1;
         }
-        params.seq_data.init(params._outputManager->GetTotalChannels(), numFrames, params.sequence_interval);
+        params.InitSequenceData(params._outputManager->GetTotalChannels(), numFrames, params.sequence_interval);
     }
     else
     {
@@ -439,7 +511,15 @@ void FileConverter::ReadLorFile(ConvertParameters& params)
 
     if (totalChannels < channelCount)
     {
-        DisplayWarning(wxString::Format("LOR file has %d channels but xLights has only %d channels defined.", channelCount, totalChannels).ToStdString());
+        wxString warning = wxString::Format("LOR file has %d channels but xLights has only %d channels defined.", channelCount, totalChannels);
+        if (wxThread::IsMain())
+        {
+            DisplayWarning(warning.ToStdString());
+        }
+        else
+        {
+            params.AppendConvertStatus("WARNING: " + warning);
+        }
     }
 
     cnt = 0;
@@ -505,7 +585,7 @@ void FileConverter::ReadLorFile(ConvertParameters& params)
                 if (nodecnt > 1000)
                 {
                     nodecnt = 0;
-                    wxYield();
+                    params.YieldToUI();
                 }
                 //msg=wxString("Element: ") + NodeName + string_format(wxString(" (%ld)\n"),cnt);
                 //AppendConvertStatus (msg);
@@ -740,7 +820,7 @@ void FileConverter::ReadLorFile(ConvertParameters& params)
     params.AppendConvertStatus(string_format(wxString("New # of time periods=%ld"), params.seq_data.NumFrames()), false);
     params.SetStatusText(wxString("LOR sequence converted successfully"));
 
-    wxYield();
+    params.YieldToUI();
 }
 
 void FileConverter::ReadXlightsFile(ConvertParameters& params)
@@ -756,7 +836,7 @@ void FileConverter::ReadXlightsFile(ConvertParameters& params)
         ChannelColors.push_back(0);
         ChannelNames.push_back("");
     }
-    params.seq_data.init(0, 0, params.sequence_interval);
+    params.InitSequenceData(0, 0, params.sequence_interval);
 
     wxFile file(params.inp_filename);
 
@@ -774,7 +854,7 @@ void FileConverter::ReadXlightsFile(ConvertParameters& params)
     }
     else
     {
-        params.seq_data.init(numch, numper, 50);
+        params.InitSequenceData(numch, numper, 50);
         char * buf = new char[numper];
         wxString filename = FromAscii(hdr + 32);
 
@@ -814,7 +894,7 @@ void FileConverter::ReadXlightsFile(ConvertParameters& params)
         ClearLastPeriod(params.seq_data);
     }
 
-    wxYield();
+    params.YieldToUI();
 
 }
 
@@ -985,14 +1065,14 @@ void FileConverter::ReadHLSFile(ConvertParameters& params)
     {
         return;
     }
-    params.seq_data.init(channels, timeCells, msPerCell);
+    params.InitSequenceData(channels, timeCells, msPerCell);
 
     ChannelNames.resize(channels);
     ChannelColors.resize(channels);
 
     channels = 0;
 
-    wxYield();
+    params.YieldToUI();
 
     parser = new SP_XmlPullParser();
     read = file.Read(bytes, MAX_READ_BLOCK_SIZE);
@@ -1069,7 +1149,7 @@ void FileConverter::ReadHLSFile(ConvertParameters& params)
                 if (nodecnt > 1000)
                 {
                     nodecnt = 0;
-                    wxYield();
+                    params.YieldToUI();
                 }
                 nodecnt++;
                 if (cnt > 0)
@@ -1144,7 +1224,7 @@ void FileConverter::ReadHLSFile(ConvertParameters& params)
     {
         ClearLastPeriod(params.seq_data);
     }
-    wxYield();
+    params.YieldToUI();
 }
 
 // return true on success
@@ -1239,7 +1319,7 @@ void FileConverter::ReadVixFile(ConvertParameters& params)
         ChannelColors.push_back(0);
         ChannelNames.push_back("");
     }
-    params.seq_data.init(0, 0, params.sequence_interval);
+    params.InitSequenceData(0, 0, params.sequence_interval);
 
     params.AppendConvertStatus (wxString("Reading Vixen sequence"));
 
@@ -1403,7 +1483,7 @@ void FileConverter::ReadVixFile(ConvertParameters& params)
     if (VixNumPeriods == 0) {
         return;
     }
-    params.seq_data.init(numChannels, VixNumPeriods, VixEventPeriod);
+    params.InitSequenceData(numChannels, VixNumPeriods, VixEventPeriod);
 
     for (size_t ch=0; ch < params.seq_data.NumChannels(); ch++)
     {
@@ -1434,7 +1514,7 @@ void FileConverter::ReadVixFile(ConvertParameters& params)
         ClearLastPeriod(params.seq_data);
     }
 
-    wxYield();
+    params.YieldToUI();
 }
 
 void FileConverter::ReadGlediatorFile(ConvertParameters& params)
@@ -1453,7 +1533,7 @@ void FileConverter::ReadGlediatorFile(ConvertParameters& params)
         ChannelColors.push_back(0);
         ChannelNames.push_back("");
     }
-    params.seq_data.init(0, 0, params.sequence_interval);
+    params.InitSequenceData(0, 0, params.sequence_interval);
 
     if (!f.Open(params.inp_filename.c_str()))
     {
@@ -1467,9 +1547,9 @@ void FileConverter::ReadGlediatorFile(ConvertParameters& params)
 
     int numFrames=(int)(fileLength/(x_width*3*y_height));
     //SetMediaFilename(filename);
-    params.seq_data.init(numChannels, numFrames, 50);
+    params.InitSequenceData(numChannels, numFrames, 50);
 
-    wxYield();
+    params.YieldToUI();
     period = 0;
     while((readcnt=f.Read(frameBuffer,params.seq_data.NumChannels())))   // Read one period of channels
     {
@@ -1517,7 +1597,7 @@ void FileConverter::ReadGlediatorFile(ConvertParameters& params)
     params.AppendConvertStatus (string_format(wxString("ReadGlediatorFile SeqData.NumFrames()=%d SeqData.NumChannels()=%d"),params.seq_data.NumFrames(),params.seq_data.NumChannels()));
 #endif
 
-    wxYield();
+    params.YieldToUI();
 }
 
 #ifndef FPP
@@ -1530,7 +1610,7 @@ void FileConverter::ReadConductorFile(ConvertParameters& params)
         ChannelColors.push_back(0);
         ChannelNames.push_back("");
     }
-    params.seq_data.init(0, 0, params.sequence_interval);
+    params.InitSequenceData(0, 0, params.sequence_interval);
 
     if (params.read_mode == ConvertParameters::READ_MODE_LOAD_MAIN) {
         wxWindow* parent;
@@ -1559,10 +1639,10 @@ void FileConverter::ReadConductorFile(ConvertParameters& params)
     int numPeriods = f.Length() / 16384;
     int period = 0;
     char row[16384];
-    params.seq_data.init(16384, numPeriods, 50);
+    params.InitSequenceData(16384, numPeriods, 50);
     while (f.Read(row, 16384) == 16384)
     {
-        wxYield();
+        params.YieldToUI();
         for (size_t i = 0; i < 4096; i++)
         {
             for (size_t j = 0; j < 4; j++)
@@ -1589,7 +1669,7 @@ void FileConverter::ReadConductorFile(ConvertParameters& params)
         ClearLastPeriod(params.seq_data);
     }
 
-    wxYield();
+    params.YieldToUI();
 }
 #endif
 
@@ -1641,7 +1721,7 @@ void FileConverter::ReadFalconFile(ConvertParameters& params)
     file->prepareRead(rng);
     if (params.read_mode == ConvertParameters::READ_MODE_LOAD_MAIN ||
         params.read_mode == ConvertParameters::READ_MODE_IMPORT) {
-        params.seq_data.init(numChannels, falconPeriods, seqStepTime);
+        params.InitSequenceData(numChannels, falconPeriods, seqStepTime);
     }
 
     int channel_offset = 0;
@@ -1760,3 +1840,116 @@ void FileConverter::WriteFalconPiFile(ConvertParameters& params)
     delete file;
     logger_conversion.debug("End fseq write");
 }
+
+bool FileConverter::ReadFile(ConvertParameters& params)
+{
+    wxString ext = wxFileName(params.inp_filename).GetExt().Lower();
+    if (ext == "lms" || ext == "las")
+    {
+        ReadLorFile(params);
+    }
+    else if (ext == "xseq")
+    {
+        ReadXlightsFile(params);
+    }
+    else if (ext == "hlsidata")
+    {
+        ReadHLSFile(params);
+    }
+    else if (ext == "vix")
+    {
+        ReadVixFile(params);
+    }
+    else if (ext == "gled")
+    {
+        ReadGlediatorFile(params);
+    }
+    else if (ext == "seq")
+    {
+        ReadConductorFile(params);
+    }
+    else if (ext == "fseq")
+    {
+        ReadFalconFile(params);
+    }
+    else
+    {
+        params.ConversionError(wxString("Unknown sequence file extension: ") + params.inp_filename);
+        return false;
+    }
+    return params.error_message.IsEmpty();
+}
+
+// Each worker takes the next file, reads it and writes the fseq. The reading of one file overlaps the
+// fseq compression and writing of the others and the memory budget stops too many large sequences
+// being held at once.
+void FileConverter::ConvertToFSEQ(std::vector<BatchConvertJob>& jobs, const BatchConvertOptions& options)
+{
+    static log4cpp::Category &logger_conversion = log4cpp::Category::getInstance(std::string("log_conversion"));
+
+    ConvertMemoryBudget budget(options.memory_budget_mb * 1024 * 1024);
+    std::atomic_int next(0);
+
+    auto worker = [&jobs, &options, &budget, &next]() {
+        for (int i = next++; i < (int)jobs.size(); i = next++)
+        {
+            BatchConvertJob& job = jobs[i];
+            wxStopWatch sw;
+            {
+                SequenceData seq_data;
+                std::string media_filename;
+                ConvertParameters params(job.inp_filename,
+                                         seq_data,
+                                         options.outputManager,
+                                         ConvertParameters::READ_MODE_NORMAL,
+                                         options.xLightsFrm,
+                                         nullptr,
+                                         nullptr,
+                                         &media_filename,
+                                         nullptr,
+                                         job.out_filename,
+                                         options.sequence_interval,
+                                         options.channels_off_at_end,
+                                         options.map_empty_channels,
+                                         options.map_no_network_channels);
+                params.memory_budget = &budget;
+
+                if (ReadFile(params))
+                {
+                    if (seq_data.NumChannels() == 0 || seq_data.NumFrames() == 0)
+                    {
+                        params.ConversionError("No channels or frames found in " + job.inp_filename);
+                    }
+                    else
+                    {
+                        WriteFalconPiFile(params);
+                    }
+                }
+                job.succeeded = params.error_message.IsEmpty();
+                job.error_message = params.error_message;
+            }
+            job.elapsedMS = sw.Time();
+            logger_conversion.info("Batch convert %s -> %s %s in %ldms.", (const char*)job.inp_filename.c_str(),
+                (const char*)job.out_filename.c_str(), job.succeeded ? "done" : "failed", job.elapsedMS);
+            if (options.jobDone)
+            {
+                options.jobDone(job);
+            }
+        }
+    };
+
+    int threads = options.max_concurrent > 0 ? options.max_concurrent : std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min(threads, (int)jobs.size());
+    logger_conversion.info("Batch converting %d files to fseq on %d threads within %dMB.", (int)jobs.size(), threads, (int)options.memory_budget_mb);
+
+    // even a single worker gets its own thread so the readers never try to yield or show errors on the caller's
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back(worker);
+    }
+    for (auto& w : workers)
+    {
+        w.join();
+    }
+}
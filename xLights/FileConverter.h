@@ -10,6 +10,9 @@
  * License: https://github.com/smeighan/xLights/blob/master/License.txt
  **************************************************************/
 
+#include <condition_variable>
+#include <functional>
+#include <mutex>
 #include <vector>
 
 #ifndef FPP
@@ -26,6 +29,24 @@ class OutputManager;
 class wxArrayInt;
 class wxArrayString;
 
+// Caps how much sequence data a batch of conversions can hold at once. A conversion asks for its
+// sequence memory before allocating it and waits until enough has been released by the others.
+// A request larger than the whole budget is let through once nothing else is held so it can't stall.
+class ConvertMemoryBudget
+{
+public:
+    ConvertMemoryBudget(size_t bytes) : _budget(bytes) {}
+
+    void Reserve(size_t bytes);
+    void Release(size_t bytes);
+
+private:
+    std::mutex _lock;
+    std::condition_variable _released;
+    size_t _budget = 0;
+    size_t _used = 0;
+};
+
 class ConvertParameters
 {
 public:
@@ -52,11 +73,18 @@ public:
     xLightsFrame* xLightsFrm = nullptr;
     ConvertDialog* convertDialog = nullptr;
     ConvertLogDialog* convertLogDialog = nullptr;
+    ConvertMemoryBudget* memory_budget = nullptr; // set when this is one of a batch of conversions
+    size_t memory_reserved = 0;
+    wxString error_message;
 
+    // Status and errors only go to the log when called off the main thread
     void SetStatusText(wxString msg);
     void ConversionError(wxString msg);
     void PlayerError(wxString msg);
     void AppendConvertStatus(const wxString &msg, bool flushBuffer = true);
+    void YieldToUI();
+    void InitSequenceData(unsigned int numChannels, unsigned int numFrames, unsigned int frameTime);
+    void ReleaseSequenceData();
 
     ConvertParameters( wxString inp_filename_,
                        SequenceData& seq_data_,
@@ -72,7 +100,33 @@ public:
                        bool channels_off_at_end_ = false,
                        bool map_empty_channels_= false,
                        bool map_no_network_channels_ = false);
+    ~ConvertParameters();
+};
+
+class BatchConvertJob
+{
+public:
+    wxString inp_filename;
+    wxString out_filename;
+    bool succeeded = false;
+    wxString error_message;
+    long elapsedMS = 0;
 
+    BatchConvertJob(const wxString& inp, const wxString& out) : inp_filename(inp), out_filename(out) {}
+};
+
+class BatchConvertOptions
+{
+public:
+    xLightsFrame* xLightsFrm = nullptr;
+    OutputManager* outputManager = nullptr;
+    int sequence_interval = 50;
+    bool channels_off_at_end = false;
+    bool map_empty_channels = false;
+    bool map_no_network_channels = false;
+    size_t memory_budget_mb = 2048;
+    int max_concurrent = 0; // 0 = one per core
+    std::function<void(const BatchConvertJob&)> jobDone; // called on the converting thread
 };
 
 class FileConverter
@@ -89,6 +143,13 @@ class FileConverter
         static void ReadFalconFile(ConvertParameters& params);
         static void WriteFalconPiFile(ConvertParameters& params);
 
+        // Reads any supported sequence format into params.seq_data based on the input file's extension
+        static bool ReadFile(ConvertParameters& params);
+
+        // Converts each job's input file to an fseq, several at once within the memory budget.
+        // Needs no dialog so it can also be driven from the command line.
+        static void ConvertToFSEQ(std::vector<BatchConvertJob>& jobs, const BatchConvertOptions& options);
+
     
         static bool LoadVixenProfile(ConvertParameters& params, const wxString& ProfileName,
                                      wxArrayInt& VixChannels, wxArrayString& VixChannelNames,
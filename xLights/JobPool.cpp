@@ -40,7 +40,10 @@ class JobPoolWorker
 {
     JobPool *pool;
     std::atomic_bool stopped;
-    std::atomic<Job  *> currentJob;
+    // held while the status display looks at currentJob and while it is changed, so the job cannot be
+    // deleted from under it
+    mutable std::mutex currentJobLock;
+    Job *currentJob;
     enum STATUS_TYPE {
         STARTING,
         IDLE,
@@ -107,6 +110,7 @@ std::string JobPoolWorker::GetStatus()
         << std::hex << tid
         << "    ";
     
+    std::unique_lock<std::mutex> lock(currentJobLock);
     Job *j = currentJob;
     
     logger_jobpool.debug("     current job %X\n", j);
@@ -191,6 +195,7 @@ static void RemoveThreadName()
 
 std::string JobPoolWorker::GetThreadName() const
 {
+    std::unique_lock<std::mutex> lock(currentJobLock);
     Job *j = currentJob;
     if (j != nullptr) {
         if (j->SetThreadName()) {
@@ -261,19 +266,31 @@ void JobPoolWorker::ProcessJob(Job *job)
     static log4cpp::Category &logger_jobpool = log4cpp::Category::getInstance(std::string("log_jobpool"));
     if (job) {
 		logger_jobpool.debug("Starting job on background thread.");
-		currentJob = job;
         
         std::string origName;
-        if (job->SetThreadName()) {
+        // jobs that are not deleted when complete may be gone as soon as Process returns
+        bool setThreadName = job->SetThreadName();
+        bool deleteWhenComplete = job->DeleteWhenComplete();
+        // An unnamed job the pool does not own (parallel_for_range's job lives on the caller's stack) can be
+        // destroyed the moment Process signals it is finished, before Process even returns, so it is never
+        // shown in the status. Named jobs outlive their Process and the pool deletes the rest itself.
+        bool showJob = setThreadName || deleteWhenComplete;
+        if (showJob) {
+            std::unique_lock<std::mutex> lock(currentJobLock);
+            currentJob = job;
+        }
+        if (setThreadName) {
             origName = OriginalThreadName();
             SetThreadName(job->GetName());
         }
-        bool deleteWhenComplete = job->DeleteWhenComplete();
         job->Process();
-        if (job->SetThreadName()) {
+        if (setThreadName) {
             SetThreadName(origName);
         }
-        currentJob = nullptr;
+        if (showJob) {
+            std::unique_lock<std::mutex> lock(currentJobLock);
+            currentJob = nullptr;
+        }
         
         if (deleteWhenComplete) {
             status = DELETING_JOB;
@@ -366,6 +383,22 @@ void JobPool::PushJob(Job *job)
     signal.notify_one();
 }
 
+int JobPool::RemoveJob(Job *job)
+{
+    std::unique_lock<std::mutex> locker(queueLock);
+    int count = 0;
+    for (auto it = queue.begin(); it != queue.end();) {
+        if (*it == job) {
+            it = queue.erase(it);
+            inFlight--;
+            count++;
+        } else {
+            ++it;
+        }
+    }
+    return count;
+}
+
 void JobPool::Start(size_t poolSize, size_t minPoolSize)
 {
     static log4cpp::Category &logger_jobpool = log4cpp::Category::getInstance(std::string("log_jobpool"));
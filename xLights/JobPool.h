@@ -51,6 +51,8 @@ public:
     virtual ~JobPool();
     
     virtual void PushJob(Job *job);
+    // takes back any queued copies of job that no thread has started yet, returns how many
+    int RemoveJob(Job *job);
     int size() const { return (int)threads.size(); }
     int maxSize() const { return maxNumThreads; }
     virtual void Start(size_t poolSize = 1, size_t minPoolSize = 0);
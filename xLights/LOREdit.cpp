@@ -10,6 +10,8 @@
 
 #include "LOREdit.h"
 
+#include <set>
+
 #include <wx/wx.h>
 #include <wx/uri.h>
 #include <wx/regex.h>
@@ -902,9 +904,68 @@ std::string LOREditEffect::GetSettings(std::string& palette) const
     return settings;
 }
 
+static std::string GetPropName(wxXmlNode* prop)
+{
+    std::string name = prop->GetAttribute("name").ToStdString();
+    if (name == "")
+    {
+        for (wxXmlNode* ap = prop->GetChildren(); ap != nullptr; ap = ap->GetNext()) {
+            if (ap->GetName() == "PropClass")
+            {
+                name = ap->GetAttribute("Name");
+            }
+        }
+    }
+    return name;
+}
+
 LOREdit::LOREdit(wxXmlDocument& input_xml, int frequency) : _input_xml(input_xml), _frequency(frequency)
 {
+    for (wxXmlNode* e = _input_xml.GetRoot()->GetChildren(); e != nullptr; e = e->GetNext()) {
+        if (e->GetName() == "SequenceProps" || e->GetName() == "ArchivedProps") {
+            // only the first prop with a name in each section counts towards its channels
+            std::set<std::string> counted;
+            for (wxXmlNode* prop = e->GetChildren(); prop != nullptr; prop = prop->GetNext()) {
+                if (prop->GetName() == "SeqProp" || prop->GetName() == "ArchiveProp") {
+                    std::string name = GetPropName(prop);
+                    LOREditProp& p = _props[name];
+                    bool first = p.nodes.empty();
+                    bool count = counted.insert(name).second;
+                    p.nodes.push_back(prop);
+                    for (wxXmlNode* tc = prop->GetChildren(); (first || count) && tc != nullptr; tc = tc->GetNext()) {
+                        if (tc->GetName() == "channel") {
+                            int row = wxAtoi(tc->GetAttribute("row", "0"));
+                            int col = wxAtoi(tc->GetAttribute("col", "0"));
+                            if (first) {
+                                int colour = wxAtoi(tc->GetAttribute("color", "0"));
+                                p.firstByRowCol.emplace(std::make_pair(row, col), p.channels.size());
+                                p.firstByRowColColour.emplace(std::make_tuple(row, col, colour), p.channels.size());
+                                p.channels.push_back(tc);
+                            }
+                            if (count && tc->GetChildren() != nullptr) {
+                                p.rows = std::max(p.rows, row + 1);
+                                p.cols = std::max(p.cols, col + 1);
+                                p.channelCount++;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        else if (e->GetName() == "PreviewClass") {
+            for (wxXmlNode* prop = e->GetChildren(); prop != nullptr; prop = prop->GetNext()) {
+                if (prop->GetName() == "PropClass") {
+                    _propClasses.emplace(prop->GetAttribute("Name").ToStdString(), prop);
+                }
+            }
+        }
+    }
+}
 
+const LOREditProp* LOREdit::FindProp(const std::string& model) const
+{
+    auto it = _props.find(model);
+    return it == _props.end() ? nullptr : &it->second;
 }
 
 // gets a list of all the free timing tracks
@@ -961,25 +1022,18 @@ std::vector<std::pair<uint32_t, uint32_t>> LOREdit::GetTimings(const std::string
 // that can then be used out to work out channel sequencing mapping
 std::map<int, std::string> LOREdit::GetModelStrands(const std::string& model) const
 {
-    for (wxXmlNode* e = _input_xml.GetRoot()->GetChildren(); e != nullptr; e = e->GetNext()) {
-        if (e->GetName() == "PreviewClass") {
-            for (wxXmlNode* prop = e->GetChildren(); prop != nullptr; prop = prop->GetNext()) {
-                if (prop->GetName() == "PropClass") {
-                    if (prop->GetAttribute("Name") == model) {
-                        wxString const grid = prop->GetAttribute("ChannelGrid");
-                        if(grid.IsEmpty()) return { { 1, "" } };
-                        wxArrayString strands = wxSplit(grid, ';');
-                        int strandCnts = 1;
-                        std::map<int, std::string> strandMap;
-                        for (wxString const& strand: strands) {
-                            strandMap[strandCnts] = GetColor(strand);
-                            strandCnts++;
-                        }
-                        return strandMap;
-                    }
-                }
-            }
-        }
+    auto it = _propClasses.find(model);
+    if (it != _propClasses.end()) {
+        wxString const grid = it->second->GetAttribute("ChannelGrid");
+        if(grid.IsEmpty()) return { { 1, "" } };
+        wxArrayString strands = wxSplit(grid, ';');
+        int strandCnts = 1;
+        std::map<int, std::string> strandMap;
+        for (wxString const& strand: strands) {
+            strandMap[strandCnts] = GetColor(strand);
+            strandCnts++;
+        }
+        return strandMap;
     }
     return std::map<int, std::string>();
 }
@@ -989,37 +1043,22 @@ std::map<int, std::string> LOREdit::GetModelStrands(const std::string& model) co
 int LOREdit::GetModelLayers(const std::string& model) const
 {
     int count = 0;
-    for (wxXmlNode* e = _input_xml.GetRoot()->GetChildren(); e != nullptr; e = e->GetNext()) {
-        if (e->GetName() == "SequenceProps" || e->GetName() == "ArchivedProps") {
-            for (wxXmlNode* prop = e->GetChildren(); prop != nullptr; prop = prop->GetNext()) {
-                if (prop->GetName() == "SeqProp" || prop->GetName() == "ArchiveProp") {
-                    std::string name = prop->GetAttribute("name").ToStdString();
-                    if (name == "")
-                    {
-                        for (wxXmlNode* ap = prop->GetChildren(); ap != nullptr; ap = ap->GetNext()) {
-                            if (ap->GetName() == "PropClass")
-                            {
-                                name = ap->GetAttribute("Name");
-                            }
-                        }
-                    }
-                    if (name == model) {
-                        for (wxXmlNode* tc = prop->GetChildren(); tc != nullptr; tc = tc->GetNext()) {
-                            if (tc->GetName() == "track") {
-                                int l1 = 0;
-                                int l2 = 0;
-                                for (wxXmlNode* ef = tc->GetChildren(); (l1 == 0 || l2 == 0) && ef != nullptr; ef = ef->GetNext()) {
-                                    int ll1 = 0;
-                                    int ll2 = 0;
-                                    GetLayers(ef->GetAttribute("settings"), ll1, ll2);
-                                    if (ll1 == 1) l1 = 1;
-                                    if (ll2 == 1) l2 = 1;
-                                }
-                                count += l1 + l2;
-                            }
-                        }
-                    }
+    const LOREditProp* p = FindProp(model);
+    if (p == nullptr) return count;
+
+    for (wxXmlNode* prop : p->nodes) {
+        for (wxXmlNode* tc = prop->GetChildren(); tc != nullptr; tc = tc->GetNext()) {
+            if (tc->GetName() == "track") {
+                int l1 = 0;
+                int l2 = 0;
+                for (wxXmlNode* ef = tc->GetChildren(); (l1 == 0 || l2 == 0) && ef != nullptr; ef = ef->GetNext()) {
+                    int ll1 = 0;
+                    int ll2 = 0;
+                    GetLayers(ef->GetAttribute("settings"), ll1, ll2);
+                    if (ll1 == 1) l1 = 1;
+                    if (ll2 == 1) l2 = 1;
                 }
+                count += l1 + l2;
             }
         }
     }
@@ -1033,37 +1072,11 @@ int LOREdit::GetModelChannels(const std::string& model, int& rows, int& cols) co
     rows = 0;
     cols = 0;
     int count = 0;
-    for (wxXmlNode* e = _input_xml.GetRoot()->GetChildren(); e != nullptr; e = e->GetNext()) {
-        if (e->GetName() == "SequenceProps" || e->GetName() == "ArchivedProps") {
-            for (wxXmlNode* prop = e->GetChildren(); prop != nullptr; prop = prop->GetNext()) {
-                if (prop->GetName() == "SeqProp" || prop->GetName() == "ArchiveProp") {
-                    std::string name = prop->GetAttribute("name").ToStdString();
-                    if (name == "")
-                    {
-                        for (wxXmlNode* ap = prop->GetChildren(); ap != nullptr; ap = ap->GetNext()) {
-                            if (ap->GetName() == "PropClass")
-                            {
-                                name = ap->GetAttribute("Name");
-                            }
-                        }
-                    }
-                    if (name == model)
-                    {
-                        for (wxXmlNode* tc = prop->GetChildren(); tc != nullptr; tc = tc->GetNext()) {
-                            if (tc->GetName() == "channel") {
-                                if (tc->GetChildren() != nullptr)
-                                {
-                                    rows = std::max(rows, wxAtoi(tc->GetAttribute("row", "0")) + 1);
-                                    cols = std::max(cols, wxAtoi(tc->GetAttribute("col", "0")) + 1);
-                                    count++;
-                                }
-                            }
-                        }
-                        break;
-                    }
-                }
-            }
-        }
+    const LOREditProp* p = FindProp(model);
+    if (p != nullptr) {
+        rows = p->rows;
+        cols = p->cols;
+        count = p->channelCount;
     }
 
     if (count > 1 && rows == 1 && cols == 1)
@@ -1078,33 +1091,17 @@ int LOREdit::GetModelChannels(const std::string& model, int& rows, int& cols) co
 // assumes you cant have both channel and track sequencing on the same model ... this may not be true
 loreditType LOREdit::GetSequencingType(const std::string& model) const
 {
-    for (wxXmlNode* e = _input_xml.GetRoot()->GetChildren(); e != nullptr; e = e->GetNext()) {
-        if (e->GetName() == "SequenceProps" || e->GetName() == "ArchivedProps") {
-            for (wxXmlNode* prop = e->GetChildren(); prop != nullptr; prop = prop->GetNext()) {
-                if (prop->GetName() == "SeqProp" || prop->GetName() == "ArchiveProp") {
-                    std::string name = prop->GetAttribute("name").ToStdString();
-                    if (name == "")
-                    {
-                        for (wxXmlNode* ap = prop->GetChildren(); ap != nullptr; ap = ap->GetNext()) {
-                            if (ap->GetName() == "PropClass")
-                            {
-                                name = ap->GetAttribute("Name");
-                            }
-                        }
-                    }
-                    if (name == model)
-                    {
-                        for (wxXmlNode* tc = prop->GetChildren(); tc != nullptr; tc = tc->GetNext()) {
-                            if (tc->GetName() == "channel" && tc->GetChildren() != nullptr) {
-                                return loreditType::CHANNELS;
-                            }
-                            if (tc->GetName() == "track" && tc->GetChildren() != nullptr)
-                            {
-                                return loreditType::TRACKS;
-                            }
-                        }
-                    }
-                }
+    const LOREditProp* p = FindProp(model);
+    if (p == nullptr) return loreditType::NONE;
+
+    for (wxXmlNode* prop : p->nodes) {
+        for (wxXmlNode* tc = prop->GetChildren(); tc != nullptr; tc = tc->GetNext()) {
+            if (tc->GetName() == "channel" && tc->GetChildren() != nullptr) {
+                return loreditType::CHANNELS;
+            }
+            if (tc->GetName() == "track" && tc->GetChildren() != nullptr)
+            {
+                return loreditType::TRACKS;
             }
         }
     }
@@ -1286,53 +1283,34 @@ std::vector<LOREditEffect> LOREdit::GetTrackEffects(const std::string& model, in
 {
     std::vector<LOREditEffect> res;
 
-    for (wxXmlNode* e = _input_xml.GetRoot()->GetChildren(); e != nullptr; e = e->GetNext()) {
-        if (e->GetName() == "SequenceProps" || e->GetName() == "ArchivedProps") {
-            for (wxXmlNode* prop = e->GetChildren(); prop != nullptr; prop = prop->GetNext()) {
-                if (prop->GetName() == "SeqProp" || prop->GetName() == "ArchiveProp") {
-                    std::string name = prop->GetAttribute("name").ToStdString();
-                    if (name == "")
-                    {
-                        for (wxXmlNode* ap = prop->GetChildren(); ap != nullptr; ap = ap->GetNext()) {
-                            if (ap->GetName() == "PropClass")
-                            {
-                                name = ap->GetAttribute("Name");
-                            }
-                        }
-                    }
-                    if (name == model)
-                    {
-                        int tcount = 0;
-                        for (wxXmlNode* tc = prop->GetChildren(); tc != nullptr; tc = tc->GetNext()) {
-                            if ((tc->GetName() == "track")) {
-                                if (tc->GetChildren() != nullptr)
-                                {
-                                    int l1 = 0;
-                                    int l2 = 0;
-                                    for (wxXmlNode* ef = tc->GetChildren(); (l1 == 0 || l2 == 0) && ef != nullptr; ef = ef->GetNext()) {
-                                        int ll1, ll2;
-                                        GetLayers(ef->GetAttribute("settings"), ll1, ll2);
-                                        if (ll1 == 1) l1 = 1;
-                                        if (ll2 == 1) l2 = 1;
-                                    }
-
-                                    if (tcount == layer && l1 == 1)
-                                    {
-                                        return AddEffects(tc, true, offset);
-                                    }
-                                    if (l1 == 1) tcount++;
-
-                                    if (l2 == 1 && tcount == layer)
-                                    {
-                                        return AddEffects(tc, false, offset);
-                                    }
-                                    if (l2 == 1) tcount++;
-                                }
-                            }
-                        }
-                        return res;
-                    }
+    const LOREditProp* p = FindProp(model);
+    if (p == nullptr) return res;
+
+    int tcount = 0;
+    for (wxXmlNode* tc = p->nodes.front()->GetChildren(); tc != nullptr; tc = tc->GetNext()) {
+        if ((tc->GetName() == "track")) {
+            if (tc->GetChildren() != nullptr)
+            {
+                int l1 = 0;
+                int l2 = 0;
+                for (wxXmlNode* ef = tc->GetChildren(); (l1 == 0 || l2 == 0) && ef != nullptr; ef = ef->GetNext()) {
+                    int ll1, ll2;
+                    GetLayers(ef->GetAttribute("settings"), ll1, ll2);
+                    if (ll1 == 1) l1 = 1;
+                    if (ll2 == 1) l2 = 1;
+                }
+
+                if (tcount == layer && l1 == 1)
+                {
+                    return AddEffects(tc, true, offset);
+                }
+                if (l1 == 1) tcount++;
+
+                if (l2 == 1 && tcount == layer)
+                {
+                    return AddEffects(tc, false, offset);
                 }
+                if (l2 == 1) tcount++;
             }
         }
     }
@@ -1340,77 +1318,84 @@ std::vector<LOREditEffect> LOREdit::GetTrackEffects(const std::string& model, in
     return res;
 }
 
-std::vector<LOREditEffect> LOREdit::GetChannelEffectsForNode(int targetRow, int targetCol, int targetColor, wxXmlNode* prop, int offset) const
+std::vector<LOREditEffect> LOREdit::GetChannelEffectsForNode(int targetRow, int targetCol, int targetColor, const LOREditProp& prop, int offset) const
 {
     std::vector<LOREditEffect> res;
 
-    for (wxXmlNode* tc = prop->GetChildren(); tc != nullptr; tc = tc->GetNext()) {
-        if ((tc->GetName() == "channel")) {
-            int row = wxAtoi(tc->GetAttribute("row", "0"));
-            int col = wxAtoi(tc->GetAttribute("col", "0"));
-            int colour = wxAtoi(tc->GetAttribute("color", "0"));
-
-            if ((targetRow == -1 && targetCol == -1 && targetColor == -1) || // map regardless
-                (row == targetRow && col == targetCol && targetColor == -1) || // map because the node matches
-                (row == 0 && col == 0 && colour == targetCol && targetRow == 0 && targetColor == -1) ||
-                (row == targetRow && col == targetCol && colour == targetColor)) {//match stand/color
-                for (wxXmlNode* ef = tc->GetChildren(); ef != nullptr; ef = ef->GetNext()) {
-                    LOREditEffect effect;
-                    effect.pixelChannels = prop->GetAttribute("EnablePixelChannels", "0") == "1";
-                    effect.startMS = wxAtoi(ef->GetAttribute("startCentisecond")) * 10 + offset;
-                    effect.endMS = wxAtoi(ef->GetAttribute("endCentisecond")) * 10 + offset;
-                    int si = wxAtoi(ef->GetAttribute("intensity", "9999"));
-                    if (si != 9999) {
-                        if (si < 0) {
-                            if (ef->GetAttribute("settings") == "DMX_INTENSITY") {
-                                effect.startIntensity = 255;
-                                effect.endIntensity = 255;
-                            }
-                            else {
-                                effect.startIntensity = 100;
-                                effect.endIntensity = 100;
-                            }
-                            effect.startColour = xlColor((si & 0xFF0000) >> 16, (si & 0xFF00) >> 8, si & 0xFF);
-                            effect.endColour = effect.startColour;
-                        }
-                        else {
-                            effect.startIntensity = si;
-                            effect.endIntensity = si;
-                            effect.startColour = xlWHITE;
-                            effect.endColour = xlWHITE;
-                        }
+    // find the first channel in the prop that matches
+    size_t match = prop.channels.size();
+    if (targetRow == -1 && targetCol == -1 && targetColor == -1) { // map regardless
+        match = 0;
+    }
+    else if (targetColor == -1) {
+        auto it = prop.firstByRowCol.find({ targetRow, targetCol }); // map because the node matches
+        if (it != prop.firstByRowCol.end()) match = it->second;
+        if (targetRow == 0) {
+            auto itc = prop.firstByRowColColour.find(std::make_tuple(0, 0, targetCol));
+            if (itc != prop.firstByRowColColour.end()) match = std::min(match, itc->second);
+        }
+    }
+    else {
+        auto it = prop.firstByRowColColour.find(std::make_tuple(targetRow, targetCol, targetColor)); //match stand/color
+        if (it != prop.firstByRowColColour.end()) match = it->second;
+    }
+    if (match >= prop.channels.size()) return res;
+
+    wxXmlNode* propNode = prop.nodes.front();
+    wxXmlNode* tc = prop.channels[match];
+    for (wxXmlNode* ef = tc->GetChildren(); ef != nullptr; ef = ef->GetNext()) {
+        LOREditEffect effect;
+        effect.pixelChannels = propNode->GetAttribute("EnablePixelChannels", "0") == "1";
+        effect.startMS = wxAtoi(ef->GetAttribute("startCentisecond")) * 10 + offset;
+        effect.endMS = wxAtoi(ef->GetAttribute("endCentisecond")) * 10 + offset;
+        int si = wxAtoi(ef->GetAttribute("intensity", "9999"));
+        if (si != 9999) {
+            if (si < 0) {
+                if (ef->GetAttribute("settings") == "DMX_INTENSITY") {
+                    effect.startIntensity = 255;
+                    effect.endIntensity = 255;
+                }
+                else {
+                    effect.startIntensity = 100;
+                    effect.endIntensity = 100;
+                }
+                effect.startColour = xlColor((si & 0xFF0000) >> 16, (si & 0xFF00) >> 8, si & 0xFF);
+                effect.endColour = effect.startColour;
+            }
+            else {
+                effect.startIntensity = si;
+                effect.endIntensity = si;
+                effect.startColour = xlWHITE;
+                effect.endColour = xlWHITE;
+            }
+        }
+        else {
+            si = wxAtoi(ef->GetAttribute("startIntensity", "9999"));
+            if (si != 9999) {
+                if (si < 0) {
+                    if (ef->GetAttribute("settings") == "DMX_INTENSITY") {
+                        effect.startIntensity = 255;
+                        effect.endIntensity = 255;
                     }
                     else {
-                        si = wxAtoi(ef->GetAttribute("startIntensity", "9999"));
-                        if (si != 9999) {
-                            if (si < 0) {
-                                if (ef->GetAttribute("settings") == "DMX_INTENSITY") {
-                                    effect.startIntensity = 255;
-                                    effect.endIntensity = 255;
-                                }
-                                else {
-                                    effect.startIntensity = 100;
-                                    effect.endIntensity = 100;
-                                }
-                                effect.startColour = xlColor((si & 0xFF0000) >> 16, (si & 0xFF00) >> 8, si & 0xFF);
-                                int ei = wxAtoi(ef->GetAttribute("endIntensity", "-1"));
-                                effect.endColour = xlColor((ei & 0xFF0000) >> 16, (ei & 0xFF00) >> 8, ei & 0xFF);
-                            }
-                            else {
-                                effect.startIntensity = si;
-                                effect.endIntensity = wxAtoi(ef->GetAttribute("endIntensity", "100"));
-                                effect.startColour = xlWHITE;
-                                effect.endColour = xlWHITE;
-                            }
-                        }
+                        effect.startIntensity = 100;
+                        effect.endIntensity = 100;
                     }
-                    effect.type = loreditType::CHANNELS;
-                    effect.effectType = ef->GetAttribute("settings");
-                    res.push_back(effect);
+                    effect.startColour = xlColor((si & 0xFF0000) >> 16, (si & 0xFF00) >> 8, si & 0xFF);
+                    int ei = wxAtoi(ef->GetAttribute("endIntensity", "-1"));
+                    effect.endColour = xlColor((ei & 0xFF0000) >> 16, (ei & 0xFF00) >> 8, ei & 0xFF);
+                }
+                else {
+                    effect.startIntensity = si;
+                    effect.endIntensity = wxAtoi(ef->GetAttribute("endIntensity", "100"));
+                    effect.startColour = xlWHITE;
+                    effect.endColour = xlWHITE;
                 }
-                return res;
             }
         }
+        effect.type = loreditType::CHANNELS;
+        effect.effectType = ef->GetAttribute("settings");
+        res.push_back(effect);
     }
     return res;
 }
@@ -1458,73 +1443,31 @@ std::vector<LOREditEffect> LOREdit::GetChannelEffects(const std::string& model,
     int targetRow = bufy;
     int targetCol = bufx;
 
-    for (wxXmlNode* e = _input_xml.GetRoot()->GetChildren(); e != nullptr; e = e->GetNext()) {
-        if (e->GetName() == "SequenceProps" || e->GetName() == "ArchivedProps") {
-            for (wxXmlNode* prop = e->GetChildren(); prop != nullptr; prop = prop->GetNext()) {
-                if (prop->GetName() == "SeqProp" || prop->GetName() == "ArchiveProp") {
-                    std::string name = prop->GetAttribute("name").ToStdString();
-                    if (name == "")
-                    {
-                        for (wxXmlNode* ap = prop->GetChildren(); ap != nullptr; ap = ap->GetNext()) {
-                            if (ap->GetName() == "PropClass")
-                            {
-                                name = ap->GetAttribute("Name");
-                            }
-                        }
-                    }
-                    if (name == model)
-                    {
-                        res = GetChannelEffectsForNode(targetRow, targetCol, -1, prop, offset);
-                        if (res.size() != 0) {
-                            return res;
-                        }
-
-                        // if we got here and the source only has one node just map it regardless
-                        if (rows == 1 && cols == 1)
-                        {
-                            return GetChannelEffectsForNode(-1, -1, -1, prop, offset);
-                        }
+    const LOREditProp* p = FindProp(model);
+    if (p == nullptr) return res;
 
-                        // still no match
+    res = GetChannelEffectsForNode(targetRow, targetCol, -1, *p, offset);
+    if (res.size() != 0) {
+        return res;
+    }
 
-                        return res;
-                    }
-                }
-            }
-        }
+    // if we got here and the source only has one node just map it regardless
+    if (rows == 1 && cols == 1)
+    {
+        return GetChannelEffectsForNode(-1, -1, -1, *p, offset);
     }
 
+    // still no match
+
     return res;
 }
 
 std::vector<LOREditEffect> LOREdit::GetChannelEffects(const std::string& model, int targetRow, int targetCol, int targetColor, int offset) const
 {
-    std::vector<LOREditEffect> res;
-    for (wxXmlNode* e = _input_xml.GetRoot()->GetChildren(); e != nullptr; e = e->GetNext()) {
-        if (e->GetName() == "SequenceProps" || e->GetName() == "ArchivedProps") {
-            for (wxXmlNode* prop = e->GetChildren(); prop != nullptr; prop = prop->GetNext()) {
-                if (prop->GetName() == "SeqProp" || prop->GetName() == "ArchiveProp") {
-                    std::string name = prop->GetAttribute("name").ToStdString();
-                    if (name == "") {
-                        for (wxXmlNode* ap = prop->GetChildren(); ap != nullptr; ap = ap->GetNext()) {
-                            if (ap->GetName() == "PropClass") {
-                                name = ap->GetAttribute("Name");
-                            }
-                        }
-                    }
-                    if (name == model) {
-                        res = GetChannelEffectsForNode(targetRow, targetCol, targetColor, prop, offset);
-                        if (res.size() != 0) {
-                            return res;
-                        }
-                        return res;
-                    }
-                }
-            }
-        }
-    }
+    const LOREditProp* p = FindProp(model);
+    if (p == nullptr) return std::vector<LOREditEffect>();
 
-    return res;
+    return GetChannelEffectsForNode(targetRow, targetCol, targetColor, *p, offset);
 }
 
 std::vector<LOREditEffect> LOREdit::GetChannelEffects(const std::string& model, int channel, int nodes, int offset) const
@@ -1554,105 +1497,78 @@ std::vector<LOREditEffect> LOREdit::GetChannelEffects(const std::string& model,
         if (channel >= cols) return res;
     }
 
-    for (wxXmlNode* e = _input_xml.GetRoot()->GetChildren(); e != nullptr; e = e->GetNext()) {
-        if (e->GetName() == "SequenceProps" || e->GetName() == "ArchivedProps") {
-            for (wxXmlNode* prop = e->GetChildren(); prop != nullptr; prop = prop->GetNext()) {
-                if (prop->GetName() == "SeqProp" || prop->GetName() == "ArchiveProp") {
-                    std::string name = prop->GetAttribute("name").ToStdString();
-                    if (name == "")
+    const LOREditProp* p = FindProp(model);
+    if (p == nullptr) return res;
+
+    auto it = p->firstByRowCol.find({ targetRow, targetCol });
+    if (it == p->firstByRowCol.end()) return res;
+
+    wxXmlNode* tc = p->channels[it->second];
+    for (wxXmlNode* ef = tc->GetChildren(); ef != nullptr; ef = ef->GetNext()) {
+        LOREditEffect effect;
+        effect.pixelChannels = p->nodes.front()->GetAttribute("EnablePixelChannels", "0") == "1";
+        effect.startMS = wxAtoi(ef->GetAttribute("startCentisecond")) * 10 + offset;
+        effect.endMS = wxAtoi(ef->GetAttribute("endCentisecond")) * 10 + offset;
+        int si = wxAtoi(ef->GetAttribute("intensity", "9999"));
+        if (si != 9999)
+        {
+            if (si < 0)
+            {
+                if (ef->GetAttribute("settings") == "DMX_INTENSITY")
+                {
+                    effect.startIntensity = 255;
+                    effect.endIntensity = 255;
+                }
+                else
+                {
+                    effect.startIntensity = 100;
+                    effect.endIntensity = 100;
+                }
+                effect.startColour = xlColor((si & 0xFF0000) >> 16, (si & 0xFF00) >> 8, si & 0xFF);
+                effect.endColour = effect.startColour;
+            }
+            else
+            {
+                effect.startIntensity = si;
+                effect.endIntensity = si;
+                effect.startColour = xlWHITE;
+                effect.endColour = xlWHITE;
+            }
+        }
+        else
+        {
+            si = wxAtoi(ef->GetAttribute("startIntensity", "9999"));
+            if (si != 9999)
+            {
+                if (si < 0)
+                {
+                    if (ef->GetAttribute("settings") == "DMX_INTENSITY")
                     {
-                        for (wxXmlNode* ap = prop->GetChildren(); ap != nullptr; ap = ap->GetNext()) {
-                            if (ap->GetName() == "PropClass")
-                            {
-                                name = ap->GetAttribute("Name");
-                            }
-                        }
+                        effect.startIntensity = 255;
+                        effect.endIntensity = 255;
                     }
-                    if (name == model)
+                    else
                     {
-                        for (wxXmlNode* tc = prop->GetChildren(); tc != nullptr; tc = tc->GetNext()) {
-                            if ((tc->GetName() == "channel")) {
-                                int row = wxAtoi(tc->GetAttribute("row", "0"));
-                                int col = wxAtoi(tc->GetAttribute("col", "0"));
-
-                                if (row == targetRow && col == targetCol)
-                                {
-                                    for (wxXmlNode* ef = tc->GetChildren(); ef != nullptr; ef = ef->GetNext()) {
-                                        LOREditEffect effect;
-                                        effect.pixelChannels = prop->GetAttribute("EnablePixelChannels", "0") == "1";
-                                        effect.startMS = wxAtoi(ef->GetAttribute("startCentisecond")) * 10 + offset;
-                                        effect.endMS = wxAtoi(ef->GetAttribute("endCentisecond")) * 10 + offset;
-                                        int si = wxAtoi(ef->GetAttribute("intensity", "9999"));
-                                        if (si != 9999)
-                                        {
-                                            if (si < 0)
-                                            {
-                                                if (ef->GetAttribute("settings") == "DMX_INTENSITY")
-                                                {
-                                                    effect.startIntensity = 255;
-                                                    effect.endIntensity = 255;
-                                                }
-                                                else
-                                                {
-                                                    effect.startIntensity = 100;
-                                                    effect.endIntensity = 100;
-                                                }
-                                                effect.startColour = xlColor((si & 0xFF0000) >> 16, (si & 0xFF00) >> 8, si & 0xFF);
-                                                effect.endColour = effect.startColour;
-                                            }
-                                            else
-                                            {
-                                                effect.startIntensity = si;
-                                                effect.endIntensity = si;
-                                                effect.startColour = xlWHITE;
-                                                effect.endColour = xlWHITE;
-                                            }
-                                        }
-                                        else
-                                        {
-                                            si = wxAtoi(ef->GetAttribute("startIntensity", "9999"));
-                                            if (si != 9999)
-                                            {
-                                                if (si < 0)
-                                                {
-                                                    if (ef->GetAttribute("settings") == "DMX_INTENSITY")
-                                                    {
-                                                        effect.startIntensity = 255;
-                                                        effect.endIntensity = 255;
-                                                    }
-                                                    else
-                                                    {
-                                                        effect.startIntensity = 100;
-                                                        effect.endIntensity = 100;
-                                                    }
-                                                    effect.startColour = xlColor((si & 0xFF0000) >> 16, (si & 0xFF00) >> 8, si & 0xFF);
-                                                    int ei = wxAtoi(ef->GetAttribute("endIntensity", "-1"));
-                                                    effect.endColour = xlColor((ei & 0xFF0000) >> 16, (ei & 0xFF00) >> 8, ei & 0xFF);
-                                                }
-                                                else
-                                                {
-                                                    effect.startIntensity = si;
-                                                    effect.endIntensity = wxAtoi(ef->GetAttribute("endIntensity", "100"));
-                                                    effect.startColour = xlWHITE;
-                                                    effect.endColour = xlWHITE;
-                                                }
-                                            }
-                                        }
-                                        effect.type = loreditType::CHANNELS;
-                                        effect.effectType = ef->GetAttribute("settings");
-                                        res.push_back(effect);
-                                    }
-                                    return res;
-                                }
-                            }
-                        }
-                        return res;
+                        effect.startIntensity = 100;
+                        effect.endIntensity = 100;
                     }
+                    effect.startColour = xlColor((si & 0xFF0000) >> 16, (si & 0xFF00) >> 8, si & 0xFF);
+                    int ei = wxAtoi(ef->GetAttribute("endIntensity", "-1"));
+                    effect.endColour = xlColor((ei & 0xFF0000) >> 16, (ei & 0xFF00) >> 8, ei & 0xFF);
+                }
+                else
+                {
+                    effect.startIntensity = si;
+                    effect.endIntensity = wxAtoi(ef->GetAttribute("endIntensity", "100"));
+                    effect.startColour = xlWHITE;
+                    effect.endColour = xlWHITE;
                 }
             }
         }
+        effect.type = loreditType::CHANNELS;
+        effect.effectType = ef->GetAttribute("settings");
+        res.push_back(effect);
     }
-
     return res;
 }
 
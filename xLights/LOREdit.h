@@ -12,6 +12,7 @@
 
 #include <vector>
 #include <map>
+#include <tuple>
 #include "Color.h"
 #include <wx/xml/xml.h>
 
@@ -53,11 +54,27 @@ struct LOREditEffect
     std::string GetBlend() const;
 };
 
+// Where a prop and its channels are in the document ... worked out once when the file is loaded
+// so mapping each model/node doesnt have to search the whole document
+struct LOREditProp
+{
+    std::vector<wxXmlNode*> nodes; // every prop with this name in document order
+    std::vector<wxXmlNode*> channels; // channels of the first prop in document order
+    std::map<std::pair<int, int>, size_t> firstByRowCol;
+    std::map<std::tuple<int, int, int>, size_t> firstByRowColColour;
+    int channelCount = 0;
+    int rows = 0;
+    int cols = 0;
+};
+
 class LOREdit {
     wxXmlDocument& _input_xml;
     int _frequency = 20;
+    std::map<std::string, LOREditProp> _props;
+    std::map<std::string, wxXmlNode*> _propClasses;
 
-    std::vector<LOREditEffect> GetChannelEffectsForNode(int targetRow, int targetCol, int targetColor, wxXmlNode* prop, int offset) const;
+    const LOREditProp* FindProp(const std::string& model) const;
+    std::vector<LOREditEffect> GetChannelEffectsForNode(int targetRow, int targetCol, int targetColor, const LOREditProp& prop, int offset) const;
 
     public:
     LOREdit(wxXmlDocument &input_xml, int frequency);
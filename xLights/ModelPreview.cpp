@@ -29,6 +29,7 @@
 #include "LayoutGroup.h"
 #include "xLightsMain.h"
 #include "models/ModelGroup.h"
+#include "Parallel.h"
 
 #include <log4cpp/Category.hh>
 
@@ -103,7 +104,7 @@ void ModelPreview::OnZoomGesture(wxZoomGestureEvent& event) {
                 Refresh();
                 Update();
                 if (xlights->GetPlayStatus() == PLAY_TYPE_MODEL_PAUSED || xlights->GetPlayStatus() == PLAY_TYPE_EFFECT_PAUSED) {
-                    Render(&xlights->SeqData[xlights->GetCurrentPlayTime() / xlights->SeqData.FrameTime()][0]);
+                    Render(xlights->SeqData.GetFrame(xlights->GetCurrentPlayTime() / xlights->SeqData.FrameTime())[0]);
                 }
             }
         }
@@ -121,7 +122,7 @@ void ModelPreview::mouseMoved(wxMouseEvent& event) {
                 Refresh();
                 Update();
                 if (xlights->GetPlayStatus() == PLAY_TYPE_MODEL_PAUSED || xlights->GetPlayStatus() == PLAY_TYPE_EFFECT_PAUSED) {
-                    Render(&xlights->SeqData[xlights->GetCurrentPlayTime() / xlights->SeqData.FrameTime()][0]);
+                    Render(xlights->SeqData.GetFrame(xlights->GetCurrentPlayTime() / xlights->SeqData.FrameTime())[0]);
                 }
             }
         }
@@ -172,7 +173,7 @@ void ModelPreview::mouseMoved(wxMouseEvent& event) {
                 Refresh();
                 Update();
                 if (xlights->GetPlayStatus() == PLAY_TYPE_MODEL_PAUSED || xlights->GetPlayStatus() == PLAY_TYPE_EFFECT_PAUSED) {
-                    Render(&xlights->SeqData[xlights->GetCurrentPlayTime() / xlights->SeqData.FrameTime()][0]);
+                    Render(xlights->SeqData.GetFrame(xlights->GetCurrentPlayTime() / xlights->SeqData.FrameTime())[0]);
                 }
             }
         }
@@ -391,7 +392,7 @@ void ModelPreview::mouseWheelMoved(wxMouseEvent& event) {
             Refresh();
             Update();
             if (xlights->GetPlayStatus() == PLAY_TYPE_MODEL_PAUSED || xlights->GetPlayStatus() == PLAY_TYPE_EFFECT_PAUSED) {
-                Render(&xlights->SeqData[xlights->GetCurrentPlayTime() / xlights->SeqData.FrameTime()][0]);
+                Render(xlights->SeqData.GetFrame(xlights->GetCurrentPlayTime() / xlights->SeqData.FrameTime())[0]);
             }
         }
     }
@@ -616,7 +617,22 @@ void ModelPreview::Render(const unsigned char *data, bool swapBuffers/*=true*/)
     float maxy = -999999;
     if (StartDrawing(mPointSize)) {
         const std::vector<Model*> &models = GetModels();
+
+        // node colours for every model are worked out at once ... only the copy into the accumulators is serial
+        parallel_for(0, models.size(), [&models, data, this](int i) {
+            if (models[i]->SupportsPreviewVertexCache()) {
+                models[i]->PreparePreviewFrame(data, is_3d);
+            }
+        });
+
         for (auto m : models) {
+            if (m->SupportsPreviewVertexCache()) {
+                if (is_3d)
+                    m->DisplayPreviewFrame(this, solidAccumulator3d, transparentAccumulator3d, minx, miny, maxx, maxy, true);
+                else
+                    m->DisplayPreviewFrame(this, solidAccumulator, transparentAccumulator, minx, miny, maxx, maxy, false);
+                continue;
+            }
             int NodeCnt = m->GetNodeCount();
             for (size_t n = 0; n < NodeCnt; ++n) {
                 int start = m->NodeStartChannel(n);
@@ -10,10 +10,14 @@
  * License: https://github.com/smeighan/xLights/blob/master/License.txt
  **************************************************************/
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <functional>
 #include <list>
 #include <mutex>
 #include <thread>
+#include <type_traits>
 
 #include "JobPool.h"
 
@@ -26,6 +30,11 @@ public:
     
     int calcSteps(int minStep, int size);
     
+    // number of parallel_for_range bodies running on this thread
+    static int &Depth() {
+        static thread_local int depth = 0;
+        return depth;
+    }
     
     std::mutex poolLock;
     std::condition_variable poolSignal;
@@ -117,3 +126,149 @@ void parallel_for(std::list<T> &list, std::function<void(T&, int)>& f, int minSt
     }
 }
 
+
+/**
+ * While one of these is alive, any parallel_for_range started on this thread, including
+ * ones started from its chunks on other threads, stops handing out work once flag is set.
+ * RenderJob holds one over its abort flag so effects stop when the render is aborted.
+ */
+class ParallelCancelScope {
+public:
+    explicit ParallelCancelScope(const std::atomic_bool *flag) : previous(Current()) { Current() = flag; }
+    ~ParallelCancelScope() { Current() = previous; }
+    ParallelCancelScope(const ParallelCancelScope&) = delete;
+    ParallelCancelScope& operator=(const ParallelCancelScope&) = delete;
+
+    static const std::atomic_bool *&Current() {
+        static thread_local const std::atomic_bool *current = nullptr;
+        return current;
+    }
+private:
+    const std::atomic_bool *previous;
+};
+
+template <typename Body>
+class ParallelRangeJob : public Job {
+    Body &body;
+    std::atomic_int next;
+    const int end;
+    const int grain;
+    const std::atomic_bool *cancel;
+public:
+    std::atomic_int finished;
+
+    ParallelRangeJob(Body &b, int start, int e, int g, const std::atomic_bool *c)
+        : Job(), body(b), next(start), end(e), grain(g), cancel(c), finished(0) {}
+
+    void RunChunks() {
+        ParallelCancelScope scope(cancel);
+        ParallelJobPool::Depth()++;
+        try {
+            int x;
+            while ((cancel == nullptr || !*cancel) && (x = next.fetch_add(grain, std::memory_order_relaxed)) < end) {
+                body(x, std::min(x + grain, end));
+            }
+        } catch (...) {
+            //nothing
+        }
+        ParallelJobPool::Depth()--;
+    }
+    virtual void Process() override {
+        RunChunks();
+        // the caller may destroy this job as soon as it sees the count change
+        ++finished;
+        ParallelJobPool::POOL.poolSignal.notify_all();
+    }
+    virtual bool SetThreadName() override { return false; }
+
+    // every chunk was handed out, none were skipped due to cancellation
+    bool Completed() const { return next >= end; }
+};
+
+#define PARALLEL_PROBE_NS 20000
+#define PARALLEL_SERIAL_NS 100000
+#define PARALLEL_CHUNK_NS 50000
+
+/**
+ * Range form of parallel_for without the per index std::function call:
+ * for(int x = start, x < max; ++x) {  ... use x ...}
+ *
+ * would convert to:
+ * parallel_for_range(start, max, [&] (int from, int to) { for (int x = from; x < to; ++x) { ... use x ... } });
+ *
+ * The body is called once per chunk. The first chunks run on the calling thread and are timed,
+ * cheap loops finish there without touching the pool and expensive ones are split into chunks
+ * of roughly PARALLEL_CHUNK_NS each. Calls from inside another parallel_for_range run inline.
+ * No chunks start once cancel (or the thread's ParallelCancelScope) is set.
+ * Returns false if the loop was cancelled before it completed.
+ */
+template <typename Body>
+bool parallel_for_range(int start, int end, Body &&body, int minGrain = 1, const std::atomic_bool *cancel = nullptr) {
+    if (cancel == nullptr) {
+        cancel = ParallelCancelScope::Current();
+    }
+    auto cancelled = [cancel]() { return cancel != nullptr && *cancel; };
+    if (minGrain < 1) minGrain = 1;
+
+    int pos = start;
+    if (ParallelJobPool::Depth() > 0 || ParallelJobPool::POOL.maxSize() < 2) {
+        // the outer loop is already keeping the pool busy
+        int grain = std::max(minGrain, (end - start + 7) / 8);
+        while (pos < end && !cancelled()) {
+            int e = std::min(end, pos + grain);
+            body(pos, e);
+            pos = e;
+        }
+        return pos >= end;
+    }
+
+    // time growing chunks on this thread until one is long enough to measure
+    int probe = minGrain;
+    long long probeNs = 0;
+    int probeItems = 1;
+    while (pos < end) {
+        if (cancelled()) return false;
+        int e = pos + std::min(probe, end - pos);
+        auto startTime = std::chrono::steady_clock::now();
+        body(pos, e);
+        probeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count();
+        probeItems = e - pos;
+        pos = e;
+        if (probeNs >= PARALLEL_PROBE_NS) break;
+        probe *= 2;
+    }
+    if (pos >= end) return true;
+
+    int remaining = end - pos;
+    double nsPerItem = std::max(1.0, (double)probeNs / probeItems);
+    if (nsPerItem * remaining < PARALLEL_SERIAL_NS) {
+        if (cancelled()) return false;
+        body(pos, end);
+        return true;
+    }
+
+    int threads = (int)std::min((double)ParallelJobPool::POOL.maxSize() + 1, nsPerItem * remaining / PARALLEL_CHUNK_NS);
+    // keep a few chunks per thread so faster threads can pick up the slack
+    int grain = std::max(minGrain, std::min((int)(PARALLEL_CHUNK_NS / nsPerItem), remaining / (threads * 4)));
+    int helpers = std::min(threads, (remaining + grain - 1) / grain) - 1;
+    if (helpers < 1) {
+        if (cancelled()) return false;
+        body(pos, end);
+        return true;
+    }
+
+    ParallelRangeJob<typename std::remove_reference<Body>::type> job(body, pos, end, grain, cancel);
+    for (int x = 0; x < helpers; x++) {
+        ParallelJobPool::POOL.PushJob(&job);
+    }
+    job.RunChunks();
+    // anything still queued has nothing left to do
+    int waitFor = helpers - ParallelJobPool::POOL.RemoveJob(&job);
+    if (job.finished < waitFor) {
+        std::unique_lock<std::mutex> lock(ParallelJobPool::POOL.poolLock);
+        while (job.finished < waitFor) {
+            ParallelJobPool::POOL.poolSignal.wait_for(lock, std::chrono::nanoseconds(1000000));
+        }
+    }
+    return job.Completed();
+}
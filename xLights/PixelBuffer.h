@@ -12,6 +12,8 @@
 
 #include <wx/xml/xml.h>
 
+#include <array>
+
 #include "models/Model.h"
 #include "models/SingleLineModel.h"
 #include "RenderBuffer.h"
@@ -21,6 +23,8 @@
 
 #define BLUR_MIN 1
 #define BLUR_MAX 15
+// largest blur the gaussian path has box sizes for ... see PixelBufferClass::Blur
+#define GAUSS_BLUR_MAX 16
 #define RZ_ROTATION_MIN 0
 #define RZ_ROTATION_MAX 100
 #define RZ_ZOOM_MIN 0
@@ -80,6 +84,24 @@ class ModelGroup;
 class PixelBufferClass
 {
 private:
+    // GetColors/SetColors compiled for a layer's nodes. Plain rgb nodes are written straight to/from their
+    // output channels with the dimming curve baked into per channel lookup tables, every other node type
+    // goes through the node's own methods.
+    struct RGBNodeOutput {
+        uint32_t node;     // index into the layer's nodes
+        uint32_t start;    // ActChan, used for the range restriction
+        uint32_t chan[3];  // output channel for red, green and blue with the colour order applied
+        uint16_t curve;    // index into forward/reverse
+    };
+    struct OutputPlan {
+        bool valid = false;
+        std::vector<RGBNodeOutput> rgb;
+        std::vector<uint32_t> otherNodes;
+        // 256 entries for each of red, green and blue, curve 0 is always the identity
+        std::vector<std::array<uint8_t, 768>> forward;
+        std::vector<std::array<uint8_t, 768>> reverse;
+    };
+
     class LayerInfo {
     public:
         LayerInfo(xLightsFrame *frame) : buffer(frame) {
@@ -211,6 +233,17 @@ private:
         int suppressUntil = 0;
 
         std::vector<uint8_t> mask;
+        OutputPlan outputPlan; // must be invalidated whenever buffer.Nodes is rebuilt
+
+        // scratch space for the blur and roto zoom post processing, reused every frame
+        std::vector<float> blurScratch;
+        std::vector<float> blurTemp;
+        std::vector<float> blurAccumulator;
+        std::vector<int> blurSums;
+        xlColorVector rotoScratch;
+        std::vector<float> rotoZoomU;
+        std::vector<float> rotoZoomV;
+
         void renderTransitions(bool isFirstFrame, const RenderBuffer* prevRB);
         void calculateMask(const std::string &type, bool mode, bool isFirstFrame);
         bool isMasked(int x, int y);
@@ -255,6 +288,7 @@ private:
     void RotateY(LayerInfo* layer, float offset);
     void RotateZAndZoom(LayerInfo* layer, float offset);
     void GetMixedColor(int node, const std::vector<bool> & validLayers, int EffectPeriod, int saveLayer);
+    void CompileOutputPlan(LayerInfo* layer);
 
     std::string modelName;
     std::string lastBufferType;
@@ -283,6 +317,20 @@ public:
     PixelBufferClass(xLightsFrame *f);
     virtual ~PixelBufferClass();
 
+#ifdef EFFECT_BENCHMARK_CHECKS
+    // result of comparing one blur or roto zoom setting against the implementation it replaced
+    struct PostProcessingCheck {
+        std::string name;
+        int width = 0;
+        int height = 0;
+        int maxDiff = 0;         // largest difference in any channel of any pixel
+        int pixelsDiffering = 0;
+        double ns = 0;
+        double referenceNs = 0;
+    };
+    static std::vector<PostProcessingCheck> CheckPostProcessing(xLightsFrame* frame);
+#endif
+
     const std::string &GetModelName() const
     { return modelName;};
     const Model* GetModel() const { return model; }
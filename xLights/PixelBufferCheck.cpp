@@ -0,0 +1,465 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "PixelBuffer.h"
+
+#ifdef EFFECT_BENCHMARK_CHECKS
+
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <random>
+
+// The layer blur and roto zoom were rewritten to avoid per frame allocations and per pixel GetPixel/SetPixel.
+// These are the straightforward implementations they replaced, kept so the effect benchmark can check the
+// fast versions still produce the same output within a tolerance. Only built with EFFECT_BENCHMARK_CHECKS
+// (the debug configurations) so release builds dont carry a second copy.
+
+static void boxesForGauss(int d, int n, std::vector<float> &boxes)  // standard deviation, number of boxes
+{
+    switch (d) {
+        case 2:
+        case 3:
+            boxes.push_back(1.0);
+            break;
+        case 4:
+        case 5:
+        case 6:
+            boxes.push_back(3.0);
+            break;
+        case 7:
+        case 8:
+        case 9:
+            boxes.push_back(5.0);
+            break;
+        case 10:
+        case 11:
+        case 12:
+            boxes.push_back(7.0);
+            break;
+        case 13:
+        case 14:
+        case 15:
+            boxes.push_back(9.0);
+            break;
+        default:
+            break;
+    }
+    float b = boxes.back();
+    switch (d) {
+        case 2:
+        case 4:
+        case 5:
+        case 7:
+        case 8:
+        case 10:
+        case 11:
+        case 13:
+        case 14:
+            boxes.push_back(b);
+            break;
+        default:
+            boxes.push_back(b + 2.0);
+            break;
+    }
+    switch (d) {
+        case 4:
+        case 7:
+        case 10:
+        case 13:
+            boxes.push_back(b);
+            break;
+        default:
+            boxes.push_back(b + 2.0);
+    }
+}
+
+#define RED(a, b) a[(b)*4]
+#define GREEN(a, b) a[(b)*4 + 1]
+#define BLUE(a, b) a[(b)*4 + 2]
+#define ALPHA(a, b) a[(b)*4 + 3]
+static inline void SET(std::vector<float>& ar, int idx, float r, float g, float b, float a) {
+    idx *= 4;
+    ar[idx++] = r;
+    ar[idx++] = g;
+    ar[idx++] = b;
+    ar[idx] = a;
+}
+
+static void boxBlurH_4 (const std::vector<float>& scl, std::vector<float>& tcl, int w, int h, float r) {
+    float iarr = 1.0f / (r+r+1.0f);
+    for(int i=0; i<h; i++) {
+        int ti = i*w;
+        int li = ti;
+        int ri = ti+r;
+        int maxri = ti + w - 1;
+        int fvIdx = ti;
+        int lvIdx = ti+w-1;
+
+        float valr = (r+1.0) * RED(scl,fvIdx);
+        float valg = (r+1.0) * GREEN(scl,fvIdx);
+        float valb = (r+1.0) * BLUE(scl,fvIdx);
+        float vala = (r+1.0) * ALPHA(scl,fvIdx);
+
+        float fvRed = RED(scl, fvIdx);
+        float fvGreen = GREEN(scl, fvIdx);
+        float fvBlue = BLUE(scl, fvIdx);
+        float fvAlpha = ALPHA(scl, fvIdx);
+        float lvRed = RED(scl, lvIdx);
+        float lvGreen = GREEN(scl, lvIdx);
+        float lvBlue = BLUE(scl, lvIdx);
+        float lvAlpha = ALPHA(scl, lvIdx);
+
+        for (int j=0; j<r; j++) {
+            int idx = j < w ? ti+j : lvIdx;
+            valr += RED(scl, idx);
+            valg += GREEN(scl, idx);
+            valb += BLUE(scl, idx);
+            vala += ALPHA(scl, idx);
+        }
+        for (int j=0  ; j<=r ; j++) {
+            int idx = ri <= maxri ? ri++ : lvIdx;
+            valr += RED(scl, idx) - fvRed;
+            valg += GREEN(scl, idx) - fvGreen;
+            valb += BLUE(scl, idx) - fvBlue;
+            vala += ALPHA(scl, idx) - fvAlpha;
+
+            if (ti <= maxri) {
+                SET(tcl, ti, valr*iarr, valg*iarr, valb*iarr, vala*iarr);
+                ti++;
+            }
+        }
+        for (int j=r+1; j<w-r; j++) {
+            int c = ri <= maxri ? ri++ : lvIdx;
+            int c2 = li <= maxri ? li++ : lvIdx;
+            valr += RED(scl, c) - RED(scl, c2);
+            valg += GREEN(scl, c) - GREEN(scl, c2);
+            valb += BLUE(scl, c) - BLUE(scl, c2);
+            vala += ALPHA(scl, c) - ALPHA(scl, c2);
+            if (ti <= maxri) {
+                SET(tcl, ti, valr*iarr, valg*iarr, valb*iarr, vala*iarr);
+                ti++;
+            }
+        }
+
+        for (int j=w-r; j<w  ; j++) {
+            int c2 = li <= maxri ? li++: lvIdx;
+            valr += lvRed - RED(scl, c2);
+            valg += lvGreen - GREEN(scl, c2);
+            valb += lvBlue - BLUE(scl, c2);
+            vala += lvAlpha - ALPHA(scl, c2);
+            if (ti <= maxri) {
+                SET(tcl, ti, valr*iarr, valg*iarr, valb*iarr, vala*iarr);
+                ti++;
+            }
+        }
+    }
+}
+
+static void boxBlurT_4 (const std::vector<float>& scl, std::vector<float>& tcl, int w, int h, float r) {
+    float iarr = 1.0f / (r+r+1.0f);
+    for(int i=0; i<w; i++) {
+        int ti = i;
+        int li = ti;
+        int ri = ti+r*w;
+
+        int maxri = ti+w*(h-1);
+
+        int fvIdx = ti;
+        int lvIdx = ti+w*(h-1);
+
+        float fvRed = RED(scl, fvIdx);
+        float fvGreen = GREEN(scl, fvIdx);
+        float fvBlue = BLUE(scl, fvIdx);
+        float fvAlpha = ALPHA(scl, fvIdx);
+        float lvRed = RED(scl, lvIdx);
+        float lvGreen = GREEN(scl, lvIdx);
+        float lvBlue = BLUE(scl, lvIdx);
+        float lvAlpha = ALPHA(scl, lvIdx);
+
+        float valr = (r+1)*fvRed;
+        float valg = (r+1)*fvGreen;
+        float valb = (r+1)*fvBlue;
+        float vala = (r+1)*fvAlpha;
+
+        for(int j=0; j<r; j++) {
+            int idx = j < w ? ti+j*w : lvIdx;
+            valr += RED(scl, idx);
+            valg += GREEN(scl, idx);
+            valb += BLUE(scl, idx);
+            vala += ALPHA(scl, idx);
+        }
+        for(int j=0  ; j<=r ; j++) {
+            int idx = ri <= maxri ? ri : lvIdx;
+            valr += RED(scl, idx) - fvRed;
+            valg += GREEN(scl, idx) - fvGreen;
+            valb += BLUE(scl, idx) - fvBlue;
+            vala += ALPHA(scl, idx) - fvAlpha;
+            if (ti <= maxri) {
+                SET(tcl, ti, valr*iarr, valg*iarr, valb*iarr, vala*iarr);
+            }
+            ri+=w;
+            ti+=w;
+        }
+        for(int j=r+1; j<h-r; j++) {
+            int c = ri <= maxri ? ri : lvIdx;
+            int c2 = li <= maxri ? li : lvIdx;
+            valr += RED(scl, c) - RED(scl, c2);
+            valg += GREEN(scl, c) - GREEN(scl, c2);
+            valb += BLUE(scl, c) - BLUE(scl, c2);
+            vala += ALPHA(scl, c) - ALPHA(scl, c2);
+            if (ti <= maxri) {
+                SET(tcl, ti, valr*iarr, valg*iarr, valb*iarr, vala*iarr);
+            }
+            li+=w; ri+=w; ti+=w;
+        }
+        for(int j=h-r; j<h  ; j++) {
+            int c2 = li <= maxri ? li : lvIdx;
+            valr += lvRed - RED(scl, c2);
+            valg += lvGreen - GREEN(scl, c2);
+            valb += lvBlue - BLUE(scl, c2);
+            vala += lvAlpha - ALPHA(scl, c2);
+            if (ti <= maxri) {
+                SET(tcl, ti, valr*iarr, valg*iarr, valb*iarr, vala*iarr);
+            }
+            li += w;
+            ti += w;
+        }
+    }
+}
+
+static void boxBlur_4(std::vector<float>& scl, std::vector<float>& tcl, int w, int h, float r, int size) {
+    tcl = scl;
+    //memcpy(tcl, scl, sizeof(float)*4*size);
+    boxBlurH_4(tcl, scl, w, h, r);
+    boxBlurT_4(scl, tcl, w, h, r);
+}
+
+static void gaussBlur_4(std::vector<float>& scl, std::vector<float>& tcl, int w, int h, int r, int size) {
+    std::vector<float> bxs;
+    boxesForGauss(r - 1, 3, bxs);
+    boxBlur_4 (scl, tcl, w, h, (bxs[0]-1)/2, size);
+    boxBlur_4 (tcl, scl, w, h, (bxs[1]-1)/2, size);
+    boxBlur_4 (scl, tcl, w, h, (bxs[2]-1)/2, size);
+}
+
+static inline int roundInt(float r) {
+    int tmp = static_cast<int> (r);
+    tmp += (r-tmp>=.5) - (r-tmp<=-.5);
+    return tmp;
+}
+
+namespace
+{
+    void refBlur(RenderBuffer& buffer, int b)
+    {
+        int w = buffer.BufferWi;
+        int h = buffer.BufferHt;
+        // the old code had no table entries past GAUSS_BLUR_MAX either ... it read past the end of them
+        if (b > 2 && b <= GAUSS_BLUR_MAX && w > 6 && h > 6) {
+            std::vector<float> input(w * h * 4);
+            std::vector<float> tmp(w * h * 4);
+            for (int x = 0; x < w * h; x++) {
+                const xlColor& c = buffer.pixels[x];
+                input[x * 4] = c.red;
+                input[x * 4 + 1] = c.green;
+                input[x * 4 + 2] = c.blue;
+                input[x * 4 + 3] = c.alpha;
+            }
+            gaussBlur_4(input, tmp, w, h, b, w * h);
+            for (int x = 0; x < w * h; x++) {
+                buffer.pixels[x].Set(roundInt(tmp[x * 4]), roundInt(tmp[x * 4 + 1]), roundInt(tmp[x * 4 + 2]), roundInt(tmp[x * 4 + 3]));
+            }
+            return;
+        }
+
+        int d = b / 2;
+        int u = (b - 1) / 2;
+        RenderBuffer orig(buffer);
+        for (int x = 0; x < w; x++) {
+            for (int y = 0; y < h; y++) {
+                int r = 0, g = 0, b2 = 0, a = 0, sm = 0;
+                for (int i = std::max(x - d, 0); i <= std::min(x + u, w - 1); i++) {
+                    for (int j = std::max(y - d, 0); j <= std::min(y + u, h - 1); j++) {
+                        const xlColor& c = orig.GetPixel(i, j);
+                        r += c.red;
+                        g += c.green;
+                        b2 += c.blue;
+                        a += c.alpha;
+                        ++sm;
+                    }
+                }
+                sm = std::max(sm, 1);
+                buffer.SetPixel(x, y, xlColor(r / sm, g / sm, b2 / sm, a / sm));
+            }
+        }
+    }
+
+    void refRotateX(RenderBuffer& buffer, float xrotation, int xpivot)
+    {
+        RenderBuffer orig(buffer);
+        buffer.Clear();
+        float sine = sin((xrotation + 90) * M_PI / 180);
+        float pivot = xpivot * buffer.BufferWi / 100;
+        for (int x = pivot; x < buffer.BufferWi; ++x) {
+            float tox = sine * (x - pivot) + pivot;
+            for (int y = 0; y < buffer.BufferHt; ++y) {
+                buffer.SetPixel(tox, y, orig.GetPixel(x, y));
+            }
+        }
+        for (int x = pivot - 1; x >= 0; --x) {
+            float tox = -1 * sine * (pivot - x) + pivot;
+            for (int y = 0; y < buffer.BufferHt; ++y) {
+                buffer.SetPixel(tox, y, orig.GetPixel(x, y));
+            }
+        }
+    }
+
+    void refRotateY(RenderBuffer& buffer, float yrotation, int ypivot)
+    {
+        RenderBuffer orig(buffer);
+        buffer.Clear();
+        float sine = sin((yrotation + 90) * M_PI / 180);
+        float pivot = ypivot * buffer.BufferHt / 100;
+        for (int y = pivot; y < buffer.BufferHt; ++y) {
+            float toy = sine * (y - pivot) + pivot;
+            for (int x = 0; x < buffer.BufferWi; ++x) {
+                buffer.SetPixel(x, toy, orig.GetPixel(x, y));
+            }
+        }
+        for (int y = pivot - 1; y >= 0; --y) {
+            float toy = -1 * sine * (pivot - y) + pivot;
+            for (int x = 0; x < buffer.BufferWi; ++x) {
+                buffer.SetPixel(x, toy, orig.GetPixel(x, y));
+            }
+        }
+    }
+
+    void refRotateZAndZoom(RenderBuffer& buffer, float rotation, float zoom, int q, int cx, int cy)
+    {
+        static const float PI_2 = 6.283185307f;
+        xlColor c;
+        RenderBuffer orig(buffer);
+        float inc = 1.0 / (float)q;
+        float angle = PI_2 * -rotation;
+        float xoff = (cx * buffer.BufferWi) / 100.0;
+        float yoff = (cy * buffer.BufferHt) / 100.0;
+        float anglecos = cos(-angle);
+        float anglesin = sin(-angle);
+
+        buffer.Clear();
+        for (int x = 0; x < buffer.BufferWi; x++) {
+            for (int i = 0; i < q; i++) {
+                for (int y = 0; y < buffer.BufferHt; y++) {
+                    orig.GetPixel(x, y, c);
+                    for (int j = 0; j < q; j++) {
+                        float xx = (float)x + ((float)i * inc) - xoff;
+                        float yy = (float)y + ((float)j * inc) - yoff;
+                        float u = xoff + anglecos * xx * zoom + anglesin * yy * zoom;
+                        if (u >= 0 && u < buffer.BufferWi) {
+                            float v = yoff + -anglesin * xx * zoom + anglecos * yy * zoom;
+                            if (v >= 0 && v < buffer.BufferHt) {
+                                buffer.SetPixel(u, v, c);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+std::vector<PixelBufferClass::PostProcessingCheck> PixelBufferClass::CheckPostProcessing(xLightsFrame* frame)
+{
+    static const std::pair<int, int> sizes[] = { { 50, 1 }, { 7, 7 }, { 20, 11 }, { 50, 50 }, { 300, 150 } };
+
+    PixelBufferClass pb(frame);
+    std::vector<PostProcessingCheck> results;
+
+    // runs the layer version and the reference version on the same random pixels and records how far apart they end up
+    auto check = [&](const std::string& name, int w, int h, std::function<void(LayerInfo*)> setup,
+                     std::function<void(LayerInfo*)> fast, std::function<void(RenderBuffer&)> reference) {
+        LayerInfo layer(frame);
+        setup(&layer);
+        layer.BufferWi = w;
+        layer.BufferHt = h;
+        layer.buffer.InitBuffer(h, w, h, w, "None");
+
+        std::mt19937 rng(w * 1000 + h);
+        std::uniform_int_distribution<int> dist(0, 255);
+        for (auto& c : layer.buffer.pixels) {
+            c.Set(dist(rng), dist(rng), dist(rng), dist(rng));
+        }
+        RenderBuffer expected(layer.buffer);
+
+        auto start = std::chrono::steady_clock::now();
+        fast(&layer);
+        auto mid = std::chrono::steady_clock::now();
+        reference(expected);
+        auto end = std::chrono::steady_clock::now();
+
+        PostProcessingCheck r;
+        r.name = name;
+        r.width = w;
+        r.height = h;
+        r.ns = std::chrono::duration<double, std::nano>(mid - start).count();
+        r.referenceNs = std::chrono::duration<double, std::nano>(end - mid).count();
+        for (size_t i = 0; i < layer.buffer.pixels.size() && i < expected.pixels.size(); i++) {
+            const xlColor& a = layer.buffer.pixels[i];
+            const xlColor& b = expected.pixels[i];
+            int diff = std::max(std::max(std::abs(a.red - b.red), std::abs(a.green - b.green)),
+                                std::max(std::abs(a.blue - b.blue), std::abs(a.alpha - b.alpha)));
+            if (diff != 0) {
+                r.pixelsDiffering++;
+                r.maxDiff = std::max(r.maxDiff, diff);
+            }
+        }
+        results.push_back(r);
+    };
+
+    for (const auto& size : sizes) {
+        int w = size.first;
+        int h = size.second;
+        // one past BLUR_MAX and GAUSS_BLUR_MAX so both sides of the gaussian cut off are checked
+        for (int b = 2; b <= GAUSS_BLUR_MAX + 1; b++) {
+            check("Blur " + std::to_string(b), w, h,
+                  [b](LayerInfo* l) { l->blur = b; },
+                  [&pb](LayerInfo* l) { pb.Blur(l, 0.0f); },
+                  [b](RenderBuffer& rb) { refBlur(rb, b); });
+        }
+        for (int rot : { 30, 120, 200 }) {
+            for (int pivot : { 0, 50, 75 }) {
+                std::string args = std::to_string(rot) + " pivot " + std::to_string(pivot);
+                check("Rotate X " + args, w, h,
+                      [rot, pivot](LayerInfo* l) { l->xrotation = rot; l->xpivot = pivot; },
+                      [&pb](LayerInfo* l) { pb.RotateX(l, 0.0f); },
+                      [rot, pivot](RenderBuffer& rb) { refRotateX(rb, rot, pivot); });
+                check("Rotate Y " + args, w, h,
+                      [rot, pivot](LayerInfo* l) { l->yrotation = rot; l->ypivot = pivot; },
+                      [&pb](LayerInfo* l) { pb.RotateY(l, 0.0f); },
+                      [rot, pivot](RenderBuffer& rb) { refRotateY(rb, rot, pivot); });
+            }
+        }
+        for (int rot : { 0, 25, 60 }) {
+            for (float zoom : { 0.5f, 1.0f, 2.0f }) {
+                for (int q : { 1, 3 }) {
+                    if (rot == 0 && zoom == 1.0f) continue;
+                    check(wxString::Format("Rotate Z %d zoom %.1f quality %d", rot, zoom, q).ToStdString(), w, h,
+                          [rot, zoom, q](LayerInfo* l) { l->rotation = rot; l->zoom = zoom; l->zoomquality = q; l->pivotpointx = 30; l->pivotpointy = 60; },
+                          [&pb](LayerInfo* l) { pb.RotateZAndZoom(l, 0.0f); },
+                          [rot, zoom, q](RenderBuffer& rb) { refRotateZAndZoom(rb, (float)rot / 100.0, zoom, q, 30, 60); });
+                }
+            }
+        }
+    }
+    return results;
+}
+
+#endif
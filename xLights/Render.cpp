@@ -12,6 +12,7 @@
 #include <condition_variable>
 #include <map>
 #include <memory>
+#include <algorithm>
 
 #include "xLightsMain.h"
 #include "xLightsXmlFile.h"
@@ -144,55 +145,102 @@ private:
     std::vector<NextRenderer *> next;
 };
 
+// inclusive frame ranges, sorted and non overlapping
+typedef std::vector<std::pair<int, int>> FrameRanges;
+
+// Holds a job back until every job that writes some of the same channels in the same frames
+// and comes before it in the sequence has finished those frames. Frames where no earlier job
+// writes any of its channels are released straight away.
 class AggregatorRenderer: public NextRenderer {
-public:
+    // receives the frames done by one earlier job
+    class Input : public NextRenderer {
+    public:
+        Input(AggregatorRenderer *a, int i, int r, FrameRanges &&c) : NextRenderer(), aggregator(a), index(i), row(r), conflicts(c) {
+            lastSafe = SafeFrame(-1);
+        }
 
-    AggregatorRenderer(int numFrames) : NextRenderer(), finalFrame(numFrames + 19) {
-        data = new int[numFrames + 20];
-        for (int x = 0; x < (numFrames + 20); ++x) {
-            data[x] = 0;
+        // the last frame the job can render given the earlier job has finished frame done
+        int SafeFrame(int done) const {
+            if (done == END_OF_RENDER_FRAME) {
+                return END_OF_RENDER_FRAME;
+            }
+            for (const auto& it : conflicts) {
+                if (it.second > done) {
+                    return std::max(done, it.first - 1);
+                }
+            }
+            // no more shared frames, anything but the final frame is fine
+            return END_OF_RENDER_FRAME - 1;
         }
-        max = 0;
-    }
 
-    virtual ~AggregatorRenderer() {
-        delete [] data;
-    }
+        virtual void setPreviousFrameDone(int frame) override {
+            int safe = SafeFrame(frame);
+            // only record every 10th frame, the final frame or a jump past frames
+            // we dont share to avoid a lot of lock contention
+            if (safe != lastSafe && (frame % 10 == 0 || frame == END_OF_RENDER_FRAME || safe > frame)) {
+                lastSafe = safe;
+                aggregator->InputDone(index, safe);
+            }
+        }
+
+        AggregatorRenderer *aggregator;
+        const int index;
+        const int row;
+        const FrameRanges conflicts;
+        int lastSafe;
+    };
+
+public:
+
+    AggregatorRenderer() : NextRenderer() {}
 
-    void incNumAggregated() {
-        ++max;
+    virtual ~AggregatorRenderer() {}
+
+    void AddInput(NextRenderer *from, int row, FrameRanges &&conflicts) {
+        inputs.push_back(std::make_unique<Input>(this, (int)inputs.size(), row, std::move(conflicts)));
+        safe.push_back(inputs.back()->lastSafe);
+        from->addNext(inputs.back().get());
     }
 
     int getNumAggregated() const
     {
-        return max;
+        return inputs.size();
     }
 
-    virtual void setPreviousFrameDone(int frame) {
-        if (max <= 1) {
-            FrameDone(frame);
-            return;
-        }
-        int idx = frame;
-        if (idx == END_OF_RENDER_FRAME) {
-            idx = finalFrame;
-        }
-        if (idx % 10 == 0 || idx == finalFrame) {
-            //only record every 10th frame and the final frame to
-            //avoid a lot of lock contention
-            std::unique_lock<std::mutex> lock(nextLock);
-            ++data[idx];
-            if (data[idx] == max) {
-                previousFrameDone = frame;
-                FrameDone(previousFrameDone);
-            }
+    int GetInputRow(int i) const {
+        return inputs[i]->row;
+    }
+
+    // call once all the inputs are added to release the frames that dont depend on anything
+    void Start() {
+        std::unique_lock<std::mutex> lock(nextLock);
+        started = true;
+        Release();
+    }
+
+    void InputDone(int index, int frame) {
+        std::unique_lock<std::mutex> lock(nextLock);
+        safe[index] = frame;
+        if (started) {
+            Release();
         }
     }
 
 private:
-    int *data;
-    int max;
-    const int finalFrame;
+    void Release() {
+        int frame = END_OF_RENDER_FRAME;
+        for (auto it : safe) {
+            frame = std::min(frame, it);
+        }
+        if (frame > previousFrameDone) {
+            previousFrameDone = frame;
+            FrameDone(frame);
+        }
+    }
+
+    std::vector<std::unique_ptr<Input>> inputs;
+    std::vector<int> safe;
+    bool started = false;
 };
 
 class SNPair {
@@ -244,7 +292,9 @@ public:
                             static const std::string CHOICE_BufferStyle("B_CHOICE_BufferStyle");
                             static const std::string DEFAULT("Default");
                             static const std::string PER_MODEL("Per Model");
-                            const std::string &bt = layer->GetEffect(e)->GetSettings().Get(CHOICE_BufferStyle, DEFAULT);
+                            const Effect* ef = layer->GetEffect(e);
+                            auto settings = ef->GetSettingsSnapshot();
+                            const std::string &bt = settings->Get(CHOICE_BufferStyle, DEFAULT);
                             if (bt.compare(0, 9, PER_MODEL) == 0) {
                                 perModelEffects = true;
                             }
@@ -318,6 +368,9 @@ public:
     int GetCurrentFrame() const { return currentFrame;}
     int GetEndFrame() const { return endFrame;}
     int GetStartFrame() const { return startFrame;}
+    long long GetRenderStartMS() const { return renderStartMS; }
+    long long GetRenderEndMS() const { return renderEndMS; }
+    long GetWaitMS() const { return waitMS; }
 
     const std::string GetName() const override {
         return name;
@@ -612,12 +665,14 @@ public:
                     rb.CopyNodeColorsToPixels(done);
                     
                     // now fill in any spaces in the buffer that don't have nodes mapped to them
-                    parallel_for(0, rb.BufferHt, [&rb, &buffer, &done, &vl, frame](int y) {
-                        for (int x = 0; x < rb.BufferWi; x++) {
-                            if (!done[y * rb.BufferWi + x]) {
-                                xlColor c = xlBLACK;
-                                buffer->GetMixedColor(x, y, c, vl, frame);
-                                rb.SetPixel(x, y, c);
+                    parallel_for_range(0, rb.BufferHt, [&rb, &buffer, &done, &vl, frame](int yStart, int yEnd) {
+                        for (int y = yStart; y < yEnd; y++) {
+                            for (int x = 0; x < rb.BufferWi; x++) {
+                                if (!done[y * rb.BufferWi + x]) {
+                                    xlColor c = xlBLACK;
+                                    buffer->GetMixedColor(x, y, c, vl, frame);
+                                    rb.SetPixel(x, y, c);
+                                }
                             }
                         }
                         });
@@ -648,6 +703,7 @@ public:
             }
             buffer->CalcOutput(frame, info.validLayers);
             buffer->GetColors(&((*seqData)[frame][0]), rangeRestriction);
+            seqData->FrameChanged(frame);
         }
 
         if (sw.Time() > 500)
@@ -663,6 +719,8 @@ public:
         static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
         static log4cpp::Category& logger_jobpool = log4cpp::Category::getInstance(std::string("log_jobpool"));
         logger_jobpool.debug("Render job thread id 0x%x or %d", wxThread::GetCurrentId(), wxThread::GetCurrentId());
+        // let parallel loops inside effects stop early when this render is aborted
+        ParallelCancelScope cancelScope(&abort);
 
         SetGenericStatus("Initializing rendering thread for %s", 0);
         int maxFrameBeforeCheck = -1;
@@ -677,6 +735,7 @@ public:
         }
         SetGenericStatus("Got lock on rendering thread for %s", 0);
 
+        renderStartMS = wxGetUTCTimeMillis().GetValue();
         rowToRender->GetAndResetDirtyRange(origChangeCount, ss, es);
         if (ss != -1) {
             //expand to cover the whole dirty range
@@ -735,6 +794,7 @@ public:
                 if (frame >= maxFrameBeforeCheck) {
                     wxStopWatch sw;
                     maxFrameBeforeCheck = waitForFrame(frame);
+                    waitMS += sw.Time();
 
                     if (sw.Time() > 500)
                     {
@@ -791,6 +851,7 @@ public:
                             buffer->SetColors(1, &((*seqData)[frame][0]));
                             buffer->CalcOutput(frame, valid);
                             buffer->GetColors(&((*seqData)[frame][0]), rangeRestriction);
+                            seqData->FrameChanged(frame);
                         }
                     }
                 }
@@ -800,6 +861,7 @@ public:
                     FrameDone(frame);
                 }
             }
+            renderEndMS = wxGetUTCTimeMillis().GetValue();
             SetGenericStatus("%s: All done - Completed frame %d ", endFrame, true, true);
         } catch ( std::exception &ex) {
             wxASSERT(false); // so when we debug we catch them
@@ -910,6 +972,9 @@ private:
     wxGauge *gauge;
     std::atomic_int currentFrame;
     std::atomic_bool abort;
+    std::atomic<long long> renderStartMS { 0 };
+    std::atomic<long long> renderEndMS { 0 };
+    std::atomic_long waitMS { 0 };
 
     std::vector<EffectLayerInfo *> subModelInfos;
 
@@ -990,6 +1055,48 @@ public:
     std::list<Model *> restriction;
 };
 
+// Logs the chain of dependent models that decided how long the render took. Starting from the
+// model that finished last, keep stepping back to the model it depended on that finished last.
+static void LogRenderCriticalPath(const RenderProgressInfo *rpi) {
+    static log4cpp::Category &logger_render = log4cpp::Category::getInstance(std::string("log_render"));
+    if (!logger_render.isInfoEnabled()) return;
+
+    int last = -1;
+    long long start = 0;
+    for (int row = 0; row < rpi->numRows; ++row) {
+        RenderJob *job = rpi->jobs[row];
+        if (job == nullptr || job->GetRenderStartMS() == 0) continue;
+        if (start == 0 || job->GetRenderStartMS() < start) {
+            start = job->GetRenderStartMS();
+        }
+        if (last == -1 || job->GetRenderEndMS() > rpi->jobs[last]->GetRenderEndMS()) {
+            last = row;
+        }
+    }
+    if (last == -1) return;
+
+    std::string path;
+    int row = last;
+    while (row != -1) {
+        RenderJob *job = rpi->jobs[row];
+        if (!path.empty()) path += " <- ";
+        path += wxString::Format("%s (%ldms, waited %ldms)", job->GetName(), (long)(job->GetRenderEndMS() - job->GetRenderStartMS()), job->GetWaitMS()).ToStdString();
+
+        int next = -1;
+        if (job->GetWaitMS() > 0) {
+            AggregatorRenderer *agg = rpi->aggregators[row];
+            for (int i = 0; i < agg->getNumAggregated(); ++i) {
+                int prev = agg->GetInputRow(i);
+                if (next == -1 || rpi->jobs[prev]->GetRenderEndMS() > rpi->jobs[next]->GetRenderEndMS()) {
+                    next = prev;
+                }
+            }
+        }
+        row = next;
+    }
+    logger_render.info("Render took %ldms, critical path: %s", (long)(rpi->jobs[last]->GetRenderEndMS() - start), (const char *)path.c_str());
+}
+
 void xLightsFrame::LogRenderStatus()
 {
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
@@ -1125,6 +1232,7 @@ void xLightsFrame::UpdateRenderStatus() {
         }
 
         if (done) {
+            LogRenderCriticalPath(rpi);
             for (size_t row = 0; row < rpi->numRows; ++row) {
                 if (rpi->jobs[row]) {
                     delete rpi->jobs[row];
@@ -1283,6 +1391,108 @@ void xLightsFrame::BuildRenderTree() {
     }
 }
 
+// channel ranges (inclusive) the buffer can write to, limited to the channels being rendered
+static std::vector<std::pair<unsigned int, unsigned int>> GetWrittenChannels(PixelBufferClass *buffer, const std::list<NodeRange> &restriction, unsigned int numChannels) {
+    std::vector<std::pair<unsigned int, unsigned int>> channels;
+    size_t cn = buffer->GetChanCountPerNode();
+    for (int node = 0; node < buffer->GetNodeCount(); ++node) {
+        unsigned int start = buffer->NodeStartChannel(node);
+        if (start >= numChannels) continue;
+        unsigned int end = std::min(start + (unsigned int)cn, numChannels) - 1;
+        for (const auto& r : restriction) {
+            unsigned int s = std::max(start, r.start);
+            unsigned int e = std::min(end, r.end);
+            if (s <= e) {
+                channels.push_back({ s, e });
+            }
+        }
+    }
+    std::sort(channels.begin(), channels.end());
+    std::vector<std::pair<unsigned int, unsigned int>> merged;
+    for (const auto& it : channels) {
+        if (!merged.empty() && it.first <= merged.back().second + 1) {
+            merged.back().second = std::max(merged.back().second, it.second);
+        } else {
+            merged.push_back(it);
+        }
+    }
+    return merged;
+}
+
+static void AddEffectFrames(EffectLayer *layer, int frameTime, FrameRanges &frames) {
+    std::unique_lock<std::recursive_mutex> lock(layer->GetLock());
+    for (int e = 0; e < layer->GetEffectCount(); ++e) {
+        Effect *ef = layer->GetEffect(e);
+        frames.push_back({ ef->GetStartTimeMS() / frameTime, ef->GetEndTimeMS() / frameTime });
+    }
+}
+
+// frames in which the model has an effect on any layer, submodel, strand or node, these are
+// the only frames a RenderJob writes to the sequence data
+static FrameRanges GetWrittenFrames(ModelElement *me, int frameTime) {
+    FrameRanges frames;
+    for (int l = 0; l < me->GetEffectLayerCount(); ++l) {
+        AddEffectFrames(me->GetEffectLayer(l), frameTime, frames);
+    }
+    for (int x = 0; x < me->GetSubModelAndStrandCount(); ++x) {
+        SubModelElement *se = me->GetSubModel(x);
+        for (int l = 0; l < se->GetEffectLayerCount(); ++l) {
+            AddEffectFrames(se->GetEffectLayer(l), frameTime, frames);
+        }
+    }
+    for (int x = 0; x < me->GetStrandCount(); ++x) {
+        StrandElement *se = me->GetStrand(x);
+        for (int n = 0; n < se->GetNodeLayerCount(); ++n) {
+            AddEffectFrames(se->GetNodeLayer(n), frameTime, frames);
+        }
+    }
+    std::sort(frames.begin(), frames.end());
+    FrameRanges merged;
+    for (const auto& it : frames) {
+        if (!merged.empty() && it.first <= merged.back().second + 1) {
+            merged.back().second = std::max(merged.back().second, it.second);
+        } else {
+            merged.push_back(it);
+        }
+    }
+    return merged;
+}
+
+template <typename T>
+static bool RangesOverlap(const std::vector<std::pair<T, T>> &a, const std::vector<std::pair<T, T>> &b) {
+    auto ia = a.begin();
+    auto ib = b.begin();
+    while (ia != a.end() && ib != b.end()) {
+        if (ia->second < ib->first) {
+            ++ia;
+        } else if (ib->second < ia->first) {
+            ++ib;
+        } else {
+            return true;
+        }
+    }
+    return false;
+}
+
+static FrameRanges IntersectRanges(const FrameRanges &a, const FrameRanges &b) {
+    FrameRanges res;
+    auto ia = a.begin();
+    auto ib = b.begin();
+    while (ia != a.end() && ib != b.end()) {
+        int s = std::max(ia->first, ib->first);
+        int e = std::min(ia->second, ib->second);
+        if (s <= e) {
+            res.push_back({ s, e });
+        }
+        if (ia->second < ib->second) {
+            ++ia;
+        } else {
+            ++ib;
+        }
+    }
+    return res;
+}
+
 void xLightsFrame::Render(const std::list<Model*> models,
                           const std::list<Model *> &restrictToModels,
                           int startFrame, int endFrame,
@@ -1311,12 +1521,13 @@ void xLightsFrame::Render(const std::list<Model*> models,
     int numRows = models.size();
     RenderJob **jobs = new RenderJob*[numRows];
     AggregatorRenderer **aggregators = new AggregatorRenderer*[numRows];
-    std::vector<std::set<int>> channelMaps(SeqData.NumChannels());
+    std::vector<std::vector<std::pair<unsigned int, unsigned int>>> jobChannels(numRows);
+    std::vector<FrameRanges> jobFrames(numRows);
 
     size_t row = 0;
     for (auto it = models.begin(); it != models.end(); ++it, ++row) {
         jobs[row] = nullptr;
-        aggregators[row] = new AggregatorRenderer(SeqData.NumFrames());
+        aggregators[row] = new AggregatorRenderer();
 
         Element *rowEl = mSequenceElements.GetElement((*it)->GetName());
 
@@ -1352,32 +1563,33 @@ void xLightsFrame::Render(const std::list<Model*> models,
 
                     jobs[row] = job;
                     aggregators[row]->addNext(job);
-                    size_t cn = buffer->GetChanCountPerNode();
-                    for (int node = 0; node < buffer->GetNodeCount(); ++node) {
-                        int start = buffer->NodeStartChannel(node);
-                        for (int c = 0; c < cn; ++c) {
-                            int cnum = start + c;
-                            if (cnum < SeqData.NumChannels()) {
-                                for (auto i = channelMaps[cnum].begin(); i != channelMaps[cnum].end(); ++i) {
-                                    int idx = *i;
-                                    if (idx != row) {
-                                        if (jobs[idx]->addNext(aggregators[row])) {
-                                            aggregators[row]->incNumAggregated();
-                                        }
-                                    }
-                                }
-                                channelMaps[cnum].insert(row);
-                            }
-                        }
-                    }
+                    jobChannels[row] = GetWrittenChannels(buffer, ranges, SeqData.NumChannels());
+                    jobFrames[row] = GetWrittenFrames(me, SeqData.FrameTime());
                 }
             }
         }
     }
 
-    logger_render.debug("Aggregators created.");
-
-    channelMaps.clear();
+    // a job has to follow every earlier job that writes some of the same channels in some of
+    // the same frames, and only for those frames
+    int dependencies = 0;
+    int overlapsIgnored = 0;
+    for (row = 0; row < numRows; ++row) {
+        if (jobs[row] == nullptr) continue;
+        for (int idx = 0; idx < row; ++idx) {
+            if (jobs[idx] == nullptr || !RangesOverlap(jobChannels[row], jobChannels[idx])) continue;
+            FrameRanges shared = IntersectRanges(jobFrames[row], jobFrames[idx]);
+            if (shared.empty()) {
+                ++overlapsIgnored;
+                continue;
+            }
+            aggregators[row]->AddInput(jobs[idx], idx, std::move(shared));
+            ++dependencies;
+        }
+    }
+    logger_render.debug("Render plan created: %d dependencies, %d channel overlaps ignored as the models never render the same frames.", dependencies, overlapsIgnored);
+    jobChannels.clear();
+    jobFrames.clear();
     RenderProgressDialog *renderProgressDialog = nullptr;
     if (progressDialog) {
         renderProgressDialog = new RenderProgressDialog(this);
@@ -1388,6 +1600,7 @@ void xLightsFrame::Render(const std::list<Model*> models,
             for (auto it = ranges.begin(); it != ranges.end(); ++it) {
                 SeqData[f].Zero(it->start, it->end - it->start + 1);
             }
+            SeqData.FrameChanged(f);
         }
     }
 
@@ -1418,6 +1631,7 @@ void xLightsFrame::Render(const std::list<Model*> models,
     for (row = 0; row < numRows; ++row) {
         if (jobs[row] && aggregators[row]->getNumAggregated() != 0) {
             //now start the rest
+            aggregators[row]->Start();
             jobPool.PushJob(jobs[row]);
             ++count;
         }
@@ -1899,6 +2113,97 @@ void xLightsFrame::ExportModel(wxCommandEvent &command) {
     }
 }
 
+// Stateful effects get a checkpoint at most this often and no more than CHECKPOINT_MAX_PER_EFFECT per effect
+#define CHECKPOINT_MIN_INTERVAL 50
+#define CHECKPOINT_MAX_PER_EFFECT 32
+
+static uint64_t GetCheckpointKey(const SettingsMap& settingsMap, const RenderBuffer& buffer, int layer)
+{
+    // FNV-1a over everything the effects state depends on
+    uint64_t hash = 14695981039346656037ULL;
+    auto add = [&hash](const std::string& str) {
+        for (auto c : str) {
+            hash ^= (uint8_t)c;
+            hash *= 1099511628211ULL;
+        }
+        hash ^= 0xFF;
+        hash *= 1099511628211ULL;
+    };
+    for (const auto& it : settingsMap) {
+        add(it.first);
+        add(it.second);
+    }
+    add(buffer.cur_model);
+    add(wxString::Format("%d,%d,%d,%d,%d,%d", layer, buffer.BufferWi, buffer.BufferHt, buffer.curEffStartPer, buffer.curEffEndPer, buffer.frameTimeInMs).ToStdString());
+    return hash;
+}
+
+static void SaveCheckpoint(RenderableEffect* reff, Effect* effectObj, int layer, int bufn, const SettingsMap& settingsMap, const RenderBuffer& buffer)
+{
+    int interval = std::max(CHECKPOINT_MIN_INTERVAL, (buffer.curEffEndPer - buffer.curEffStartPer) / CHECKPOINT_MAX_PER_EFFECT);
+    if ((buffer.curPeriod - buffer.curEffStartPer + 1) % interval != 0) return;
+
+    EffectCheckpoint* checkpoint = buffer.CreateCheckpoint(reff->GetId());
+    if (checkpoint != nullptr) {
+        effectObj->AddCheckpoint(bufn, GetCheckpointKey(settingsMap, buffer, layer), buffer.curPeriod, checkpoint);
+    }
+}
+
+// A stateful effect can only reach a frame by stepping through every frame before it. When a render starts
+// part way through one restore the nearest checkpoint (or start from the beginning of the effect) and step
+// forward to the frame so the output matches rendering the whole effect.
+static void ResumeFromCheckpoint(RenderableEffect* reff, Effect* effectObj, int layer, int period, SettingsMap& settingsMap, PixelBufferClass& buffer)
+{
+    static log4cpp::Category &logger_render = log4cpp::Category::getInstance(std::string("log_render"));
+
+    RenderBuffer& first = buffer.BufferForLayer(layer, 0);
+    if (!first.needToInit || period <= first.curEffStartPer) return;
+
+    int buffers = buffer.BufferCountForLayer(layer);
+    std::vector<std::shared_ptr<EffectCheckpoint>> checkpoints(buffers);
+    int from = -1;
+    for (int bufn = 0; bufn < buffers; ++bufn) {
+        RenderBuffer& b = buffer.BufferForLayer(layer, bufn);
+        int frame = -1;
+        checkpoints[bufn] = effectObj->GetCheckpoint(bufn, GetCheckpointKey(settingsMap, b, layer), period - 1, frame);
+        if (checkpoints[bufn] == nullptr || (bufn > 0 && frame != from)) {
+            from = -1;
+            break;
+        }
+        from = frame;
+    }
+
+    int start = first.curEffStartPer;
+    if (from >= 0) {
+        for (int bufn = 0; bufn < buffers; ++bufn) {
+            buffer.BufferForLayer(layer, bufn).RestoreCheckpoint(reff->GetId(), *checkpoints[bufn]);
+        }
+        start = from + 1;
+    }
+    logger_render.debug("Effect %s on %s resuming at frame %d by stepping from frame %d.", (const char*)reff->Name().c_str(), (const char*)buffer.GetModelName().c_str(), period, start);
+
+    int suppressUntil = buffer.GetSuppressUntil(layer);
+    for (int frame = start; frame < period; ++frame) {
+        buffer.SetLayer(layer, frame, false);
+        buffer.Clear(layer);
+        for (int bufn = 0; bufn < buffers; ++bufn) {
+            RenderBuffer* b = &buffer.BufferForLayer(layer, bufn);
+            if (suppressUntil > frame - first.curEffStartPer) {
+                // same as a suppressed frame in RenderEffectFromMap
+                RenderBuffer rb(*b);
+                reff->Render(effectObj, settingsMap, rb);
+                b->needToInit = rb.needToInit;
+                b->infoCache = rb.infoCache;
+            } else {
+                reff->Render(effectObj, settingsMap, *b);
+                SaveCheckpoint(reff, effectObj, layer, bufn, settingsMap, *b);
+            }
+        }
+    }
+    buffer.SetLayer(layer, period, false);
+    buffer.Clear(layer);
+}
+
 bool xLightsFrame::RenderEffectFromMap(bool suppress, Effect *effectObj, int layer, int period, SettingsMap& SettingsMap,
                                        PixelBufferClass &buffer, bool &resetEffectState,
                                        bool bgThread, RenderEvent *event) {
@@ -1960,6 +2265,14 @@ bool xLightsFrame::RenderEffectFromMap(bool suppress, Effect *effectObj, int lay
     if (eidx >= 0) {
         RenderableEffect *reff = effectManager.GetEffect(eidx);
 
+        // layers whose pixels carry from frame to frame or change shape over the effect cant be stepped forward on their own
+        bool checkpoint = reff != nullptr && effectObj != nullptr && !suppress && reff->SupportsCheckpoints() && !reff->SupportsRenderCache(SettingsMap) &&
+            !buffer.IsPersistent(layer) && !buffer.IsVariableSubBuffer(layer) && !buffer.IsCanvasMix(layer) &&
+            (!bgThread || reff->CanRenderOnBackgroundThread(effectObj, SettingsMap, buffer.BufferForLayer(layer, 0)));
+        if (checkpoint) {
+            ResumeFromCheckpoint(reff, effectObj, layer, period, SettingsMap, buffer);
+        }
+
         for (int bufn = 0; bufn < buffer.BufferCountForLayer(layer); ++bufn) {
             RenderBuffer* b = &buffer.BufferForLayer(layer, bufn);
             RenderBuffer* oldBuffer = nullptr;
@@ -1984,6 +2297,9 @@ bool xLightsFrame::RenderEffectFromMap(bool suppress, Effect *effectObj, int lay
                     }
                 } else {
                     reff->Render(effectObj, SettingsMap, *b);
+                    if (checkpoint) {
+                        SaveCheckpoint(reff, effectObj, layer, bufn, SettingsMap, *b);
+                    }
                 }
                 // Log slow render frames ... this takes time but at this point it is already slow
                 if (sw.Time() > 150) {
@@ -10,6 +10,7 @@
  **************************************************************/
 
 #include <cmath>
+#include <functional>
 #ifdef _MSC_VER
 	// required so M_PI will be defined by MSC
 	#define _USE_MATH_DEFINES
@@ -783,7 +784,7 @@ float RenderBuffer::cos(float rad)
 }
 
 // generates a random number between num1 and num2 inclusive
-double RenderBuffer::RandomRange(double num1, double num2) const
+double RenderBuffer::RandomRange(double num1, double num2)
 {
     double hi,lo;
     if (num1 < num2)
@@ -796,7 +797,7 @@ double RenderBuffer::RandomRange(double num1, double num2) const
         lo = num2;
         hi = num1;
     }
-    return rand01()*(hi-lo)+ lo;
+    return Rand01()*(hi-lo)+ lo;
 }
 
 void RenderBuffer::Color2HSV(const xlColor& color, HSVValue& hsv) const
@@ -1266,14 +1267,27 @@ const xlColor& RenderBuffer::GetTempPixelRGB(int x, int y)
     return xlBLACK;
 }
 
-void RenderBuffer::SetState(int period, bool ResetState, const std::string& model_name)
+void RenderBuffer::SetState(int period, bool ResetState, const std::string& model_name, int layer)
 {
     if (ResetState) {
         needToInit = true;
     }
     curPeriod = period;
     cur_model = model_name;
-    curPeriod = period;
+
+    // reseed every frame so a frame renders the same regardless of what was rendered before it
+    // FNV-1a rather than std::hash as the latter differs between standard libraries and builds
+    uint64_t seed = 0xcbf29ce484222325ULL;
+    for (const char c : cur_model) {
+        seed ^= (uint8_t)c;
+        seed *= 0x100000001b3ULL;
+    }
+    seed = seed * 31 + (uint64_t)layer;
+    seed = seed * 31 + (uint64_t)curEffStartPer;
+    seed = seed * 31 + (uint64_t)period;
+    _randomSeed = seed;
+    _random.Seed(seed);
+
     palette.UpdateForProgress(GetEffectTimeIntervalPosition());
     dmx_buffer = false;
     Model* m = GetModel();
@@ -1284,6 +1298,99 @@ void RenderBuffer::SetState(int period, bool ResetState, const std::string& mode
     }
 }
 
+EffectCheckpoint* RenderBuffer::CreateCheckpoint(int id) const
+{
+    EffectRenderCache* cache = nullptr;
+    auto it = infoCache.find(id);
+    if (it != infoCache.end() && it->second != nullptr) {
+        cache = it->second->Clone();
+        if (cache == nullptr) return nullptr;
+    }
+
+    EffectCheckpoint* checkpoint = new EffectCheckpoint();
+    checkpoint->cache = cache;
+    checkpoint->tempbuf = tempbuf;
+    checkpoint->tempInt = tempInt;
+    checkpoint->tempInt2 = tempInt2;
+    return checkpoint;
+}
+
+// All checkpoints together may use at most this much memory
+#define CHECKPOINT_MEMORY_BUDGET (512 * 1024 * 1024)
+
+EffectCheckpointBudget& EffectCheckpointBudget::Instance()
+{
+    static EffectCheckpointBudget budget;
+    return budget;
+}
+
+std::shared_ptr<EffectCheckpoint> EffectCheckpointBudget::Add(EffectCheckpoint* checkpoint)
+{
+    std::shared_ptr<EffectCheckpoint> cp(checkpoint);
+    cp->_memorySize = cp->GetMemorySize();
+
+    // anything evicted is freed after the lock is released
+    std::list<std::shared_ptr<EffectCheckpoint>> evicted;
+    std::unique_lock<std::mutex> lock(_lock);
+    _lru.push_front(cp);
+    cp->_budgetPos = _lru.begin();
+    cp->_inBudget = true;
+    _used += cp->_memorySize;
+    while (_used > CHECKPOINT_MEMORY_BUDGET && _lru.size() > 1) {
+        auto& last = _lru.back();
+        last->_inBudget = false;
+        _used -= last->_memorySize;
+        evicted.splice(evicted.end(), _lru, std::prev(_lru.end()));
+    }
+    lock.unlock();
+    if (!evicted.empty()) {
+        static log4cpp::Category& logger_render = log4cpp::Category::getInstance(std::string("log_render"));
+        logger_render.debug("Checkpoint memory budget exceeded, dropped %d least recently used checkpoints.", (int)evicted.size());
+    }
+    return cp;
+}
+
+void EffectCheckpointBudget::Touch(const std::shared_ptr<EffectCheckpoint>& checkpoint)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    if (checkpoint->_inBudget) {
+        _lru.splice(_lru.begin(), _lru, checkpoint->_budgetPos);
+    }
+}
+
+void EffectCheckpointBudget::Remove(const std::shared_ptr<EffectCheckpoint>& checkpoint)
+{
+    std::list<std::shared_ptr<EffectCheckpoint>> removed;
+    std::lock_guard<std::mutex> lock(_lock);
+    if (checkpoint->_inBudget) {
+        checkpoint->_inBudget = false;
+        _used -= checkpoint->_memorySize;
+        removed.splice(removed.end(), _lru, checkpoint->_budgetPos);
+    }
+}
+
+size_t EffectCheckpointBudget::GetMemoryUsed() const
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    return _used;
+}
+
+void RenderBuffer::RestoreCheckpoint(int id, const EffectCheckpoint& checkpoint)
+{
+    auto it = infoCache.find(id);
+    if (it != infoCache.end()) {
+        delete it->second;
+        infoCache.erase(it);
+    }
+    if (checkpoint.cache != nullptr) {
+        infoCache[id] = checkpoint.cache->Clone();
+    }
+    tempbuf = checkpoint.tempbuf;
+    tempInt = checkpoint.tempInt;
+    tempInt2 = checkpoint.tempInt2;
+    needToInit = false;
+}
+
 void RenderBuffer::ClearTempBuf()
 {
     for (size_t i = 0; i < tempbuf.size(); i++)
@@ -1437,6 +1544,8 @@ RenderBuffer::RenderBuffer(RenderBuffer& buffer)
     infoCache = buffer.infoCache;
 
     pixels = buffer.pixels;
+    _random = buffer._random;
+    _randomSeed = buffer._randomSeed;
     _textDrawingContext = buffer._textDrawingContext;
     _pathDrawingContext = buffer._pathDrawingContext;
 }
@@ -15,6 +15,8 @@
 #include <list>
 #include <vector>
 #include <atomic>
+#include <memory>
+#include <mutex>
 #include <wx/colour.h>
 #include <wx/dcclient.h>
 #include <wx/dcmemory.h>
@@ -384,10 +386,95 @@ public:
     }
 };
 
+// Small fast random number generator (xoshiro128**) owned by each render buffer.
+// Unlike rand() it takes no global lock and because it is reseeded from the model,
+// layer, effect start and frame every frame a render is repeatable.
+class RenderRandom {
+public:
+    void Seed(uint64_t seed)
+    {
+        // splitmix64 to spread the seed over the state
+        for (int i = 0; i < 4; i += 2) {
+            seed += 0x9E3779B97F4A7C15ULL;
+            uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            z = z ^ (z >> 31);
+            _s[i] = (uint32_t)z;
+            _s[i + 1] = (uint32_t)(z >> 32);
+        }
+        if ((_s[0] | _s[1] | _s[2] | _s[3]) == 0) _s[0] = 1;
+    }
+    uint32_t Next()
+    {
+        const uint32_t result = Rotl(_s[1] * 5, 7) * 9;
+        const uint32_t t = _s[1] << 9;
+        _s[2] ^= _s[0];
+        _s[3] ^= _s[1];
+        _s[1] ^= _s[2];
+        _s[0] ^= _s[3];
+        _s[2] ^= t;
+        _s[3] = Rotl(_s[3], 11);
+        return result;
+    }
+    // RAND_MAX differs between platforms so use a fixed range to get the same render everywhere
+    static constexpr int RANDOM_MAX = 0x7FFFFFFF;
+    // 0 to RANDOM_MAX inclusive
+    int Rand() { return (int)(Next() >> 1); }
+    // same range as rand01() ... 0.0 to 1.0 inclusive
+    double Rand01() { return (double)(Next() >> 1) / (double)RANDOM_MAX; }
+
+private:
+    static uint32_t Rotl(const uint32_t x, int k) { return (x << k) | (x >> (32 - k)); }
+    uint32_t _s[4] = { 1, 0, 0, 0 };
+};
+
 class /*NCCDLLEXPORT*/ EffectRenderCache {
 public:
 	EffectRenderCache();
 	virtual ~EffectRenderCache();
+	// effects which support checkpoints return a copy of their state, nullptr if it cant be copied
+	virtual EffectRenderCache* Clone() const { return nullptr; }
+	// approximate bytes held ... used to keep checkpoints within their memory budget
+	virtual size_t GetMemorySize() const { return sizeof(*this); }
+};
+
+// The state an effect carries from one frame to the next on a buffer
+class EffectCheckpoint {
+public:
+    EffectCheckpoint() {}
+    ~EffectCheckpoint() { if (cache != nullptr) delete cache; }
+
+    size_t GetMemorySize() const { return sizeof(*this) + tempbuf.capacity() * sizeof(xlColor) + (cache == nullptr ? 0 : cache->GetMemorySize()); }
+
+    EffectRenderCache* cache = nullptr;
+    xlColorVector tempbuf;
+    int tempInt = 0;
+    int tempInt2 = 0;
+
+private:
+    friend class EffectCheckpointBudget;
+    std::list<std::shared_ptr<EffectCheckpoint>>::iterator _budgetPos;
+    bool _inBudget = false;
+    size_t _memorySize = 0;
+};
+
+// Checkpoints from every effect share one memory budget. The budget owns them and when it is
+// exceeded drops the least recently used, effects only hold weak references to theirs.
+class EffectCheckpointBudget {
+public:
+    static EffectCheckpointBudget& Instance();
+
+    std::shared_ptr<EffectCheckpoint> Add(EffectCheckpoint* checkpoint);
+    void Touch(const std::shared_ptr<EffectCheckpoint>& checkpoint);
+    void Remove(const std::shared_ptr<EffectCheckpoint>& checkpoint);
+    size_t GetMemoryUsed() const;
+
+private:
+    EffectCheckpointBudget() {}
+    mutable std::mutex _lock;
+    std::list<std::shared_ptr<EffectCheckpoint>> _lru; // most recently used at the front
+    size_t _used = 0;
 };
 
 class /*NCCDLLEXPORT*/ RenderBuffer {
@@ -396,6 +483,8 @@ public:
     ~RenderBuffer();
     RenderBuffer(RenderBuffer& buffer);
     void InitBuffer(int newBufferHt, int newBufferWi, int newModelBufferHt, int newModelBufferWi, const std::string& bufferTransform, bool nodeBuffer = false);
+    EffectCheckpoint* CreateCheckpoint(int id) const;
+    void RestoreCheckpoint(int id, const EffectCheckpoint& checkpoint);
     AudioManager* GetMedia() const;
     Model* GetModel() const;
     Model* GetPermissiveModel() const; // gets the model even if it is a submodel/strand
@@ -409,7 +498,13 @@ public:
     void SetAllowAlphaChannel(bool a);
     bool IsDmxBuffer() const { return dmx_buffer; }
 
-    void SetState(int period, bool reset, const std::string& model_name);
+    void SetState(int period, bool reset, const std::string& model_name, int layer = 0);
+
+    // per buffer replacements for rand() and rand01() ... effects should use these
+    int Rand() { return _random.Rand(); }
+    double Rand01() { return _random.Rand01(); }
+    // seed for this frame ... use it to seed a local RenderRandom inside parallel loops
+    uint64_t GetRandomSeed() const { return _randomSeed; }
 
     void SetEffectDuration(int startMsec, int endMsec);
     void GetEffectPeriods(int& curEffStartPer, int& curEffEndPer) const;  // nobody wants endPer?
@@ -457,7 +552,7 @@ public:
     void Get2ColorAlphaBlend(const xlColor& c1, const xlColor& c2, float ratio, xlColor &color);
     void GetMultiColorBlend(float n, bool circular, xlColor &color, int reserveColors = 0);
     void SetRangeColor(const HSVValue& hsv1, const HSVValue& hsv2, HSVValue& newhsv);
-    double RandomRange(double num1, double num2) const;
+    double RandomRange(double num1, double num2);
     void Color2HSV(const xlColor& color, HSVValue& hsv) const;
     const PaletteClass& GetPalette() const { return palette; }
 
@@ -515,6 +610,8 @@ private:
     std::vector<NodeBaseClassPtr> Nodes;
     PathDrawingContext *_pathDrawingContext = nullptr;
     TextDrawingContext *_textDrawingContext = nullptr;
+    RenderRandom _random;
+    uint64_t _randomSeed = 0;
 
     void SetPixelDMXModel(int x, int y, const xlColor& color);
     void Forget();
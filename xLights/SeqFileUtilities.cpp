@@ -50,6 +50,7 @@
 #include "effects/SnowflakesEffect.h"
 #include "Vixen3.h"
 #include "osxMacUtils.h"
+#include "Parallel.h"
 
 #include <log4cpp/Category.hh>
 
@@ -2169,16 +2170,194 @@ void xLightsFrame::ImportHLS(const wxFileName &filename)
     SetStatusText(wxString::Format("'%s' imported in %4.3f sec.", filename.GetPath(), elapsedTime));
 }
 
+// What an LMS import needs from a LOR .lms/.las file. The file is read with the pull parser and only
+// the channels, their effects and the timing grids are kept rather than loading the whole document.
+struct LMSEffect {
+    std::string type;
+    int startCentisecond = 0;
+    int endCentisecond = 0;
+    std::string intensity = "-1";
+    std::string startIntensity;
+    std::string endIntensity;
+};
+
+struct LMSChannel {
+    bool rgb = false;
+    int channelsIndex = 0; // which <channels> element it came from
+    std::string name;
+    std::string color;
+    std::string unit;
+    std::string circuit;
+    std::string savedIndex;
+    std::vector<std::string> rgbSavedIndexes;
+    std::vector<LMSEffect> effects;
+};
+
+class LMSFile {
+public:
+    std::vector<LMSChannel> channels; // in file order
+    std::list<std::pair<std::string, std::vector<int>>> timingGrids;
+
+    bool Load(const wxString& filename);
+    void AdjustTimings(int offsetCS);
+    const LMSChannel* FindChannel(const std::string& name) const;
+    const LMSChannel* FindSavedIndex(int channelsIndex, const std::string& savedIndex) const;
+
+private:
+    std::map<std::string, size_t> _byName;
+    std::map<std::pair<int, std::string>, size_t> _bySavedIndex;
+};
+
+bool LMSFile::Load(const wxString& filename) {
+    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    wxFile file;
+    if (!file.Open(filename)) {
+        logger_base.error("Unable to open LMS file %s.", (const char *)filename.c_str());
+        return false;
+    }
+
+    SP_XmlPullParser *parser = new SP_XmlPullParser();
+    parser->setMaxTextSize(MAX_READ_BLOCK_SIZE / 2);
+    char *bytes = new char[MAX_READ_BLOCK_SIZE];
+    size_t read = file.Read(bytes, MAX_READ_BLOCK_SIZE);
+    parser->append(bytes, read);
+
+    std::vector<std::string> context;
+    int channelsIndex = -1;
+    LMSChannel* channel = nullptr;
+    std::vector<int>* timingGrid = nullptr;
+    bool ok = false;
+
+    SP_XmlPullEvent * event = parser->getNext();
+    bool done = false;
+    while (!done) {
+        if (!event) {
+            read = file.Read(bytes, MAX_READ_BLOCK_SIZE);
+            if (read == 0) {
+                done = true;
+            }
+            else {
+                parser->append(bytes, read);
+            }
+        }
+        else {
+            switch (event->getEventType()) {
+            case SP_XmlPullEvent::eEndDocument:
+                ok = true;
+                done = true;
+                break;
+            case SP_XmlPullEvent::eStartTag:
+            {
+                SP_XmlStartTagEvent * stagEvent = (SP_XmlStartTagEvent*)event;
+                std::string nodeName = stagEvent->getName();
+                context.push_back(nodeName);
+                size_t depth = context.size();
+
+                if (depth == 2 && nodeName == "channels") {
+                    channelsIndex++;
+                }
+                else if (depth == 3 && context[1] == "channels" && (nodeName == "channel" || nodeName == "rgbChannel")) {
+                    channels.emplace_back();
+                    channel = &channels.back();
+                    channel->rgb = nodeName == "rgbChannel";
+                    channel->channelsIndex = channelsIndex;
+                    channel->name = SafeGetAttrValue(stagEvent, "name");
+                    channel->color = SafeGetAttrValue(stagEvent, "color");
+                    channel->unit = SafeGetAttrValue(stagEvent, "unit");
+                    channel->circuit = SafeGetAttrValue(stagEvent, "circuit");
+                    channel->savedIndex = SafeGetAttrValue(stagEvent, "savedIndex");
+                }
+                else if (depth == 4 && channel != nullptr && !channel->rgb && nodeName == "effect") {
+                    channel->effects.emplace_back();
+                    LMSEffect& effect = channel->effects.back();
+                    effect.type = SafeGetAttrValue(stagEvent, "type");
+                    effect.startCentisecond = wxAtoi(SafeGetAttrValue(stagEvent, "startCentisecond"));
+                    effect.endCentisecond = wxAtoi(SafeGetAttrValue(stagEvent, "endCentisecond"));
+                    const char* intensity = stagEvent->getAttrValue("intensity");
+                    if (intensity != nullptr) effect.intensity = intensity;
+                    effect.startIntensity = SafeGetAttrValue(stagEvent, "startIntensity");
+                    effect.endIntensity = SafeGetAttrValue(stagEvent, "endIntensity");
+                }
+                else if (depth == 5 && channel != nullptr && channel->rgb && context[3] == "channels" && nodeName == "channel") {
+                    if (channel->rgbSavedIndexes.size() < 3) {
+                        channel->rgbSavedIndexes.push_back(SafeGetAttrValue(stagEvent, "savedIndex"));
+                    }
+                }
+                else if (depth == 3 && context[1] == "timingGrids" && nodeName == "timingGrid") {
+                    std::string name = SafeGetAttrValue(stagEvent, "name");
+                    if (SafeGetAttrValue(stagEvent, "type") != "fixed" && name != "") {
+                        timingGrids.push_back({ name, std::vector<int>() });
+                        timingGrid = &timingGrids.back().second;
+                    }
+                }
+                else if (depth == 4 && timingGrid != nullptr && nodeName == "timing") {
+                    timingGrid->push_back(wxAtoi(SafeGetAttrValue(stagEvent, "centisecond")));
+                }
+            }
+            break;
+            case SP_XmlPullEvent::eEndTag:
+                if (context.size() == 3) {
+                    channel = nullptr;
+                    timingGrid = nullptr;
+                }
+                if (!context.empty()) {
+                    context.pop_back();
+                }
+                break;
+            }
+            delete event;
+        }
+        if (!done) {
+            event = parser->getNext();
+        }
+    }
+    delete[] bytes;
+    delete parser;
+    file.Close();
+
+    if (!ok) {
+        logger_base.error("LMS file %s could not be parsed.", (const char *)filename.c_str());
+        return false;
+    }
+
+    // first channel in the file wins for a name, last wins for a saved index ... as the DOM based import did
+    for (size_t i = 0; i < channels.size(); ++i) {
+        const LMSChannel& c = channels[i];
+        _byName.emplace(c.name, i);
+        _byName.emplace(c.name + "_Unit_" + c.unit + "_Circuit_" + c.circuit, i);
+        if (!c.rgb) {
+            _bySavedIndex[{ c.channelsIndex, c.savedIndex }] = i;
+        }
+    }
+    return true;
+}
+
+void LMSFile::AdjustTimings(int offsetCS) {
+    for (auto& c : channels) {
+        for (auto& e : c.effects) {
+            e.startCentisecond += offsetCS;
+            e.endCentisecond += offsetCS;
+        }
+    }
+}
+
+const LMSChannel* LMSFile::FindChannel(const std::string& name) const {
+    auto it = _byName.find(name);
+    return it == _byName.end() ? nullptr : &channels[it->second];
+}
+
+const LMSChannel* LMSFile::FindSavedIndex(int channelsIndex, const std::string& savedIndex) const {
+    auto it = _bySavedIndex.find({ channelsIndex, savedIndex });
+    return it == _bySavedIndex.end() ? nullptr : &channels[it->second];
+}
+
 void xLightsFrame::ImportLMS(const wxFileName &filename) {
     wxStopWatch sw; // start a stopwatch timer
 
-    wxFileName xml_file(filename);
-    wxXmlDocument input_xml;
-    wxString xml_doc = xml_file.GetFullPath();
-    wxFileInputStream fin(xml_doc);
-
-    if( !input_xml.Load(fin) )  return;
-    ImportLMS(input_xml, filename);
+    LMSFile lms;
+    if (!lms.Load(filename.GetFullPath())) return;
+    ImportLMS(lms, filename);
     float elapsedTime = sw.Time()/1000.0; //msec => sec
     SetStatusText(wxString::Format("'%s' imported in %4.3f sec.", filename.GetPath(), elapsedTime));
 }
@@ -2332,52 +2511,21 @@ void xLightsFrame::ImportSuperStar(const wxFileName &filename)
     SetStatusText(wxString::Format("'%s' imported in %4.3f sec.", filename.GetPath(), elapsedTime));
 }
 
-bool findRGB(wxXmlNode *e, wxXmlNode *chan, wxXmlNode *&rchannel, wxXmlNode *&gchannel, wxXmlNode *&bchannel) {
-    wxString idxs[3];
-    int cnt = 0;
-    for (wxXmlNode *n = chan->GetChildren(); n != nullptr; n = n->GetNext()) {
-        if (n->GetName() == "channels") {
-            for (wxXmlNode *n2 = n->GetChildren(); n2 != nullptr; n2 = n2->GetNext()) {
-                if (n2->GetName() == "channel" && cnt < 3) {
-                    idxs[cnt] = n2->GetAttribute("savedIndex");
-                    cnt++;
-                }
-            }
-        }
-    }
-    for (wxXmlNode* ch=e->GetChildren(); ch!=nullptr; ch=ch->GetNext()) {
-        if (ch->GetName() == "channel") {
-            wxString idx = ch->GetAttribute("savedIndex");
-            if (idx == idxs[0]) {
-                rchannel = ch;
-            }
-            if (idx == idxs[1]) {
-                gchannel = ch;
-            }
-            if (idx == idxs[2]) {
-                bchannel = ch;
-            }
-        }
-    }
-    return true;
-}
-
-void GetRGBTimes(wxXmlNode *re, int &startms, int &endms) {
+void GetRGBTimes(const LMSEffect *re, int &startms, int &endms) {
     if (re != nullptr) {
-        startms = wxAtoi(re->GetAttribute("startCentisecond")) * 10;
-        endms = wxAtoi(re->GetAttribute("endCentisecond")) * 10;
+        startms = re->startCentisecond * 10;
+        endms = re->endCentisecond * 10;
     } else {
         startms = 9999999;
         endms = 9999999;
     }
 }
-void GetIntensities(wxXmlNode *re, int &starti, int &endi) {
-    wxString intensity = re->GetAttribute("intensity", "-1");
-    if (intensity == "-1") {
-        starti = wxAtoi(re->GetAttribute("startIntensity"));
-        endi = wxAtoi(re->GetAttribute("endIntensity"));
+void GetIntensities(const LMSEffect *re, int &starti, int &endi) {
+    if (re->intensity == "-1") {
+        starti = wxAtoi(re->startIntensity);
+        endi = wxAtoi(re->endIntensity);
     } else {
-        starti = endi = wxAtoi(intensity);
+        starti = endi = wxAtoi(re->intensity);
     }
 }
 
@@ -2388,10 +2536,10 @@ public:
     bool shimmer;
 };
 
-void FillData(wxXmlNode *nd, RGBData &data) {
+void FillData(const LMSEffect *nd, RGBData &data) {
     GetIntensities(nd, data.starti, data.endi);
     GetRGBTimes(nd, data.startms, data.endms);
-    data.shimmer = nd->GetAttribute("type") == "shimmer";
+    data.shimmer = nd->type == "shimmer";
 }
 void Insert(int x, std::vector<RGBData> &v, int startms) {
     v.insert(v.begin() + x, 1, RGBData());
@@ -2482,38 +2630,23 @@ bool GetRGBEffectData(RGBData &red, RGBData &green, RGBData &blue, xlColor &sc,
     return red.shimmer | blue.shimmer | green.shimmer;
 }
 
-void LoadRGBData(EffectManager &effectManager, EffectLayer *layer, wxXmlNode *rchannel, wxXmlNode *gchannel, wxXmlNode *bchannel) {
-    std::vector<RGBData> red, green, blue;
-    while (rchannel != nullptr) {
+void FillData(const std::vector<LMSEffect>& effects, std::vector<RGBData>& data) {
+    for (const auto& e : effects) {
         int startms, endms;
-        GetRGBTimes(rchannel, startms, endms);
+        GetRGBTimes(&e, startms, endms);
         if (startms < endms)
         {
-            red.resize(red.size() + 1);
-            FillData(rchannel, red[red.size() - 1]);
+            data.resize(data.size() + 1);
+            FillData(&e, data[data.size() - 1]);
         }
-        rchannel = rchannel->GetNext();
-    }
-    while (gchannel != nullptr) {
-        int startms, endms;
-        GetRGBTimes(gchannel, startms, endms);
-        if (startms < endms)
-        {
-            green.resize(green.size() + 1);
-            FillData(gchannel, green[green.size() - 1]);
-        }
-        gchannel = gchannel->GetNext();
-    }
-    while (bchannel != nullptr) {
-        int startms, endms;
-        GetRGBTimes(bchannel, startms, endms);
-        if (startms < endms)
-        {
-            blue.resize(blue.size() + 1);
-            FillData(bchannel, blue[blue.size() - 1]);
-        }
-        bchannel = bchannel->GetNext();
     }
+}
+
+void LoadRGBData(EffectManager &effectManager, EffectLayer *layer, const LMSChannel& rchannel, const LMSChannel& gchannel, const LMSChannel& bchannel) {
+    std::vector<RGBData> red, green, blue;
+    FillData(rchannel.effects, red);
+    FillData(gchannel.effects, green);
+    FillData(bchannel.effects, blue);
     //have the data, now need to split it so common start/end times
     for (size_t x = 0; x < red.size() || x < green.size() || x < blue.size(); x++) {
         UnifyData(x, red, green, blue);
@@ -2531,7 +2664,7 @@ void LoadRGBData(EffectManager &effectManager, EffectLayer *layer, wxXmlNode *rc
                 std::string palette = "C_BUTTON_Palette1=" + (std::string)sc + ",C_CHECKBOX_Palette1=1,"
                     + "C_BUTTON_Palette2=#000000,C_CHECKBOX_Palette2=0";
                 std::string settings = (isShimmer ? "E_CHECKBOX_On_Shimmer=1" : "");
-                layer->AddEffect(0, "On", settings, palette, starttime, endtime, false, false);
+                layer->AddEffect(0, "On", settings, palette, starttime, endtime, false, false, true);
             }
         } else if (sc == xlBLACK) {
             std::string palette = "C_BUTTON_Palette1=" + (std::string)ec + ",C_CHECKBOX_Palette1=1,"
@@ -2540,7 +2673,7 @@ void LoadRGBData(EffectManager &effectManager, EffectLayer *layer, wxXmlNode *rc
             if (isShimmer) {
                 settings += ",E_CHECKBOX_On_Shimmer=1";
             }
-            layer->AddEffect(0, "On", settings, palette, starttime, endtime, false, false);
+            layer->AddEffect(0, "On", settings, palette, starttime, endtime, false, false, true);
         } else if (ec == xlBLACK) {
             std::string palette = "C_BUTTON_Palette1=" + (std::string)sc + ",C_CHECKBOX_Palette1=1,"
                 "C_BUTTON_Palette2=#000000,C_CHECKBOX_Palette2=0";
@@ -2548,26 +2681,16 @@ void LoadRGBData(EffectManager &effectManager, EffectLayer *layer, wxXmlNode *rc
             if (isShimmer) {
                 settings += ",E_CHECKBOX_On_Shimmer=1";
             }
-            layer->AddEffect(0, "On", settings, palette, starttime, endtime, false, false);
+            layer->AddEffect(0, "On", settings, palette, starttime, endtime, false, false, true);
         } else {
             std::string palette = "C_BUTTON_Palette1=" + (std::string)sc + ",C_CHECKBOX_Palette1=1,"
                 "C_BUTTON_Palette2=" + (std::string)ec + ",C_CHECKBOX_Palette2=1";
             std::string settings = (isShimmer ? "E_CHECKBOX_ColorWash_Shimmer=1," : "");
-            layer->AddEffect(0, "Color Wash", settings, palette, starttime, endtime, false, false);
+            layer->AddEffect(0, "Color Wash", settings, palette, starttime, endtime, false, false, true);
         }
     }
 }
 
-void MapRGBEffects(EffectManager &effectManager, EffectLayer *layer, wxXmlNode *rchannel, wxXmlNode *gchannel, wxXmlNode *bchannel) {
-    wxXmlNode* re=rchannel->GetChildren();
-    while (re != nullptr && "effect" != re->GetName()) re = re->GetNext();
-    wxXmlNode* ge=gchannel->GetChildren();
-    while (ge != nullptr && "effect" != ge->GetName()) ge = ge->GetNext();
-    wxXmlNode* be=bchannel->GetChildren();
-    while (be != nullptr && "effect" != be->GetName()) be = be->GetNext();
-    LoadRGBData(effectManager, layer, re, ge, be);
-}
-
 std::string Scale255To100(wxString s, bool doscale)
 {
     if (doscale)
@@ -2576,89 +2699,75 @@ std::string Scale255To100(wxString s, bool doscale)
     return s.ToStdString();
 }
 
-void MapOnEffects(EffectManager &effectManager, EffectLayer *layer, wxXmlNode *channel, int chancountpernode, const wxColor &color) {
+void MapOnEffects(EffectManager &effectManager, EffectLayer *layer, const LMSChannel& channel, int chancountpernode, const wxColor &color) {
     std::string palette = "C_BUTTON_Palette1=#FFFFFF,C_CHECKBOX_Palette1=1";
     if (chancountpernode > 1) {
         xlColor color1(color);
         palette = "C_BUTTON_Palette1=" + color1 + ",C_CHECKBOX_Palette1=1";
     }
 
-    for (wxXmlNode* ch=channel->GetChildren(); ch!=nullptr; ch=ch->GetNext()) {
-        if (ch->GetName() == "effect") {
-            bool doscale = ch->GetAttribute("type", "") == "DMX intensity";
-            int starttime = (wxAtoi(ch->GetAttribute("startCentisecond"))) * 10;
-            int endtime = (wxAtoi(ch->GetAttribute("endCentisecond"))) * 10;
-            std::string intensity = ch->GetAttribute("intensity", "-1").ToStdString();
-            std::string starti, endi;
-            if (intensity == "-1") {
-                starti = Scale255To100(ch->GetAttribute("startIntensity"), doscale);
-                endi = Scale255To100(ch->GetAttribute("endIntensity"), doscale);
-            } else {
-                starti = endi = Scale255To100(intensity, doscale);
-            }
-            std::string settings;
-            if ("100" != starti) {
-                settings += "E_TEXTCTRL_Eff_On_Start=" + starti;
-            }
-            if ("100" != endi) {
-                if (!settings.empty()) {
-                    settings += ",";
-                }
-                settings += "E_TEXTCTRL_Eff_On_End=" + endi;
+    for (const auto& ch : channel.effects) {
+        bool doscale = ch.type == "DMX intensity";
+        int starttime = ch.startCentisecond * 10;
+        int endtime = ch.endCentisecond * 10;
+        std::string starti, endi;
+        if (ch.intensity == "-1") {
+            starti = Scale255To100(ch.startIntensity, doscale);
+            endi = Scale255To100(ch.endIntensity, doscale);
+        } else {
+            starti = endi = Scale255To100(ch.intensity, doscale);
+        }
+        std::string settings;
+        if ("100" != starti) {
+            settings += "E_TEXTCTRL_Eff_On_Start=" + starti;
+        }
+        if ("100" != endi) {
+            if (!settings.empty()) {
+                settings += ",";
             }
-            if (("intensity" != ch->GetAttribute("type")) && ("DMX intensity" != ch->GetAttribute("type"))) {
-                if (!settings.empty()) {
-                    settings += ",";
-                }
-                settings += "E_CHECKBOX_On_Shimmer=1";
+            settings += "E_TEXTCTRL_Eff_On_End=" + endi;
+        }
+        if (("intensity" != ch.type) && ("DMX intensity" != ch.type)) {
+            if (!settings.empty()) {
+                settings += ",";
             }
-            layer->AddEffect(0, "On", settings, palette, starttime, endtime, false, false);
+            settings += "E_CHECKBOX_On_Shimmer=1";
         }
+        layer->AddEffect(0, "On", settings, palette, starttime, endtime, false, false, true);
     }
 }
 
-bool MapChannelInformation(EffectManager &effectManager, EffectLayer *layer, wxXmlDocument &input_xml, const wxString &nm, const wxColor &color, const Model &mc, bool eraseExisting) {
+// Adds the effects unsorted ... the caller sorts each layer once it is done with it
+bool MapChannelInformation(EffectManager &effectManager, EffectLayer *layer, const LMSFile &lms, const wxString &nm, const wxColor &color, const Model &mc, bool eraseExisting) {
     if ("" == nm) {
         return false;
     }
 
     if (eraseExisting) layer->DeleteAllEffects();
 
-    wxXmlNode *channel = nullptr;
-    wxXmlNode *rchannel = nullptr;
-    wxXmlNode *gchannel = nullptr;
-    wxXmlNode *bchannel = nullptr;
-    for (wxXmlNode* e = input_xml.GetRoot()->GetChildren(); channel == nullptr && e != nullptr; e = e->GetNext()) {
-        if (e->GetName() == "channels") {
-            for (wxXmlNode* chan = e->GetChildren(); channel == nullptr && chan != nullptr; chan = chan->GetNext()) {
-                std::string unit = chan->GetAttribute("unit");
-                std::string circuit = chan->GetAttribute("circuit");
-                std::string dedupname = chan->GetAttribute("name") + "_Unit_" + unit + "_Circuit_" + circuit;
-                if ((chan->GetName() == "channel" || chan->GetName() == "rgbChannel")
-                    && (nm == chan->GetAttribute("name") || nm == dedupname)) {
-                    channel = chan;
-                    if (chan->GetName() == "rgbChannel"
-                        && !findRGB(e, chan, rchannel, gchannel, bchannel)) {
-                        return false;
-                    }
-                    break;
-                }
-            }
-        }
-    }
+    const LMSChannel* channel = lms.FindChannel(nm.ToStdString());
     if (channel == nullptr) {
         return false;
     }
-    if (channel->GetName() == "rgbChannel") {
-        MapRGBEffects(effectManager, layer, rchannel, gchannel, bchannel);
+    if (channel->rgb) {
+        if (channel->rgbSavedIndexes.size() < 3) {
+            return false;
+        }
+        const LMSChannel* rchannel = lms.FindSavedIndex(channel->channelsIndex, channel->rgbSavedIndexes[0]);
+        const LMSChannel* gchannel = lms.FindSavedIndex(channel->channelsIndex, channel->rgbSavedIndexes[1]);
+        const LMSChannel* bchannel = lms.FindSavedIndex(channel->channelsIndex, channel->rgbSavedIndexes[2]);
+        if (rchannel == nullptr || gchannel == nullptr || bchannel == nullptr) {
+            return false;
+        }
+        LoadRGBData(effectManager, layer, *rchannel, *gchannel, *bchannel);
     }
     else {
-        MapOnEffects(effectManager, layer, channel, mc.GetChanCountPerNode(), color);
+        MapOnEffects(effectManager, layer, *channel, mc.GetChanCountPerNode(), color);
     }
     return true;
 }
 
-void MapCCRModel(int& node, const std::vector<std::string>& channelNames, ModelElement* model, xLightsImportModelNode* m, Model* mc, wxXmlDocument &input_xml, EffectManager& effectManager, bool eraseExisting)
+void MapCCRModel(int& node, const std::vector<std::string>& channelNames, ModelElement* model, xLightsImportModelNode* m, Model* mc, const LMSFile &lms, EffectManager& effectManager, bool eraseExisting)
 {
     wxString ccrName = m->_mapping;
 
@@ -2683,15 +2792,16 @@ void MapCCRModel(int& node, const std::vector<std::string>& channelNames, ModelE
                 nm = ccrName + wxString::Format(" P %02d", (node + 1));
             }
             MapChannelInformation(effectManager,
-                layer, input_xml,
+                layer, lms,
                 nm, m->_color,
                 *mc, eraseExisting);
+            layer->SortEffects();
             node++;
         }
     }
 }
 
-void MapCCRStrand(const std::vector<std::string>& channelNames, StrandElement* se, xLightsImportModelNode* s, Model* mc, wxXmlDocument &input_xml, EffectManager& effectManager, bool eraseExisting)
+void MapCCRStrand(const std::vector<std::string>& channelNames, StrandElement* se, xLightsImportModelNode* s, Model* mc, const LMSFile &lms, EffectManager& effectManager, bool eraseExisting)
 {
     int node = 0;
     wxString ccrName = s->_mapping;
@@ -2712,14 +2822,15 @@ void MapCCRStrand(const std::vector<std::string>& channelNames, StrandElement* s
             nm = ccrName + wxString::Format(" P %02d", (node + 1));
         }
         MapChannelInformation(effectManager,
-            layer, input_xml,
+            layer, lms,
             nm, s->_color,
             *mc, eraseExisting);
+        layer->SortEffects();
         node++;
     }
 }
 
-void MapCCR(const std::vector<std::string>& channelNames, ModelElement* model, xLightsImportModelNode* m, Model* mc, wxXmlDocument &input_xml, EffectManager& effectManager, bool eraseExisting)
+void MapCCR(const std::vector<std::string>& channelNames, ModelElement* model, xLightsImportModelNode* m, Model* mc, const LMSFile &lms, EffectManager& effectManager, bool eraseExisting)
 {
     if (mc->GetDisplayAs() == "ModelGroup")
     {
@@ -2727,94 +2838,70 @@ void MapCCR(const std::vector<std::string>& channelNames, ModelElement* model, x
         int node = 0;
         for (auto it = mg->Models().begin(); it != mg->Models().end(); ++it)
         {
-            MapCCRModel(node, channelNames, model, m, *it, input_xml, effectManager, eraseExisting);
+            MapCCRModel(node, channelNames, model, m, *it, lms, effectManager, eraseExisting);
         }
     }
     else
     {
         int node = 0;
-        MapCCRModel(node, channelNames, model, m, mc, input_xml, effectManager, eraseExisting);
+        MapCCRModel(node, channelNames, model, m, mc, lms, effectManager, eraseExisting);
     }
 }
 
-bool xLightsFrame::ImportLMS(wxXmlDocument &input_xml, const wxFileName &filename)
+bool xLightsFrame::ImportLMS(LMSFile &lms, const wxFileName &filename)
 {
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
     xLightsImportChannelMapDialog dlg(this, filename, true, true, true, true);
     dlg.mSequenceElements = &mSequenceElements;
     dlg.xlights = this;
     std::vector<std::string> timingTrackNames;
-    std::map<std::string, wxXmlNode*> timingTracks;
-
-    for(wxXmlNode* e=input_xml.GetRoot()->GetChildren(); e!=nullptr; e=e->GetNext()) {
-        if (e->GetName() == "channels"){
-            for (wxXmlNode* chan=e->GetChildren(); chan!=nullptr; chan=chan->GetNext()) {
-                if (chan->GetName() == "channel" || chan->GetName() == "rgbChannel") {
-                    std::string name = chan->GetAttribute("name").ToStdString();
-                    if (chan->GetName() == "rgbChannel") {
-                        dlg.channelColors[name] = xlBLACK;
-                    } else {
-                        std::string color = chan->GetAttribute("color").ToStdString();
-                        std::string unit = chan->GetAttribute("unit").ToStdString();
-                        std::string circuit = chan->GetAttribute("circuit").ToStdString();
-                        if (std::find(begin(dlg.channelNames), end(dlg.channelNames), name) != end(dlg.channelNames)) {
-                            name += "_Unit_" + unit + "_Circuit_" + circuit;
-                        }
-                        dlg.channelColors[name] = GetColor(color);
-                    }
+    std::map<std::string, const std::vector<int>*> timingTracks;
 
-                    bool ccr = false;
-                    if (chan->GetName() == "rgbChannel") {
-                        int idxDP = name.find("-P");
-                        int idxUP = name.find(" P");
-                        int idxSP = name.find(" p");
-                        if (idxUP > idxSP) {
-                            idxSP = idxUP;
-                        }
-                        if (idxDP > idxSP) {
-                            idxSP = idxDP;
-                        }
-                        if (idxSP != wxNOT_FOUND) {
-                            int i = wxAtoi(name.substr(idxSP + 2, name.size()));
-                            if (i > 0 && name != "")
-                            {
-                                ccr = true;
-                                dlg.channelNames.push_back(name);
-                                //if (std::find(dlg.ccrNames.begin(), dlg.ccrNames.end(), name.substr(0, idxSP - 1)) == dlg.ccrNames.end())
-                                if (name.substr(0, idxSP) != "" && std::find(dlg.ccrNames.begin(), dlg.ccrNames.end(), name.substr(0, idxSP)) == dlg.ccrNames.end())
-                                {
-                                    //dlg.ccrNames.push_back(name.substr(0, idxSP - 1));
-                                    dlg.ccrNames.push_back(name.substr(0, idxSP));
-                                }
-                            }
-                        }
-                    }
+    for (const auto& chan : lms.channels) {
+        std::string name = chan.name;
+        if (chan.rgb) {
+            dlg.channelColors[name] = xlBLACK;
+        } else {
+            if (std::find(begin(dlg.channelNames), end(dlg.channelNames), name) != end(dlg.channelNames)) {
+                name += "_Unit_" + chan.unit + "_Circuit_" + chan.circuit;
+            }
+            dlg.channelColors[name] = GetColor(chan.color);
+        }
 
-                    if (!ccr && name != "")
+        bool ccr = false;
+        if (chan.rgb) {
+            int idxDP = name.find("-P");
+            int idxUP = name.find(" P");
+            int idxSP = name.find(" p");
+            if (idxUP > idxSP) {
+                idxSP = idxUP;
+            }
+            if (idxDP > idxSP) {
+                idxSP = idxDP;
+            }
+            if (idxSP != wxNOT_FOUND) {
+                int i = wxAtoi(name.substr(idxSP + 2, name.size()));
+                if (i > 0 && name != "")
+                {
+                    ccr = true;
+                    dlg.channelNames.push_back(name);
+                    if (name.substr(0, idxSP) != "" && std::find(dlg.ccrNames.begin(), dlg.ccrNames.end(), name.substr(0, idxSP)) == dlg.ccrNames.end())
                     {
-                        dlg.channelNames.push_back(name);
+                        dlg.ccrNames.push_back(name.substr(0, idxSP));
                     }
                 }
             }
         }
-        else if (e->GetName() == "timingGrids")
+
+        if (!ccr && name != "")
         {
-            for (wxXmlNode* timing = e->GetChildren(); timing != nullptr; timing = timing->GetNext()) {
-                if (timing->GetName() == "timingGrid") {
-                    wxString type = timing->GetAttribute("type", "");
-                    if (type != "fixed")
-                    {
-                        std::string name = timing->GetAttribute("name", "").ToStdString();
-                        if (name != "")
-                        {
-                            timingTrackNames.push_back(name);
-                            timingTracks[name] = timing;
-                        }
-                    }
-                }
-            }
+            dlg.channelNames.push_back(name);
         }
     }
+    for (const auto& it : lms.timingGrids) {
+        timingTrackNames.push_back(it.first);
+        timingTracks[it.first] = &it.second;
+    }
 
     std::sort(dlg.channelNames.begin(), dlg.channelNames.end(), stdlistNumberAwareStringCompare);
     std::sort(dlg.ccrNames.begin(), dlg.ccrNames.end(), stdlistNumberAwareStringCompare);
@@ -2828,7 +2915,7 @@ bool xLightsFrame::ImportLMS(wxXmlDocument &input_xml, const wxFileName &filenam
 
     if (dlg.TimeAdjustSpinCtrl->GetValue() != 0) {
         int offset = dlg.TimeAdjustSpinCtrl->GetValue();
-        AdjustAllTimings(input_xml.GetRoot(), offset / 10);
+        lms.AdjustTimings(offset / 10);
     }
 
     for (size_t tt = 0; tt < dlg.TimingTrackListBox->GetCount(); ++tt) {
@@ -2847,57 +2934,68 @@ bool xLightsFrame::ImportLMS(wxXmlDocument &input_xml, const wxFileName &filenam
             int offset = dlg.TimeAdjustSpinCtrl->GetValue();
             EffectLayer *targetLayer = target->GetEffectLayer(0);
             long last = offset;
-            for (wxXmlNode* t = timingTracks[name]->GetChildren(); t != nullptr; t = t->GetNext())
+            for (int centisecond : *timingTracks[name])
             {
-                if (t->GetName() == "timing")
+                int time = centisecond * 10 + offset;
+                int adjTime = TimeLine::RoundToMultipleOfPeriod(time, CurrentSeqXmlFile->GetFrequency());
+                if (adjTime > last)
                 {
-                    int time = wxAtoi(t->GetAttribute("centisecond")) * 10 + offset;
-                    int adjTime = TimeLine::RoundToMultipleOfPeriod(time, CurrentSeqXmlFile->GetFrequency());
-                    if (adjTime > last)
-                    {
-                        targetLayer->AddEffect(0, "", "", "", last, adjTime, false, false);
-                        last = adjTime;
-                    }
+                    targetLayer->AddEffect(0, "", "", "", last, adjTime, false, false);
+                    last = adjTime;
                 }
             }
         }
     }
 
+    // Adding elements changes the sequence so do that here first. Each model then only touches its own
+    // element's layers so the effects are created one model per thread.
+    std::vector<ModelElement*> models(dlg._dataModel->GetChildCount(), nullptr);
     for (size_t i = 0; i < dlg._dataModel->GetChildCount(); ++i)
     {
         xLightsImportModelNode* m = dlg._dataModel->GetNthChild(i);
-        std::string modelName = m->_model.ToStdString();
-        Model *mc = GetModel(modelName);
-        ModelElement* model = nullptr;
-        for (size_t x = 0; x < mSequenceElements.GetElementCount(); x++) {
-            if (mSequenceElements.GetElement(x)->GetType() == ElementType::ELEMENT_TYPE_MODEL
-                && modelName == mSequenceElements.GetElement(x)->GetName()) {
-                model = dynamic_cast<ModelElement*>(mSequenceElements.GetElement(x));
-                break;
+        bool mapped = m->_mapping != "";
+        for (size_t j = 0; !mapped && j < m->GetChildCount(); j++)
+        {
+            xLightsImportModelNode* s = m->GetNthChild(j);
+            mapped = s->_mapping != "";
+            for (size_t n = 0; !mapped && n < s->GetChildCount(); n++) {
+                mapped = s->GetNthChild(n)->_mapping != "";
             }
         }
+        if (!mapped) continue;
+
+        std::string modelName = m->_model.ToStdString();
+        ModelElement* model = dynamic_cast<ModelElement*>(mSequenceElements.GetElement(modelName));
+        if (model == nullptr) {
+            model = AddModel(GetModel(modelName), mSequenceElements);
+        }
+        if (model == nullptr)
+        {
+            logger_base.error("Attempt to add model %s during LMS import failed.", (const char *)modelName.c_str());
+        }
+        models[i] = model;
+    }
+
+    bool eraseExisting = dlg.CheckBox_EraseExistingEffects->GetValue();
+    parallel_for(0, models.size(), [this, &dlg, &lms, &models, eraseExisting](int i) {
+        ModelElement* model = models[i];
+        if (model == nullptr) return;
+
+        xLightsImportModelNode* m = dlg._dataModel->GetNthChild(i);
+        Model *mc = GetModel(m->_model.ToStdString());
 
         if (m->_mapping != "") {
-            if (model == nullptr) {
-                model = AddModel(GetModel(modelName), mSequenceElements);
-            }
-            if (model == nullptr)
+            if (std::find(dlg.ccrNames.begin(), dlg.ccrNames.end(), m->_mapping) != dlg.ccrNames.end())
             {
-                logger_base.error("Attempt to add model %s during LMS import failed.", (const char *)modelName.c_str());
+                MapCCR(dlg.channelNames, model, m, mc, lms, effectManager, eraseExisting);
             }
             else
             {
-                if (std::find(dlg.ccrNames.begin(), dlg.ccrNames.end(), m->_mapping) != dlg.ccrNames.end())
-                {
-                    MapCCR(dlg.channelNames, model, m, mc, input_xml, effectManager, dlg.CheckBox_EraseExistingEffects->GetValue());
-                }
-                else
-                {
-                    MapChannelInformation(effectManager,
-                        model->GetEffectLayer(0), input_xml,
-                        m->_mapping,
-                        m->_color, *mc, dlg.CheckBox_EraseExistingEffects->GetValue());
-                }
+                MapChannelInformation(effectManager,
+                    model->GetEffectLayer(0), lms,
+                    m->_mapping,
+                    m->_color, *mc, eraseExisting);
+                model->GetEffectLayer(0)->SortEffects();
             }
         }
 
@@ -2907,125 +3005,94 @@ bool xLightsFrame::ImportLMS(wxXmlDocument &input_xml, const wxFileName &filenam
             xLightsImportModelNode* s = m->GetNthChild(j);
 
             if ("" != s->_mapping) {
-                if (model == nullptr) {
-                    model = AddModel(GetModel(modelName), mSequenceElements);
-                }
-                if (model == nullptr)
+                if (std::find(dlg.ccrNames.begin(), dlg.ccrNames.end(), s->_mapping) != dlg.ccrNames.end())
                 {
-                    logger_base.error("Attempt to add model %s during LMS import failed.", (const char *)modelName.c_str());
+                    StrandElement *se = model->GetStrand(str);
+                    MapCCRStrand(dlg.channelNames, se, s, mc, lms, effectManager, eraseExisting);
                 }
                 else
                 {
-                    if (std::find(dlg.ccrNames.begin(), dlg.ccrNames.end(), s->_mapping) != dlg.ccrNames.end())
-                    {
-                        StrandElement *se = model->GetStrand(str);
-                        MapCCRStrand(dlg.channelNames, se, s, mc, input_xml, effectManager, dlg.CheckBox_EraseExistingEffects->GetValue());
-                    }
-                    else
-                    {
-                        SubModelElement *ste = model->GetSubModel(str);
-                        if (ste != nullptr) {
-                            MapChannelInformation(effectManager,
-                                ste->GetEffectLayer(0), input_xml,
-                                s->_mapping,
-                                s->_color, *mc, dlg.CheckBox_EraseExistingEffects->GetValue());
-                        }
+                    SubModelElement *ste = model->GetSubModel(str);
+                    if (ste != nullptr) {
+                        MapChannelInformation(effectManager,
+                            ste->GetEffectLayer(0), lms,
+                            s->_mapping,
+                            s->_color, *mc, eraseExisting);
+                        ste->GetEffectLayer(0)->SortEffects();
                     }
                 }
             }
             for (size_t n = 0; n < s->GetChildCount(); n++) {
                 xLightsImportModelNode* ns = s->GetNthChild(n);
                 if ("" != ns->_mapping) {
-                    if (model == nullptr) {
-                        model = AddModel(GetModel(modelName), mSequenceElements);
-                    }
-                    if (model == nullptr)
-                    {
-                        logger_base.error("Attempt to add model %s during LMS import failed.", (const char *)modelName.c_str());
-                    }
-                    else
-                    {
-                        SubModelElement *ste = model->GetSubModel(str);
-                        StrandElement *stre = dynamic_cast<StrandElement *>(ste);
-                        if (stre != nullptr) {
-                            NodeLayer *nl = stre->GetNodeLayer(n, true);
-                            if (nl != nullptr) {
-                                MapChannelInformation(effectManager,
-                                    nl, input_xml,
-                                    ns->_mapping,
-                                    ns->_color, *mc, dlg.CheckBox_EraseExistingEffects->GetValue());
-                            }
+                    SubModelElement *ste = model->GetSubModel(str);
+                    StrandElement *stre = dynamic_cast<StrandElement *>(ste);
+                    if (stre != nullptr) {
+                        NodeLayer *nl = stre->GetNodeLayer(n, true);
+                        if (nl != nullptr) {
+                            MapChannelInformation(effectManager,
+                                nl, lms,
+                                ns->_mapping,
+                                ns->_color, *mc, eraseExisting);
+                            nl->SortEffects();
                         }
                     }
                 }
             }
             str++;
         }
-    }
+    });
 
     return true;
 }
 
-bool LPEHasEffects(const wxXmlDocument& input_xml, const wxString& model, int layer, bool left)
+// every prop in an LPE file by name in document order, built once so mapping doesnt search the document
+typedef std::map<std::string, std::vector<wxXmlNode*>> LPEProps;
+
+bool LPEHasEffects(const LPEProps& props, const wxString& model, int layer, bool left)
 {
-    for (wxXmlNode* e = input_xml.GetRoot()->GetChildren(); e != nullptr; e = e->GetNext()) {
-        if (e->GetName() == "SequenceProps" || e->GetName() == "ArchivedProps") {
-            for (wxXmlNode* prop = e->GetChildren(); prop != nullptr; prop = prop->GetNext()) {
-                if (prop->GetName() == "SeqProp" || prop->GetName() == "ArchiveProp") {
-                    std::string name = prop->GetAttribute("name").ToStdString();
-                    if (name == "")
+    auto it = props.find(model.ToStdString());
+    if (it == props.end()) return false;
+
+    for (wxXmlNode* prop : it->second) {
+        for (wxXmlNode* track = prop->GetChildren(); track != nullptr; track = track->GetNext())
+        {
+            int id = wxAtoi(track->GetAttribute("id"));
+            if (id == layer)
+            {
+                for (wxXmlNode* eff = track->GetChildren(); eff != nullptr; eff = eff->GetNext())
+                {
+                    if (eff->GetName() == "effect" && eff->GetAttribute("type") == "pixelEffect")
                     {
-                        for (wxXmlNode* ap = prop->GetChildren(); ap != nullptr; ap = ap->GetNext()) {
-                            if (ap->GetName() == "PropClass")
+                        wxString settings = eff->GetAttribute("pixelEffect");
+                        wxArrayString as = wxSplit(settings, '|');
+                        if (as.size() == 7)
+                        {
+                            wxString s;
+                            if (left)
                             {
-                                name = ap->GetAttribute("Name");
+                                s = as[5];
                             }
+                            else
+                            {
+                                s = as[6];
+                            }
+                            wxArrayString ss = wxSplit(s, ':');
+                            if (ss[0] != "none") return true;
                         }
-                    }
-                    if (name == model)
-                    {
-                        for (wxXmlNode* track = prop->GetChildren(); track != nullptr; track = track->GetNext())
+                        else if (as.size() == 5)
                         {
-                            int id = wxAtoi(track->GetAttribute("id"));
-                            if (id == layer)
+                            wxString s;
+                            if (left)
                             {
-                                for (wxXmlNode* eff = track->GetChildren(); eff != nullptr; eff = eff->GetNext())
-                                {
-                                    if (eff->GetName() == "effect" && eff->GetAttribute("type") == "pixelEffect")
-                                    {
-                                        wxString settings = eff->GetAttribute("pixelEffect");
-                                        wxArrayString as = wxSplit(settings, '|');
-                                        if (as.size() == 7)
-                                        {
-                                            wxString s;
-                                            if (left)
-                                            {
-                                                s = as[5];
-                                            }
-                                            else
-                                            {
-                                                s = as[6];
-                                            }
-                                            wxArrayString ss = wxSplit(s, ':');
-                                            if (ss[0] != "none") return true;
-                                        }
-                                        else if (as.size() == 5)
-                                        {
-                                            wxString s;
-                                            if (left)
-                                            {
-                                                s = as[3];
-                                            }
-                                            else
-                                            {
-                                                s = as[4];
-                                            }
-                                            wxArrayString ss = wxSplit(s, ':');
-                                            if (ss[0] != "none") return true;
-                                        }
-                                    }
-                                }
+                                s = as[3];
                             }
+                            else
+                            {
+                                s = as[4];
+                            }
+                            wxArrayString ss = wxSplit(s, ':');
+                            if (ss[0] != "none") return true;
                         }
                     }
                 }
@@ -3875,157 +3942,139 @@ std::string LPEParseEffectSettings(const wxString& effectType, const wxArrayStri
     return settings;
 }
 
-void MapLPE(const EffectManager& effect_manager, int i, EffectLayer* layer, const wxXmlDocument& input_xml, const wxString& model, bool left, int frequency, bool eraseExisting)
+void MapLPE(const EffectManager& effect_manager, int i, EffectLayer* layer, const LPEProps& props, const wxString& model, bool left, int frequency, bool eraseExisting)
 {
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
 
     if (eraseExisting) layer->DeleteAllEffects();
 
-    for (wxXmlNode* e = input_xml.GetRoot()->GetChildren(); e != nullptr; e = e->GetNext()) {
-        if (e->GetName() == "SequenceProps" || e->GetName() == "ArchivedProps") {
-            for (wxXmlNode* prop = e->GetChildren(); prop != nullptr; prop = prop->GetNext()) {
-                if (prop->GetName() == "SeqProp" || prop->GetName() == "ArchiveProp") {
-                    std::string name = prop->GetAttribute("name").ToStdString();
-                    if (name == "")
+    auto it = props.find(model.ToStdString());
+    if (it == props.end()) return;
+
+    wxXmlNode* prop = it->second.front();
+    for (wxXmlNode* track = prop->GetChildren(); track != nullptr; track = track->GetNext())
+    {
+        int id = wxAtoi(track->GetAttribute("id"));
+        if (id == i)
+        {
+            // now to add effects
+            for (wxXmlNode* effect = track->GetChildren(); effect != nullptr; effect = effect->GetNext())
+            {
+                wxString type = effect->GetAttribute("type");
+
+                if (effect->GetName() != "effect" || type != "pixelEffect")
+                {
+                    logger_base.warn("LPE import node %s type %s not known.", (const char *)effect->GetName().c_str(), (const char *)type.c_str());
+                }
+                else
+                {
+                    int startCentisecond = wxAtoi(effect->GetAttribute("startCentisecond"));
+                    int endCentisecond = wxAtoi(effect->GetAttribute("endCentisecond"));
+                    int startIntensity = wxAtoi(effect->GetAttribute("startIntensity", "100"));
+                    int endIntensity = wxAtoi(effect->GetAttribute("endIntensity", "100"));
+                    wxString settings = effect->GetAttribute("pixelEffect", "");
+                    wxArrayString settingsArray = wxSplit(settings, '|');
+                    wxString sideSettings;
+                    if (left)
                     {
-                        for (wxXmlNode* ap = prop->GetChildren(); ap != nullptr; ap = ap->GetNext()) {
-                            if (ap->GetName() == "PropClass")
-                            {
-                                name = ap->GetAttribute("Name");
-                            }
+                        if (settingsArray.size() == 7)
+                        {
+                            sideSettings = settingsArray[5];
+                        }
+                        else
+                        {
+                            sideSettings = settingsArray[3];
                         }
                     }
-                    if (name == model)
+                    else
                     {
-                        for (wxXmlNode* track = prop->GetChildren(); track != nullptr; track = track->GetNext())
+                        if (settingsArray.size() == 7)
                         {
-                            int id = wxAtoi(track->GetAttribute("id"));
-                            if (id == i)
+                            sideSettings = settingsArray[6];
+                        }
+                        else
+                        {
+                            sideSettings = settingsArray[4];
+                        }
+                    }
+                    wxArrayString effSettings = wxSplit(sideSettings, ':');
+                    wxString effectType = effSettings[0];
+                    if (effectType == "none")
+                    {
+                        // nothing to do
+                    }
+                    else
+                    {
+                        wxString ourEffectType = MapLPEEffectType(effectType);
+
+                        if (ourEffectType == "")
+                        {
+                            logger_base.warn("LPE import effect %s not known.", (const char *)effectType.c_str());
+                        }
+                        else
+                        {
+                            // skip over the multiple nodes PE creates when fading isnt perfectly even
+                            int fadeInCS, fadeOutCS;
+                            wxXmlNode* lastnode = FindLastLPEEffectNode(effect, startCentisecond, endCentisecond, endIntensity, endIntensity - startIntensity, settings, fadeInCS, fadeOutCS);
+                            if (lastnode != effect)
+                            {
+                                endCentisecond = wxAtoi(lastnode->GetAttribute("endCentisecond"));
+                                endIntensity = wxAtoi(lastnode->GetAttribute("endIntensity", "100"));
+                                effect = lastnode;
+                            }
+
+                            // only create effect if there is nothing there
+                            if (!layer->HasEffectsInTimeRange(TimeLine::RoundToMultipleOfPeriod(startCentisecond * 10, frequency), TimeLine::RoundToMultipleOfPeriod(endCentisecond * 10, frequency)))
                             {
-                                // now to add effects
-                                for (wxXmlNode* effect = track->GetChildren(); effect != nullptr; effect = effect->GetNext())
+                                wxString blend = MapLPEBlend(settingsArray[0], left);
+                                int blendPos = wxAtoi(settingsArray[1]);
+                                int sparkle = wxAtoi(settingsArray[2]);
+
+                                // now we need to create the effect
+                                std::string newpalette = ExtractLPEPallette(effSettings);
+                                std::string newsettings = "T_CHOICE_LayerMethod=" + blend;
+
+                                if (sparkle > 0)
                                 {
-                                    wxString type = effect->GetAttribute("type");
+                                    newpalette += ",C_SLIDER_SparkleFrequency=" + wxString::Format("%d", sparkle);
+                                }
+                                if (left && blendPos > 0)
+                                {
+                                    newsettings += ",T_SLIDER_EffectLayerMix=" + wxString::Format("%d", blendPos);
+                                }
 
-                                    if (effect->GetName() != "effect" || type != "pixelEffect")
+                                if (startIntensity == 100 && endIntensity == 100 && fadeInCS == 0 && fadeOutCS == 0)
+                                {
+                                    // dont need to do anything
+                                }
+                                else if (startIntensity == endIntensity && fadeInCS == 0 && fadeOutCS == 0)
+                                {
+                                    // need to set brightness
+                                    newpalette += ",C_SLIDER_Brightness=" + wxString::Format("%d", startIntensity);
+                                }
+                                else
+                                {
+                                    // need to set a brightness value curve
+                                    if (fadeInCS > 0)
                                     {
-                                        logger_base.warn("LPE import node %s type %s not known.", (const char *)effect->GetName().c_str(), (const char *)type.c_str());
+                                        newsettings += ",T_TEXTCTRL_Fadein=" + wxString::Format("%.2f", (float)(fadeInCS - startCentisecond) / 100.0);
                                     }
-                                    else
+                                    if (fadeOutCS > 0)
                                     {
-                                        int startCentisecond = wxAtoi(effect->GetAttribute("startCentisecond"));
-                                        int endCentisecond = wxAtoi(effect->GetAttribute("endCentisecond"));
-                                        int startIntensity = wxAtoi(effect->GetAttribute("startIntensity", "100"));
-                                        int endIntensity = wxAtoi(effect->GetAttribute("endIntensity", "100"));
-                                        wxString settings = effect->GetAttribute("pixelEffect", "");
-                                        wxArrayString settingsArray = wxSplit(settings, '|');
-                                        wxString sideSettings;
-                                        if (left)
-                                        {
-                                            if (settingsArray.size() == 7)
-                                            {
-                                                sideSettings = settingsArray[5];
-                                            }
-                                            else
-                                            {
-                                                sideSettings = settingsArray[3];
-                                            }
-                                        }
-                                        else
-                                        {
-                                            if (settingsArray.size() == 7)
-                                            {
-                                                sideSettings = settingsArray[6];
-                                            }
-                                            else
-                                            {
-                                                sideSettings = settingsArray[4];
-                                            }
-                                        }
-                                        wxArrayString effSettings = wxSplit(sideSettings, ':');
-                                        wxString effectType = effSettings[0];
-                                        if (effectType == "none")
-                                        {
-                                            // nothing to do
-                                        }
-                                        else
-                                        {
-                                            wxString ourEffectType = MapLPEEffectType(effectType);
-
-                                            if (ourEffectType == "")
-                                            {
-                                                logger_base.warn("LPE import effect %s not known.", (const char *)effectType.c_str());
-                                            }
-                                            else
-                                            {
-                                                // skip over the multiple nodes PE creates when fading isnt perfectly even
-                                                int fadeInCS, fadeOutCS;
-                                                wxXmlNode* lastnode = FindLastLPEEffectNode(effect, startCentisecond, endCentisecond, endIntensity, endIntensity - startIntensity, settings, fadeInCS, fadeOutCS);
-                                                if (lastnode != effect)
-                                                {
-                                                    endCentisecond = wxAtoi(lastnode->GetAttribute("endCentisecond"));
-                                                    endIntensity = wxAtoi(lastnode->GetAttribute("endIntensity", "100"));
-                                                    effect = lastnode;
-                                                }
+                                        newsettings += ",T_TEXTCTRL_Fadeout=" + wxString::Format("%.2f", (float)(endCentisecond - fadeOutCS) / 100.0);
+                                    }
 
-                                                // only create effect if there is nothing there
-                                                if (!layer->HasEffectsInTimeRange(TimeLine::RoundToMultipleOfPeriod(startCentisecond * 10, frequency), TimeLine::RoundToMultipleOfPeriod(endCentisecond * 10, frequency)))
-                                                {
-                                                    wxString blend = MapLPEBlend(settingsArray[0], left);
-                                                    int blendPos = wxAtoi(settingsArray[1]);
-                                                    int sparkle = wxAtoi(settingsArray[2]);
-
-                                                    // now we need to create the effect
-                                                    std::string newpalette = ExtractLPEPallette(effSettings);
-                                                    std::string newsettings = "T_CHOICE_LayerMethod=" + blend;
-
-                                                    if (sparkle > 0)
-                                                    {
-                                                        newpalette += ",C_SLIDER_SparkleFrequency=" + wxString::Format("%d", sparkle);
-                                                    }
-                                                    if (left && blendPos > 0)
-                                                    {
-                                                        newsettings += ",T_SLIDER_EffectLayerMix=" + wxString::Format("%d", blendPos);
-                                                    }
-
-                                                    if (startIntensity == 100 && endIntensity == 100 && fadeInCS == 0 && fadeOutCS == 0)
-                                                    {
-                                                        // dont need to do anything
-                                                    }
-                                                    else if (startIntensity == endIntensity && fadeInCS == 0 && fadeOutCS == 0)
-                                                    {
-                                                        // need to set brightness
-                                                        newpalette += ",C_SLIDER_Brightness=" + wxString::Format("%d", startIntensity);
-                                                    }
-                                                    else
-                                                    {
-                                                        // need to set a brightness value curve
-                                                        if (fadeInCS > 0)
-                                                        {
-                                                            newsettings += ",T_TEXTCTRL_Fadein=" + wxString::Format("%.2f", (float)(fadeInCS - startCentisecond) / 100.0);
-                                                        }
-                                                        if (fadeOutCS > 0)
-                                                        {
-                                                            newsettings += ",T_TEXTCTRL_Fadeout=" + wxString::Format("%.2f", (float)(endCentisecond - fadeOutCS) / 100.0);
-                                                        }
-
-                                                        if (fadeInCS == 0 && fadeOutCS == 0)
-                                                        {
-                                                            newpalette += ",C_VALUECURVE_Brightness=Active=TRUE|Id=ID_VALUECURVE_Brightness|Type=Ramp|Min=0.00|Max=400.00|P1=" + wxString::Format("%d", startIntensity) + "|P2=" + wxString::Format("%d", endIntensity) + "|RV=TRUE|";
-                                                        }
-                                                    }
-
-                                                    newsettings += LPEParseEffectSettings(effectType, effSettings, newpalette, (endCentisecond - startCentisecond) * 10);
-
-                                                    layer->AddEffect(0, ourEffectType, newsettings, newpalette, TimeLine::RoundToMultipleOfPeriod(startCentisecond * 10, frequency), TimeLine::RoundToMultipleOfPeriod(endCentisecond * 10, frequency), false, false);
-                                                }
-                                            }
-                                        }
+                                    if (fadeInCS == 0 && fadeOutCS == 0)
+                                    {
+                                        newpalette += ",C_VALUECURVE_Brightness=Active=TRUE|Id=ID_VALUECURVE_Brightness|Type=Ramp|Min=0.00|Max=400.00|P1=" + wxString::Format("%d", startIntensity) + "|P2=" + wxString::Format("%d", endIntensity) + "|RV=TRUE|";
                                     }
                                 }
+
+                                newsettings += LPEParseEffectSettings(effectType, effSettings, newpalette, (endCentisecond - startCentisecond) * 10);
+
+                                layer->AddEffect(0, ourEffectType, newsettings, newpalette, TimeLine::RoundToMultipleOfPeriod(startCentisecond * 10, frequency), TimeLine::RoundToMultipleOfPeriod(endCentisecond * 10, frequency), false, false);
                             }
                         }
-                        return;
                     }
                 }
             }
@@ -4033,18 +4082,18 @@ void MapLPE(const EffectManager& effect_manager, int i, EffectLayer* layer, cons
     }
 }
 
-void MapLPEEffects(const EffectManager& effectManager, Element* model, const wxXmlDocument& input_xml, const wxString& mapping, int frequency, bool eraseExisting)
+void MapLPEEffects(const EffectManager& effectManager, Element* model, const LPEProps& props, const wxString& mapping, int frequency, bool eraseExisting)
 {
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
 
     int layer = 0;
-    if (LPEHasEffects(input_xml, mapping, 0, true))
+    if (LPEHasEffects(props, mapping, 0, true))
     {
         logger_base.debug("Creating effects on model %s layer %d from %s layer 0 left hand side",
             (const char *)model->GetFullName().c_str(), layer + 1, (const char *)mapping.c_str());
-        MapLPE(effectManager, 0, model->GetEffectLayer(layer), input_xml, mapping, true, frequency, eraseExisting);
+        MapLPE(effectManager, 0, model->GetEffectLayer(layer), props, mapping, true, frequency, eraseExisting);
     }
-    if (LPEHasEffects(input_xml, mapping, 0, false))
+    if (LPEHasEffects(props, mapping, 0, false))
     {
         layer++;
         if (model->GetEffectLayerCount() < layer + 1)
@@ -4053,9 +4102,9 @@ void MapLPEEffects(const EffectManager& effectManager, Element* model, const wxX
         }
         logger_base.debug("Creating effects on model %s layer %d from %s layer 0 right hand side",
             (const char *)model->GetFullName().c_str(), layer + 1, (const char *)mapping.c_str());
-        MapLPE(effectManager, 0, model->GetEffectLayer(layer), input_xml, mapping, false, frequency, eraseExisting);
+        MapLPE(effectManager, 0, model->GetEffectLayer(layer), props, mapping, false, frequency, eraseExisting);
     }
-    if (LPEHasEffects(input_xml, mapping, 1, true))
+    if (LPEHasEffects(props, mapping, 1, true))
     {
         layer++;
         if (model->GetEffectLayerCount() < layer + 1)
@@ -4064,9 +4113,9 @@ void MapLPEEffects(const EffectManager& effectManager, Element* model, const wxX
         }
         logger_base.debug("Creating effects on model %s layer %d from %s layer 1 left hand side",
             (const char *)model->GetFullName().c_str(), layer + 1, (const char *)mapping.c_str());
-        MapLPE(effectManager, 1, model->GetEffectLayer(layer), input_xml, mapping, true, frequency, eraseExisting);
+        MapLPE(effectManager, 1, model->GetEffectLayer(layer), props, mapping, true, frequency, eraseExisting);
     }
-    if (LPEHasEffects(input_xml, mapping, 1, false))
+    if (LPEHasEffects(props, mapping, 1, false))
     {
         layer++;
         if (model->GetEffectLayerCount() < layer + 1)
@@ -4075,7 +4124,7 @@ void MapLPEEffects(const EffectManager& effectManager, Element* model, const wxX
         }
         logger_base.debug("Creating effects on model %s layer %d from %s layer 1 right hand side",
             (const char *)model->GetFullName().c_str(), layer + 1, (const char *)mapping.c_str());
-        MapLPE(effectManager, 1, model->GetEffectLayer(layer), input_xml, mapping, false, frequency, eraseExisting);
+        MapLPE(effectManager, 1, model->GetEffectLayer(layer), props, mapping, false, frequency, eraseExisting);
     }
 }
 
@@ -4575,6 +4624,7 @@ bool xLightsFrame::ImportLPE(wxXmlDocument &input_xml, const wxFileName &filenam
     dlg.xlights = this;
     std::vector<std::string> timingTrackNames;
     std::map<std::string, wxXmlNode*> timingTracks;
+    LPEProps props;
 
     for (wxXmlNode* e = input_xml.GetRoot()->GetChildren(); e != nullptr; e = e->GetNext()) {
         if (e->GetName() == "SequenceProps" || e->GetName() == "ArchivedProps") {
@@ -4592,6 +4642,7 @@ bool xLightsFrame::ImportLPE(wxXmlDocument &input_xml, const wxFileName &filenam
                     }
                     dlg.channelNames.push_back(name);
                     dlg.channelColors[name] = xlBLACK;
+                    props[name].push_back(prop);
                 }
             }
         }
@@ -4636,7 +4687,7 @@ bool xLightsFrame::ImportLPE(wxXmlDocument &input_xml, const wxFileName &filenam
             }
             else
             {
-                MapLPEEffects(effectManager, model, input_xml, m->_mapping, CurrentSeqXmlFile->GetFrequency(), dlg.CheckBox_EraseExistingEffects->GetValue());
+                MapLPEEffects(effectManager, model, props, m->_mapping, CurrentSeqXmlFile->GetFrequency(), dlg.CheckBox_EraseExistingEffects->GetValue());
             }
         }
 
@@ -4657,7 +4708,7 @@ bool xLightsFrame::ImportLPE(wxXmlDocument &input_xml, const wxFileName &filenam
                 {
                         SubModelElement *ste = model->GetSubModel(str);
                         if (ste != nullptr) {
-                            MapLPEEffects(effectManager, ste, input_xml, s->_mapping, CurrentSeqXmlFile->GetFrequency(), dlg.CheckBox_EraseExistingEffects->GetValue());
+                            MapLPEEffects(effectManager, ste, props, s->_mapping, CurrentSeqXmlFile->GetFrequency(), dlg.CheckBox_EraseExistingEffects->GetValue());
                         }
                 }
             }
@@ -4678,7 +4729,7 @@ bool xLightsFrame::ImportLPE(wxXmlDocument &input_xml, const wxFileName &filenam
                         if (stre != nullptr) {
                             NodeLayer *nl = stre->GetNodeLayer(n, true);
                             if (nl != nullptr) {
-                                MapLPE(effectManager, 0, nl, input_xml, ns->_mapping, true, CurrentSeqXmlFile->GetFrequency(), dlg.CheckBox_EraseExistingEffects->GetValue());
+                                MapLPE(effectManager, 0, nl, props, ns->_mapping, true, CurrentSeqXmlFile->GetFrequency(), dlg.CheckBox_EraseExistingEffects->GetValue());
                             }
                         }
                     }
@@ -5907,8 +5958,117 @@ void AddLSPEffect(EffectLayer *layer, int pos, int epos, int in, int out, int ef
     layer->AddEffect(0, effect, settings, palette, start_time, end_time, false, false);
 }
 
-void MapLSPEffects(EffectLayer *layer, wxXmlNode *node, const wxColor &c) {
-    if (node == nullptr) {
+// What an LSP import needs from each controller file in the zip. They are read with the pull parser
+// keeping only the channel names and their intervals rather than a document per controller.
+struct LSPInterval {
+    int eff;
+    int pos;
+    int in;
+    int out;
+    int bst;
+    int ben;
+};
+
+struct LSPChannel {
+    std::string name;
+    std::vector<LSPInterval> intervals; // every track's intervals in file order
+};
+
+struct LSPController {
+    std::string id = "1";
+    std::vector<LSPChannel> channels;
+};
+
+static int GetAttrInt(SP_XmlStartTagEvent* event, const char* name, int def) {
+    const char* value = event->getAttrValue(name);
+    return value == nullptr ? def : wxAtoi(value);
+}
+
+static bool LoadLSPController(wxInputStream& in, LSPController& controller) {
+    SP_XmlPullParser *parser = new SP_XmlPullParser();
+    parser->setMaxTextSize(MAX_READ_BLOCK_SIZE / 2);
+    char *bytes = new char[MAX_READ_BLOCK_SIZE];
+    in.Read(bytes, MAX_READ_BLOCK_SIZE);
+    parser->append(bytes, in.LastRead());
+
+    std::vector<std::string> context;
+    LSPChannel* channel = nullptr;
+    bool ok = false;
+
+    SP_XmlPullEvent * event = parser->getNext();
+    bool done = false;
+    while (!done) {
+        if (!event) {
+            size_t read = 0;
+            if (!in.Eof()) {
+                in.Read(bytes, MAX_READ_BLOCK_SIZE);
+                read = in.LastRead();
+            }
+            if (read == 0) {
+                done = true;
+            }
+            else {
+                parser->append(bytes, read);
+            }
+        }
+        else {
+            switch (event->getEventType()) {
+            case SP_XmlPullEvent::eEndDocument:
+                ok = true;
+                done = true;
+                break;
+            case SP_XmlPullEvent::eStartTag:
+            {
+                SP_XmlStartTagEvent * stagEvent = (SP_XmlStartTagEvent*)event;
+                std::string nodeName = stagEvent->getName();
+                context.push_back(nodeName);
+                size_t depth = context.size();
+
+                if (depth == 3 && context[1] == "Channels" && nodeName == "Channel") {
+                    controller.channels.emplace_back();
+                    channel = &controller.channels.back();
+                }
+                else if (depth == 7 && channel != nullptr && nodeName == "TimeInterval"
+                         && context[3] == "Tracks" && context[4] == "Track" && context[5] == "Intervals") {
+                    channel->intervals.push_back({ GetAttrInt(stagEvent, "eff", 4), GetAttrInt(stagEvent, "pos", 1),
+                                                   GetAttrInt(stagEvent, "in", 1), GetAttrInt(stagEvent, "out", 1),
+                                                   GetAttrInt(stagEvent, "bst", 0), GetAttrInt(stagEvent, "ben", 0) });
+                }
+            }
+            break;
+            case SP_XmlPullEvent::eCData:
+            {
+                SP_XmlCDataEvent * stagEvent = (SP_XmlCDataEvent*)event;
+                if (context.size() == 2 && context[1] == "ControllerName") {
+                    controller.id = stagEvent->getText();
+                }
+                else if (context.size() == 6 && channel != nullptr && context[3] == "Tracks" && context[4] == "Track" && context[5] == "Name") {
+                    channel->name = stagEvent->getText();
+                }
+            }
+            break;
+            case SP_XmlPullEvent::eEndTag:
+                if (context.size() == 3) {
+                    channel = nullptr;
+                }
+                if (!context.empty()) {
+                    context.pop_back();
+                }
+                break;
+            }
+            delete event;
+        }
+        if (!done) {
+            event = parser->getNext();
+        }
+    }
+    delete[] bytes;
+    delete parser;
+    return ok;
+}
+
+void MapLSPEffects(EffectLayer *layer, const LSPChannel *channel, const wxColor &c) {
+    if (channel == nullptr) {
         return;
     }
     int eff = -1;
@@ -5916,52 +6076,33 @@ void MapLSPEffects(EffectLayer *layer, wxXmlNode *node, const wxColor &c) {
 
     int bst = 0, ben = 0;
 
-
-    for (wxXmlNode *cnd = node->GetChildren(); cnd != nullptr; cnd = cnd->GetNext()) {
-        if (cnd->GetName() == "Tracks") {
-            for (wxXmlNode *cnnd = cnd->GetChildren(); cnnd != nullptr; cnnd = cnnd->GetNext()) {
-                if (cnnd->GetName() == "Track") {
-                    for (wxXmlNode *ind = cnnd->GetChildren(); ind != nullptr; ind = ind->GetNext()) {
-                        if (ind->GetName() == "Intervals") {
-                            for (wxXmlNode *ti = ind->GetChildren(); ti != nullptr; ti = ti->GetNext()) {
-                                if (ti->GetName() == "TimeInterval") {
-                                    int neff = wxAtoi(ti->GetAttribute("eff", "4"));
-                                    if (eff != -1 && neff != 7) {
-                                        int npos = wxAtoi(ti->GetAttribute("pos", "1"));
-                                        AddLSPEffect(layer, pos, npos, in, out, eff, c, bst, ben);
-                                    }
-                                    if (neff != 7) {
-                                        pos = wxAtoi(ti->GetAttribute("pos", "1"));
-                                        eff = neff;
-                                        in = wxAtoi(ti->GetAttribute("in", "1"));
-                                        out = wxAtoi(ti->GetAttribute("out", "1"));
-                                        bst = wxAtoi(ti->GetAttribute("bst", "0"));
-                                        ben = wxAtoi(ti->GetAttribute("ben", "0"));
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
+    for (const auto& ti : channel->intervals) {
+        int neff = ti.eff;
+        if (eff != -1 && neff != 7) {
+            AddLSPEffect(layer, pos, ti.pos, in, out, eff, c, bst, ben);
+        }
+        if (neff != 7) {
+            pos = ti.pos;
+            eff = neff;
+            in = ti.in;
+            out = ti.out;
+            bst = ti.bst;
+            ben = ti.ben;
         }
     }
 }
 
-void MapLSPStrand(StrandElement *layer, wxXmlNode *node, const wxColor &c) {
+void MapLSPStrand(StrandElement *layer, const LSPController *controller, const wxColor &c) {
+    if (controller == nullptr) {
+        return;
+    }
     int nodeNum = 0;
-    for (wxXmlNode *nd = node->GetChildren(); nd != nullptr; nd = nd->GetNext()) {
-        if (nd->GetName() == "Channels") {
-            for (wxXmlNode *cnd = nd->GetChildren(); cnd != nullptr; cnd = cnd->GetNext()) {
-                if (cnd->GetName() == "Channel") {
-                    EffectLayer *el = layer->GetNodeLayer(nodeNum, true);
-                    MapLSPEffects(el, cnd, c);
-                    nodeNum++;
-                    if (nodeNum >= layer->GetNodeLayerCount()) {
-                        return;
-                    }
-                }
-            }
+    for (const auto& channel : controller->channels) {
+        EffectLayer *el = layer->GetNodeLayer(nodeNum, true);
+        MapLSPEffects(el, &channel, c);
+        nodeNum++;
+        if (nodeNum >= layer->GetNodeLayerCount()) {
+            return;
         }
     }
 }
@@ -5981,59 +6122,32 @@ void xLightsFrame::ImportLSP(const wxFileName &filename) {
     wxZipEntry *ent = zin.GetNextEntry();
 
 
-    wxXmlDocument seq_xml;
-    std::map<wxString, wxXmlDocument> cont_xml;
-    std::map<wxString, wxXmlNode *> nodes;
-    std::map<wxString, wxXmlNode *> strandNodes;
+    std::list<LSPController> controllers;
+    std::map<wxString, const LSPChannel *> nodes;
+    std::map<wxString, const LSPController *> strandNodes;
 
     while (ent != nullptr) {
-        if (ent->GetName() == "Sequence") {
-            seq_xml.Load(zin);
-        }
-        else {
-            std::string id("1");
-            wxXmlDocument &doc = cont_xml[ent->GetName()];
-
-            if (doc.Load(zin)) {
-                for (wxXmlNode *nd = doc.GetRoot()->GetChildren(); nd != nullptr; nd = nd->GetNext()) {
-                    if (nd->GetName() == "ControllerName") {
-                        id = nd->GetChildren()->GetContent();
-                    }
-                }
-                strandNodes[id] = doc.GetRoot();
-                dlg.ccrNames.push_back(id);
-                for (wxXmlNode *nd = doc.GetRoot()->GetChildren(); nd != nullptr; nd = nd->GetNext()) {
-                    if (nd->GetName() == "Channels") {
-                        for (wxXmlNode *cnd = nd->GetChildren(); cnd != nullptr; cnd = cnd->GetNext()) {
-                            if (cnd->GetName() == "Channel") {
-                                std::string cname;
-                                for (wxXmlNode *cnnd = cnd->GetChildren(); cnnd != nullptr; cnnd = cnnd->GetNext()) {
-                                    if (cnnd->GetName() == "Tracks") {
-                                        for (wxXmlNode *tnd = cnnd->GetChildren(); tnd != nullptr; tnd = tnd->GetNext()) {
-                                            if (tnd->GetName() == "Track") {
-                                                for (wxXmlNode *tnd2 = tnd->GetChildren(); tnd2 != nullptr; tnd2 = tnd2->GetNext()) {
-                                                    if (tnd2->GetName() == "Name") {
-                                                        cname = tnd2->GetChildren()->GetContent();
-                                                    }
-                                                }
-                                            }
-                                        }
-                                    }
-                                }
-                                cname = id + "/" + cname;
-                                nodes[cname] = cnd;
-                                dlg.channelNames.push_back(cname);
-                                dlg.channelColors[cname] = xlWHITE;
-                            }
-                        }
-                    }
+        // the Sequence entry isnt used by the import so it is skipped rather than parsed
+        if (ent->GetName() != "Sequence") {
+            controllers.emplace_back();
+            LSPController &controller = controllers.back();
+            if (LoadLSPController(zin, controller)) {
+                strandNodes[controller.id] = &controller;
+                dlg.ccrNames.push_back(controller.id);
+                for (const auto& channel : controller.channels) {
+                    std::string cname = controller.id + "/" + channel.name;
+                    nodes[cname] = &channel;
+                    dlg.channelNames.push_back(cname);
+                    dlg.channelColors[cname] = xlWHITE;
                 }
             }
             else {
                 logger_base.warn("Could not parse XML file %s.", (const char *)ent->GetName().c_str());
                 wxLogError("Could not parse XML file %s", ent->GetName().c_str());
+                controllers.pop_back();
             }
         }
+        delete ent;
         ent = zin.GetNextEntry();
     }
 
@@ -27,6 +27,7 @@
 #endif
 
 const unsigned char FrameData::_constzero = 0;
+std::atomic_uint SequenceData::__nextSerial(1);
 
 SequenceData::SequenceData() : _invalidFrame()
 {
@@ -65,6 +66,11 @@ void SequenceData::Cleanup()
         }
     }
     _dataBlocks.clear();
+    _changeCounts.reset();
+    _changedBlocks.clear();
+    _changedBlocksCounts.clear();
+    _numBlocks = 0;
+    _blockWords = 0;
     _invalidFrame._numChannels = 0;
     free(_invalidFrame._data);
     _invalidFrame._data = nullptr;
@@ -201,6 +207,7 @@ void SequenceData::init(unsigned int numChannels, unsigned int numFrames, unsign
 {
     static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
     Cleanup();
+    _serial = __nextSerial++;
     _hugePagesFailed = false;
     if (roundto4) {
         _numChannels = roundTo4(numChannels);
@@ -227,6 +234,16 @@ void SequenceData::init(unsigned int numChannels, unsigned int numFrames, unsign
             sizeRemaining -= _bytesPerFrame;
             blockSize -= _bytesPerFrame;
         }
+
+        _changeCounts = std::make_unique<std::atomic_uint[]>(numFrames);
+        for (unsigned int frame = 0; frame < numFrames; ++frame) {
+            _changeCounts[frame] = 1;
+        }
+        _numBlocks = (_numChannels + CHANGE_BLOCK_SIZE - 1) / CHANGE_BLOCK_SIZE;
+        _blockWords = (_numBlocks + 63) / 64;
+        // counts of 0 never match so every bitmap starts out stale
+        _changedBlocksCounts.resize(numFrames, { 0, 0 });
+        _changedBlocks.resize((size_t)numFrames * _blockWords);
     }
     else {
         logger_base.debug("Sequence memory released.");
@@ -235,6 +252,53 @@ void SequenceData::init(unsigned int numChannels, unsigned int numFrames, unsign
     _invalidFrame._numChannels = _numChannels;
 }
 
+unsigned int SequenceData::ForEachChangedRange(unsigned int frame, const std::function<void(unsigned int, unsigned int)>& f)
+{
+    if (frame >= _numFrames) return 0;
+
+    if (frame == 0) {
+        f(0, _numChannels);
+        return _numChannels;
+    }
+
+    std::unique_lock<std::mutex> lock(_changedBlocksLock);
+    uint64_t* bits = &_changedBlocks[(size_t)frame * _blockWords];
+    // read the counts before comparing so a write that races the compare leaves the bitmap stale
+    std::pair<unsigned int, unsigned int> counts = { _changeCounts[frame].load(), _changeCounts[frame - 1].load() };
+    if (_changedBlocksCounts[frame] != counts) {
+        const unsigned char* cur = _frames[frame]._data;
+        const unsigned char* prev = _frames[frame - 1]._data;
+        memset(bits, 0x00, _blockWords * sizeof(uint64_t));
+        for (unsigned int b = 0; b < _numBlocks; ++b) {
+            unsigned int start = b * CHANGE_BLOCK_SIZE;
+            unsigned int len = std::min(CHANGE_BLOCK_SIZE, _numChannels - start);
+            if (memcmp(&cur[start], &prev[start], len) != 0) {
+                bits[b / 64] |= (uint64_t)1 << (b % 64);
+            }
+        }
+        _changedBlocksCounts[frame] = counts;
+    }
+
+    // hand out runs of consecutive changed blocks
+    unsigned int reported = 0;
+    unsigned int b = 0;
+    while (b < _numBlocks) {
+        if ((bits[b / 64] & ((uint64_t)1 << (b % 64))) == 0) {
+            ++b;
+            continue;
+        }
+        unsigned int first = b;
+        while (b < _numBlocks && (bits[b / 64] & ((uint64_t)1 << (b % 64))) != 0) {
+            ++b;
+        }
+        unsigned int start = first * CHANGE_BLOCK_SIZE;
+        unsigned int len = std::min(b * CHANGE_BLOCK_SIZE, _numChannels) - start;
+        f(start, len);
+        reported += len;
+    }
+    return reported;
+}
+
 // This encodes the sequence data grouped by channel
 wxString SequenceData::base64_encode()
 {
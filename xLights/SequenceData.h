@@ -11,7 +11,10 @@
  **************************************************************/
 
 #include <wx/wx.h>
+#include <atomic>
+#include <functional>
 #include <memory>
+#include <mutex>
 
 class FrameData {
     FrameData(const FrameData&) = delete;
@@ -79,6 +82,23 @@ class SequenceData {
     unsigned int _numFrames;
     unsigned int _frameTime;
 
+    // Change tracking. Every frame has a change count that is bumped whenever it may have been
+    // written. For each frame we cache a bitmap of the CHANGE_BLOCK_SIZE channel blocks that
+    // differ from the previous frame along with the change counts it was built from.
+    std::unique_ptr<std::atomic_uint[]> _changeCounts;
+    std::vector<uint64_t> _changedBlocks;
+    std::vector<std::pair<unsigned int, unsigned int>> _changedBlocksCounts;
+    unsigned int _serial = 0;
+    static std::atomic_uint __nextSerial;
+    unsigned int _numBlocks = 0;
+    unsigned int _blockWords = 0;
+    std::mutex _changedBlocksLock;
+
+    void TouchFrame(unsigned int frame) {
+        // not an atomic increment, this is on every non const frame access and any change in value is enough
+        _changeCounts[frame].store(_changeCounts[frame].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
     SequenceData(const SequenceData&) = delete;  //make sure we cannot "copy" these
     SequenceData &operator=(const SequenceData& rgb) = delete;
 
@@ -92,10 +112,14 @@ public:
     unsigned int TotalTime() const { return _numFrames * _frameTime; }
     bool OK(unsigned int frame, unsigned int channel) const { return frame < _numFrames && channel < _numChannels; }
     
+    static constexpr unsigned int CHANGE_BLOCK_SIZE = 512;
+
+    // non const access assumes the frame is about to be written
     FrameData &operator[](unsigned int frame) {
         if (frame >= _numFrames) {
             return _invalidFrame;
         }
+        TouchFrame(frame);
         return _frames[frame];
     }
     const FrameData &operator[](unsigned int frame) const {
@@ -104,6 +128,19 @@ public:
         }
         return _frames[frame];
     }
+    // read only access that leaves the change tracking alone
+    const FrameData &GetFrame(unsigned int frame) const { return (*this)[frame]; }
+
+    // call once a frame has been written through a pointer obtained before the write started
+    void FrameChanged(unsigned int frame) {
+        if (frame < _numFrames) _changeCounts[frame]++;
+    }
+    // changes every time init is called
+    unsigned int GetSerial() const { return _serial; }
+    unsigned int GetChangeCount(unsigned int frame) const { return frame < _numFrames ? _changeCounts[frame].load() : 0; }
+    // calls f(startChannel, count) for each run of channels in frame that differs from frame - 1
+    // returns the number of channels reported
+    unsigned int ForEachChangedRange(unsigned int frame, const std::function<void(unsigned int, unsigned int)>& f);
     
     unsigned int NumChannels() const { return _numChannels;}
     unsigned int NumFrames() const { return _numFrames;}
@@ -0,0 +1,234 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <map>
+#include <set>
+
+#include <wx/filename.h>
+
+#include "xLightsMain.h"
+#include "xLightsApp.h"
+#include "xLightsXmlFile.h"
+#include "sequencer/SequenceElements.h"
+#include "sequencer/Element.h"
+#include "sequencer/EffectLayer.h"
+#include "sequencer/Effect.h"
+
+#include <log4cpp/Category.hh>
+
+// Loads each sequence with the streaming loader and with the whole document loader, then saves it and loads
+// the copy, checking the elements, layers and effects come out the same each time.
+
+static bool CompareLayer(const std::string& where, EffectLayer* a, EffectLayer* b, std::string& diff)
+{
+    int ca = a == nullptr ? 0 : a->GetEffectCount();
+    int cb = b == nullptr ? 0 : b->GetEffectCount();
+    if (ca != cb) {
+        diff = wxString::Format("%s has %d effects vs %d", where, ca, cb).ToStdString();
+        return false;
+    }
+    for (int i = 0; i < ca; i++) {
+        Effect* ea = a->GetEffect(i);
+        Effect* eb = b->GetEffect(i);
+        if (ea->GetEffectName() != eb->GetEffectName() ||
+            ea->GetStartTimeMS() != eb->GetStartTimeMS() ||
+            ea->GetEndTimeMS() != eb->GetEndTimeMS() ||
+            ea->GetID() != eb->GetID() ||
+            ea->GetProtected() != eb->GetProtected() ||
+            ea->GetSettingsAsString() != eb->GetSettingsAsString() ||
+            ea->GetPaletteAsString() != eb->GetPaletteAsString()) {
+            diff = wxString::Format("%s effect %d (%s %d-%dms) differs", where, i, ea->GetEffectName(), ea->GetStartTimeMS(), ea->GetEndTimeMS()).ToStdString();
+            return false;
+        }
+    }
+    return true;
+}
+
+// strands and submodels don't save empty layers after their last used one
+static int UsedLayerCount(Element* el)
+{
+    if (el == nullptr) {
+        return 0;
+    }
+    int count = el->GetEffectLayerCount();
+    while (count > 0 && el->GetEffectLayer(count - 1)->GetEffectCount() == 0) {
+        count--;
+    }
+    return count;
+}
+
+static bool CompareLayers(const std::string& where, Element* a, Element* b, bool allLayers, std::string& diff)
+{
+    int ca = allLayers ? a->GetEffectLayerCount() : UsedLayerCount(a);
+    int cb = allLayers ? b->GetEffectLayerCount() : UsedLayerCount(b);
+    if (ca != cb) {
+        diff = wxString::Format("%s has %d layers vs %d", where, ca, cb).ToStdString();
+        return false;
+    }
+    for (int i = 0; i < ca; i++) {
+        if (!CompareLayer(where + " layer " + std::to_string(i + 1), a->GetEffectLayer(i), b->GetEffectLayer(i), diff)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static std::string SubModelKey(SubModelElement* se)
+{
+    StrandElement* strand = dynamic_cast<StrandElement*>(se);
+    if (strand != nullptr) {
+        return "Strand " + std::to_string(strand->GetStrand() + 1);
+    }
+    return se->GetName();
+}
+
+static bool CompareSubModel(const std::string& where, SubModelElement* a, SubModelElement* b, std::string& diff)
+{
+    if (!CompareLayers(where, a, b, false, diff)) {
+        return false;
+    }
+    StrandElement* sa = dynamic_cast<StrandElement*>(a);
+    StrandElement* sb = dynamic_cast<StrandElement*>(b);
+    int na = sa == nullptr ? 0 : sa->GetNodeLayerCount();
+    int nb = sb == nullptr ? 0 : sb->GetNodeLayerCount();
+    for (int n = 0; n < std::max(na, nb); n++) {
+        NodeLayer* la = n < na ? sa->GetNodeLayer(n) : nullptr;
+        NodeLayer* lb = n < nb ? sb->GetNodeLayer(n) : nullptr;
+        std::string nodeWhere = where + " node " + std::to_string(n + 1);
+        if (!CompareLayer(nodeWhere, la, lb, diff)) {
+            return false;
+        }
+        if (la != nullptr && lb != nullptr && la->GetEffectCount() != 0 && la->GetName() != lb->GetName()) {
+            diff = nodeWhere + " is named " + la->GetName() + " vs " + lb->GetName();
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool CompareElements(SequenceElements& a, SequenceElements& b, std::string& diff)
+{
+    if (a.GetElementCount() != b.GetElementCount()) {
+        diff = wxString::Format("%d elements vs %d", (int)a.GetElementCount(), (int)b.GetElementCount()).ToStdString();
+        return false;
+    }
+    for (size_t i = 0; i < a.GetElementCount(); i++) {
+        Element* ea = a.GetElement(i);
+        Element* eb = b.GetElement(i);
+        if (ea->GetName() != eb->GetName() || ea->GetType() != eb->GetType()) {
+            diff = "element " + std::to_string(i + 1) + " is " + ea->GetName() + " vs " + eb->GetName();
+            return false;
+        }
+        if (ea->GetType() == ElementType::ELEMENT_TYPE_TIMING &&
+            dynamic_cast<TimingElement*>(ea)->GetFixedTiming() != dynamic_cast<TimingElement*>(eb)->GetFixedTiming()) {
+            diff = ea->GetName() + " fixed timing differs";
+            return false;
+        }
+        if (!CompareLayers(ea->GetName(), ea, eb, true, diff)) {
+            return false;
+        }
+
+        ModelElement* ma = dynamic_cast<ModelElement*>(ea);
+        ModelElement* mb = dynamic_cast<ModelElement*>(eb);
+        if (ma == nullptr || mb == nullptr) {
+            continue;
+        }
+        // submodels are created as they are found so they are matched by name rather than position
+        std::map<std::string, SubModelElement*> bSubModels;
+        for (int s = 0; s < mb->GetSubModelAndStrandCount(); s++) {
+            bSubModels[SubModelKey(mb->GetSubModel(s))] = mb->GetSubModel(s);
+        }
+        std::set<std::string> compared;
+        for (int s = 0; s < ma->GetSubModelAndStrandCount(); s++) {
+            SubModelElement* sa = ma->GetSubModel(s);
+            std::string key = SubModelKey(sa);
+            auto sb = bSubModels.find(key);
+            compared.insert(key);
+            if (!CompareSubModel(ea->GetName() + "/" + key, sa, sb == bSubModels.end() ? nullptr : sb->second, diff)) {
+                return false;
+            }
+        }
+        for (const auto& it : bSubModels) {
+            if (compared.find(it.first) == compared.end() && !CompareSubModel(ea->GetName() + "/" + it.first, nullptr, it.second, diff)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static bool LoadForRoundTrip(xLightsFrame* frame, xLightsXmlFile& file, SequenceElements& elements, bool streamEffects)
+{
+    if (!file.Open(frame->GetShowDirectory(), true, streamEffects)) {
+        return false;
+    }
+    elements.SetFrequency(file.GetFrequency());
+    elements.SetViewsManager(frame->GetViewsManager()); // This must come first before LoadSequencerFile.
+    return elements.LoadSequencerFile(file, frame->GetShowDirectory());
+}
+
+static bool CheckRoundTrip(xLightsFrame* frame, const wxString& filename, std::string& diff)
+{
+    xLightsXmlFile streamed(filename);
+    SequenceElements streamedElements(frame);
+    xLightsXmlFile document(filename);
+    SequenceElements documentElements(frame);
+    if (!LoadForRoundTrip(frame, streamed, streamedElements, true) || !LoadForRoundTrip(frame, document, documentElements, false)) {
+        diff = "could not be loaded";
+        return false;
+    }
+    if (!CompareElements(streamedElements, documentElements, diff)) {
+        diff = "streaming vs document load: " + diff;
+        return false;
+    }
+
+    wxFileName saved(wxFileName::GetTempDir(), streamed.GetName() + "_roundtrip." + streamed.GetExt());
+    streamed.SetPath(saved.GetPath());
+    streamed.SetFullName(saved.GetFullName());
+    streamed.Save(streamedElements);
+
+    xLightsXmlFile reloaded(saved);
+    SequenceElements reloadedElements(frame);
+    bool ok = LoadForRoundTrip(frame, reloaded, reloadedElements, true);
+    wxRemoveFile(saved.GetFullPath());
+    if (!ok) {
+        diff = "saved copy could not be loaded";
+        return false;
+    }
+    if (!CompareElements(streamedElements, reloadedElements, diff)) {
+        diff = "save and reload: " + diff;
+        return false;
+    }
+    return true;
+}
+
+void xLightsFrame::CheckSequenceRoundTrip(const wxArrayString& files, bool exitOnDone)
+{
+    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    int failed = 0;
+    for (const auto& f : files) {
+        std::string diff;
+        if (CheckRoundTrip(this, f, diff)) {
+            printf("%s OK\n", (const char*)f.c_str());
+        }
+        else {
+            failed++;
+            printf("%s FAILED: %s\n", (const char*)f.c_str(), diff.c_str());
+            logger_base.warn("Round trip of %s failed: %s", (const char*)f.c_str(), diff.c_str());
+        }
+    }
+
+    logger_base.info("Round trip checked %d sequences, %d failed.", (int)files.size(), failed);
+    if (exitOnDone) {
+        xLightsApp::exitCode = failed ? 1 : 0;
+        Destroy();
+    }
+}
@@ -0,0 +1,374 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "SharedVideoReader.h"
+#include "VideoReader.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <wx/filename.h>
+
+#include <log4cpp/Category.hh>
+
+#pragma region SharedVideoReader
+SharedVideoReader::SharedVideoReader(const std::string& filename) : _filename(filename)
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    auto reader = OpenReader();
+    if (reader == nullptr) {
+        logger_base.warn("SharedVideoReader: Failed to open video file %s.", (const char*)filename.c_str());
+        return;
+    }
+
+    _valid = true;
+    _lengthMS = reader->GetLengthMS();
+    _frameMS = reader->GetFrameMS();
+    _width = reader->GetWidth();
+    _height = reader->GetHeight();
+    _decoders.push_back(std::make_shared<Decoder>());
+    _decoders.back()->_reader = std::move(reader);
+
+    // every frame is the same size so the byte cap is a frame count ... always keep the frame being drawn
+    // and only decode ahead as far as the rest of the ring allows
+    size_t frameSize = (size_t)_width * _height * 4;
+    _maxFrames = std::min((size_t)120, std::max((size_t)1, MAX_RING_BYTES / frameSize));
+    _decodeAheadFrames = std::min(DECODE_AHEAD_FRAMES, (int)_maxFrames - 1);
+
+    logger_base.debug("SharedVideoReader: Opened %s %dx%d keeping up to %d frames (%lu bytes), decoding %d ahead.",
+        (const char*)filename.c_str(), _width, _height, (int)_maxFrames, (unsigned long)(_maxFrames * frameSize), _decodeAheadFrames);
+
+    if (_decodeAheadFrames > 0) {
+        _decodeAhead = std::thread(&SharedVideoReader::DecodeAhead, this);
+    }
+}
+
+SharedVideoReader::~SharedVideoReader()
+{
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        _stop = true;
+    }
+    _signal.notify_all();
+    if (_decodeAhead.joinable()) {
+        _decodeAhead.join();
+    }
+}
+
+std::unique_ptr<VideoReader> SharedVideoReader::OpenReader() const
+{
+    // native resolution with alpha ... each consumer scales to its own size
+    auto reader = std::make_unique<VideoReader>(_filename, 100, 100, false, true, true);
+    if (!reader->IsValid() || reader->GetWidth() <= 0 || reader->GetHeight() <= 0) {
+        return nullptr;
+    }
+    return reader;
+}
+
+void SharedVideoReader::GetOutputSize(int maxwidth, int maxheight, bool keepaspectratio, int& width, int& height) const
+{
+    if (keepaspectratio && _width > 0 && _height > 0) {
+        float shrink = std::min((float)maxwidth / (float)_width, (float)maxheight / (float)_height);
+        width = (int)((float)_width * shrink);
+        height = (int)((float)_height * shrink);
+    }
+    else {
+        width = maxwidth;
+        height = maxheight;
+    }
+}
+
+std::shared_ptr<SharedVideoFrame> SharedVideoReader::GetFrame(int timestampMS)
+{
+    if (!IsValid() || timestampMS < 0 || timestampMS > _lengthMS) return nullptr;
+
+    int index = _frameMS > 0 ? timestampMS / _frameMS : timestampMS;
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        if (_endIndex >= 0 && index >= _endIndex) return nullptr;
+
+        _lastRequested = index;
+        auto it = _frames.find(index);
+        if (it != _frames.end()) {
+            it->second.second = ++_useCounter;
+            _signal.notify_one();
+            return it->second.first;
+        }
+    }
+
+    auto frame = Decode(index);
+    _signal.notify_one();
+    return frame;
+}
+
+bool SharedVideoReader::IsPastEnd(int timestampMS)
+{
+    if (timestampMS > _lengthMS) return true;
+
+    int index = _frameMS > 0 ? timestampMS / _frameMS : timestampMS;
+    std::unique_lock<std::mutex> lock(_lock);
+    return _endIndex >= 0 && index >= _endIndex;
+}
+
+// must be called holding the lock ... returns nullptr if a new decoder should be opened for the index
+std::shared_ptr<SharedVideoReader::Decoder> SharedVideoReader::ChooseDecoder(int index)
+{
+    // the decoder just behind the request ... it gets there without seeking
+    std::shared_ptr<Decoder> best;
+    for (const auto& it : _decoders) {
+        int position = it->_position;
+        if (position < 0 || (index >= position && index - position <= SEQUENTIAL_FRAMES)) {
+            if (best == nullptr || position > best->_position) {
+                best = it;
+            }
+        }
+    }
+    if (best != nullptr) return best;
+    if (_decoders.size() < MAX_DECODERS) return nullptr;
+
+    // all in use at other offsets ... the least recently used one has to seek
+    best = _decoders.front();
+    for (const auto& it : _decoders) {
+        if (it->_lastUsed < best->_lastUsed) {
+            best = it;
+        }
+    }
+    return best;
+}
+
+std::shared_ptr<SharedVideoFrame> SharedVideoReader::Decode(int index)
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    std::shared_ptr<Decoder> decoder;
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        decoder = ChooseDecoder(index);
+        if (decoder != nullptr) {
+            decoder->_lastUsed = ++_useCounter;
+        }
+    }
+
+    if (decoder == nullptr) {
+        // this request is somewhere none of the decoders are ... give it its own rather than drag one
+        // away from the effects it is serving
+        auto reader = OpenReader();
+        if (reader == nullptr) {
+            logger_base.warn("SharedVideoReader: Failed to open another decoder for %s.", (const char*)_filename.c_str());
+            return nullptr;
+        }
+        std::unique_lock<std::mutex> lock(_lock);
+        decoder = ChooseDecoder(index);
+        if (decoder == nullptr) {
+            decoder = std::make_shared<Decoder>();
+            decoder->_reader = std::move(reader);
+            _decoders.push_back(decoder);
+            logger_base.debug("SharedVideoReader: %s now has %d decoders.", (const char*)_filename.c_str(), (int)_decoders.size());
+        }
+        decoder->_lastUsed = ++_useCounter;
+    }
+
+    std::unique_lock<std::mutex> decodeLock(decoder->_lock);
+
+    {
+        // it may have been decoded while we waited for the reader
+        std::unique_lock<std::mutex> lock(_lock);
+        auto it = _frames.find(index);
+        if (it != _frames.end()) {
+            it->second.second = ++_useCounter;
+            return it->second.first;
+        }
+    }
+
+    int timestampMS = _frameMS > 0 ? index * _frameMS : index;
+    AVFrame* f = decoder->_reader->GetNextFrame(timestampMS);
+    if (f == nullptr || f->data[0] == nullptr) {
+        std::unique_lock<std::mutex> lock(_lock);
+        decoder->_position = index;
+        if (decoder->_reader->AtEnd()) {
+            if (_endIndex < 0 || index < _endIndex) {
+                _endIndex = index;
+            }
+        }
+        return nullptr;
+    }
+
+    // deep copy as the reader reuses its frames
+    auto frame = std::make_shared<SharedVideoFrame>();
+    frame->_timestampMS = timestampMS;
+    frame->_width = _width;
+    frame->_height = _height;
+    frame->_data.resize((size_t)_width * _height * 4);
+    int rowSize = _width * 4;
+    for (int y = 0; y < _height; y++) {
+        memcpy(frame->_data.data() + (size_t)y * rowSize, f->data[0] + (size_t)y * f->linesize[0], rowSize);
+    }
+
+    std::unique_lock<std::mutex> lock(_lock);
+    decoder->_position = index;
+    _frames[index] = { frame, ++_useCounter };
+    Trim();
+    return frame;
+}
+
+void SharedVideoReader::DecodeAhead()
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    while (!_stop) {
+        int next = -1;
+        if (_lastRequested >= 0) {
+            for (int i = _lastRequested + 1; i <= _lastRequested + _decodeAheadFrames; i++) {
+                if (_endIndex >= 0 && i >= _endIndex) break;
+                if (_frames.find(i) == _frames.end()) {
+                    next = i;
+                    break;
+                }
+            }
+        }
+
+        if (next < 0) {
+            _signal.wait(lock);
+            continue;
+        }
+
+        lock.unlock();
+        auto frame = Decode(next);
+        lock.lock();
+
+        if (frame == nullptr && !_stop) {
+            // dont spin on a frame that will not decode ... wait for the next request
+            _signal.wait(lock);
+        }
+    }
+}
+
+// must be called holding the lock
+void SharedVideoReader::Trim()
+{
+    while (_frames.size() > _maxFrames) {
+        // least recently used frame nobody is still drawing from
+        auto oldest = _frames.end();
+        for (auto it = _frames.begin(); it != _frames.end(); ++it) {
+            if (it->second.first.use_count() == 1 && (oldest == _frames.end() || it->second.second < oldest->second.second)) {
+                oldest = it;
+            }
+        }
+        if (oldest == _frames.end()) break;
+        _frames.erase(oldest);
+    }
+}
+#pragma endregion
+
+#pragma region SharedVideoScaler
+SharedVideoScaler::~SharedVideoScaler()
+{
+    if (_swsCtx != nullptr) {
+        sws_freeContext(_swsCtx);
+        _swsCtx = nullptr;
+    }
+}
+
+const uint8_t* SharedVideoScaler::Scale(const std::shared_ptr<SharedVideoFrame>& frame, int width, int height)
+{
+    if (frame == nullptr || width <= 0 || height <= 0) return nullptr;
+
+    // already the right size so no need to copy it
+    if (frame->_width == width && frame->_height == height) return frame->_data.data();
+
+    // the weak reference never keeps a frame alive ... if the ring dropped it this is not the same frame
+    if (frame == _lastFrame.lock() && width == _width && height == _height) return _data.data();
+
+    _swsCtx = sws_getCachedContext(_swsCtx, frame->_width, frame->_height, AV_PIX_FMT_RGBA,
+        width, height, AV_PIX_FMT_RGBA, SWS_BICUBIC, nullptr, nullptr, nullptr);
+    if (_swsCtx == nullptr) return nullptr;
+
+    _data.resize((size_t)width * height * 4);
+    const uint8_t* src[4] = { frame->_data.data(), nullptr, nullptr, nullptr };
+    int srcStride[4] = { frame->_width * 4, 0, 0, 0 };
+    uint8_t* dst[4] = { _data.data(), nullptr, nullptr, nullptr };
+    int dstStride[4] = { width * 4, 0, 0, 0 };
+    sws_scale(_swsCtx, src, srcStride, 0, frame->_height, dst, dstStride);
+
+    _lastFrame = frame;
+    _width = width;
+    _height = height;
+    return _data.data();
+}
+#pragma endregion
+
+#pragma region SharedVideoService
+std::shared_ptr<SharedVideoReader> SharedVideoService::GetReader(const std::string& filename)
+{
+    wxFileName fn(filename);
+    if (!fn.FileExists()) return nullptr;
+    ReaderKey key(filename, (long)fn.GetModificationTime().GetTicks());
+
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        auto it = _readers.find(key);
+        if (it != _readers.end()) {
+            it->second.second = ++_useCounter;
+            return it->second.first;
+        }
+    }
+
+    // opening the video is slow so dont hold the lock while we do it
+    auto reader = std::make_shared<SharedVideoReader>(filename);
+    if (!reader->IsValid()) return nullptr;
+
+    // declared before the lock so the readers trimmed are destroyed after it is released
+    std::list<std::shared_ptr<SharedVideoReader>> evicted;
+    std::unique_lock<std::mutex> lock(_lock);
+    auto it = _readers.find(key);
+    if (it != _readers.end()) {
+        // another thread beat us to it ... use theirs
+        it->second.second = ++_useCounter;
+        return it->second.first;
+    }
+    _readers[key] = { reader, ++_useCounter };
+    evicted = Trim();
+    return reader;
+}
+
+// must be called holding the lock ... the caller must release the readers it returns after unlocking as
+// destroying a reader joins its decode ahead thread
+std::list<std::shared_ptr<SharedVideoReader>> SharedVideoService::Trim()
+{
+    std::list<std::shared_ptr<SharedVideoReader>> evicted;
+
+    // keep a few idle readers around so the next effect on the same video does not have to reopen it
+    std::vector<std::pair<uint64_t, ReaderKey>> idle;
+    for (const auto& it : _readers) {
+        if (it.second.first.use_count() == 1) {
+            idle.push_back({ it.second.second, it.first });
+        }
+    }
+    if (idle.size() <= _maxIdleReaders) return evicted;
+
+    std::sort(idle.begin(), idle.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    for (size_t i = 0; i < idle.size() - _maxIdleReaders; i++) {
+        auto it = _readers.find(idle[i].second);
+        evicted.push_back(it->second.first);
+        _readers.erase(it);
+    }
+    return evicted;
+}
+
+void SharedVideoService::Clear()
+{
+    // destroyed once we have let go of the lock so nobody waits on us while the decode threads stop
+    std::map<ReaderKey, std::pair<std::shared_ptr<SharedVideoReader>, uint64_t>> readers;
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        readers.swap(_readers);
+    }
+}
+#pragma endregion
@@ -0,0 +1,161 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <string>
+#include <list>
+#include <map>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+extern "C"
+{
+#include <libswscale/swscale.h>
+}
+
+class VideoReader;
+
+// A decoded frame at the native resolution of the video. RGBA, rows top down.
+// Frames are shared between every effect using the video so they must be treated as read only.
+struct SharedVideoFrame
+{
+    int _timestampMS = 0;
+    int _width = 0;
+    int _height = 0;
+    std::vector<uint8_t> _data;
+};
+
+// Decodes a video once at native resolution no matter how many models or layers show it.
+// Recently decoded frames are kept in a small timestamp indexed ring and a background thread
+// decodes ahead of the most recent request so renders rarely wait on the decoder.
+// The ring is capped in bytes so large videos keep fewer frames and decode less far ahead.
+// Effects showing the video at different offsets would make a single decoder seek back and forth
+// every frame so a frame that is not in the ring and not just ahead of an existing decoder gets
+// another decoder (up to MAX_DECODERS) which then follows that offset.
+class SharedVideoReader
+{
+    typedef std::map<int, std::pair<std::shared_ptr<SharedVideoFrame>, uint64_t>> FrameMap; // frame index -> frame, last used
+
+    struct Decoder
+    {
+        std::unique_ptr<VideoReader> _reader;
+        std::mutex _lock;    // held while the reader is in use
+        int _position = -1;  // index of the last frame decoded ... this and _lastUsed are protected by SharedVideoReader::_lock
+        uint64_t _lastUsed = 0;
+    };
+
+    std::string _filename;
+    bool _valid = false;
+    int _lengthMS = 0;
+    int _frameMS = 0;
+    int _width = 0;
+    int _height = 0;
+    size_t _maxFrames = 1;
+    int _decodeAheadFrames = 0;
+
+    std::mutex _lock; // protects everything below
+    std::condition_variable _signal;
+    std::vector<std::shared_ptr<Decoder>> _decoders;
+    FrameMap _frames;
+    uint64_t _useCounter = 0;
+    int _lastRequested = -1;
+    int _endIndex = -1;
+    bool _stop = false;
+    std::thread _decodeAhead;
+
+    std::unique_ptr<VideoReader> OpenReader() const;
+    std::shared_ptr<Decoder> ChooseDecoder(int index);
+    std::shared_ptr<SharedVideoFrame> Decode(int index);
+    void DecodeAhead();
+    void Trim();
+
+public:
+    static constexpr int DECODE_AHEAD_FRAMES = 8;
+    static constexpr size_t MAX_RING_BYTES = 64 * 1024 * 1024;
+    static constexpr int MAX_DECODERS = 4;
+    // a decoder this many frames or fewer behind a request decodes forward to it rather than another seeking
+    static constexpr int SEQUENTIAL_FRAMES = 2 * DECODE_AHEAD_FRAMES;
+
+    SharedVideoReader(const std::string& filename);
+    ~SharedVideoReader();
+    SharedVideoReader(const SharedVideoReader&) = delete;
+    SharedVideoReader& operator=(const SharedVideoReader&) = delete;
+
+    bool IsValid() const { return _valid; }
+    const std::string& GetFilename() const { return _filename; }
+    int GetLengthMS() const { return _lengthMS; }
+    int GetFrameMS() const { return _frameMS; }
+    int GetWidth() const { return _width; }
+    int GetHeight() const { return _height; }
+
+    // size the frame ends up when scaled to fit the given size the same way VideoReader does it
+    void GetOutputSize(int maxwidth, int maxheight, bool keepaspectratio, int& width, int& height) const;
+
+    // returns nullptr if the timestamp is past the end of the video or the frame cannot be decoded
+    std::shared_ptr<SharedVideoFrame> GetFrame(int timestampMS);
+
+    // true if the timestamp is known to be at or past the end of the video ... GetFrame returning nullptr
+    // for a timestamp that is not past the end means the frame failed to decode
+    bool IsPastEnd(int timestampMS);
+};
+
+// Per render scaler from shared native frames to the size a model needs.
+// Only a weak reference to the last frame scaled is kept so the scaler never holds a frame in memory
+// after the ring has let it go.
+class SharedVideoScaler
+{
+    SwsContext* _swsCtx = nullptr;
+    std::vector<uint8_t> _data;
+    std::weak_ptr<SharedVideoFrame> _lastFrame;
+    int _width = 0;
+    int _height = 0;
+
+public:
+    SharedVideoScaler() {}
+    ~SharedVideoScaler();
+    SharedVideoScaler(const SharedVideoScaler&) = delete;
+    SharedVideoScaler& operator=(const SharedVideoScaler&) = delete;
+
+    // returns RGBA rows top down of width x height ... valid until the next call
+    const uint8_t* Scale(const std::shared_ptr<SharedVideoFrame>& frame, int width, int height);
+};
+
+// Process wide registry of shared video readers keyed by file and modification time
+class SharedVideoService
+{
+    typedef std::pair<std::string, long> ReaderKey;
+
+    std::mutex _lock;
+    std::map<ReaderKey, std::pair<std::shared_ptr<SharedVideoReader>, uint64_t>> _readers;
+    uint64_t _useCounter = 0;
+    size_t _maxIdleReaders = 4;
+
+    SharedVideoService() {}
+    std::list<std::shared_ptr<SharedVideoReader>> Trim();
+
+public:
+
+    static SharedVideoService& instance()
+    {
+        static SharedVideoService service;
+        return service;
+    }
+
+    SharedVideoService(const SharedVideoService&) = delete;
+    SharedVideoService& operator=(const SharedVideoService&) = delete;
+
+    // returns nullptr if the file cannot be opened as a video
+    std::shared_ptr<SharedVideoReader> GetReader(const std::string& filename);
+    void Clear();
+};
@@ -8,6 +8,7 @@
  * License: https://github.com/smeighan/xLights/blob/master/License.txt
  **************************************************************/
 
+#include <algorithm>
 #include <stdio.h>
 #include <sstream>
 #include <iomanip>
@@ -36,6 +37,7 @@ extern "C"
 #include "outputs/OutputManager.h"
 #include "sequencer/EffectLayer.h"
 #include "xLightsMain.h"
+#include "xLightsApp.h"
 #include "FSEQFile.h"
 #include <log4cpp/Category.hh>
 
@@ -1346,3 +1348,51 @@ void xLightsFrame:: WriteFalconPiFile(const wxString& filename)
     
     FileConverter::WriteFalconPiFile(write_params);
 }
+
+// Command line conversion ... each file is written as an fseq in the fseq folder and nothing is loaded
+// into the sequencer
+void xLightsFrame::ConvertSequencesToFSEQ(const wxArrayString& files, bool exitOnDone)
+{
+    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    std::vector<BatchConvertJob> jobs;
+    for (const auto& f : files)
+    {
+        wxFileName oName(f);
+        oName.SetPath(fseqDirectory);
+        oName.SetExt("fseq");
+        if (oName.GetFullPath() == wxFileName(f).GetFullPath())
+        {
+            logger_base.warn("Not converting %s over itself.", (const char *)f.c_str());
+            continue;
+        }
+        jobs.emplace_back(f, oName.GetFullPath());
+    }
+
+    BatchConvertOptions options;
+    options.xLightsFrm = this;
+    options.outputManager = &_outputManager;
+    if (xLightsApp::renderThreads > 0)
+    {
+        options.max_concurrent = xLightsApp::renderThreads;
+    }
+    options.jobDone = [](const BatchConvertJob& job) {
+        if (job.succeeded)
+        {
+            printf("%s -> %s (%ldms)\n", (const char *)job.inp_filename.c_str(), (const char *)job.out_filename.c_str(), job.elapsedMS);
+        }
+        else
+        {
+            printf("%s FAILED: %s\n", (const char *)job.inp_filename.c_str(), (const char *)job.error_message.c_str());
+        }
+    };
+    FileConverter::ConvertToFSEQ(jobs, options);
+
+    int failed = std::count_if(jobs.begin(), jobs.end(), [](const BatchConvertJob& job) { return !job.succeeded; });
+    logger_base.info("Converted %d of %d sequences to fseq.", (int)jobs.size() - failed, (int)jobs.size());
+    if (exitOnDone)
+    {
+        xLightsApp::exitCode = failed ? 1 : 0;
+        Destroy();
+    }
+}
@@ -29,7 +29,7 @@ void xLightsFrame::ShowPreviewTime(long ElapsedMSec)
 void xLightsFrame::PreviewOutput(int period)
 {
     TimerOutput(period);
-    modelPreview->Render(&SeqData[period][0]);
+    modelPreview->Render(SeqData.GetFrame(period)[0]);
 }
 
 void xLightsFrame::SetStoredLayoutGroup(const std::string &group)
@@ -37,6 +37,9 @@
 #include "ValueCurvesPanel.h"
 #include "ColoursPanel.h"
 #include "sequencer/MainSequencer.h"
+#include "xLightsApp.h"
+#include "../xSchedule/wxJSON/jsonval.h"
+#include "../xSchedule/wxJSON/jsonwriter.h"
 
 #include <log4cpp/Category.hh>
 
@@ -302,6 +305,7 @@ wxString xLightsFrame::LoadEffectsFileNoCheck()
         SetXmlSetting("renderCacheDir", showDirectory);
         UnsavedRgbEffectsChanges = true;
     }
+    AudioManager::SetFrameDataCacheFolder(renderCacheDirectory);
     if (!wxDir::Exists(backupDirectory)) {
         logger_base.warn("Backup Directory not Found ... switching to Show Directory.");
         backupDirectory = showDirectory;
@@ -1025,11 +1029,7 @@ void xLightsFrame::OpenRenderAndSaveSequences(const wxArrayString &origFilenames
         EnableSequenceControls(true);
         logger_base.debug("Batch render done.");
         printf("Done All Files\n");
-        if (exitOnDone) {
-            Destroy();
-        } else {
-            CloseSequence();
-        }
+        FinishBatchRender(false, exitOnDone);
         return;
     }
 
@@ -1038,12 +1038,7 @@ void xLightsFrame::OpenRenderAndSaveSequences(const wxArrayString &origFilenames
         logger_base.debug("Batch render cancelled.");
         EnableSequenceControls(true);
         printf("Batch render cancelled.\n");
-        if (exitOnDone) {
-            Destroy();
-        }
-        else {
-            CloseSequence();
-        }
+        FinishBatchRender(true, exitOnDone);
         return;
     }
 
@@ -1059,6 +1054,18 @@ void xLightsFrame::OpenRenderAndSaveSequences(const wxArrayString &origFilenames
     OpenSequence(seq, nullptr);
     EnableSequenceControls(false);
 
+    BatchRenderResult result;
+    result.file = seq.ToStdString();
+    result.loadMS = sw.Time();
+    if (CurrentSeqXmlFile == nullptr || SeqData.NumFrames() == 0) {
+        logger_base.error("Batch Render unable to load %s.", (const char *)seq.c_str());
+        printf("Failed to load %s\n", (const char *)seq.c_str());
+        _batchRenderResults.push_back(result);
+        CallAfter(&xLightsFrame::OpenRenderAndSaveSequences, fileNames, exitOnDone);
+        return;
+    }
+    result.frames = SeqData.NumFrames();
+
     // if the fseq directory is not the show directory then ensure the fseq folder is set right
     if (fseqDirectory != showDirectory) {
         ObtainAccessToURL(fseqDirectory);
@@ -1074,12 +1081,13 @@ void xLightsFrame::OpenRenderAndSaveSequences(const wxArrayString &origFilenames
     RenderIseqData(true, nullptr); // render ISEQ layers below the Nutcracker layer
     logger_base.info("   iseq below effects done.");
     ProgressBar->SetValue(10);
-    RenderGridToSeqData([this, sw, fileNames, exitOnDone] {
+    RenderGridToSeqData([this, sw, fileNames, exitOnDone, result]() mutable {
         static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
         logger_base.info("   Effects done.");
         ProgressBar->SetValue(90);
         RenderIseqData(false, nullptr);  // render ISEQ layers above the Nutcracker layer
         logger_base.info("   iseq above effects done. Render complete.");
+        result.renderMS = sw.Time() - result.loadMS;
         ProgressBar->SetValue(100);
         ProgressBar->Hide();
         GaugeSizer->Layout();
@@ -1088,6 +1096,10 @@ void xLightsFrame::OpenRenderAndSaveSequences(const wxArrayString &origFilenames
         SetStatusText(_("Saving ") + xlightsFilename + _(" ... Writing fseq."));
         WriteFalconPiFile(xlightsFilename);
         logger_base.info("fseq file done.");
+        result.saveMS = sw.Time() - result.loadMS - result.renderMS;
+        wxFileName fseq(xlightsFilename);
+        result.ok = fseq.FileExists() && fseq.GetSize() > 0;
+        _batchRenderResults.push_back(result);
         DisplayXlightsFilename(xlightsFilename);
         float elapsedTime = sw.Time()/1000.0; // now stop stopwatch timer and get elapsed time. change into seconds from ms
         wxString displayBuff = wxString::Format(_("%s     Updated in %7.3f seconds"),xlightsFilename,elapsedTime);
@@ -1100,6 +1112,70 @@ void xLightsFrame::OpenRenderAndSaveSequences(const wxArrayString &origFilenames
     } );
 }
 
+void xLightsFrame::FinishBatchRender(bool cancelled, bool exitOnDone) {
+    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    int failed = 0;
+    for (const auto& r : _batchRenderResults) {
+        if (!r.ok) failed++;
+        printf("%s %s: %d frames, load %ldms, render %ldms, save %ldms\n", r.ok ? "OK" : "FAILED", r.file.c_str(), r.frames, r.loadMS, r.renderMS, r.saveMS);
+    }
+    printf("%d sequences rendered, %d failed%s.\n", (int)_batchRenderResults.size() - failed, failed, cancelled ? ", cancelled" : "");
+
+    if (exitOnDone) {
+        // 0 all rendered, 1 one or more sequences failed, 2 cancelled
+        xLightsApp::exitCode = cancelled ? 2 : (failed ? 1 : 0);
+
+        if (xLightsApp::renderReport != "" && !xLightsApp::renderReport.Lower().EndsWith(".json")) {
+            wxString str = wxString::Format("threads %d, failed %d%s\n", (int)xLightsApp::renderThreads, failed, cancelled ? ", cancelled" : "");
+            for (const auto& r : _batchRenderResults) {
+                str += wxString::Format("%s\t%s\t%d frames\tload %ldms\trender %ldms\tsave %ldms\n", r.ok ? "OK" : "FAILED", r.file.c_str(), r.frames, r.loadMS, r.renderMS, r.saveMS);
+            }
+            wxFile f;
+            if (f.Create(xLightsApp::renderReport, true) && f.IsOpened()) {
+                f.Write(str);
+                f.Close();
+            } else {
+                logger_base.error("Unable to write render timing report %s.", (const char *)xLightsApp::renderReport.c_str());
+            }
+        }
+        else if (xLightsApp::renderReport != "") {
+            wxJSONValue report;
+            report["cancelled"] = cancelled;
+            report["failed"] = failed;
+            report["threads"] = (int)xLightsApp::renderThreads;
+            report["sequences"].SetType(wxJSONTYPE_ARRAY);
+            for (const auto& r : _batchRenderResults) {
+                wxJSONValue s;
+                s["file"] = wxString(r.file);
+                s["ok"] = r.ok;
+                s["frames"] = r.frames;
+                s["loadMS"] = r.loadMS;
+                s["renderMS"] = r.renderMS;
+                s["saveMS"] = r.saveMS;
+                report["sequences"].Append(s);
+            }
+            wxString str;
+            wxJSONWriter writer(wxJSONWRITER_STYLED, 0, 3);
+            writer.Write(report, str);
+            wxFile f;
+            if (f.Create(xLightsApp::renderReport, true) && f.IsOpened()) {
+                f.Write(str);
+                f.Close();
+            } else {
+                logger_base.error("Unable to write render timing report %s.", (const char *)xLightsApp::renderReport.c_str());
+            }
+        }
+    }
+    _batchRenderResults.clear();
+
+    if (exitOnDone) {
+        Destroy();
+    } else {
+        CloseSequence();
+    }
+}
+
 void xLightsFrame::SaveSequence()
 {
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
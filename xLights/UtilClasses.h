@@ -13,6 +13,7 @@
 #include <map>
 #include <string>
 #include <algorithm>
+#include <cstring>
 
 #include <wx/filepicker.h>
 
@@ -137,30 +138,35 @@ public:
     }
 
 
+    // single pass over the string ... each entry is copied once and only unescaped if it contains an &
     void Parse(const std::string &str) {
         clear();
-        std::string before,after,name,value;
-        std::string settings(str);
-        while (!settings.empty()) {
-            size_t start_pos = settings.find(',');
-            if (start_pos != std::string::npos) {
-                before = settings.substr(0, start_pos);
-                settings = settings.substr(start_pos + 1);
+        std::string name, value;
+        const char* data = str.data();
+        const size_t len = str.size();
+        size_t pos = 0;
+        while (pos < len) {
+            const char* comma = (const char*)memchr(data + pos, ',', len - pos);
+            size_t end = (comma == nullptr) ? len : comma - data;
+            const char* eq = (const char*)memchr(data + pos, '=', end - pos);
+            if (eq == nullptr) {
+                // no value so the key doubles as the value
+                name.assign(data + pos, end - pos);
+                value = name;
             } else {
-                before = settings;
-                settings = "";
+                size_t e = eq - data;
+                name.assign(data + pos, e - pos);
+                value.assign(data + e + 1, end - e - 1);
+            }
+            if (value.find('&') != std::string::npos) {
+                Unescape(value);
             }
-
-            start_pos = before.find('=');
-            name = before.substr(0, start_pos);
-            value = before.substr(start_pos + 1);
-            ReplaceAll(value, "&comma;", ","); //unescape the commas
-            ReplaceAll(value, "&amp;", "&"); //unescape the amps
 
             RemapKey(name, value);
             if (!name.empty()) {
-                (*this)[name]=value;
+                (*this)[name] = value;
             }
+            pos = end + 1;
         }
     }
 
@@ -181,6 +187,28 @@ public:
 
 private:
 
+    // &comma; -> , and &amp; -> & in one pass
+    static void Unescape(std::string &str) {
+        size_t out = 0;
+        const size_t len = str.size();
+        for (size_t i = 0; i < len; ++i) {
+            if (str[i] == '&') {
+                if (str.compare(i, 7, "&comma;") == 0) {
+                    str[out++] = ',';
+                    i += 6;
+                    continue;
+                }
+                if (str.compare(i, 5, "&amp;") == 0) {
+                    str[out++] = '&';
+                    i += 4;
+                    continue;
+                }
+            }
+            str[out++] = str[i];
+        }
+        str.resize(out);
+    }
+
     void ReplaceAll(std::string &str, const std::string& from, const std::string& to) const {
         size_t start_pos = 0;
         while((start_pos = str.find(from, start_pos)) != std::string::npos) {
@@ -32,6 +32,7 @@ public:
 	VideoReader(const std::string& filename, int width, int height, bool keepaspectratio, bool usenativeresolution = false, bool wantAlpha = false, bool bgr = false);
 	~VideoReader();
 	int GetLengthMS() const { return (int)_lengthMS; };
+    int GetFrameMS() const { return _frameMS; }
 	void Seek(int timestampMS, bool readFrame = true);
 	AVFrame* GetNextFrame(int timestampMS, int gracetime = 0); // grace time is the minimum the video must be ahead before we bother to seek back to a frame
 	bool IsValid() const { return _valid; };
@@ -21,6 +21,8 @@
 #include <wx/regex.h>
 #include <wx/file.h>
 #include <wx/filename.h>
+#include <wx/stdpaths.h>
+#include <wx/textfile.h>
 #include <wx/wfstream.h>
 #include <wx/sckstrm.h>
 #include <wx/zstream.h>
@@ -146,7 +148,7 @@ wxSecretStore xlPasswordEntryDialog::pwdStore = wxSecretStore::GetDefault();
 static const std::string PIHAT("Pi Hat");
 static const std::string LEDPANELS("LED Panels");
 
-FPP::FPP(const std::string &ad) : BaseController(ad, ""), majorVersion(0), minorVersion(0), outputFile(nullptr), parent(nullptr), ipAddress(ad), curl(nullptr), isFPP(true) {
+FPP::FPP(const std::string &ad) : BaseController(ad, ""), majorVersion(0), minorVersion(0), parent(nullptr), ipAddress(ad), curl(nullptr), isFPP(true) {
     wxIPV4address address;
     if (address.Hostname(ad)) {
         hostName = ad;
@@ -158,7 +160,7 @@ FPP::FPP(const std::string &ad) : BaseController(ad, ""), majorVersion(0), minor
 }
 
 
-FPP::FPP(const std::string &ip, const std::string &proxy, const std::string &model) : BaseController(ip, proxy), majorVersion(0), minorVersion(0), outputFile(nullptr), parent(nullptr), curl(nullptr), isFPP(true) {
+FPP::FPP(const std::string &ip, const std::string &proxy, const std::string &model) : BaseController(ip, proxy), majorVersion(0), minorVersion(0), parent(nullptr), curl(nullptr), isFPP(true) {
     ipAddress = ip;
     pixelControllerType = model;
     wxIPV4address address;
@@ -171,7 +173,7 @@ FPP::FPP(const std::string &ip, const std::string &proxy, const std::string &mod
 }
 
 FPP::FPP(const FPP &c)
-    : majorVersion(c.majorVersion), minorVersion(c.minorVersion), outputFile(nullptr), parent(nullptr), curl(nullptr),
+    : majorVersion(c.majorVersion), minorVersion(c.minorVersion), parent(nullptr), curl(nullptr),
     hostName(c.hostName), description(c.description), ipAddress(c.ipAddress), fullVersion(c.fullVersion), platform(c.platform),
     model(c.model), ranges(c.ranges), mode(c.mode), pixelControllerType(c.pixelControllerType), username(c.username), password(c.password), isFPP(c.isFPP)
 {
@@ -179,14 +181,7 @@ FPP::FPP(const FPP &c)
 }
 
 FPP::~FPP() {
-    if (outputFile) {
-        delete outputFile;
-        outputFile = nullptr;
-    }
-    if (tempFileName != "") {
-        ::wxRemoveFile(tempFileName);
-        tempFileName = "";
-    }
+    outputFile.reset();
     if (curl) {
         curl_easy_cleanup(curl);
         curl = nullptr;
@@ -655,12 +650,29 @@ int FPP::PostToURL(const std::string& url, const std::string &val, const std::st
 
 
 
-bool FPP::uploadFile(const std::string &filename, const std::string &file)  {
+class FPPUploadState {
+public:
+    FPPUploadState() : chunk(nullptr) { error[0] = 0; }
+    ~FPPUploadState() {
+        if (chunk) {
+            curl_slist_free_all(chunk);
+        }
+    }
+
+    std::string filename;
+    std::string fullUrl;
+    wxMemoryBuffer memBuffPre;
+    wxMemoryBuffer memBuffPost;
+    wxFile fileobj;
+    struct curl_slist *chunk;
+    char error[1024];
+    FPPWriteData data;
+};
+
+FPPUploadState *FPP::startUpload(const std::string &filename, const std::string &file) {
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
 
     wxString fn;
-    wxString ext;
-
     for (int a = 0; a < filename.length(); a++) {
         wxChar ch = filename[a];
         if (ch == '"') {
@@ -669,43 +681,36 @@ bool FPP::uploadFile(const std::string &filename, const std::string &file)  {
             fn.Append(ch);
         }
     }
+    logger_base.debug("FPP upload via http of %s to %s.", (const char*)filename.c_str(), (const char*)ipAddress.c_str());
 
-    bool cancelled = false;
-    progressDialog->SetTitle("FPP Upload");
-    logger_base.debug("FPP upload via http of %s.", (const char*)filename.c_str());
-    progressDialog->Update(0, "Transferring " + filename + " to " + ipAddress, &cancelled);
-    int lastDone = 0;
+    FPPUploadState *state = new FPPUploadState();
+    state->filename = filename;
 
     std::string ct = "Content-Type: application/octet-stream";
-    bool deleteFile = false;
-    std::string fullFileName = file;
-    
+
     setupCurl();
     //if we cannot upload it in 5 minutes, we have serious issues
     curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, 1000*5*60);
 
     curlInputBuffer.clear();
-    char error[1024];
-    std::string fullUrl = "http://" + ipAddress + "/jqupload.php";
-    curl_easy_setopt(curl, CURLOPT_URL, fullUrl.c_str());
-    curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, &error);
+    state->fullUrl = "http://" + ipAddress + "/jqupload.php";
+    curl_easy_setopt(curl, CURLOPT_URL, state->fullUrl.c_str());
+    curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, state->error);
     if (username != "") {
         curl_easy_setopt(curl, CURLOPT_USERNAME, username.c_str());
         curl_easy_setopt(curl, CURLOPT_PASSWORD, password.c_str());
         curl_easy_setopt(curl, CURLOPT_HTTPAUTH, CURLAUTH_BASIC | CURLAUTH_DIGEST | CURLAUTH_NEGOTIATE);
     }
     const std::string bound = "----WebKitFormBoundaryb29a7c2fe47b9481";
-    struct curl_slist *chunk = nullptr;
     std::string ctMime = "Content-Type: multipart/form-data; boundary=" + bound;
-    chunk = curl_slist_append(chunk, "Transfer-Encoding: chunked");
-    chunk = curl_slist_append(chunk, ctMime.c_str());
-    chunk = curl_slist_append(chunk, "X-Requested-With: FPPConnect");
-    chunk = curl_slist_append(chunk, "User-Agent: Mozilla/5.0 (Macintosh; Intel Mac OS X 10_14_1) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/70.0.3538.77 Safari/537.36");
+    state->chunk = curl_slist_append(state->chunk, "Transfer-Encoding: chunked");
+    state->chunk = curl_slist_append(state->chunk, ctMime.c_str());
+    state->chunk = curl_slist_append(state->chunk, "X-Requested-With: FPPConnect");
+    state->chunk = curl_slist_append(state->chunk, "User-Agent: Mozilla/5.0 (Macintosh; Intel Mac OS X 10_14_1) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/70.0.3538.77 Safari/537.36");
     curl_easy_setopt(curl, CURLOPT_POST, 1L);
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, chunk);
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, state->chunk);
 
-    
-    wxMemoryBuffer memBuffPost;
+    wxMemoryBuffer &memBuffPost = state->memBuffPost;
     addString(memBuffPost, "\r\n--");
     addString(memBuffPost, bound);
     addString(memBuffPost,"\r\nContent-Disposition: form-data; name=\"\"\r\n\r\nundefined\r\n--");
@@ -713,11 +718,11 @@ bool FPP::uploadFile(const std::string &filename, const std::string &file)  {
     addString(memBuffPost,"\r\nContent-Disposition: form-data; name=\"\"\r\n\r\nundefined\r\n--");
     addString(memBuffPost, bound);
     addString(memBuffPost, "--\r\n");
-    
+
     std::string cd = "Content-Disposition: form-data; name=\"myfile\"; filename=\"";
     cd += fn.ToStdString();
     cd += "\"\r\n";
-    wxMemoryBuffer memBuffPre;
+    wxMemoryBuffer &memBuffPre = state->memBuffPre;
     addString(memBuffPre, "--");
     addString(memBuffPre, bound);
     addString(memBuffPre, "\r\n");
@@ -725,49 +730,135 @@ bool FPP::uploadFile(const std::string &filename, const std::string &file)  {
     addString(memBuffPre, ct);
     addString(memBuffPre, "\r\n\r\n");
 
-    FPPWriteData data;
-    wxFile fileobj(fullFileName);
-    fileobj.Seek(0);
+    FPPWriteData &data = state->data;
+    state->fileobj.Open(file);
+    state->fileobj.Seek(0);
     data.data = (uint8_t*)memBuffPre.GetData();
     data.dataSize = memBuffPre.GetDataLen();
-    data.progress = progressDialog;
-    data.file = &fileobj;
+    data.file = &state->fileobj;
     data.postData =  (uint8_t*)memBuffPost.GetData();
     data.postDataSize = memBuffPost.GetDataLen();
     curl_easy_setopt(curl, CURLOPT_READFUNCTION, read_callback);
     curl_easy_setopt(curl, CURLOPT_READDATA, &data);
-    
-    data.progress = progressDialog;
-    data.progressString = "Transferring " + filename + " to " + ipAddress;
-    data.lastDone = lastDone;
+    return state;
+}
+
+bool FPP::finishUpload(FPPUploadState *state, int curlResult) {
+    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
 
-    int i = curl_easy_perform(curl);
-    curl_slist_free_all(chunk);
-    if (deleteFile) {
-        wxRemoveFile(fullFileName);
-    }
     long response_code = 0;
-    if (i == CURLE_OK) {
+    if (curlResult == CURLE_OK) {
         curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response_code);
         if (response_code == 200) {
             std::string val;
-            if (!GetURLAsString("/fppxml.php?command=moveFile&file=" + URLEncode(filename + ext), val)) {
+            if (!GetURLAsString("/fppxml.php?command=moveFile&file=" + URLEncode(state->filename), val)) {
                 logger_base.warn("Error trying to rename file.");
             } else {
                 logger_base.debug("Renaming done.");
             }
         } else {
             logger_base.warn("Did not get 200 resonse code:  %d", response_code);
-            cancelled = true;
         }
     } else {
         curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response_code);
-        logger_base.warn("Curl did not upload file:  %d   %s", response_code, error);
+        logger_base.warn("Curl did not upload file:  %d   %s", response_code, state->error);
+    }
+    logger_base.info("FPPConnect Upload file %s  - Return: %d - RC: %d - File: %s", state->fullUrl.c_str(), curlResult, response_code, state->filename.c_str());
+
+    bool cancelled = state->data.cancelled;
+    delete state;
+    return cancelled;
+}
+
+bool FPP::uploadFile(const std::string &filename, const std::string &file)  {
+    bool cancelled = false;
+    progressDialog->SetTitle("FPP Upload");
+    progressDialog->Update(0, "Transferring " + filename + " to " + ipAddress, &cancelled);
+
+    FPPUploadState *state = startUpload(filename, file);
+    state->data.progress = progressDialog;
+    state->data.progressString = "Transferring " + filename + " to " + ipAddress;
+
+    int i = curl_easy_perform(curl);
+    cancelled = finishUpload(state, i);
+    progressDialog->Update(1000, wxEmptyString);
+    return cancelled;
+}
+
+bool FPP::uploadFileToMany(const std::list<FPP*> &instances, const std::string &filename,
+                           const std::string &file, wxProgressDialog *progress) {
+    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+    if (instances.empty()) {
+        return false;
+    }
+    if (instances.size() == 1) {
+        return instances.front()->uploadFile(filename, file);
+    }
+
+    bool cancelled = false;
+    std::string progressString = "Transferring " + filename + " to " + std::to_string(instances.size()) + " FPP instances";
+    progress->SetTitle("FPP Upload");
+    progress->Update(0, progressString, &cancelled);
+    logger_base.debug("FPP upload via http of %s to %d instances at once.", (const char*)filename.c_str(), (int)instances.size());
+
+    // all the transfers read the same file so it only has to be read from disk once per target
+    // rather than the whole thing being sent to one instance after another
+    CURLM *multi = curl_multi_init();
+    std::map<CURL*, std::pair<FPP*, FPPUploadState*>> transfers;
+    wxFileOffset total = 0;
+    wxFileOffset completed = 0;
+    for (auto inst : instances) {
+        FPPUploadState *state = inst->startUpload(filename, file);
+        total += state->fileobj.Length();
+        curl_multi_add_handle(multi, inst->curl);
+        transfers[inst->curl] = std::pair<FPP*, FPPUploadState*>(inst, state);
     }
-    progressDialog->Update(1000, wxEmptyString, &cancelled);
-    logger_base.info("FPPConnect Upload file %s  - Return: %d - RC: %d - File: %s", fullUrl.c_str(), i, response_code, filename.c_str());
 
-    return data.cancelled;
+    int lastDone = 0;
+    int running = transfers.size();
+    while (!transfers.empty() && !cancelled) {
+        curl_multi_perform(multi, &running);
+
+        int msgsLeft = 0;
+        CURLMsg *msg = nullptr;
+        while ((msg = curl_multi_info_read(multi, &msgsLeft)) != nullptr) {
+            if (msg->msg == CURLMSG_DONE) {
+                CURL *handle = msg->easy_handle;
+                CURLcode result = msg->data.result;
+                auto it = transfers.find(handle);
+                curl_multi_remove_handle(multi, handle);
+                if (it != transfers.end()) {
+                    completed += it->second.second->fileobj.Length();
+                    it->second.first->finishUpload(it->second.second, result);
+                    transfers.erase(it);
+                }
+            }
+        }
+
+        wxFileOffset written = completed;
+        for (const auto& t : transfers) {
+            written += t.second.second->data.totalWritten;
+        }
+        int donePct = total == 0 ? 1000 : (int)(written * 1000 / total);
+        if (donePct != lastDone) {
+            lastDone = donePct;
+            cancelled = !progress->Update(donePct, progressString, &cancelled);
+        }
+        wxYield();
+
+        if (running) {
+            curl_multi_wait(multi, nullptr, 0, 100, nullptr);
+        }
+    }
+
+    // anything still in flight has been cancelled
+    for (auto& t : transfers) {
+        curl_multi_remove_handle(multi, t.first);
+        t.second.first->finishUpload(t.second.second, CURLE_ABORTED_BY_CALLBACK);
+    }
+    curl_multi_cleanup(multi);
+    progress->Update(1000, wxEmptyString);
+    return cancelled;
 }
 
 
@@ -831,17 +922,228 @@ bool FPP::uploadOrCopyFile(const std::string &filename,
 }
 
 
-bool FPP::PrepareUploadSequence(const FSEQFile &file,
-                                const std::string &seq, const std::string &media,
-                                int type) {
-    if (outputFile) {
-        delete outputFile;
-        outputFile = nullptr;
+FPPUploadFile::~FPPUploadFile() {
+    if (file) {
+        delete file;
+        file = nullptr;
     }
     if (tempFileName != "") {
         ::wxRemoveFile(tempFileName);
         tempFileName = "";
     }
+}
+
+// collects the start of a download and stops it as soon as the whole fseq header has arrived
+static size_t fseqHeaderWriteCallback(void *ptr, size_t size, size_t nmemb, void *userp) {
+    std::vector<uint8_t> *header = (std::vector<uint8_t>*)userp;
+    size_t len = size * nmemb;
+    header->insert(header->end(), (uint8_t*)ptr, (uint8_t*)ptr + len);
+    if (header->size() >= 8) {
+        uint32_t headerSize = (*header)[4] + ((*header)[5] << 8);
+        if (header->size() >= headerSize) {
+            return 0; // abort, we have all we need
+        }
+    }
+    return len;
+}
+
+bool FPP::GetRemoteSequenceHeader(const std::string &baseName, std::vector<uint8_t> &header) {
+    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+    header.clear();
+    if (IsDrive()) {
+        wxString fn = ipAddress + wxFileName::GetPathSeparator() + "sequences" + wxFileName::GetPathSeparator() + baseName;
+        if (!wxFile::Exists(fn)) {
+            return false;
+        }
+        wxFile f(fn);
+        if (!f.IsOpened()) {
+            return false;
+        }
+        header.resize(8);
+        if (f.Read(&header[0], 8) != 8) {
+            return false;
+        }
+        uint32_t headerSize = header[4] + (header[5] << 8);
+        if (headerSize < 8) {
+            return false;
+        }
+        header.resize(headerSize);
+        return f.Read(&header[8], headerSize - 8) == headerSize - 8;
+    }
+    if (!IsVersionAtLeast(2, 0)) {
+        return false;
+    }
+
+    setupCurl();
+    std::string fullUrl = "http://" + ipAddress + "/api/sequence/" + URLEncode(baseName);
+    curl_easy_setopt(curl, CURLOPT_URL, fullUrl.c_str());
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, fseqHeaderWriteCallback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &header);
+    if (username != "") {
+        curl_easy_setopt(curl, CURLOPT_USERNAME, username.c_str());
+        curl_easy_setopt(curl, CURLOPT_PASSWORD, password.c_str());
+        curl_easy_setopt(curl, CURLOPT_HTTPAUTH, CURLAUTH_BASIC | CURLAUTH_DIGEST | CURLAUTH_NEGOTIATE);
+    }
+    int i = curl_easy_perform(curl);
+    long response_code = 0;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response_code);
+    // the header callback aborting the transfer is the expected outcome
+    bool ok = (i == CURLE_OK || i == CURLE_WRITE_ERROR) && response_code == 200 && header.size() >= 8;
+    if (ok) {
+        uint32_t headerSize = header[4] + (header[5] << 8);
+        ok = header.size() >= headerSize;
+    }
+    logger_base.debug("FPPConnect GET header %s  - Return: %d - RC: %d - Bytes: %d", fullUrl.c_str(), i, response_code, (int)header.size());
+    return ok;
+}
+
+// Compares the header of the copy of the sequence already on the player with what would be uploaded.
+// The unique id changes every time the sequence is rendered so if everything else matches the frames
+// may still be the same ... the block hashes saved when it was uploaded tell us.
+int FPP::CompareRemoteSequence(const std::string &baseName, const V2FSEQFile &file, uint64_t &remoteId) {
+    remoteId = 0;
+    std::vector<uint8_t> header;
+    if (!GetRemoteSequenceHeader(baseName, header) || header.size() < 32) {
+        return REMOTE_SEQUENCE_DIFFERENT;
+    }
+    if (header[0] != 'P' || header[1] != 'S' || header[2] != 'E' || header[3] != 'Q' || header[7] != 2) {
+        return REMOTE_SEQUENCE_DIFFERENT;
+    }
+    uint32_t remoteChannels = header[10] + (header[11] << 8) + (header[12] << 16) + (header[13] << 24);
+    uint32_t remoteFrames = header[14] + (header[15] << 8) + (header[16] << 16) + (header[17] << 24);
+    memcpy(&remoteId, &header[24], sizeof(remoteId));
+    if (remoteFrames != file.getNumFrames() || remoteChannels != file.getChannelCount() || header[18] != file.getStepTime()
+        || header[20] != file.m_compressionType || header[22] != file.m_sparseRanges.size()) {
+        return REMOTE_SEQUENCE_DIFFERENT;
+    }
+    size_t pos = 32 + header[21] * 8;
+    for (const auto& r : file.m_sparseRanges) {
+        if (pos + 6 > header.size()) {
+            return REMOTE_SEQUENCE_DIFFERENT;
+        }
+        uint32_t start = header[pos] + (header[pos + 1] << 8) + (header[pos + 2] << 16);
+        uint32_t len = header[pos + 3] + (header[pos + 4] << 8) + (header[pos + 5] << 16);
+        if (start != r.first || len != r.second) {
+            return REMOTE_SEQUENCE_DIFFERENT;
+        }
+        pos += 6;
+    }
+    // the variable headers hold the media file name so they have to match too
+    pos = header[8] + (header[9] << 8);
+    for (const auto& v : file.getVariableHeaders()) {
+        uint32_t len = 4 + v.data.size();
+        if (pos + len > header.size() || header[pos] + (header[pos + 1] << 8) != len
+            || header[pos + 2] != (uint8_t)v.code[0] || header[pos + 3] != (uint8_t)v.code[1]
+            || (!v.data.empty() && memcmp(&header[pos + 4], &v.data[0], v.data.size()) != 0)) {
+            return REMOTE_SEQUENCE_DIFFERENT;
+        }
+        pos += len;
+    }
+    return remoteId == file.getUniqueId() ? REMOTE_SEQUENCE_SAME : REMOTE_SEQUENCE_SAME_LAYOUT;
+}
+
+// Frames are hashed this many at a time when comparing with the copy on the player
+#define SEQUENCE_HASH_BLOCK_FRAMES 64
+
+static uint64_t HashChannelData(uint64_t hash, const uint8_t *data, size_t len) {
+    // FNV-1a a word at a time, it only has to tell changed blocks apart
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        uint64_t w;
+        memcpy(&w, data + i, sizeof(w));
+        hash ^= w;
+        hash *= 1099511628211ULL;
+    }
+    for (; i < len; i++) {
+        hash ^= data[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// The hashes of what was last uploaded to each player are kept locally, losing them only costs a full upload
+static std::string GetSequenceHashFile(const std::string &ipAddress, const std::string &baseName) {
+    wxString name = ipAddress + "_" + baseName + ".blocks";
+    for (const auto c : wxString("\\/:*?\"<>|")) {
+        name.Replace(c, "_");
+    }
+    wxFileName fn(wxStandardPaths::Get().GetUserLocalDataDir(), name);
+    fn.AppendDir("FPPSync");
+    return fn.GetFullPath().ToStdString();
+}
+
+void FPP::StartBlockCompare(const std::string &baseName, const V2FSEQFile &file, int remoteState, uint64_t remoteId) {
+    uploadBlockHashes.clear();
+    remoteBlockHashes.clear();
+    uploadHashRanges.clear();
+    uploadUniqueId = file.getUniqueId();
+    if (file.m_sparseRanges.empty()) {
+        uploadHashRanges.push_back(std::pair<uint32_t, uint32_t>(0, file.getChannelCount()));
+    } else {
+        uploadHashRanges = file.m_sparseRanges;
+    }
+    if (remoteState != REMOTE_SEQUENCE_SAME_LAYOUT || IsDrive()) {
+        return;
+    }
+
+    // only any use if the player still has the copy the hashes were saved for
+    wxTextFile f(GetSequenceHashFile(ipAddress, baseName));
+    if (!f.Exists() || !f.Open() || f.GetLineCount() < 2) {
+        return;
+    }
+    unsigned long long id = 0;
+    long blockFrames = 0;
+    if (!f.GetLine(0).ToULongLong(&id) || id != remoteId || !f.GetLine(1).ToLong(&blockFrames) || blockFrames != SEQUENCE_HASH_BLOCK_FRAMES) {
+        return;
+    }
+    for (size_t i = 2; i < f.GetLineCount(); i++) {
+        unsigned long long h = 0;
+        if (!f.GetLine(i).ToULongLong(&h, 16)) {
+            remoteBlockHashes.clear();
+            return;
+        }
+        remoteBlockHashes.push_back(h);
+    }
+}
+
+bool FPP::IsUploadUnchanged() const {
+    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+    if (remoteBlockHashes.empty() || remoteBlockHashes != uploadBlockHashes) {
+        return false;
+    }
+    logger_base.info("FPPConnect %s already has the same frames for %s in all %d blocks, skipping upload.", ipAddress.c_str(), baseSeqName.c_str(), (int)uploadBlockHashes.size());
+    return true;
+}
+
+void FPP::SaveBlockHashes() {
+    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+    if (uploadHashRanges.empty() || uploadBlockHashes.empty()) {
+        return;
+    }
+    wxFileName fn(GetSequenceHashFile(ipAddress, baseSeqName));
+    if (!fn.DirExists() && !wxFileName::Mkdir(fn.GetPath(), wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL)) {
+        return;
+    }
+    wxFile f;
+    if (!f.Create(fn.GetFullPath(), true)) {
+        logger_base.warn("FPPConnect unable to save the block hashes to %s.", (const char *)fn.GetFullPath().c_str());
+        return;
+    }
+    f.Write(wxString::Format("%llu\n%d\n", (unsigned long long)uploadUniqueId, SEQUENCE_HASH_BLOCK_FRAMES));
+    for (const auto h : uploadBlockHashes) {
+        f.Write(wxString::Format("%016llx\n", (unsigned long long)h));
+    }
+    f.Close();
+}
+
+bool FPP::PrepareUploadSequence(const FSEQFile &file,
+                                const std::string &seq, const std::string &media,
+                                int type, FPPUploadFileMap *sharedFiles) {
+    outputFile.reset();
+    directUploadFile = "";
+    uploadHashRanges.clear();
+    uploadBlockHashes.clear();
+    remoteBlockHashes.clear();
 
     wxFileName fn(seq);
     std::string baseName = fn.GetFullName();
@@ -858,13 +1160,6 @@ bool FPP::PrepareUploadSequence(const FSEQFile &file,
     }
     sequences[baseName] = mediaBaseName;
 
-    std::string fileName;
-    if (IsDrive()) {
-        fileName = ipAddress + wxFileName::GetPathSeparator() + "sequences" + wxFileName::GetPathSeparator() + baseName;
-    } else {
-        tempFileName = wxFileName::CreateTempFileName(baseName);
-        fileName = tempFileName;
-    }
     if ((type == 0 && file.getVersionMajor() == 1)
         || fn.GetExt() == "eseq") {
 
@@ -873,10 +1168,21 @@ bool FPP::PrepareUploadSequence(const FSEQFile &file,
     }
 
     if (type == 1 && file.getVersionMajor() == 2) {
-        // Full v2 file, upload directly
-        return uploadOrCopyFile(baseName, seq, fn.GetExt() == "eseq" ? "effects" : "sequences");
+        // Full v2 file, uploaded directly once its frames have been compared with the player's copy
+        const V2FSEQFile *v2 = (const V2FSEQFile*)&file;
+        uint64_t remoteId = 0;
+        int remoteState = CompareRemoteSequence(baseName, *v2, remoteId);
+        if (remoteState == REMOTE_SEQUENCE_SAME) {
+            logger_base.info("FPPConnect %s already has an up to date copy of %s, skipping upload.", ipAddress.c_str(), baseName.c_str());
+            return false;
+        }
+        StartBlockCompare(baseName, *v2, remoteState, remoteId);
+        baseSeqName = baseName;
+        directUploadFile = seq;
+        return false;
     }
     baseSeqName = baseName;
+    int version = type == 0 ? 1 : 2;
     FSEQFile::CompressionType ctype = ::FSEQFile::CompressionType::zstd;
     if (type == 3) {
         ctype = ::FSEQFile::CompressionType::none;
@@ -890,10 +1196,10 @@ bool FPP::PrepareUploadSequence(const FSEQFile &file,
             clevel = -5;
         }
     }
-    outputFile = FSEQFile::createFSEQFile(fileName, type == 0 ? 1 : 2, ctype, clevel);
-    outputFile->initializeFromFSEQ(file);
-    if (type >= 2 && ranges != "") {
-        wxArrayString r1 = wxSplit(wxString(ranges), ',');
+    std::string sparse = (type >= 2) ? ranges : "";
+    std::vector<std::pair<uint32_t, uint32_t>> sparseRanges;
+    if (sparse != "") {
+        wxArrayString r1 = wxSplit(wxString(sparse), ',');
         for (const auto& a : r1) {
             wxArrayString r = wxSplit(a, '-');
             int start = wxAtoi(r[0]);
@@ -901,30 +1207,138 @@ bool FPP::PrepareUploadSequence(const FSEQFile &file,
             if (r.size() == 2) {
                 len = wxAtoi(r[1]) - start + 1;
             }
-            ((V2FSEQFile*)outputFile)->m_sparseRanges.push_back(std::pair<uint32_t, uint32_t>(start, len));
+            sparseRanges.push_back(std::pair<uint32_t, uint32_t>(start, len));
+        }
+    }
+
+    // anything that would produce byte for byte the same file just reuses the one already being generated
+    std::string key = std::to_string(version) + "|" + std::to_string((int)ctype) + "|" + std::to_string(clevel) + "|" + sparse;
+    std::shared_ptr<FPPUploadFile> upload;
+    if (sharedFiles != nullptr) {
+        auto it = sharedFiles->find(key);
+        if (it != sharedFiles->end() && it->second->file != nullptr) {
+            upload = it->second;
         }
     }
-    outputFile->writeHeader();
+    if (!upload) {
+        // always generate to a temp file, even for drives, so it can be shared
+        std::string tempFileName = wxFileName::CreateTempFileName(baseName).ToStdString();
+        FSEQFile *f = FSEQFile::createFSEQFile(tempFileName, version, ctype, clevel);
+        f->initializeFromFSEQ(file);
+        if (!sparseRanges.empty()) {
+            ((V2FSEQFile*)f)->m_sparseRanges.insert(((V2FSEQFile*)f)->m_sparseRanges.end(), sparseRanges.begin(), sparseRanges.end());
+        }
+        f->writeHeader();
+        upload = std::make_shared<FPPUploadFile>(f, tempFileName, this);
+    }
+    if (version == 2) {
+        // writeHeader has trimmed the sparse ranges and worked out the channel count so compare with what it produced
+        const V2FSEQFile *v2 = (const V2FSEQFile*)upload->file;
+        uint64_t remoteId = 0;
+        int remoteState = CompareRemoteSequence(baseName, *v2, remoteId);
+        if (remoteState == REMOTE_SEQUENCE_SAME) {
+            logger_base.info("FPPConnect %s already has an up to date copy of %s, skipping upload.", ipAddress.c_str(), baseName.c_str());
+            return false;
+        }
+        StartBlockCompare(baseName, *v2, remoteState, remoteId);
+    }
+    outputFile = upload;
+    if (sharedFiles != nullptr) {
+        (*sharedFiles)[key] = outputFile;
+    }
     return false;
 }
 bool FPP::AddFrameToUpload(uint32_t frame, uint8_t *data) {
-    if (outputFile) {
-        outputFile->addFrame(frame, data);
+    // only the instance that created a shared file writes to it
+    if (outputFile && outputFile->owner == this && outputFile->file) {
+        outputFile->file->addFrame(frame, data);
+    }
+    if (!uploadHashRanges.empty()) {
+        size_t block = frame / SEQUENCE_HASH_BLOCK_FRAMES;
+        if (block >= uploadBlockHashes.size()) {
+            uploadBlockHashes.resize(block + 1, 14695981039346656037ULL);
+        }
+        for (const auto& r : uploadHashRanges) {
+            uploadBlockHashes[block] = HashChannelData(uploadBlockHashes[block], data + r.first, r.second);
+        }
     }
     return false;
 }
 bool FPP::FinalizeUploadSequence() {
     bool cancelled = false;
     if (outputFile) {
-        outputFile->finalize();
+        if (outputFile->file) {
+            outputFile->file->finalize();
+            delete outputFile->file;
+            outputFile->file = nullptr;
+        }
+        if (!IsUploadUnchanged()) {
+            cancelled = uploadOrCopyFile(baseSeqName, outputFile->tempFileName, "sequences");
+            if (!cancelled) {
+                SaveBlockHashes();
+            }
+        }
+        outputFile.reset();
+    } else if (directUploadFile != "") {
+        if (!IsUploadUnchanged()) {
+            cancelled = uploadOrCopyFile(baseSeqName, directUploadFile, "sequences");
+            if (!cancelled) {
+                SaveBlockHashes();
+            }
+        }
+        directUploadFile = "";
+    }
+    return cancelled;
+}
+bool FPP::FinalizeUploadSequences(const std::list<FPP*> &instances, wxProgressDialog *progress) {
+    // group the instances by the file they are uploading, keeping the order they were prepared in
+    std::list<std::pair<std::shared_ptr<FPPUploadFile>, std::list<FPP*>>> groups;
+    for (auto inst : instances) {
+        if (!inst->outputFile) {
+            continue;
+        }
+        auto it = std::find_if(groups.begin(), groups.end(), [inst](const auto& g) { return g.first == inst->outputFile; });
+        if (it == groups.end()) {
+            groups.push_back({ inst->outputFile, std::list<FPP*>() });
+            it = std::prev(groups.end());
+        }
+        it->second.push_back(inst);
+    }
 
-        delete outputFile;
-        outputFile = nullptr;
-        if (tempFileName != "") {
-            cancelled = uploadOrCopyFile(baseSeqName, tempFileName, "sequences");
-            ::wxRemoveFile(tempFileName);
-            tempFileName = "";
+    bool cancelled = false;
+    for (auto& g : groups) {
+        if (g.first->file) {
+            g.first->file->finalize();
+            delete g.first->file;
+            g.first->file = nullptr;
+        }
+        std::list<FPP*> http;
+        for (auto inst : g.second) {
+            if (cancelled) {
+                break;
+            }
+            if (inst->IsDrive()) {
+                cancelled |= inst->copyFile(inst->baseSeqName, g.first->tempFileName, "sequences");
+            } else if (!inst->IsUploadUnchanged()) {
+                http.push_back(inst);
+            }
+        }
+        if (!cancelled && !http.empty()) {
+            cancelled |= uploadFileToMany(http, http.front()->baseSeqName, g.first->tempFileName, progress);
+            if (!cancelled) {
+                for (auto inst : http) {
+                    inst->SaveBlockHashes();
+                }
+            }
+        }
+    }
+    // full v2 files that were held back until their frames could be compared
+    for (auto inst : instances) {
+        if (!cancelled && inst->directUploadFile != "") {
+            cancelled |= inst->FinalizeUploadSequence();
         }
+        inst->directUploadFile = "";
+        inst->outputFile.reset();
     }
     return cancelled;
 }
@@ -4,6 +4,7 @@
 #include <map>
 #include <set>
 #include <algorithm>
+#include <memory>
 
 #include "../models/ModelManager.h"
 #include "ControllerUploadData.h"
@@ -11,15 +12,32 @@
 
 class wxJSONValue;
 class FSEQFile;
+class V2FSEQFile;
 class wxMemoryBuffer;
 typedef void CURL;
 class wxWindow;
 class wxProgressDialog;
+class FPP;
+class FPPUploadState;
+
+// An fseq being generated for upload. Instances that need identical output (same version, compression
+// and sparse ranges) share one so the sequence is only encoded once no matter how many are uploaded to.
+class FPPUploadFile
+{
+public:
+    FPPUploadFile(FSEQFile* f, const std::string& temp, FPP* o) : file(f), tempFileName(temp), owner(o) {}
+    ~FPPUploadFile();
+
+    FSEQFile* file = nullptr; // nullptr once finalized
+    std::string tempFileName;
+    FPP* owner = nullptr;     // the only instance that adds frames to it
+};
+typedef std::map<std::string, std::shared_ptr<FPPUploadFile>> FPPUploadFileMap;
 
 class FPP : public BaseController
 {
     public:
-    FPP() : BaseController("", ""), majorVersion(0), minorVersion(0), outputFile(nullptr), parent(nullptr), curl(nullptr), isFPP(true) {}
+    FPP() : BaseController("", ""), majorVersion(0), minorVersion(0), parent(nullptr), curl(nullptr), isFPP(true) {}
     FPP(const std::string &ip, const std::string &proxy, const std::string &model);
     FPP(const std::string &address);
     FPP(const FPP &c);
@@ -61,9 +79,12 @@ class FPP : public BaseController
     bool PrepareUploadSequence(const FSEQFile &file,
                                const std::string &seq,
                                const std::string &media,
-                               int type);
+                               int type,
+                               FPPUploadFileMap *sharedFiles = nullptr);
     bool AddFrameToUpload(uint32_t frame, uint8_t *data);
     bool FinalizeUploadSequence();
+    // finalizes each shared file once and then uploads it to all the instances using it at the same time
+    static bool FinalizeUploadSequences(const std::list<FPP*> &instances, wxProgressDialog *progress);
 
 
     bool UploadUDPOutputsForProxy(OutputManager* outputManager);
@@ -119,9 +140,22 @@ private:
                           const std::string &dir);
     bool uploadFile(const std::string &filename,
                     const std::string &file);
+    FPPUploadState *startUpload(const std::string &filename,
+                                const std::string &file);
+    bool finishUpload(FPPUploadState *state, int curlResult);
+    static bool uploadFileToMany(const std::list<FPP*> &instances,
+                                 const std::string &filename,
+                                 const std::string &file,
+                                 wxProgressDialog *progress);
     bool copyFile(const std::string &filename,
                   const std::string &file,
                   const std::string &dir);
+    bool GetRemoteSequenceHeader(const std::string &baseName, std::vector<uint8_t> &header);
+    enum { REMOTE_SEQUENCE_DIFFERENT, REMOTE_SEQUENCE_SAME_LAYOUT, REMOTE_SEQUENCE_SAME };
+    int CompareRemoteSequence(const std::string &baseName, const V2FSEQFile &file, uint64_t &remoteId);
+    void StartBlockCompare(const std::string &baseName, const V2FSEQFile &file, int remoteState, uint64_t remoteId);
+    bool IsUploadUnchanged() const;
+    void SaveBlockHashes();
 
     bool parseSysInfo(wxJSONValue& v);
     void parseControllerType(wxJSONValue& v);
@@ -130,9 +164,15 @@ private:
 
 
     std::map<std::string, std::string> sequences;
-    std::string tempFileName;
     std::string baseSeqName;
-    FSEQFile *outputFile = nullptr;
+    std::shared_ptr<FPPUploadFile> outputFile;
+    std::string directUploadFile;
+
+    // per block hashes of the frames being uploaded and of what the player was last sent
+    std::vector<std::pair<uint32_t, uint32_t>> uploadHashRanges;
+    std::vector<uint64_t> uploadBlockHashes;
+    std::vector<uint64_t> remoteBlockHashes;
+    uint64_t uploadUniqueId = 0;
 
     void setupCurl();
     CURL *curl = nullptr;
@@ -693,6 +693,9 @@ void FPPConnectDialog::OnButton_UploadClick(wxCommandEvent& event)
 
             FSEQFile *seq = FSEQFile::openFSEQFile(fseq);
             if (seq) {
+                // instances that need the same output share a single generated file
+                FPPUploadFileMap sharedFiles;
+                std::list<FPP*> uploadInstances;
                 row = 0;
                 for (const auto& inst : instances) {
                     std::string rowStr = std::to_string(row);
@@ -705,7 +708,9 @@ void FPPConnectDialog::OnButton_UploadClick(wxCommandEvent& event)
                         int fseqType = GetChoiceValueIndex(FSEQ_COL + rowStr);
                         cancelled |= inst->PrepareUploadSequence(*seq,
                                                                 fseq, m2,
-                                                                fseqType);
+                                                                fseqType,
+                                                                &sharedFiles);
+                        uploadInstances.push_back(inst);
                     }
                     row++;
                 }
@@ -755,12 +760,8 @@ void FPPConnectDialog::OnButton_UploadClick(wxCommandEvent& event)
                         parallel_for(instances, func);
                     }
                 }
-                row = 0;
-                for (const auto &inst : instances) {
-                    if (!cancelled && doUpload[row]) {
-                        cancelled |= inst->FinalizeUploadSequence();
-                    }
-                    row++;
+                if (!cancelled) {
+                    cancelled |= FPP::FinalizeUploadSequences(uploadInstances, &prgs);
                 }
             }
             delete seq;
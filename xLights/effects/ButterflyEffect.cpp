@@ -100,215 +100,216 @@ void ButterflyEffect::Render(Effect *effect, SettingsMap &SettingsMap, RenderBuf
     const double offset = (ButterflyDirection==1 ? -1 : 1) * double(curState)/200.0;
     const int xc=buffer.BufferWi/2;
     const int yc=buffer.BufferHt/2;
-    int block = buffer.BufferHt * buffer.BufferWi > 100 ? 1 : -1;
-    parallel_for(0, buffer.BufferWi, [&buffer, Style, &xc, &yc, &offset, frame, maxframe, Chunks, colorcnt, Skip, ColorScheme, butterFlySpeed](int x) {
-        double  fractpart, intpart;
-        double h=0.0,hue1,hue2;
-        xlColor color;
-        HSVValue hsv;
-        int y, d, x0, y0;
-        double n,x1,y1,f;
-        double rx,ry,cx,cy,v,time,multiplier;
+    parallel_for_range(0, buffer.BufferWi, [&buffer, Style, &xc, &yc, &offset, frame, maxframe, Chunks, colorcnt, Skip, ColorScheme, butterFlySpeed](int xStart, int xEnd) {
+        for (int x = xStart; x < xEnd; x++) {
+            double  fractpart, intpart;
+            double h=0.0,hue1,hue2;
+            xlColor color;
+            HSVValue hsv;
+            int y, d, x0, y0;
+            double n,x1,y1,f;
+            double rx,ry,cx,cy,v,time,multiplier;
 
-        for (y=0; y<buffer.BufferHt; y++)
-        {
-            switch (Style)
+            for (y=0; y<buffer.BufferHt; y++)
             {
-                case 1:
-                    //  http://mathworld.wolfram.com/ButterflyFunction.html
-                    n = std::abs((x*x - y*y) * buffer.sin (offset + ((x+y)*pi2 / float(buffer.BufferHt+buffer.BufferWi))));
-                    d = x*x + y*y;
+                switch (Style)
+                {
+                    case 1:
+                        //  http://mathworld.wolfram.com/ButterflyFunction.html
+                        n = std::abs((x*x - y*y) * buffer.sin (offset + ((x+y)*pi2 / float(buffer.BufferHt+buffer.BufferWi))));
+                        d = x*x + y*y;
                     
-                    //  This section is to fix the colors on pixels at {0,1} and {1,0}
-                    x0=x+1;
-                    y0=y+1;
-                    if((x==0 && y==1))
-                    {
-                        n = std::abs((x*x - y0*y0) * buffer.sin (offset + ((x+y0)*pi2 / float(buffer.BufferHt+buffer.BufferWi))));
-                        d = x*x + y0*y0;
-                    }
-                    if((x==1 && y==0))
-                    {
-                        n = std::abs((x0*x0 - y*y) * buffer.sin (offset + ((x0+y)*pi2 / float(buffer.BufferHt+buffer.BufferWi))));
-                        d = x0*x0 + y*y;
-                    }
-                    // end of fix
+                        //  This section is to fix the colors on pixels at {0,1} and {1,0}
+                        x0=x+1;
+                        y0=y+1;
+                        if((x==0 && y==1))
+                        {
+                            n = std::abs((x*x - y0*y0) * buffer.sin (offset + ((x+y0)*pi2 / float(buffer.BufferHt+buffer.BufferWi))));
+                            d = x*x + y0*y0;
+                        }
+                        if((x==1 && y==0))
+                        {
+                            n = std::abs((x0*x0 - y*y) * buffer.sin (offset + ((x0+y)*pi2 / float(buffer.BufferHt+buffer.BufferWi))));
+                            d = x0*x0 + y*y;
+                        }
+                        // end of fix
                     
-                    h=d>0.001 ? n/d : 0.0;
-                    break;
+                        h=d>0.001 ? n/d : 0.0;
+                        break;
                     
-                case 2:
-                    f=(frame < maxframe/2) ? frame+1 : maxframe - frame;
-                    x1=(double(x)-buffer.BufferWi/2.0)/f;
-                    y1=(double(y)-buffer.BufferHt/2.0)/f;
-                    h=sqrt(x1*x1+y1*y1);
-                    break;
+                    case 2:
+                        f=(frame < maxframe/2) ? frame+1 : maxframe - frame;
+                        x1=(double(x)-buffer.BufferWi/2.0)/f;
+                        y1=(double(y)-buffer.BufferHt/2.0)/f;
+                        h=sqrt(x1*x1+y1*y1);
+                        break;
                     
-                case 3:
-                    f=(frame < maxframe/2) ? frame+1 : maxframe - frame;
-                    f=f*0.1+double(buffer.BufferHt)/60.0;
-                    x1 = (x-buffer.BufferWi/2.0)/f;
-                    y1 = (y-buffer.BufferHt/2.0)/f;
-                    h=buffer.sin(x1) * buffer.cos(y1);
-                    break;
+                    case 3:
+                        f=(frame < maxframe/2) ? frame+1 : maxframe - frame;
+                        f=f*0.1+double(buffer.BufferHt)/60.0;
+                        x1 = (x-buffer.BufferWi/2.0)/f;
+                        y1 = (y-buffer.BufferHt/2.0)/f;
+                        h=buffer.sin(x1) * buffer.cos(y1);
+                        break;
                     
-                case 4:
-                    //  http://mathworld.wolfram.com/ButterflyFunction.html
-                    n = ((x*x - y*y) * buffer.sin (offset + ((x+y)*pi2 / float(buffer.BufferHt+buffer.BufferWi))));
-                    d = x*x + y*y;
+                    case 4:
+                        //  http://mathworld.wolfram.com/ButterflyFunction.html
+                        n = ((x*x - y*y) * buffer.sin (offset + ((x+y)*pi2 / float(buffer.BufferHt+buffer.BufferWi))));
+                        d = x*x + y*y;
                     
-                    //  This section is to fix the colors on pixels at {0,1} and {1,0}
-                    x0=x+1;
-                    y0=y+1;
-                    if((x==0 && y==1))
-                    {
-                        n = ((x*x - y0*y0) * buffer.sin (offset + ((x+y0)*pi2 / float(buffer.BufferHt+buffer.BufferWi))));
-                        d = x*x + y0*y0;
-                    }
-                    if((x==1 && y==0))
-                    {
-                        n = ((x0*x0 - y*y) * buffer.sin (offset + ((x0+y)*pi2 / float(buffer.BufferHt+buffer.BufferWi))));
-                        d = x0*x0 + y*y;
-                    }
-                    // end of fix
+                        //  This section is to fix the colors on pixels at {0,1} and {1,0}
+                        x0=x+1;
+                        y0=y+1;
+                        if((x==0 && y==1))
+                        {
+                            n = ((x*x - y0*y0) * buffer.sin (offset + ((x+y0)*pi2 / float(buffer.BufferHt+buffer.BufferWi))));
+                            d = x*x + y0*y0;
+                        }
+                        if((x==1 && y==0))
+                        {
+                            n = ((x0*x0 - y*y) * buffer.sin (offset + ((x0+y)*pi2 / float(buffer.BufferHt+buffer.BufferWi))));
+                            d = x0*x0 + y*y;
+                        }
+                        // end of fix
                     
-                    h=d>0.001 ? n/d : 0.0;
-                    fractpart = modf (h , &intpart);
-                    h=fractpart;
-                    if(h<0) h=1.0+h;
-                    break;
+                        h=d>0.001 ? n/d : 0.0;
+                        fractpart = modf (h , &intpart);
+                        h=fractpart;
+                        if(h<0) h=1.0+h;
+                        break;
                     
-                case 5:
-                    //  http://mathworld.wolfram.com/ButterflyFunction.html
-                    n = std::abs((x*x - y*y) * buffer.sin (offset + ((x+y)*pi2 / float(buffer.BufferHt*buffer.BufferWi))));
-                    d = x*x + y*y;
+                    case 5:
+                        //  http://mathworld.wolfram.com/ButterflyFunction.html
+                        n = std::abs((x*x - y*y) * buffer.sin (offset + ((x+y)*pi2 / float(buffer.BufferHt*buffer.BufferWi))));
+                        d = x*x + y*y;
                     
-                    //  This section is to fix the colors on pixels at {0,1} and {1,0}
-                    x0=x+1;
-                    y0=y+1;
-                    if((x==0 && y==1))
-                    {
-                        n = std::abs((x*x - y0*y0) * buffer.sin (offset + ((x+y0)*pi2 / float(buffer.BufferHt*buffer.BufferWi))));
-                        d = x*x + y0*y0;
-                    }
-                    if((x==1 && y==0))
-                    {
-                        n = std::abs((x0*x0 - y*y) * buffer.sin (offset + ((x0+y)*pi2 / float(buffer.BufferHt*buffer.BufferWi))));
-                        d = x0*x0 + y*y;
-                    }
-                    // end of fix
+                        //  This section is to fix the colors on pixels at {0,1} and {1,0}
+                        x0=x+1;
+                        y0=y+1;
+                        if((x==0 && y==1))
+                        {
+                            n = std::abs((x*x - y0*y0) * buffer.sin (offset + ((x+y0)*pi2 / float(buffer.BufferHt*buffer.BufferWi))));
+                            d = x*x + y0*y0;
+                        }
+                        if((x==1 && y==0))
+                        {
+                            n = std::abs((x0*x0 - y*y) * buffer.sin (offset + ((x0+y)*pi2 / float(buffer.BufferHt*buffer.BufferWi))));
+                            d = x0*x0 + y*y;
+                        }
+                        // end of fix
                     
-                    h=d>0.001 ? n/d : 0.0;
-                    break;
+                        h=d>0.001 ? n/d : 0.0;
+                        break;
                     
-            }
-            if(Style<=5)
-            {
+                }
+                if(Style<=5)
+                {
                 
                 
-                hsv.saturation=1.0;
-                hsv.value=1.0;
-                if (Chunks <= 1 || int(h*Chunks) % Skip != 0)
-                {
-                    if (ColorScheme == 0)
-                    {
-                        hsv.hue=h;
-                        buffer.SetPixel(x,y,hsv);
-                    }
-                    else
+                    hsv.saturation=1.0;
+                    hsv.value=1.0;
+                    if (Chunks <= 1 || int(h*Chunks) % Skip != 0)
                     {
-                        buffer.GetMultiColorBlend(h,false,color);
-                        buffer.SetPixel(x,y,color);
+                        if (ColorScheme == 0)
+                        {
+                            hsv.hue=h;
+                            buffer.SetPixel(x,y,hsv);
+                        }
+                        else
+                        {
+                            buffer.GetMultiColorBlend(h,false,color);
+                            buffer.SetPixel(x,y,color);
+                        }
                     }
                 }
-            }
-            else  // Plasma
-            {
-                // reference: http://www.bidouille.org/prog/plasma
+                else  // Plasma
+                {
+                    // reference: http://www.bidouille.org/prog/plasma
                 
-                int state = (buffer.curPeriod - buffer.curEffStartPer); // frames 0 to N
-                double Speed_plasma = (Style == 10) ? (101-butterFlySpeed)*3 : (101-butterFlySpeed)*5;
-                time = (state+1.0)/Speed_plasma;
+                    int state = (buffer.curPeriod - buffer.curEffStartPer); // frames 0 to N
+                    double Speed_plasma = (Style == 10) ? (101-butterFlySpeed)*3 : (101-butterFlySpeed)*5;
+                    time = (state+1.0)/Speed_plasma;
                 
-                v=0;
+                    v=0;
                 
-                rx = ((float)x/buffer.BufferWi) -0.5;
-                ry = ((float)y/buffer.BufferHt) -0.5;
+                    rx = ((float)x/buffer.BufferWi) -0.5;
+                    ry = ((float)y/buffer.BufferHt) -0.5;
                 
                 
                 
-                // 1st equation
-                v=buffer.sin(rx*10+time);
+                    // 1st equation
+                    v=buffer.sin(rx*10+time);
                 
-                //  second equation
-                v+=buffer.sin(10*(rx*buffer.sin(time/2)+ry*buffer.cos(time/3))+time);
+                    //  second equation
+                    v+=buffer.sin(10*(rx*buffer.sin(time/2)+ry*buffer.cos(time/3))+time);
                 
-                //  third equation
-                cx=rx+.5*buffer.sin(time/5);
-                cy=ry+.5*buffer.cos(time/3);
-                v+=buffer.sin ( sqrt(100*((cx*cx)+(cy*cy))+1+time));
+                    //  third equation
+                    cx=rx+.5*buffer.sin(time/5);
+                    cy=ry+.5*buffer.cos(time/3);
+                    v+=buffer.sin ( sqrt(100*((cx*cx)+(cy*cy))+1+time));
                 
                 
-                //    vec2 c = v_coords * u_k - u_k/2.0;
-                v += buffer.sin(rx+time);
-                v += buffer.sin((ry+time)/2.0);
-                v += buffer.sin((rx+ry+time)/2.0);
-                //   c += u_k/2.0 * vec2(sin(u_time/3.0), cos(u_time/2.0));
-                v += buffer.sin(sqrt(rx*rx+ry*ry+1.0)+time);
-                v = v/2.0;
-                // vec3 col = vec3(1, sin(PI*v), cos(PI*v));
-                //   gl_FragColor = vec4(col*.5 + .5, 1);
+                    //    vec2 c = v_coords * u_k - u_k/2.0;
+                    v += buffer.sin(rx+time);
+                    v += buffer.sin((ry+time)/2.0);
+                    v += buffer.sin((rx+ry+time)/2.0);
+                    //   c += u_k/2.0 * vec2(sin(u_time/3.0), cos(u_time/2.0));
+                    v += buffer.sin(sqrt(rx*rx+ry*ry+1.0)+time);
+                    v = v/2.0;
+                    // vec3 col = vec3(1, sin(PI*v), cos(PI*v));
+                    //   gl_FragColor = vec4(col*.5 + .5, 1);
                 
-                buffer.GetMultiColorBlend(h,false,color);
-                //color.red=color.green=color.blue=h*255;
-                switch (Style)
-                {
-                    case 6:
-                        color.red = (buffer.sin(v*Chunks*pi)+1)*128;
-                        color.green= (buffer.cos(v*Chunks*pi)+1)*128;
-                        color.blue =0;
-                        break;
-                    case 7:
-                        color.red = 1;
-                        color.green= (buffer.cos(v*Chunks*pi)+1)*128;
-                        color.blue =(buffer.sin(v*Chunks*pi)+1)*128;
-                        break;
+                    buffer.GetMultiColorBlend(h,false,color);
+                    //color.red=color.green=color.blue=h*255;
+                    switch (Style)
+                    {
+                        case 6:
+                            color.red = (buffer.sin(v*Chunks*pi)+1)*128;
+                            color.green= (buffer.cos(v*Chunks*pi)+1)*128;
+                            color.blue =0;
+                            break;
+                        case 7:
+                            color.red = 1;
+                            color.green= (buffer.cos(v*Chunks*pi)+1)*128;
+                            color.blue =(buffer.sin(v*Chunks*pi)+1)*128;
+                            break;
                         
-                    case 8:
-                        color.red = (buffer.sin(v*Chunks*pi)+1)*128;
-                        color.green= (buffer.sin(v*Chunks*pi + 2*pi/3)+1)*128;
-                        color.blue =(buffer.sin(v*Chunks*pi+4*pi/3)+1)*128;
-                        break;
+                        case 8:
+                            color.red = (buffer.sin(v*Chunks*pi)+1)*128;
+                            color.green= (buffer.sin(v*Chunks*pi + 2*pi/3)+1)*128;
+                            color.blue =(buffer.sin(v*Chunks*pi+4*pi/3)+1)*128;
+                            break;
                         
-                    case 9:
-                        color.red=color.green=color.blue=(buffer.sin(v*Chunks*pi) +1) * 128;
-                        break;
-                    case 10:
-                        if(colorcnt>=2)
-                        {
-                            buffer.GetMultiColorBlend(h,false,color);
+                        case 9:
+                            color.red=color.green=color.blue=(buffer.sin(v*Chunks*pi) +1) * 128;
+                            break;
+                        case 10:
+                            if(colorcnt>=2)
+                            {
+                                buffer.GetMultiColorBlend(h,false,color);
                             
-                            hue1=.1;
-                            hue1=0;
-                            hue2=.7;
-                            hue2=1;
-                            multiplier=(hue2-hue1)/2;
-                            h=hue1+ multiplier*(v+1); // v is between -1 to 1. h
-                            h = buffer.sin(v*Chunks*pi+2*pi/3)+1*0.5;
+                                hue1=.1;
+                                hue1=0;
+                                hue2=.7;
+                                hue2=1;
+                                multiplier=(hue2-hue1)/2;
+                                h=hue1+ multiplier*(v+1); // v is between -1 to 1. h
+                                h = buffer.sin(v*Chunks*pi+2*pi/3)+1*0.5;
                             
-                            hsv.hue=h;
-                            //  hsv.hue=hsv.hue + (v+1)/20.0;
-                            //color.red = (buffer.sin(v*color.red)+1)*128;
-                            //color.green = (buffer.sin(v*color.green)+1)*128;
-                            //color.blue = (buffer.sin(v*color.blue)+1)*128;
+                                hsv.hue=h;
+                                //  hsv.hue=hsv.hue + (v+1)/20.0;
+                                //color.red = (buffer.sin(v*color.red)+1)*128;
+                                //color.green = (buffer.sin(v*color.green)+1)*128;
+                                //color.blue = (buffer.sin(v*color.blue)+1)*128;
                             
-                        }
-                        break;
-                }
+                            }
+                            break;
+                    }
                 
-                buffer.SetPixel(x,y,color);
+                    buffer.SetPixel(x,y,color);
+                }
             }
         }
-    }, block);
+    });
 }
 
@@ -22,6 +22,7 @@
 #include "../UtilFunctions.h"
 #include "../xLightsMain.h" 
 #include "PicturesEffect.h"
+#include "ImageCache.h"
 
 #include <wx/tokenzr.h>
 
@@ -199,12 +200,12 @@ std::list<std::string> FacesEffect::CheckEffectSettings(const SettingsMap& setti
 
                     if (wxFileExists(picture))
                     {
-                        wxImage i;
-                        i.LoadFile(picture);
-                        if (i.IsOk())
+                        // decoded through the cache so the render that follows does not decode it again
+                        auto i = ImageCache::instance().GetFrame(picture, ImageCache::GetModified(picture), 0, false);
+                        if (i != nullptr)
                         {
-                            int ih = i.GetHeight();
-                            int iw = i.GetWidth();
+                            int ih = i->GetHeight();
+                            int iw = i->GetWidth();
 
 #define IMAGESIZETHRESHOLD 10
                             if (ih > IMAGESIZETHRESHOLD * model->GetDefaultBufferHt() || iw > IMAGESIZETHRESHOLD * model->GetDefaultBufferWi())
@@ -583,7 +584,7 @@ void FacesEffect::drawoutline(RenderBuffer &buffer, int Phoneme, bool outline, c
         {
             if ((buffer.curPeriod * buffer.frameTimeInMs) >= cache->nextBlinkTime) {
                 //roughly every 5 seconds we'll blink
-                cache->nextBlinkTime += (4500 + (rand() % 1000));
+                cache->nextBlinkTime += (4500 + (buffer.Rand() % 1000));
                 cache->blinkEndTime = buffer.curPeriod * buffer.frameTimeInMs + 101; //100ms blink
                 eye = "Closed";
             }
@@ -891,7 +892,7 @@ void FacesEffect::RenderFaces(RenderBuffer &buffer,
             if ("Auto" == eyes) {
                 if ((buffer.curPeriod * buffer.frameTimeInMs) >= cache->nextBlinkTime) {
                     //roughly every 5 seconds we'll blink
-                    cache->nextBlinkTime += (4500 + (rand() % 1000));
+                    cache->nextBlinkTime += (4500 + (buffer.Rand() % 1000));
                     cache->blinkEndTime = buffer.curPeriod * buffer.frameTimeInMs + 101; //100ms blink
                     eyes = "Closed";
                 }
@@ -944,7 +945,7 @@ void FacesEffect::RenderFaces(RenderBuffer &buffer,
                 if ((buffer.curPeriod * buffer.frameTimeInMs) >= cache->nextBlinkTime) {
                     if ((startms + 150) >= (buffer.curPeriod * buffer.frameTimeInMs)) {
                         //don't want to blink RIGHT at the start of the rest, delay a little bie
-                        int tmp = (buffer.curPeriod * buffer.frameTimeInMs) + 150 + rand() % 400;
+                        int tmp = (buffer.curPeriod * buffer.frameTimeInMs) + 150 + buffer.Rand() % 400;
 
                         //also don't want it right at the end
                         if ((tmp + 130) > endms) {
@@ -956,7 +957,7 @@ void FacesEffect::RenderFaces(RenderBuffer &buffer,
                     }
                     else {
                         //roughly every 5 seconds we'll blink
-                        cache->nextBlinkTime += (4500 + (rand() % 1000));
+                        cache->nextBlinkTime += (4500 + (buffer.Rand() % 1000));
                         cache->blinkEndTime = buffer.curPeriod * buffer.frameTimeInMs + 101; //100ms blink
                         eyes = "Closed";
                     }
@@ -975,7 +976,7 @@ void FacesEffect::RenderFaces(RenderBuffer &buffer,
         if ("Auto" == eyes) {
             if ((buffer.curPeriod * buffer.frameTimeInMs) >= cache->nextBlinkTime) {
                 //roughly every 5 seconds we'll blink
-                cache->nextBlinkTime += (4500 + (rand() % 1000));
+                cache->nextBlinkTime += (4500 + (buffer.Rand() % 1000));
                 cache->blinkEndTime = buffer.curPeriod * buffer.frameTimeInMs + 101; //100ms blink
                 eyes = "Closed";
             }
@@ -163,6 +163,8 @@ class FireRenderCache : public EffectRenderCache {
 public:
     FireRenderCache() {};
     virtual ~FireRenderCache() {};
+    virtual EffectRenderCache* Clone() const override { return new FireRenderCache(*this); }
+    virtual size_t GetMemorySize() const override { return sizeof(*this) + FireBuffer.capacity() * sizeof(int); }
 
     std::vector<int> FireBuffer;
 };
@@ -261,7 +263,7 @@ void FireEffect::Render(Effect *effect, SettingsMap &SettingsMap, RenderBuffer &
     }
     // build fire
     for (x=0; x<maxMWi; x++) {
-        int r = x%2==0 ? 190+(rand() % 10) : 100+(rand() % 50);
+        int r = x%2==0 ? 190+(buffer.Rand() % 10) : 100+(buffer.Rand() % 50);
         SetFireBuffer(x,0,r, cache->FireBuffer, maxMWi, maxMHt);
     }
     int step=255*100/maxHt/HeightPct;
@@ -298,7 +300,7 @@ void FireEffect::Render(Effect *effect, SettingsMap &SettingsMap, RenderBuffer &
             int new_index = n > 0 ? sum / n : 0;
             if (new_index > 0)
             {
-                new_index+=(rand() % 100 < 20) ? step : -step;
+                new_index+=(buffer.Rand() % 100 < 20) ? step : -step;
                 if (new_index < 0) new_index=0;
                 if (new_index >= FirePalette.size()) new_index = FirePalette.size()-1;
             }
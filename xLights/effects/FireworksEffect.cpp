@@ -74,7 +74,7 @@ class FireworkParticle
     int _age = 0;
 
 public:
-    FireworkParticle(int x, int y, double vx, double vy, int fade, bool gravity, int colourIndex, bool holdColour, double velocity, int width, int height, int frameMS, const PaletteClass& palette)
+    FireworkParticle(int x, int y, double vx, double vy, int fade, bool gravity, int colourIndex, bool holdColour, double velocity, int width, int height, int frameMS, const PaletteClass& palette, RenderBuffer& buffer)
     {
         _width = width;
         _height = height;
@@ -92,8 +92,8 @@ public:
 
         _fps = 1000.0 / frameMS;
 
-        double explosionVelocity = (rand() - RAND_MAX / 2)*velocity / (RAND_MAX / 2);
-        double angle = 2 * M_PI*rand() / RAND_MAX;
+        double explosionVelocity = (buffer.Rand() - RenderRandom::RANDOM_MAX / 2)*velocity / (RenderRandom::RANDOM_MAX / 2);
+        double angle = 2 * M_PI*buffer.Rand() / RenderRandom::RANDOM_MAX;
         _vx = 3.0 * vx / 100 + explosionVelocity * cos(angle);
         _vy = 3.0 * -vy / 100 + explosionVelocity * sin(angle);
     }
@@ -165,12 +165,12 @@ class Firework
     std::vector<FireworkParticle> _particles;
 
 public:
-    Firework(int particles, int x, int y, double vx, double vy, int fade, bool gravity, int colourIndex, bool holdColour, double velocity, int width, int height, int frameMS, const PaletteClass& palette)
+    Firework(int particles, int x, int y, double vx, double vy, int fade, bool gravity, int colourIndex, bool holdColour, double velocity, int width, int height, int frameMS, const PaletteClass& palette, RenderBuffer& buffer)
     {
         _cycles = 0;
         for (int i = 0; i < particles; i++)
         {
-            _particles.push_back(FireworkParticle(x, y, vx, vy, fade, gravity, colourIndex, holdColour, velocity, width, height, frameMS, palette));
+            _particles.push_back(FireworkParticle(x, y, vx, vy, fade, gravity, colourIndex, holdColour, velocity, width, height, frameMS, palette, buffer));
         }
     }
 
@@ -211,6 +211,14 @@ class FireworksRenderCache : public EffectRenderCache {
 public:
     FireworksRenderCache() {};
     virtual ~FireworksRenderCache() {};
+    virtual EffectRenderCache* Clone() const override { return new FireworksRenderCache(*this); }
+    virtual size_t GetMemorySize() const override {
+        size_t size = sizeof(*this) + _firePeriods.capacity() * sizeof(int);
+        for (const auto& it : _fireworks) {
+            size += sizeof(Firework) + 2 * sizeof(void*) + it.GetParticles().capacity() * sizeof(FireworkParticle);
+        }
+        return size;
+    }
     int _sinceLastTriggered = 0;
     std::list<Firework> _fireworks;
     std::vector<int> _firePeriods;
@@ -305,8 +313,10 @@ void FireworksEffect::SetPanelTimingTracks() const
     wxPostEvent(fp, event);
 }
 
-std::pair<int,int> FireworksEffect::GetFireworkLocation(int width, int height, int overridex, int overridey)
+std::pair<int,int> FireworksEffect::GetFireworkLocation(RenderBuffer& buffer, int overridex, int overridey)
 {
+    int width = buffer.BufferWi;
+    int height = buffer.BufferHt;
     int startX;
     int startY;
     if (overridex >= 0)
@@ -317,7 +327,7 @@ std::pair<int,int> FireworksEffect::GetFireworkLocation(int width, int height, i
     {
         int x25 = static_cast<int>(0.25f * width);
         int x75 = static_cast<int>(0.75f * width);
-        if ((x75 - x25) > 0) startX = x25 + rand() % (x75 - x25); else startX = 0;
+        if ((x75 - x25) > 0) startX = x25 + buffer.Rand() % (x75 - x25); else startX = 0;
     }
 
     if (overridey >= 0)
@@ -328,7 +338,7 @@ std::pair<int,int> FireworksEffect::GetFireworkLocation(int width, int height, i
     {
         int y25 = static_cast<int>(0.25f * height);
         int y75 = static_cast<int>(0.75f * height);
-        if ((y75 - y25) > 0) startY = y25 + rand() % (y75 - y25); else startY = 0;
+        if ((y75 - y25) > 0) startY = y25 + buffer.Rand() % (y75 - y25); else startY = 0;
     }
     return { startX, startY };
 }
@@ -386,7 +396,7 @@ void FireworksEffect::Render(Effect *effect, SettingsMap &SettingsMap, RenderBuf
         if (!useMusic && !useTiming)
         {
             for (int i = 0; i < numberOfExplosions; i++) {
-                firePeriods.push_back(buffer.curEffStartPer + rand01() * (buffer.curEffEndPer - buffer.curEffStartPer));
+                firePeriods.push_back(buffer.curEffStartPer + buffer.Rand01() * (buffer.curEffEndPer - buffer.curEffStartPer));
             }
         }
 
@@ -404,8 +414,8 @@ void FireworksEffect::Render(Effect *effect, SettingsMap &SettingsMap, RenderBuf
             // trigger if it was not previously triggered or has been triggered for REPEATTRIGGER frames
             if (sinceLastTriggered == 0 || sinceLastTriggered > REPEATTRIGGER)
             {
-                auto location = GetFireworkLocation(buffer.BufferWi, buffer.BufferHt, xLocation, yLocation);
-                int colourIndex = rand() % colorcnt;
+                auto location = GetFireworkLocation(buffer, xLocation, yLocation);
+                int colourIndex = buffer.Rand() % colorcnt;
                 fireworks.push_back(Firework(particleCount,
                     location.first, location.second,
                     xVelocity, yVelocity,
@@ -413,7 +423,7 @@ void FireworksEffect::Render(Effect *effect, SettingsMap &SettingsMap, RenderBuf
                     colourIndex, holdColour,
                     particleVelocity,
                     buffer.BufferWi, buffer.BufferHt,
-                    buffer.frameTimeInMs, buffer.palette));
+                    buffer.frameTimeInMs, buffer.palette, buffer));
             }
 
             // if music is over the trigger level for REPEATTRIGGER frames then we will trigger another firework
@@ -453,8 +463,8 @@ void FireworksEffect::Render(Effect *effect, SettingsMap &SettingsMap, RenderBuf
                     if (buffer.curPeriod == el->GetEffect(j)->GetStartTimeMS() / buffer.frameTimeInMs ||
                         buffer.curPeriod == el->GetEffect(j)->GetEndTimeMS() / buffer.frameTimeInMs)
                     {
-                        auto location = GetFireworkLocation(buffer.BufferWi, buffer.BufferHt, xLocation, yLocation);
-                        int colourIndex = rand() % colorcnt;
+                        auto location = GetFireworkLocation(buffer, xLocation, yLocation);
+                        int colourIndex = buffer.Rand() % colorcnt;
                         fireworks.push_back(Firework(particleCount,
                             location.first, location.second,
                             xVelocity, yVelocity,
@@ -462,7 +472,7 @@ void FireworksEffect::Render(Effect *effect, SettingsMap &SettingsMap, RenderBuf
                             colourIndex, holdColour,
                             particleVelocity,
                             buffer.BufferWi, buffer.BufferHt,
-                            buffer.frameTimeInMs, buffer.palette));
+                            buffer.frameTimeInMs, buffer.palette, buffer));
                         break;
                     }
                 }
@@ -476,8 +486,8 @@ void FireworksEffect::Render(Effect *effect, SettingsMap &SettingsMap, RenderBuf
         {
             if (it == buffer.curPeriod)
             {
-                auto location = GetFireworkLocation(buffer.BufferWi, buffer.BufferHt, xLocation, yLocation);
-                int colourIndex = rand() % colorcnt;
+                auto location = GetFireworkLocation(buffer, xLocation, yLocation);
+                int colourIndex = buffer.Rand() % colorcnt;
                 fireworks.push_back(Firework(particleCount,
                     location.first, location.second,
                     xVelocity, yVelocity,
@@ -485,7 +495,7 @@ void FireworksEffect::Render(Effect *effect, SettingsMap &SettingsMap, RenderBuf
                     colourIndex, holdColour,
                     particleVelocity,
                     buffer.BufferWi, buffer.BufferHt,
-                    buffer.frameTimeInMs, buffer.palette));
+                    buffer.frameTimeInMs, buffer.palette, buffer));
             }
         }
     }
@@ -42,12 +42,13 @@ class FireworksEffect : public RenderableEffect
         virtual void SetDefaultParameters() override;
         virtual void SetPanelStatus(Model *cls) override;
         virtual void Render(Effect *effect, SettingsMap &settings, RenderBuffer &buffer) override;
+        virtual bool SupportsCheckpoints() const override { return true; }
         virtual std::list<std::string> CheckEffectSettings(const SettingsMap& settings, AudioManager* media, Model* model, Effect* eff, bool renderCache) override;
         virtual bool AppropriateOnNodes() const override { return false; }
 protected:
         virtual wxPanel *CreatePanel(wxWindow *parent) override;
         void SetPanelTimingTracks() const;
-        static std::pair<int, int> GetFireworkLocation(int width, int height, int overridex = -1, int overridey = -1);
+        static std::pair<int, int> GetFireworkLocation(RenderBuffer& buffer, int overridex = -1, int overridey = -1);
         virtual bool needToAdjustSettings(const std::string &version) override;
         virtual void adjustSettings(const std::string &version, Effect *effect, bool removeDefaults = true) override;
 };
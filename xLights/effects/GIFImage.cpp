@@ -89,6 +89,19 @@ int GIFImage::CalcFrameForTime(int msec, bool loop)
 	return frame-1; // we shouldn't get here
 }
 
+// the decoder holds every frame as palette indexes plus its palette and we keep the last composed frame
+size_t GIFImage::GetMemorySize() const
+{
+    if (!_ok) return 0;
+
+    size_t size = (size_t)_gifSize.GetWidth() * _gifSize.GetHeight() * 4;
+    for (const auto& it : _frameSizes)
+    {
+        size += (size_t)it.GetWidth() * it.GetHeight() + 256 * 3;
+    }
+    return size;
+}
+
 void GIFImage::ReadFrameProperties()
 {
     wxLogNull logNo;  // suppress popups from gif images.
@@ -33,7 +33,6 @@ class GIFImage
     bool _ok = false;
 	
 	void ReadFrameProperties();
-    int CalcFrameForTime(int msec, bool loop);
     wxPoint LoadRawImageFrame(wxImage& image, int frame, wxAnimationDisposal& disposal);
     void CopyImageToImage(wxImage& to, wxImage& from, wxPoint offset, bool overlay, bool dontaddtransparency = false);
     void DoCreate(const std::string& filename);
@@ -44,6 +43,9 @@ class GIFImage
 		wxImage GetFrame(int frame);
 		wxImage GetFrameForTime(int msec, bool loop);
         int GetMSUntilNextFrame(int msec, bool loop);
+        int CalcFrameForTime(int msec, bool loop);
+        wxSize GetImageSize() const { return _gifSize; }
+        size_t GetMemorySize() const;
         std::string GetFilename() const { return _filename; }
         bool IsOk() const { return _ok; }
 
@@ -0,0 +1,281 @@
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include "ImageCache.h"
+#include "GIFImage.h"
+
+#include <vector>
+#include <algorithm>
+#include <functional>
+
+#include <wx/filename.h>
+#include <wx/log.h>
+
+#include <log4cpp/Category.hh>
+
+long ImageCache::GetModified(const std::string& filename)
+{
+    wxFileName fn(filename);
+    if (!fn.FileExists()) return 0;
+    return (long)fn.GetModificationTime().GetTicks();
+}
+
+size_t ImageCache::GetImageSize(const wxImage& image)
+{
+    if (!image.IsOk()) return 0;
+    return (size_t)image.GetWidth() * image.GetHeight() * (image.HasAlpha() ? 4 : 3);
+}
+
+int ImageCache::GetImageCount(const std::string& filename, long modified)
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    auto key = std::make_pair(filename, modified);
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        auto it = _imageCounts.find(key);
+        if (it != _imageCounts.end()) return it->second;
+    }
+
+    wxLogNull logNo;  // suppress popups from png images. See http://trac.wxwidgets.org/ticket/15331
+
+    // There seems to be a bug on linux where this function crashes occasionally
+#ifdef LINUX
+    logger_base.debug("About to count images in bitmap %s.", (const char*)filename.c_str());
+#endif
+    int count = wxImage::GetImageCount(filename);
+    if (count <= 0) {
+        logger_base.error("Image %s reports %d frames which is invalid. Overriding it to be 1.", (const char*)filename.c_str(), count);
+        count = 1;
+    }
+
+    std::unique_lock<std::mutex> lock(_lock);
+    _imageCounts[key] = count;
+    return count;
+}
+
+std::shared_ptr<ImageCache::GIFEntry> ImageCache::GetGIF(const std::string& filename, long modified, bool suppressBackground)
+{
+    GIFKey key(filename, modified, suppressBackground);
+
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        auto it = _gifs.find(key);
+        if (it != _gifs.end()) {
+            it->second->_lastUsed = ++_useCounter;
+            return it->second;
+        }
+    }
+
+    // loading the gif reads the whole file so dont hold the lock while we do it
+    auto gif = std::make_shared<GIFEntry>();
+    gif->_gif = std::make_unique<GIFImage>(filename, suppressBackground);
+    gif->_size = gif->_gif->GetMemorySize();
+
+    std::unique_lock<std::mutex> lock(_lock);
+    auto it = _gifs.find(key);
+    if (it != _gifs.end()) {
+        it->second->_lastUsed = ++_useCounter;
+        return it->second;
+    }
+    gif->_lastUsed = ++_useCounter;
+    _gifs[key] = gif;
+    _memoryUsed += gif->_size;
+    Trim();
+    return gif;
+}
+
+std::shared_ptr<wxImage> ImageCache::LoadFrame(const std::string& filename, long modified, int frame, bool suppressBackground)
+{
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    if (GetImageCount(filename, modified) > 1) {
+        auto gif = GetGIF(filename, modified, suppressBackground);
+
+        // the decoder keeps state between frames so only one thread may use it at a time
+        std::unique_lock<std::mutex> lock(gif->_lock);
+        if (!gif->_gif->IsOk()) return nullptr;
+
+        if (frame < 0) {
+            return std::make_shared<wxImage>(gif->_gif->GetImageSize());
+        }
+
+        // take a deep copy so the cached image shares nothing with the decoder
+        return std::make_shared<wxImage>(gif->_gif->GetFrame(frame).Copy());
+    }
+
+    wxLogNull logNo;  // suppress popups from png images. See http://trac.wxwidgets.org/ticket/15331
+    auto image = std::make_shared<wxImage>();
+    if (!image->LoadFile(filename, wxBITMAP_TYPE_ANY, 0)) {
+        logger_base.error("Error loading image file: %s.", (const char*)filename.c_str());
+        image->Create(5, 5, true);
+    }
+    return image;
+}
+
+int ImageCache::GetGIFFrameForTime(const std::string& filename, long modified, int msec, bool loop, bool suppressBackground)
+{
+    auto gif = GetGIF(filename, modified, suppressBackground);
+
+    std::unique_lock<std::mutex> lock(gif->_lock);
+    if (!gif->_gif->IsOk()) return -1;
+    return gif->_gif->CalcFrameForTime(msec, loop);
+}
+
+std::shared_ptr<wxImage> ImageCache::GetFrame(const std::string& filename, long modified, int frame, bool suppressBackground)
+{
+    if (GetImageCount(filename, modified) <= 1) {
+        // still images only have one frame and the gif background setting is irrelevant
+        frame = 0;
+        suppressBackground = false;
+    }
+    FrameKey key(filename, modified, frame, suppressBackground);
+
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        auto it = _frames.find(key);
+        if (it != _frames.end()) {
+            it->second._lastUsed = ++_useCounter;
+            return it->second._image;
+        }
+    }
+
+    // decode without holding the lock so other files can be served meanwhile
+    auto image = LoadFrame(filename, modified, frame, suppressBackground);
+    if (image == nullptr || !image->IsOk()) return nullptr;
+
+    std::unique_lock<std::mutex> lock(_lock);
+    auto it = _frames.find(key);
+    if (it != _frames.end()) {
+        // another thread beat us to it ... use theirs
+        it->second._lastUsed = ++_useCounter;
+        return it->second._image;
+    }
+
+    CacheEntry& entry = _frames[key];
+    entry._image = image;
+    entry._size = GetImageSize(*image);
+    entry._lastUsed = ++_useCounter;
+    _memoryUsed += entry._size;
+    Trim();
+
+    return image;
+}
+
+std::shared_ptr<wxImage> ImageCache::GetScaledFrame(const std::string& filename, long modified, int frame, bool suppressBackground, int width, int height, wxImageResizeQuality quality)
+{
+    width = std::max(width, 1);
+    height = std::max(height, 1);
+
+    auto source = GetFrame(filename, modified, frame, suppressBackground);
+    if (source == nullptr) return nullptr;
+    if (source->GetWidth() == width && source->GetHeight() == height) return source;
+
+    if (GetImageCount(filename, modified) <= 1) {
+        frame = 0;
+        suppressBackground = false;
+    }
+    ScaledKey key(filename, modified, frame, suppressBackground, width, height, (int)quality);
+
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        auto it = _scaled.find(key);
+        if (it != _scaled.end()) {
+            it->second._lastUsed = ++_useCounter;
+            return it->second._image;
+        }
+    }
+
+    // scale a private copy so nothing we do can touch the shared image
+    auto image = std::make_shared<wxImage>(GetCopy(source).Scale(width, height, quality));
+    if (!image->IsOk()) return nullptr;
+
+    std::unique_lock<std::mutex> lock(_lock);
+    auto it = _scaled.find(key);
+    if (it != _scaled.end()) {
+        it->second._lastUsed = ++_useCounter;
+        return it->second._image;
+    }
+
+    CacheEntry& entry = _scaled[key];
+    entry._image = image;
+    entry._size = GetImageSize(*image);
+    entry._lastUsed = ++_useCounter;
+    _memoryUsed += entry._size;
+    Trim();
+
+    return image;
+}
+
+// must be called holding the lock
+void ImageCache::Trim()
+{
+    if (_memoryUsed <= _maxMemory) return;
+
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    // only entries nobody outside the cache is using can go
+    std::vector<std::pair<uint64_t, std::function<void()>>> candidates;
+    for (auto it = _frames.begin(); it != _frames.end(); ++it) {
+        if (it->second._image.use_count() == 1) {
+            candidates.push_back({ it->second._lastUsed, [this, it]() { _memoryUsed -= it->second._size; _frames.erase(it); } });
+        }
+    }
+    for (auto it = _scaled.begin(); it != _scaled.end(); ++it) {
+        if (it->second._image.use_count() == 1) {
+            candidates.push_back({ it->second._lastUsed, [this, it]() { _memoryUsed -= it->second._size; _scaled.erase(it); } });
+        }
+    }
+    for (auto it = _gifs.begin(); it != _gifs.end(); ++it) {
+        if (it->second.use_count() == 1) {
+            candidates.push_back({ it->second->_lastUsed, [this, it]() { _memoryUsed -= it->second->_size; _gifs.erase(it); } });
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    size_t before = _memoryUsed;
+    for (auto& it : candidates) {
+        if (_memoryUsed <= _maxMemory) break;
+        it.second();
+    }
+
+    logger_base.debug("Image cache trimmed from %lu to %lu bytes.", (unsigned long)before, (unsigned long)_memoryUsed);
+}
+
+wxImage ImageCache::GetCopy(const std::shared_ptr<wxImage>& image)
+{
+    // no lock ... our reference keeps the image alive and Copy only reads the shared pixels, it does
+    // not touch the reference count, so large copies on many threads do not queue up on the cache
+    std::shared_ptr<wxImage> source = image;
+    return source->Copy();
+}
+
+void ImageCache::SetMaxMemory(size_t bytes)
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    _maxMemory = bytes;
+    Trim();
+}
+
+size_t ImageCache::GetMemoryUsed()
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    return _memoryUsed;
+}
+
+void ImageCache::Clear()
+{
+    std::unique_lock<std::mutex> lock(_lock);
+    _frames.clear();
+    _scaled.clear();
+    _gifs.clear();
+    _imageCounts.clear();
+    _memoryUsed = 0;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+/***************************************************************
+ * This source files comes from the xLights project
+ * https://www.xlights.org
+ * https://github.com/smeighan/xLights
+ * See the github commit history for a record of contributing
+ * developers.
+ * Copyright claimed based on commit dates recorded in Github
+ * License: https://github.com/smeighan/xLights/blob/master/License.txt
+ **************************************************************/
+
+#include <string>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <wx/image.h>
+
+class GIFImage;
+
+// Process wide cache of decoded (and scaled) image frames so the same picture used on many
+// models is only decoded once per render.
+//
+// Frames are keyed by file, modification time and frame index so an edited file is reloaded.
+// Callers look the modification time up once with GetModified when they set up and pass it to
+// every request rather than checking the file each frame.
+// Images handed out are shared and must be treated as read only ... including not copying the
+// wxImage itself as wxImage reference counting is not thread safe. Use GetCopy to get a private
+// image to work on. Entries and gif decoders not referenced outside the cache are discarded least
+// recently used first once the memory cap is exceeded.
+class ImageCache
+{
+    typedef std::tuple<std::string, long, int, bool> FrameKey; // file, modified, frame, suppress gif background
+    typedef std::tuple<std::string, long, int, bool, int, int, int> ScaledKey; // frame key + width, height, quality
+    typedef std::tuple<std::string, long, bool> GIFKey;
+
+    struct CacheEntry
+    {
+        std::shared_ptr<wxImage> _image;
+        size_t _size = 0;
+        uint64_t _lastUsed = 0;
+    };
+
+    struct GIFEntry
+    {
+        std::unique_ptr<GIFImage> _gif;
+        std::mutex _lock;
+        size_t _size = 0;
+        uint64_t _lastUsed = 0;
+    };
+
+    std::mutex _lock;
+    std::map<FrameKey, CacheEntry> _frames;
+    std::map<ScaledKey, CacheEntry> _scaled;
+    std::map<GIFKey, std::shared_ptr<GIFEntry>> _gifs;
+    std::map<std::pair<std::string, long>, int> _imageCounts;
+    size_t _memoryUsed = 0;
+    size_t _maxMemory = 256 * 1024 * 1024;
+    uint64_t _useCounter = 0;
+
+    ImageCache() {}
+    static size_t GetImageSize(const wxImage& image);
+    std::shared_ptr<GIFEntry> GetGIF(const std::string& filename, long modified, bool suppressBackground);
+    std::shared_ptr<wxImage> LoadFrame(const std::string& filename, long modified, int frame, bool suppressBackground);
+    void Trim();
+
+public:
+
+    static ImageCache& instance()
+    {
+        static ImageCache cache;
+        return cache;
+    }
+
+    ImageCache(const ImageCache&) = delete;
+    ImageCache& operator=(const ImageCache&) = delete;
+
+    // modification time to pass to the other functions ... 0 if the file does not exist
+    static long GetModified(const std::string& filename);
+
+    // number of frames in the file ... always at least 1
+    int GetImageCount(const std::string& filename, long modified);
+
+    // frame of an animated gif to show at the given time or -1 if past the end
+    int GetGIFFrameForTime(const std::string& filename, long modified, int msec, bool loop, bool suppressBackground);
+
+    // returns nullptr if the frame cannot be decoded
+    std::shared_ptr<wxImage> GetFrame(const std::string& filename, long modified, int frame, bool suppressBackground);
+    std::shared_ptr<wxImage> GetScaledFrame(const std::string& filename, long modified, int frame, bool suppressBackground, int width, int height, wxImageResizeQuality quality = wxIMAGE_QUALITY_NORMAL);
+
+    // deep copy of a shared image that the caller is free to use and modify
+    wxImage GetCopy(const std::shared_ptr<wxImage>& image);
+
+    void SetMaxMemory(size_t bytes);
+    size_t GetMemoryUsed();
+    void Clear();
+};
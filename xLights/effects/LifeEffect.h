@@ -19,6 +19,7 @@ public:
     virtual ~LifeEffect();
     virtual void SetDefaultParameters() override;
     virtual void Render(Effect* effect, SettingsMap& settings, RenderBuffer& buffer) override;
+    virtual bool SupportsCheckpoints() const override { return true; }
     virtual bool AppropriateOnNodes() const override { return false; }
 protected:
     virtual wxPanel* CreatePanel(wxWindow* parent) override;
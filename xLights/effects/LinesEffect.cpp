@@ -97,9 +97,9 @@ class LineObject
     static LinePoint CreatePoint(int width, int height)
     {
         LinePoint pt;
-        pt._x = rand01() * width;
-        pt._y = rand01() * height;
-        pt._angle = rand01() * pi2;
+        pt._x = buffer.Rand01() * width;
+        pt._y = buffer.Rand01() * height;
+        pt._angle = buffer.Rand01() * pi2;
         return pt;
     }
 
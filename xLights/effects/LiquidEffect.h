@@ -67,7 +67,7 @@ class LiquidEffect : public RenderableEffect
             const std::string& particleType, int despeckle, float gravity);
         void CreateBarrier(b2World* world, float x, float y, float width, float height);
         void Draw(RenderBuffer& buffer, b2ParticleSystem* ps, const xlColor& color, bool mixColors, int despeckle);
-        void CreateParticles(b2ParticleSystem* ps, int x, int y, int direction, int velocity, int flow, bool flowMusic, int lifetime, int width, int height, const xlColor& c, const std::string& particleType, bool mixcolors, float audioLevel, int sourceSize);
+        void CreateParticles(RenderBuffer& buffer, b2ParticleSystem* ps, int x, int y, int direction, int velocity, int flow, bool flowMusic, int lifetime, int width, int height, const xlColor& c, const std::string& particleType, bool mixcolors, float audioLevel, int sourceSize);
         void CreateParticleSystem(b2World* world, int lifetime, int size);
         void Step(b2World* world, RenderBuffer &buffer, bool enabled[], int lifetime, const std::string& particleType, bool mixcolors,
             int x1, int y1, int direction1, int velocity1, int flow1, int sourceSize1, bool flowMusic1,
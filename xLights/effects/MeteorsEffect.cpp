@@ -119,6 +119,11 @@ class MeteorsRenderCache : public EffectRenderCache {
 public:
     MeteorsRenderCache() {};
     virtual ~MeteorsRenderCache() {};
+    virtual EffectRenderCache* Clone() const override { return new MeteorsRenderCache(*this); }
+    virtual size_t GetMemorySize() const override {
+        // each list node also holds two pointers
+        return sizeof(*this) + meteors.size() * (sizeof(MeteorClass) + 2 * sizeof(void*)) + meteorsRadial.size() * (sizeof(MeteorRadialClass) + 2 * sizeof(void*));
+    }
 
     int effectState;
     MeteorList meteors;
@@ -264,7 +269,7 @@ void MeteorsEffect::RenderMeteorsHorizontal(RenderBuffer &buffer, int ColorSchem
     // create new meteors
 
     for (int i = 0; i < buffer.BufferHt; i++) {
-        if (rand() % 200 < Count) {
+        if (buffer.Rand() % 200 < Count) {
             m.x=buffer.BufferWi - 1;
             m.y=i;
 
@@ -273,7 +278,7 @@ void MeteorsEffect::RenderMeteorsHorizontal(RenderBuffer &buffer, int ColorSchem
                     buffer.SetRangeColor(hsv0,hsv1,m.hsv);
                     break;
                 case 2:
-                    buffer.palette.GetHSV(rand()%colorcnt, m.hsv);
+                    buffer.palette.GetHSV(buffer.Rand()%colorcnt, m.hsv);
                     break;
             }
             cache->meteors.push_back(m);
@@ -285,10 +290,12 @@ void MeteorsEffect::RenderMeteorsHorizontal(RenderBuffer &buffer, int ColorSchem
     std::function<void(MeteorClass &, int)> f = [&buffer, MeteorsEffect, TailLength, mspeed, SwirlIntensity, ColorScheme] (MeteorClass &meteor, int n) {
         int x,y,dy;
         HSVValue hsv;
+        RenderRandom rnd; // the buffer generator is not thread safe
+        rnd.Seed(buffer.GetRandomSeed() + n);
         for (int ph = 0; ph <= TailLength; ph++) {
             switch (ColorScheme) {
                 case 0:
-                    hsv.hue=double(rand() % 1000) / 1000.0;
+                    hsv.hue=double(rnd.Rand() % 1000) / 1000.0;
                     hsv.saturation=1.0;
                     hsv.value=1.0;
                     break;
@@ -365,7 +372,7 @@ void MeteorsEffect::RenderMeteorsVertical(RenderBuffer &buffer, int ColorScheme,
     // create new meteors
 
     for (int i = 0; i < buffer.BufferWi; i++) {
-        if (rand() % 200 < Count) {
+        if (buffer.Rand() % 200 < Count) {
             m.x=i;
             m.y=buffer.BufferHt - 1;
 
@@ -374,7 +381,7 @@ void MeteorsEffect::RenderMeteorsVertical(RenderBuffer &buffer, int ColorScheme,
                     buffer.SetRangeColor(hsv0,hsv1,m.hsv);
                     break;
                 case 2:
-                    buffer.palette.GetHSV(rand()%colorcnt, m.hsv);
+                    buffer.palette.GetHSV(buffer.Rand()%colorcnt, m.hsv);
                     break;
             }
             cache->meteors.push_back(m);
@@ -386,10 +393,12 @@ void MeteorsEffect::RenderMeteorsVertical(RenderBuffer &buffer, int ColorScheme,
     std::function<void(MeteorClass &, int)> f = [&buffer, MeteorsEffect, TailLength, mspeed, SwirlIntensity, ColorScheme] (MeteorClass &meteor, int n) {
         int x,y,dx;
         HSVValue hsv;
+        RenderRandom rnd; // the buffer generator is not thread safe
+        rnd.Seed(buffer.GetRandomSeed() + n);
         for (int ph = 0; ph <= TailLength; ph++) {
             switch (ColorScheme) {
                 case 0:
-                    hsv.hue=double(rand() % 1000) / 1000.0;
+                    hsv.hue=double(rnd.Rand() % 1000) / 1000.0;
                     hsv.saturation=1.0;
                     hsv.value=1.0;
                     break;
@@ -449,18 +458,18 @@ void MeteorsEffect::RenderIcicleDrip(RenderBuffer &buffer, int ColorScheme, int
 
     MeteorClass m;
     for (int i = 0; i < buffer.BufferWi; i++) {
-        if (rand() % 200 < Count) {
+        if (buffer.Rand() % 200 < Count) {
             m.x=i;
             m.y=buffer.BufferHt - 1;
             //            m.h = TailLength;
-            m.h = (rand() % (2 * buffer.BufferHt))/3; //somewhat variable length -DJ
+            m.h = (buffer.Rand() % (2 * buffer.BufferHt))/3; //somewhat variable length -DJ
 
             switch (ColorScheme) {
                 case 1:
                     buffer.SetRangeColor(hsv0,hsv1,m.hsv);
                     break;
                 case 2:
-                    buffer.palette.GetHSV(rand()%colorcnt, m.hsv);
+                    buffer.palette.GetHSV(buffer.Rand()%colorcnt, m.hsv);
                     break;
             }
             cache->meteors.push_back(m);
@@ -557,13 +566,13 @@ void MeteorsEffect::RenderMeteorsImplode(RenderBuffer &buffer, int ColorScheme,
 
     m.cnt=1;
     for (int i = 0; i < MinDimension; i++) {
-        if (rand() % 200 < Count) {
+        if (buffer.Rand() % 200 < Count) {
             if (buffer.BufferHt == 1) {
-                angle=double(rand() % 2) * M_PI;
+                angle=double(buffer.Rand() % 2) * M_PI;
             } else if (buffer.BufferWi == 1) {
-                angle=double(rand() % 2) * M_PI - (M_PI/2.0);
+                angle=double(buffer.Rand() % 2) * M_PI - (M_PI/2.0);
             } else {
-                angle=rand01()*2.0*M_PI;
+                angle=buffer.Rand01()*2.0*M_PI;
             }
             m.dx=buffer.cos(angle);
             m.dy=buffer.sin(angle);
@@ -577,7 +586,7 @@ void MeteorsEffect::RenderMeteorsImplode(RenderBuffer &buffer, int ColorScheme,
                     buffer.SetRangeColor(hsv0,hsv1,m.hsv);
                     break;
                 case 2:
-                    buffer.palette.GetHSV(rand()%colorcnt, m.hsv);
+                    buffer.palette.GetHSV(buffer.Rand()%colorcnt, m.hsv);
                     break;
             }
             cache->meteorsRadial.push_back(m);
@@ -589,6 +598,8 @@ void MeteorsEffect::RenderMeteorsImplode(RenderBuffer &buffer, int ColorScheme,
     std::function<void(MeteorRadialClass&, int)> f = [&buffer, fadeWithDistance, centerX, centerY, maxdiag, TailLength, ColorScheme, mspeed](MeteorRadialClass& meteor, int n) {
         int x,y;
         HSVValue hsv;
+        RenderRandom rnd; // the buffer generator is not thread safe
+        rnd.Seed(buffer.GetRandomSeed() + n);
         float hdistance = 1.0f;
         if (fadeWithDistance) {
             float x = meteor.x;
@@ -599,7 +610,7 @@ void MeteorsEffect::RenderMeteorsImplode(RenderBuffer &buffer, int ColorScheme,
         for (int ph = 0; ph <= TailLength; ph++) {
             switch (ColorScheme) {
                 case 0:
-                    hsv.hue=double(rand() % 1000) / 1000.0;
+                    hsv.hue=double(rnd.Rand() % 1000) / 1000.0;
                     hsv.saturation=1.0;
                     hsv.value=1.0;
                     break;
@@ -694,13 +705,13 @@ void MeteorsEffect::RenderMeteorsExplode(RenderBuffer &buffer, int ColorScheme,
     m.y=buffer.BufferHt/2+trueyoffset;
     m.cnt=1;
     for (int i = 0; i < MinDimension; i++) {
-        if (rand() % 200 < Count) {
+        if (buffer.Rand() % 200 < Count) {
             if (buffer.BufferHt == 1) {
-                angle=double(rand() % 2) * M_PI;
+                angle=double(buffer.Rand() % 2) * M_PI;
             } else if (buffer.BufferWi == 1) {
-                angle=double(rand() % 2) * M_PI - (M_PI/2.0);
+                angle=double(buffer.Rand() % 2) * M_PI - (M_PI/2.0);
             } else {
-                angle=rand01()*2.0*M_PI;
+                angle=buffer.Rand01()*2.0*M_PI;
             }
             m.dx=buffer.cos(angle);
             m.dy=buffer.sin(angle);
@@ -710,7 +721,7 @@ void MeteorsEffect::RenderMeteorsExplode(RenderBuffer &buffer, int ColorScheme,
                     buffer.SetRangeColor(hsv0,hsv1,m.hsv);
                     break;
                 case 2:
-                    buffer.palette.GetHSV(rand()%colorcnt, m.hsv);
+                    buffer.palette.GetHSV(buffer.Rand()%colorcnt, m.hsv);
                     break;
             }
             cache->meteorsRadial.push_back(m);
@@ -722,6 +733,8 @@ void MeteorsEffect::RenderMeteorsExplode(RenderBuffer &buffer, int ColorScheme,
     std::function<void(MeteorRadialClass&, int)> f = [&buffer, fadeWithDistance, centerX, centerY, maxdiag, TailLength, ColorScheme, mspeed](MeteorRadialClass& meteor, int n) {
         int x,y;
         HSVValue hsv;
+        RenderRandom rnd; // the buffer generator is not thread safe
+        rnd.Seed(buffer.GetRandomSeed() + n);
 
         float hdistance = 1.0f;
         if (fadeWithDistance) {
@@ -734,7 +747,7 @@ void MeteorsEffect::RenderMeteorsExplode(RenderBuffer &buffer, int ColorScheme,
             //if (ph >= it->cnt) continue;
             switch (ColorScheme) {
                 case 0:
-                    hsv.hue=double(rand() % 1000) / 1000.0;
+                    hsv.hue=double(rnd.Rand() % 1000) / 1000.0;
                     hsv.saturation=1.0;
                     hsv.value=1.0;
                     break;
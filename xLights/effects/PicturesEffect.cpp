@@ -30,6 +30,7 @@
 #include "../models/Model.h"
 #include "../UtilFunctions.h"
 #include "GIFImage.h"
+#include "ImageCache.h"
 #include "../xLightsMain.h" 
 
 #include <log4cpp/Category.hh>
@@ -75,12 +76,13 @@ std::list<std::string> PicturesEffect::CheckEffectSettings(const SettingsMap& se
 
         if (!renderCache)
         {
-            wxImage i;
-            i.LoadFile(pictureFilename);
-            if (i.IsOk())
+            // decoded through the cache so the render that follows does not decode it again
+            std::string fn = pictureFilename.ToStdString();
+            auto i = ImageCache::instance().GetFrame(fn, ImageCache::GetModified(fn), 0, false);
+            if (i != nullptr)
             {
-                int ih = i.GetHeight();
-                int iw = i.GetWidth();
+                int ih = i->GetHeight();
+                int iw = i->GetWidth();
 
 #define IMAGESIZETHRESHOLD 10
                 if (ih > IMAGESIZETHRESHOLD * model->GetDefaultBufferHt() || iw > IMAGESIZETHRESHOLD * model->GetDefaultBufferWi())
@@ -247,22 +249,18 @@ typedef std::vector< std::pair<wxPoint, xlColor> > PixelVector;
 
 class PicturesRenderCache : public EffectRenderCache {
 public:
-    PicturesRenderCache() : imageCount(0), frame(0),  gifImage(nullptr), maxmovieframes(0) {};
-    virtual ~PicturesRenderCache()
-    {
-        if (gifImage != nullptr) {
-            delete gifImage;
-            gifImage = nullptr;
-        }
-    };
+    PicturesRenderCache() : imageCount(0), imageFrame(0), frame(0), maxmovieframes(0), modified(0) {};
+    virtual ~PicturesRenderCache() {};
 
-    wxImage image;
-    wxImage rawimage;
+    // both of these may be shared with other effects through the ImageCache so they must not be modified
+    std::shared_ptr<wxImage> image;
+    std::shared_ptr<wxImage> rawimage;
     int imageCount;
+    int imageFrame;
     int frame;
     int maxmovieframes;
+    long modified;
     wxString PictureName;
-    GIFImage* gifImage;
     std::vector<PixelVector> PixelsByFrame;
 };
 
@@ -293,12 +291,10 @@ void PicturesEffect::LoadPixelsFromTextFile(RenderBuffer &buffer, wxFile& debug,
     wxByte rgb[3] = { 0,0,0 };
     PicturesRenderCache *cache = GetCache(buffer);
     cache->imageCount = 0;
-    wxImage &image = cache->image;
-    wxImage &rawimage = cache->rawimage;
     std::vector<PixelVector> &PixelsByFrame = cache->PixelsByFrame;
 
-    if (image.GetWidth() && image.GetHeight()) image.Clear(); //CAUTION: image must be non-empty to clear it (memory error otherwise)
-    if (rawimage.GetWidth() && rawimage.GetHeight()) rawimage.Clear(); //CAUTION: image must be non-empty to clear it (memory error otherwise)
+    cache->image = nullptr;
+    cache->rawimage = nullptr;
 
     if (!cache->PictureName.CmpNoCase(filename)) { wrdebug("no change: " + filename); return; }
     if (!wxFileExists(filename)) { wrdebug("not found: " + filename); return; }
@@ -510,8 +506,7 @@ void PicturesEffect::Render(RenderBuffer& buffer,
     bool noImageFile = false;
 
     PicturesRenderCache* cache = GetCache(buffer);
-    wxImage& image = cache->image;
-    wxImage& rawimage = cache->rawimage;
+    ImageCache& imageCache = ImageCache::instance();
 
     if (NewPictureName2.length() == 0) {
         noImageFile = true;
@@ -526,7 +521,6 @@ void PicturesEffect::Render(RenderBuffer& buffer,
         //      ffmpeg -i XXXX.mts -s 16x50 XXXX-%d.jpg
 
         wxFile f;
-        GIFImage*& gifImage = cache->gifImage;
         std::vector<PixelVector>& PixelsByFrame = cache->PixelsByFrame;
         int& frame = cache->frame;
 
@@ -590,80 +584,50 @@ void PicturesEffect::Render(RenderBuffer& buffer,
         if (NewPictureName != cache->PictureName || buffer.needToInit) {
             buffer.needToInit = false;
             scale_image = true;
+            cache->image = nullptr;
+            cache->rawimage = nullptr;
+            cache->imageFrame = 0;
 
             if (!wxFile::Exists(NewPictureName)) {
                 noImageFile = true;
             }
             else {
-                wxLogNull logNo;  // suppress popups from png images. See http://trac.wxwidgets.org/ticket/15331
-
-                // There seems to be a bug on linux where this function crashes occasionally
-#ifdef LINUX
-                logger_base.debug("About to count images in bitmap %s.", (const char*)NewPictureName.c_str());
-#endif
-                cache->imageCount = wxImage::GetImageCount(NewPictureName);
-                if (cache->imageCount <= 0) {
-                    logger_base.error("Image %s reports %d frames which is invalid. Overriding it to be 1.", (const char*)NewPictureName.c_str(), cache->imageCount);
-
-                    // override it to 1
-                    cache->imageCount = 1;
-                }
-
-                if (!image.LoadFile(NewPictureName, wxBITMAP_TYPE_ANY, 0)) {
-                    logger_base.error("Error loading image file: %s.", (const char*)NewPictureName.c_str());
-                    image.Create(5, 5, true);
-                }
-
-                rawimage = image;
+                // decoding is shared with every other effect using this file
+                cache->modified = ImageCache::GetModified(NewPictureName.ToStdString());
+                cache->imageCount = imageCache.GetImageCount(NewPictureName.ToStdString(), cache->modified);
+                cache->rawimage = imageCache.GetFrame(NewPictureName.ToStdString(), cache->modified, 0, suppressGIFBackground);
+                cache->image = cache->rawimage;
                 cache->PictureName = NewPictureName;
 
-                if (cache->imageCount > 1) {
-#ifdef DEBUG_GIF
-                    logger_base.debug("Preparing GIF file for reading: %s", (const char*)NewPictureName.c_str());
-#endif
-                    if (gifImage != nullptr && gifImage->GetFilename() != NewPictureName) {
-                        delete gifImage;
-                        gifImage = nullptr;
-                    }
-                    gifImage = new GIFImage(NewPictureName.ToStdString(), suppressGIFBackground);
-
-                    if (!gifImage->IsOk()) {
-                        delete gifImage;
-                        gifImage = nullptr;
-                        noImageFile = true;
-                    }
-
-                    if (!noImageFile) {
-                        image = gifImage->GetFrame(0);
-                        rawimage = image;
-                    }
+                if (cache->rawimage == nullptr) {
+                    noImageFile = true;
+                }
             }
         }
 
-            if (!noImageFile && !image.IsOk()) {
-                noImageFile = true;
-            }
-    }
-
         if (!noImageFile && cache->imageCount > 1) {
 
             //animated Gif,
             scale_image = true;
 
             if (loopGIF) {
-                image = gifImage->GetFrameForTime((buffer.curPeriod - buffer.curEffStartPer) * buffer.frameTimeInMs * frameRateAdj, true);
+                cache->imageFrame = imageCache.GetGIFFrameForTime(NewPictureName.ToStdString(), cache->modified, (buffer.curPeriod - buffer.curEffStartPer) * buffer.frameTimeInMs * frameRateAdj, true, suppressGIFBackground);
             }
             else {
-                int ii = cache->imageCount * buffer.GetEffectTimeIntervalPosition(frameRateAdj) * 0.99;
-                image = gifImage->GetFrame(ii);
+                cache->imageFrame = cache->imageCount * buffer.GetEffectTimeIntervalPosition(frameRateAdj) * 0.99;
             }
 
-            rawimage = image;
+            cache->rawimage = imageCache.GetFrame(NewPictureName.ToStdString(), cache->modified, cache->imageFrame, suppressGIFBackground);
+            cache->image = cache->rawimage;
 
-            if (!rawimage.IsOk()) {
+            if (cache->rawimage == nullptr || !cache->rawimage->IsOk()) {
                 noImageFile = true;
             }
         }
+
+        if (cache->rawimage == nullptr || cache->image == nullptr) {
+            noImageFile = true;
+        }
     }
 
     if (noImageFile) {
@@ -676,31 +640,31 @@ void PicturesEffect::Render(RenderBuffer& buffer,
     }
 
     if (scale_to_fit == "No Scaling" && (start_scale != end_scale)) {
-        image = rawimage;
+        cache->image = cache->rawimage;
         scale_image = true;
     }
 
-    int imgwidth = image.GetWidth();
-    int imght = image.GetHeight();
+    int imgwidth = cache->image->GetWidth();
+    int imght = cache->image->GetHeight();
     int yoffset = (BufferHt + imght) / 2; //centered if sizes don't match
     int xoffset = (imgwidth - BufferWi) / 2; //centered if sizes don't match
 
     if (scale_to_fit == "Scale To Fit" && (BufferWi != imgwidth || BufferHt != imght)) {
-        image = rawimage;
-        image.Rescale(BufferWi, BufferHt);
-        imgwidth = image.GetWidth();
-        imght = image.GetHeight();
+        cache->image = imageCache.GetScaledFrame(cache->PictureName.ToStdString(), cache->modified, cache->imageFrame, suppressGIFBackground, BufferWi, BufferHt);
+        if (cache->image == nullptr) cache->image = cache->rawimage;
+        imgwidth = cache->image->GetWidth();
+        imght = cache->image->GetHeight();
         yoffset = (BufferHt + imght) / 2; //centered if sizes don't match
         xoffset = (imgwidth - BufferWi) / 2; //centered if sizes don't match
     }
     else if (scale_to_fit == "Scale Keep Aspect Ratio") {
-        image = rawimage;
-        float xr = (float)BufferWi / (float)image.GetWidth();
-        float yr = (float)BufferHt / (float)image.GetHeight();
+        float xr = (float)BufferWi / (float)cache->rawimage->GetWidth();
+        float yr = (float)BufferHt / (float)cache->rawimage->GetHeight();
         float sc = std::min(xr, yr);
-        image.Rescale(image.GetWidth() * sc, image.GetHeight() * sc);
-        imgwidth = image.GetWidth();
-        imght = image.GetHeight();
+        cache->image = imageCache.GetScaledFrame(cache->PictureName.ToStdString(), cache->modified, cache->imageFrame, suppressGIFBackground, cache->rawimage->GetWidth() * sc, cache->rawimage->GetHeight() * sc);
+        if (cache->image == nullptr) cache->image = cache->rawimage;
+        imgwidth = cache->image->GetWidth();
+        imght = cache->image->GetHeight();
         yoffset = (BufferHt + imght) / 2; //centered if sizes don't match
         xoffset = (imgwidth - BufferWi) / 2; //centered if sizes don't match
     }
@@ -708,16 +672,19 @@ void PicturesEffect::Render(RenderBuffer& buffer,
         if ((start_scale != 100 || end_scale != 100) && scale_image) {
             int delta_scale = end_scale - start_scale;
             int current_scale = start_scale + delta_scale * position;
-            imgwidth = (image.GetWidth() * current_scale) / 100;
-            imght = (image.GetHeight() * current_scale) / 100;
+            imgwidth = (cache->image->GetWidth() * current_scale) / 100;
+            imght = (cache->image->GetHeight() * current_scale) / 100;
             imgwidth = std::max(imgwidth, 1);
             imght = std::max(imght, 1);
-            image.Rescale(imgwidth, imght);
+            // a different size every frame so not worth sharing ... scale our own copy of the shared image
+            cache->image = std::make_shared<wxImage>(imageCache.GetCopy(cache->image).Scale(imgwidth, imght));
             yoffset = (BufferHt + imght) / 2; //centered if sizes don't match
             xoffset = (imgwidth - BufferWi) / 2; //centered if sizes don't match
         }
     }
 
+    const wxImage& image = *cache->image;
+
     int waveX = 0;
     int waveW = 0;
     int waveN = 0; //location of first wave, height adjust, width, wave# -DJ
@@ -931,7 +898,7 @@ void PicturesEffect::Render(RenderBuffer& buffer,
         xlColor color;
         for (int x = 0; x < BufferWi; x++) {
             for (int y = 0; y < BufferHt; y++) {
-                if (rand01() > 0.5) {
+                if (buffer.Rand01() > 0.5) {
                     buffer.GetPixel(x, y, color);
                     if (color != xlBLACK) {
                         buffer.ProcessPixel(x, y, c, false);
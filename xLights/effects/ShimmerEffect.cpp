@@ -133,7 +133,7 @@ void ShimmerEffect::Render(Effect* effect, SettingsMap& SettingsMap, RenderBuffe
     for (int y = 0; y < buffer.BufferHt; y++) {
         for (int x = 0; x < buffer.BufferWi; x++) {
             if (Use_All_Colors) { // Should we randomly assign colors from palette or cycle thru sequentially?
-                ColorIdx = rand() % colorcnt; // Select random numbers from 0 up to number of colors the user has checked. 0-5 if 6 boxes checked
+                ColorIdx = buffer.Rand() % colorcnt; // Select random numbers from 0 up to number of colors the user has checked. 0-5 if 6 boxes checked
                 buffer.palette.GetColor(ColorIdx, color); // Now go and get the hsv value for this ColorIdx
             }
             else
@@ -137,6 +137,7 @@ class SnowflakesRenderCache : public EffectRenderCache {
 public:
     SnowflakesRenderCache() : LastSnowflakeCount(0), LastSnowflakeType(0), LastFalling(""), effectState(0) {};
     virtual ~SnowflakesRenderCache() {};
+    virtual EffectRenderCache* Clone() const override { return new SnowflakesRenderCache(*this); }
 
     int LastSnowflakeCount;
     int LastSnowflakeType;
@@ -219,8 +220,8 @@ void SnowflakesEffect::Render(Effect *effect, SettingsMap &SettingsMap, RenderBu
             // find unused space
             for (check = 0; check < 20; check++)
             {
-                x = rand() % buffer.BufferWi;
-                y = y0 + (rand() % delta_y);
+                x = buffer.Rand() % buffer.BufferWi;
+                y = y0 + (buffer.Rand() % delta_y);
                 if (buffer.GetTempPixel(x, y) == xlBLACK) {
                     effectState++;
                     break;
@@ -228,7 +229,7 @@ void SnowflakesEffect::Render(Effect *effect, SettingsMap &SettingsMap, RenderBu
             }
 
             // draw flake, SnowflakeType=0 is random type
-            switch (SnowflakeType == 0 ? rand() % 9 : SnowflakeType - 1)
+            switch (SnowflakeType == 0 ? buffer.Rand() % 9 : SnowflakeType - 1)
             {
             case 0:
                 // single node
@@ -269,7 +270,7 @@ void SnowflakesEffect::Render(Effect *effect, SettingsMap &SettingsMap, RenderBu
                 else
                 {
                     buffer.SetTempPixel(x, y, c1);
-                    if (rand() % 100 > 50)      // % 2 was not so random
+                    if (buffer.Rand() % 100 > 50)      // % 2 was not so random
                     {
                         buffer.SetTempPixel(x - 1, y, c2);
                         buffer.SetTempPixel(x + 1, y, c2);
@@ -442,7 +443,7 @@ void SnowflakesEffect::Render(Effect *effect, SettingsMap &SettingsMap, RenderBu
                         if (moves > 0 || (falling == "Falling" && y == 0))
                         {
                             int x0;
-                            switch (rand() % 9)
+                            switch (buffer.Rand() % 9)
                             {
                             case 0:
                                 if (moves & 1) {
@@ -481,7 +482,7 @@ void SnowflakesEffect::Render(Effect *effect, SettingsMap &SettingsMap, RenderBu
                                     x0 = x - 1;
                                 }
                                 else {
-                                    switch (rand() % 2)
+                                    switch (buffer.Rand() % 2)
                                     {
                                     case 0:
                                         x0 = x + 1;
@@ -554,10 +555,10 @@ void SnowflakesEffect::Render(Effect *effect, SettingsMap &SettingsMap, RenderBu
         int placedFullCount = 0;
         while (effectState < Count && check < 20) {
             // find unused space
-            int x = rand() % buffer.BufferWi;
+            int x = buffer.Rand() % buffer.BufferWi;
             if (buffer.GetTempPixel(x, buffer.BufferHt - 1) == xlBLACK) {
                 effectState++;
-                buffer.SetTempPixel(x, buffer.BufferHt - 1, color1, SnowflakeType == 0 ? rand() % 9 : SnowflakeType - 1);
+                buffer.SetTempPixel(x, buffer.BufferHt - 1, color1, SnowflakeType == 0 ? buffer.Rand() % 9 : SnowflakeType - 1);
 
                 int nextmoves = possible_downward_moves(buffer, x, buffer.BufferHt - 1);
                 if (nextmoves == 0) {
@@ -611,7 +612,7 @@ void SnowflakesEffect::Render(Effect *effect, SettingsMap &SettingsMap, RenderBu
                             set_pixel_if_not_color(buffer, x + 1, y, color2, color1, wrapx, false);
                         }
                         else {
-                            if (rand() % 100 > 50)      // % 2 was not so random
+                            if (buffer.Rand() % 100 > 50)      // % 2 was not so random
                             {
                                 set_pixel_if_not_color(buffer, x - 1, y, color2, color1, wrapx, false);
                                 set_pixel_if_not_color(buffer, x + 1, y, color2, color1, wrapx, false);
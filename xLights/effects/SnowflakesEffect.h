@@ -25,6 +25,7 @@ class SnowflakesEffect : public RenderableEffect
         virtual ~SnowflakesEffect();
         virtual void SetDefaultParameters() override;
         virtual void Render(Effect *effect, SettingsMap &settings, RenderBuffer &buffer) override;
+        virtual bool SupportsCheckpoints() const override { return true; }
 protected:
         virtual wxPanel *CreatePanel(wxWindow *parent) override;
         virtual bool needToAdjustSettings(const std::string &version) override;
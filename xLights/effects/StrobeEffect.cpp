@@ -128,11 +128,11 @@ void StrobeEffect::Render(Effect *effect, SettingsMap &SettingsMap, RenderBuffer
         // prepopulate first frame
         for (int i = 0; i < Number_Strobes * StrobeDuration; i++) {
             xlColor color;
-            ColorIdx = rand() % colorcnt;
+            ColorIdx = buffer.Rand() % colorcnt;
             buffer.palette.GetHSV(ColorIdx, hsv); // take first checked color as color of flash
             buffer.palette.GetColor(ColorIdx, color); // take first checked color as color of flash
-            strobe.push_back(StrobeClass(rand() % buffer.BufferWi,
-                rand() % buffer.BufferHt, i % StrobeDuration, hsv, color));
+            strobe.push_back(StrobeClass(buffer.Rand() % buffer.BufferWi,
+                buffer.Rand() % buffer.BufferHt, i % StrobeDuration, hsv, color));
         }
     }
 
@@ -140,11 +140,11 @@ void StrobeEffect::Render(Effect *effect, SettingsMap &SettingsMap, RenderBuffer
     while (strobe.size() < Number_Strobes * StrobeDuration) {
         HSVValue hsv;
         xlColor color;
-        ColorIdx = rand() % colorcnt;
+        ColorIdx = buffer.Rand() % colorcnt;
         buffer.palette.GetHSV(ColorIdx, hsv); // take first checked color as color of flash
         buffer.palette.GetColor(ColorIdx, color); // take first checked color as color of flash
-        strobe.push_back(StrobeClass(rand() % buffer.BufferWi,
-            rand() % buffer.BufferHt, StrobeDuration, hsv, color));
+        strobe.push_back(StrobeClass(buffer.Rand() % buffer.BufferWi,
+            buffer.Rand() % buffer.BufferHt, StrobeDuration, hsv, color));
     }
 
     // render strobe, we go through all storbes and decide if they should be turned on
@@ -174,7 +174,7 @@ void StrobeEffect::Render(Effect *effect, SettingsMap &SettingsMap, RenderBuffer
         }
 
         if (Strobe_Type == 2) {
-            int r = rand() % 2;
+            int r = buffer.Rand() % 2;
             if (r == 0) {
                 buffer.SetPixel(x, y - 1, color);
                 buffer.SetPixel(x, y + 1, color);
@@ -190,7 +190,7 @@ void StrobeEffect::Render(Effect *effect, SettingsMap &SettingsMap, RenderBuffer
             buffer.SetPixel(x + 1, y, color);
         }
         if (Strobe_Type == 4) {
-            int r = rand() % 2;
+            int r = buffer.Rand() % 2;
             if (r == 0) {
                 buffer.SetPixel(x, y - 1, color);
                 buffer.SetPixel(x, y + 1, color);
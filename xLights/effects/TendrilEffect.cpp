@@ -109,7 +109,7 @@ ATendril::~ATendril()
 	}
 }
 
-ATendril::ATendril(float friction, int size, float dampening, float tension, float spring, const wxPoint& start, size_t maxx, size_t maxy)
+ATendril::ATendril(RenderBuffer& buffer, float friction, int size, float dampening, float tension, float spring, const wxPoint& start, size_t maxx, size_t maxy)
 {
     _width = maxx;
     _height = maxy;
@@ -136,11 +136,11 @@ ATendril::ATendril(float friction, int size, float dampening, float tension, flo
 	_friction = 0.5f;
 	if (friction >= 0)
 	{
-		_friction = friction + ((float)rand())/(float)RAND_MAX * 0.01f - 0.005f;
+		_friction = friction + (float)buffer.Rand01() * 0.01f - 0.005f;
 	}
 	else
 	{
-		_friction = _friction + ((float)rand())/(float)RAND_MAX * 0.01f - 0.005f;
+		_friction = _friction + (float)buffer.Rand01() * 0.01f - 0.005f;
 	}
 
     _nodes.clear();
@@ -259,7 +259,7 @@ Tendril::~Tendril()
 	}
 }
 
-Tendril::Tendril(float friction, int trails, int size, float dampening, float tension, float springbase, float springincr, const wxPoint& start, size_t maxx, size_t maxy)
+Tendril::Tendril(RenderBuffer& buffer, float friction, int trails, int size, float dampening, float tension, float springbase, float springincr, const wxPoint& start, size_t maxx, size_t maxy)
 {
     _width = maxx;
     _height = maxy;
@@ -283,7 +283,7 @@ Tendril::Tendril(float friction, int trails, int size, float dampening, float te
 	for (int i = 0; i < t; i++)
 	{
 		float aspring = sb + si * ((float)i / (float)t);
-		ATendril* at = new ATendril(friction, size, dampening, tension, aspring, start, maxx, maxy);
+		ATendril* at = new ATendril(buffer, friction, size, dampening, tension, aspring, start, maxx, maxy);
 		if (at != nullptr)
 		{
 			_tendrils.push_back(at);
@@ -291,7 +291,7 @@ Tendril::Tendril(float friction, int trails, int size, float dampening, float te
 	}
 }
 
-void Tendril::UpdateRandomMove(int tunemovement)
+void Tendril::UpdateRandomMove(RenderBuffer& buffer, int tunemovement)
 {
     if (tunemovement < 1)
     {
@@ -340,12 +340,12 @@ void Tendril::UpdateRandomMove(int tunemovement)
 			int x = 0;
 			if (xmove > 0)
 			{
-				x = (rand() % xmove) + realminmovex;
+				x = (buffer.Rand() % xmove) + realminmovex;
 			}
 			int y = 0;
 			if (ymove > 0)
 			{
-				y = (rand() % ymove) + realminmovey;
+				y = (buffer.Rand() % ymove) + realminmovey;
 			}
 
 			current->x = current->x + x;
@@ -601,7 +601,7 @@ void TendrilEffect::Render(RenderBuffer &buffer, const std::string& movement,
         {
         case 1:
             // random
-            _tendril = new Tendril(friction, trails, length, dampening, tension, -1, -1, startmiddle, buffer.ModelBufferWi, buffer.ModelBufferHt);
+            _tendril = new Tendril(buffer, friction, trails, length, dampening, tension, -1, -1, startmiddle, buffer.ModelBufferWi, buffer.ModelBufferHt);
             break;
         case 2:
             // corners
@@ -613,7 +613,7 @@ void TendrilEffect::Render(RenderBuffer &buffer, const std::string& movement,
             {
                 _mv4 = 1;
             }
-            _tendril = new Tendril(friction, trails, length, dampening, tension, -1, -1, startbottomleft, buffer.ModelBufferWi, buffer.ModelBufferHt);
+            _tendril = new Tendril(buffer, friction, trails, length, dampening, tension, -1, -1, startbottomleft, buffer.ModelBufferWi, buffer.ModelBufferHt);
             break;
         case 3:
             // circles
@@ -624,7 +624,7 @@ void TendrilEffect::Render(RenderBuffer &buffer, const std::string& movement,
             {
                 _mv3 = 1;
             }
-            _tendril = new Tendril(friction, trails, length, dampening, tension, -1, -1, startmiddle, buffer.ModelBufferWi, buffer.ModelBufferHt);
+            _tendril = new Tendril(buffer, friction, trails, length, dampening, tension, -1, -1, startmiddle, buffer.ModelBufferWi, buffer.ModelBufferHt);
             break;
         case 4:
             // horizontal zig zag
@@ -635,14 +635,14 @@ void TendrilEffect::Render(RenderBuffer &buffer, const std::string& movement,
                 _mv2 = 1;
             }
             _mv3 = 1; // direction
-            _tendril = new Tendril(friction, trails, length, dampening, tension, -1, -1, startmiddlebottom, buffer.ModelBufferWi, buffer.ModelBufferHt);
+            _tendril = new Tendril(buffer, friction, trails, length, dampening, tension, -1, -1, startmiddlebottom, buffer.ModelBufferWi, buffer.ModelBufferHt);
             break;
         case 5:
             // vertical zig zag
             _mv1 = 0 + truexoffset; // current x
             _mv2 = (double)tunemovement * 1.5;
             _mv3 = 1; // direction
-            _tendril = new Tendril(friction, trails, length, dampening, tension, -1, -1, startmiddleleft, buffer.ModelBufferWi, buffer.ModelBufferHt);
+            _tendril = new Tendril(buffer, friction, trails, length, dampening, tension, -1, -1, startmiddleleft, buffer.ModelBufferWi, buffer.ModelBufferHt);
             break;
         case 6:
             // line movement based on music
@@ -652,7 +652,7 @@ void TendrilEffect::Render(RenderBuffer &buffer, const std::string& movement,
             {
                 _mv3 = 1;
             }
-            _tendril = new Tendril(friction, trails, length, dampening, tension, -1, -1, startbottomleft, buffer.ModelBufferWi, buffer.ModelBufferHt);
+            _tendril = new Tendril(buffer, friction, trails, length, dampening, tension, -1, -1, startbottomleft, buffer.ModelBufferWi, buffer.ModelBufferHt);
             break;
         case 7:
             // circle movement based on music
@@ -663,7 +663,7 @@ void TendrilEffect::Render(RenderBuffer &buffer, const std::string& movement,
             {
                 _mv3 = 1;
             }
-            _tendril = new Tendril(friction, trails, length, dampening, tension, -1, -1, startmiddle, buffer.ModelBufferWi, buffer.ModelBufferHt);
+            _tendril = new Tendril(buffer, friction, trails, length, dampening, tension, -1, -1, startmiddle, buffer.ModelBufferWi, buffer.ModelBufferHt);
             break;
         case 9:
             // horizontal zig zag return
@@ -674,17 +674,17 @@ void TendrilEffect::Render(RenderBuffer &buffer, const std::string& movement,
                 _mv2 = 1;
             }
             _mv3 = 1; // direction
-            _tendril = new Tendril(friction, trails, length, dampening, tension, -1, -1, startmiddlebottom, buffer.ModelBufferWi, buffer.ModelBufferHt);
+            _tendril = new Tendril(buffer, friction, trails, length, dampening, tension, -1, -1, startmiddlebottom, buffer.ModelBufferWi, buffer.ModelBufferHt);
             break;
         case 8:
             // vertical zig zag return
             _mv1 = 0; // current x
             _mv2 = (double)tunemovement * 1.5;
             _mv3 = 1; // direction
-            _tendril = new Tendril(friction, trails, length, dampening, tension, -1, -1, startmiddleleft, buffer.ModelBufferWi, buffer.ModelBufferHt);
+            _tendril = new Tendril(buffer, friction, trails, length, dampening, tension, -1, -1, startmiddleleft, buffer.ModelBufferWi, buffer.ModelBufferHt);
             break;
         case 10:
-            _tendril = new Tendril(friction, trails, length, dampening, tension, -1, -1, wxPoint(manualx * buffer.BufferWi / 100, manualy * buffer.BufferHt / 100), buffer.ModelBufferWi, buffer.ModelBufferHt);
+            _tendril = new Tendril(buffer, friction, trails, length, dampening, tension, -1, -1, wxPoint(manualx * buffer.BufferWi / 100, manualy * buffer.BufferHt / 100), buffer.ModelBufferWi, buffer.ModelBufferHt);
             break;
         }
     }
@@ -710,7 +710,7 @@ void TendrilEffect::Render(RenderBuffer &buffer, const std::string& movement,
             // random
             if (_tendril != nullptr)
             {
-                _tendril->UpdateRandomMove(tunemovement);
+                _tendril->UpdateRandomMove(buffer, tunemovement);
             }
             break;
         case 2:
@@ -65,7 +65,7 @@ class ATendril
 	public:
 
 	~ATendril();
-	ATendril(float friction, int size, float dampening, float tension, float spring, const wxPoint& start, size_t maxx, size_t maxy);
+	ATendril(RenderBuffer& buffer, float friction, int size, float dampening, float tension, float spring, const wxPoint& start, size_t maxx, size_t maxy);
 	void Update(wxPoint* target);
 	void Draw(PathDrawingContext* gc, xlColor colour, int thickness);
 	wxPoint* LastLocation();
@@ -80,8 +80,8 @@ class Tendril
 	public:
 
 	~Tendril();
-	Tendril(float friction, int trails, int size, float dampening, float tension, float springbase, float springincr, const wxPoint& start, size_t maxx, size_t maxy);
-	void UpdateRandomMove(int tunemovement);
+	Tendril(RenderBuffer& buffer, float friction, int trails, int size, float dampening, float tension, float springbase, float springincr, const wxPoint& start, size_t maxx, size_t maxy);
+	void UpdateRandomMove(RenderBuffer& buffer, int tunemovement);
     void Update(wxPoint* target);
     void Update(int x, int y);
     void Draw(PathDrawingContext* gc, xlColor colour, int thickness);
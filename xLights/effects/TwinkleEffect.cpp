@@ -212,12 +212,12 @@ void TwinkleEffect::Render(Effect *effect, SettingsMap &SettingsMap, RenderBuffe
                 if (i%step==1 || step==1) {
                     int s = strobe.size();
                     strobe.resize(s + 1);
-                    strobe[s].duration = rand() % max_modulo;
+                    strobe[s].duration = buffer.Rand() % max_modulo;
                     
                     strobe[s].x = x;
                     strobe[s].y = y;
                     
-                    strobe[s].colorindex = rand() % colorcnt;
+                    strobe[s].colorindex = buffer.Rand() % colorcnt;
                 }
             }
         }
@@ -231,8 +231,11 @@ void TwinkleEffect::Render(Effect *effect, SettingsMap &SettingsMap, RenderBuffe
         if (strobe[x].duration == max_modulo) {
             strobe[x].duration = 0;
             if (reRandomize) {
-                strobe[x].duration -= rand() % max_modulo2;
-                strobe[x].colorindex = rand() % colorcnt;
+                // the buffer generator is not thread safe so each strobe gets its own
+                RenderRandom rnd;
+                rnd.Seed(buffer.GetRandomSeed() + x);
+                strobe[x].duration -= rnd.Rand() % max_modulo2;
+                strobe[x].colorindex = rnd.Rand() % colorcnt;
             }
         }
         int i7 = strobe[x].duration;
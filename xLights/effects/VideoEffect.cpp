@@ -17,6 +17,7 @@
 #include "VideoEffect.h"
 #include "VideoPanel.h"
 #include "../VideoReader.h"
+#include "../SharedVideoReader.h"
 #include "../sequencer/Effect.h"
 #include "../RenderBuffer.h"
 #include "../UtilClasses.h"
@@ -224,20 +225,15 @@ public:
     VideoRenderCache()
 	{
 		_videoframerate = -1;
-		_videoreader = nullptr;
         _loops = 0;
         _frameMS = 50;
         _nextManualMS = 0;
 	};
-    virtual ~VideoRenderCache() {
-		if (_videoreader != nullptr)
-		{
-			delete _videoreader;
-			_videoreader = nullptr;
-		}
-	};
+    virtual ~VideoRenderCache() {};
 
-    VideoReader* _videoreader;
+    // the decoder is shared with every other effect showing the same video ... only the scaling is ours
+    std::shared_ptr<SharedVideoReader> _videoreader;
+    SharedVideoScaler _scaler;
 	int _videoframerate;
 	int _loops;
     int _frameMS;
@@ -289,7 +285,7 @@ void VideoEffect::Render(RenderBuffer &buffer, std::string filename,
     }
 
     int &_loops = cache->_loops;
-    VideoReader* &_videoreader = cache->_videoreader;
+    std::shared_ptr<SharedVideoReader>& _videoreader = cache->_videoreader;
     int& _frameMS = cache->_frameMS;
     int& _nextManualMS = cache->_nextManualMS;
 
@@ -312,11 +308,7 @@ void VideoEffect::Render(RenderBuffer &buffer, std::string filename,
         _loops = 0;
         _nextManualMS = 0;
         _frameMS = buffer.frameTimeInMs;
-        if (_videoreader != nullptr)
-        {
-            delete _videoreader;
-            _videoreader = nullptr;
-        }
+        _videoreader = nullptr;
 
         if (buffer.BufferHt == 1)
         {
@@ -324,10 +316,8 @@ void VideoEffect::Render(RenderBuffer &buffer, std::string filename,
         }
         else if (wxFileExists(filename))
         {
-            // have to open the file
-            int width = buffer.BufferWi * 100 / (cropRight - cropLeft);
-            int height = buffer.BufferHt * 100 / (cropTop - cropBottom);
-            _videoreader = new VideoReader(filename, width, height, aspectratio, false, true);
+            // have to open the file ... or share it if another effect already has
+            _videoreader = SharedVideoService::instance().GetReader(filename);
 
             if (_videoreader == nullptr)
             {
@@ -353,12 +343,6 @@ void VideoEffect::Render(RenderBuffer &buffer, std::string filename,
                     //fp->addVideoTime(filename, videolen);
                 }
 
-                if (starttime != 0)
-                {
-                    logger_base.debug("Video effect initialising ... seeking to start location for the video %f.", (float)starttime);
-                    _videoreader->Seek(starttime * 1000);
-                }
-
                 if (durationTreatment == "Slow/Accelerate")
                 {
                     int effectFrames = buffer.curEffEndPer - buffer.curEffStartPer + 1;
@@ -380,23 +364,6 @@ void VideoEffect::Render(RenderBuffer &buffer, std::string filename,
         }
     }
 
-    if (_videoreader != nullptr) {
-        int width = buffer.BufferWi * 100 / (cropRight - cropLeft);
-        int height = buffer.BufferHt * 100 / (cropTop - cropBottom);
-        bool vwidthEq = width == _videoreader->GetWidth();
-        bool vheightEq = height == _videoreader->GetHeight();
-        if (aspectratio) {
-            // if aspect ratio scaling, then only one or the other will be equal
-            vwidthEq = vheightEq | vwidthEq;
-            vheightEq = vwidthEq;
-        }
-        if (!vwidthEq || !vheightEq) {
-            // need to close and reopen video reader to the new size ... this is inefficient ... but lots of work to do to change video reader size dynamically
-            delete _videoreader;
-            _videoreader = new VideoReader(filename, width, height, aspectratio, false, true);
-        }
-    }
-
     if (_videoreader != nullptr && _videoreader->GetLengthMS() > 0)
     {
         long frame = 0;
@@ -428,10 +395,11 @@ void VideoEffect::Render(RenderBuffer &buffer, std::string filename,
         }
 
         // get the image for the current frame
-        AVFrame* image = _videoreader->GetNextFrame(frame);
+        std::shared_ptr<SharedVideoFrame> image = frame >= 0 ? _videoreader->GetFrame(frame) : nullptr;
 
-        // if we have reached the end and we are to loop
-        if (_videoreader->AtEnd() && durationTreatment == "Loop")
+        // if we have reached the end and we are to loop ... a frame that failed to decode before the end is an
+        // error and is drawn as one below rather than looping from there
+        if (image == nullptr && frame > 0 && durationTreatment == "Loop" && _videoreader->IsPastEnd(frame))
         {
             // jump back to start and try to read frame again
             _loops++;
@@ -442,43 +410,38 @@ void VideoEffect::Render(RenderBuffer &buffer, std::string filename,
             }
             logger_base.debug("Video effect loop #%d at frame %d to video frame %d.", _loops, buffer.curPeriod - buffer.curEffStartPer, frame);
 
-            _videoreader->Seek(0);
-            image = _videoreader->GetNextFrame(frame);
+            image = _videoreader->GetFrame(frame);
         }
 
-        int xoffset = cropLeft * _videoreader->GetWidth() / 100;
-        int yoffset = cropBottom * _videoreader->GetHeight() / 100;
-        int xtail = (100 - cropRight) * _videoreader->GetWidth() / 100;
-        int ytail = (100 - cropTop) * _videoreader->GetHeight() / 100;
-        int startx = (buffer.BufferWi - _videoreader->GetWidth() * (cropRight - cropLeft) / 100) / 2;
-        int starty = (buffer.BufferHt - _videoreader->GetHeight() * (cropTop - cropBottom) / 100) / 2;
+        // scale the shared native frame to the size this buffer needs
+        int vwidth = 0;
+        int vheight = 0;
+        _videoreader->GetOutputSize(buffer.BufferWi * 100 / (cropRight - cropLeft), buffer.BufferHt * 100 / (cropTop - cropBottom), aspectratio, vwidth, vheight);
+        const uint8_t* pixels = cache->_scaler.Scale(image, vwidth, vheight);
 
-        //wxASSERT(xoffset + xtail + buffer.BufferWi == _videoreader->GetWidth());
-        //wxASSERT(yoffset + ytail + buffer.BufferHt == _videoreader->GetHeight());
+        int xoffset = cropLeft * vwidth / 100;
+        int yoffset = cropBottom * vheight / 100;
+        int xtail = (100 - cropRight) * vwidth / 100;
+        int ytail = (100 - cropTop) * vheight / 100;
+        int startx = (buffer.BufferWi - vwidth * (cropRight - cropLeft) / 100) / 2;
+        int starty = (buffer.BufferHt - vheight * (cropTop - cropBottom) / 100) / 2;
+
+        //wxASSERT(xoffset + xtail + buffer.BufferWi == vwidth);
+        //wxASSERT(yoffset + ytail + buffer.BufferHt == vheight);
 
         // check it looks valid
-        if (image != nullptr && frame >= 0)
+        if (pixels != nullptr && frame >= 0)
         {
-            int ch = _videoreader->GetPixelChannels();
+            const int ch = 4;
             // draw the image
             xlColor c;
-            for (int y = 0; y < _videoreader->GetHeight() - yoffset - ytail; y++)
+            for (int y = 0; y < vheight - yoffset - ytail; y++)
             {
-                uint8_t* ptr = image->data[0] + (_videoreader->GetHeight() - 1 - y - yoffset) * _videoreader->GetWidth() * ch + xoffset * ch;
+                const uint8_t* ptr = pixels + (vheight - 1 - y - yoffset) * vwidth * ch + xoffset * ch;
 
-                for (int x = 0; x < _videoreader->GetWidth() - xoffset - xtail; x++)
+                for (int x = 0; x < vwidth - xoffset - xtail; x++)
                 {
-                    try
-                    {
-                        c.Set(*(ptr),
-                            *(ptr + 1),
-                            *(ptr + 2), ch == 3 ? 255 : *(ptr+3));
-                    }
-                    catch (...)
-                    {
-                        // this shouldnt happen so make it stand out
-                        c = xlRED;
-                    }
+                    c.Set(*(ptr), *(ptr + 1), *(ptr + 2), *(ptr + 3));
 
                     if (transparentBlack)
                     {
@@ -27,6 +27,7 @@ class ImageModel : public ModelWithScreenLocation<BoxedScreenLocation>
         virtual void DisplayModelOnWindow(ModelPreview* preview, DrawGLUtils::xlAccumulator &va, DrawGLUtils::xlAccumulator &tva, float& minx, float& miny, float& maxx, float& maxy, bool is_3d = false, const xlColor *color = NULL, bool allowSelected = true) override;
         virtual void DisplayModelOnWindow(ModelPreview* preview, DrawGLUtils::xl3Accumulator &va, DrawGLUtils::xl3Accumulator &tva, DrawGLUtils::xl3Accumulator& lva, bool is_3d = false, const xlColor *color = NULL, bool allowSelected = true, bool wiring = false, bool highlightFirst = false, int highlightpixel = 0) override;
         virtual void DisplayEffectOnWindow(ModelPreview* preview, double pointSize) override;
+        virtual bool SupportsPreviewVertexCache() const override { return false; }
 
         virtual void AddTypeProperties(wxPropertyGridInterface *grid) override;
         virtual void DisableUnusedProperties(wxPropertyGridInterface *grid) override;
@@ -45,6 +45,8 @@
 #include "xLightsVersion.h"
 #include "../controllers/ControllerCaps.h"
 
+#include <limits>
+
 #include <log4cpp/Category.hh>
 
 static const int PORTS_PER_SMARTREMOTE = 4;
@@ -2289,6 +2291,9 @@ std::list<int> Model::ParseFaceNodes(std::string channels)
 }
 
 void Model::SetFromXml(wxXmlNode* ModelNode, bool zb) {
+    // the background group build may be copying this model's nodes
+    modelManager.StopWarmUp();
+
     if (modelDimmingCurve != nullptr) {
         delete modelDimmingCurve;
         modelDimmingCurve = nullptr;
@@ -2488,7 +2493,83 @@ void Model::SetFromXml(wxXmlNode* ModelNode, bool zb) {
     if (modelDimmingCurve == nullptr && dimmingCurveNode != nullptr) {
         ModelNode->RemoveChild(dimmingCurveNode);
     }
+    _structureSignature = CalcStructureSignature();
+    _builtStartChannel = CouldComputeStartChannel ? StartChannel : -1;
+    IncrementChangeCount();
+}
+
+static void HashXmlString(const wxString& str, uint64_t& hash)
+{
+    // FNV-1a
+    for (const auto& c : str) {
+        hash ^= (uint32_t)c.GetValue();
+        hash *= 1099511628211ULL;
+    }
+    hash ^= 0xFF;
+    hash *= 1099511628211ULL;
+}
+
+static void HashXmlNode(const wxXmlNode* node, bool root, uint64_t& hash)
+{
+    HashXmlString(node->GetName(), hash);
+    HashXmlString(node->GetContent(), hash);
+    for (const wxXmlAttribute* a = node->GetAttributes(); a != nullptr; a = a->GetNext()) {
+        if (root && a->GetName() == "StartChannel") continue;
+        HashXmlString(a->GetName(), hash);
+        HashXmlString(a->GetValue(), hash);
+    }
+    for (const wxXmlNode* c = node->GetChildren(); c != nullptr; c = c->GetNext()) {
+        HashXmlNode(c, false, hash);
+    }
+}
+
+uint64_t Model::CalcStructureSignature() const
+{
+    uint64_t hash = 14695981039346656037ULL;
+    if (ModelXml != nullptr) {
+        HashXmlNode(ModelXml, true, hash);
+    }
+    return hash;
+}
+
+// When nothing but the start channel has changed since the model was last built
+// the nodes can just be moved rather than rebuilding the whole model.
+// Returns false if a full SetFromXml is required.
+bool Model::ShiftToStartChannel()
+{
+    if (ModelXml == nullptr || zeroBased || Nodes.empty() || _builtStartChannel < 0) return false;
+    if (ModelXml->GetAttribute("Advanced", "0") == "1") return false;
+    if (CalcStructureSignature() != _structureSignature) return false;
+
+    bool valid = false;
+    std::string dependsonmodel;
+    int32_t startChannel = GetNumberFromChannelString(ModelXml->GetAttribute("StartChannel", "1").ToStdString(), valid, dependsonmodel);
+    if (!valid) return false;
+
+    ModelStartChannel = ModelXml->GetAttribute("StartChannel");
+    CouldComputeStartChannel = true;
+
+    // stringStartChan[0] is not always the first channel (eg reversed candy canes, multi string
+    // custom models) so shift by how far the resolved start channel itself has moved
+    int32_t delta = startChannel - _builtStartChannel;
+    if (delta == 0) return true;
+    _builtStartChannel = startChannel;
+
+    for (auto& it : stringStartChan) {
+        it += delta;
+    }
+    for (auto& it : Nodes) {
+        it->ActChan += delta;
+    }
+    for (auto sm : subModels) {
+        if (sm->Nodes.empty()) continue;
+        for (auto& it : sm->Nodes) {
+            it->ActChan += delta;
+        }
+        sm->ModelStartChannel = wxString::Format("%u", sm->GetFirstChannel() + 1);
+    }
     IncrementChangeCount();
+    return true;
 }
 
 std::string Model::GetControllerConnectionString() const
@@ -2659,8 +2740,22 @@ void Model::SetStringStartChannels(bool zeroBased, int NumberOfStrings, int Star
     }
 }
 
+std::recursive_mutex Model::_nodesLock;
+
+void Model::BuildPendingNodes() const
+{
+    std::lock_guard<std::recursive_mutex> lock(_nodesLock);
+    // if this thread is already building them further up the stack just use what is there
+    if (_nodesState == NODES_PENDING) {
+        _nodesState = NODES_BUILDING;
+        const_cast<Model*>(this)->BuildNodes();
+        _nodesState = NODES_READY;
+    }
+}
+
 int Model::FindNodeAtXY(int bufx, int bufy)
 {
+    EnsureNodes();
     for (int i = 0; i < Nodes.size(); ++i)
     {
         if ((bufx == -1 || Nodes[i]->Coords[0].bufX == bufx) && (bufy == -1 || Nodes[i]->Coords[0].bufY == bufy))
@@ -2676,6 +2771,7 @@ void Model::InitModel() {
 }
 
 void Model::GetNodeChannelValues(size_t nodenum, unsigned char *buf) {
+    EnsureNodes();
     wxASSERT(nodenum < Nodes.size()); // trying to catch an error i can see in crash reports
     if (nodenum < Nodes.size()) {
         Nodes[nodenum]->GetForChannels(buf);
@@ -2683,6 +2779,7 @@ void Model::GetNodeChannelValues(size_t nodenum, unsigned char *buf) {
 }
 
 void Model::SetNodeChannelValues(size_t nodenum, const unsigned char *buf) {
+    EnsureNodes();
     wxASSERT(nodenum < Nodes.size()); // trying to catch an error i can see in crash reports
     if (nodenum < Nodes.size()) {
         Nodes[nodenum]->SetFromChannels(buf);
@@ -2690,6 +2787,7 @@ void Model::SetNodeChannelValues(size_t nodenum, const unsigned char *buf) {
 }
 
 xlColor Model::GetNodeColor(size_t nodenum) const {
+    EnsureNodes();
     wxASSERT(nodenum < Nodes.size()); // trying to catch an error i can see in crash reports
     xlColor color;
     if (nodenum < Nodes.size()) {
@@ -2703,6 +2801,7 @@ xlColor Model::GetNodeColor(size_t nodenum) const {
 }
 
 xlColor Model::GetNodeMaskColor(size_t nodenum) const {
+    EnsureNodes();
     if (nodenum >= Nodes.size()) return xlWHITE; // this shouldnt happen but it does if you have a custom model with no nodes in it
     xlColor color;
     Nodes[nodenum]->GetMaskColor(color);
@@ -2710,6 +2809,7 @@ xlColor Model::GetNodeMaskColor(size_t nodenum) const {
 }
 
 void Model::SetNodeColor(size_t nodenum, const xlColor &c) {
+    EnsureNodes();
     wxASSERT(nodenum < Nodes.size()); // trying to catch an error i can see in crash reports
     if (nodenum < Nodes.size()) {
         Nodes[nodenum]->SetColor(c);
@@ -2717,6 +2817,7 @@ void Model::SetNodeColor(size_t nodenum, const xlColor &c) {
 }
 
 bool Model::IsNodeInBufferRange(size_t nodeNum, int x1, int y1, int x2, int y2) {
+    EnsureNodes();
     if (nodeNum < Nodes.size()) {
         for (auto a = Nodes[nodeNum]->Coords.begin(); a != Nodes[nodeNum]->Coords.end(); ++a) {
             if (a->bufX >= x1 && a->bufX <= x2
@@ -2987,14 +3088,17 @@ int Model::NodesPerString() const {
 }
 
 int32_t Model::NodeStartChannel(size_t nodenum) const {
+    EnsureNodes();
     return Nodes.size() && nodenum < Nodes.size() ? Nodes[nodenum]->ActChan: 0; //avoid memory access error if no nods -DJ
 }
 
 const std::string &Model::NodeType(size_t nodenum) const {
+    EnsureNodes();
     return Nodes.size() && nodenum < Nodes.size() ? Nodes[nodenum]->GetNodeType(): NodeBaseClass::RGB; //avoid memory access error if no nods -DJ
 }
 
 void Model::GetBufferSize(const std::string &type, const std::string &camera, const std::string &transform, int &bufferWi, int &bufferHi) const {
+    EnsureNodes();
     if (type == DEFAULT) {
         bufferHi = this->BufferHt;
         bufferWi = this->BufferWi;
@@ -3136,6 +3240,7 @@ void Model::InitRenderBufferNodes(const std::string &type, const std::string &ca
     std::vector<NodeBaseClassPtr> &newNodes, int &bufferWi, int &bufferHt) const {
 
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+    EnsureNodes();
 
     int firstNode = newNodes.size();
 
@@ -3588,6 +3693,7 @@ int Model::GetNodeChannelCount(const std::string & nodeType) const {
 
 // returns a number where the first node is 1
 uint32_t Model::GetNodeNumber(size_t nodenum) const {
+    EnsureNodes();
     if (nodenum >= Nodes.size()) return 0;
     int sn=Nodes[nodenum]->StringNum;
     return (Nodes[nodenum]->ActChan - stringStartChan[sn]) / 3 + sn*NodesPerString() + 1;
@@ -3595,6 +3701,7 @@ uint32_t Model::GetNodeNumber(size_t nodenum) const {
 
 uint32_t Model::GetNodeNumber(int bufY, int bufX) const
 {
+    EnsureNodes();
     uint32_t count = 0;
     for (const auto& it : Nodes)
     {
@@ -3611,6 +3718,7 @@ uint32_t Model::GetNodeNumber(int bufY, int bufX) const
 }
 
 uint32_t Model::GetNodeCount() const {
+    EnsureNodes();
     return Nodes.size();
 }
 
@@ -3659,20 +3767,24 @@ int Model::GetChanCountPerNode() const {
 }
 
 uint32_t Model::GetCoordCount(size_t nodenum) const {
+    EnsureNodes();
     return nodenum < Nodes.size() ? Nodes[nodenum]->Coords.size() : 0;
 }
 
 int Model::GetNodeStringNumber(size_t nodenum) const {
+    EnsureNodes();
     return nodenum < Nodes.size() ? Nodes[nodenum]->StringNum : 0;
 }
 
 void Model::GetNodeScreenCoords(int nodeidx, std::vector<wxRealPoint> &pts) {
+    EnsureNodes();
     for (int x = 0; x < Nodes[nodeidx]->Coords.size(); x++) {
         pts.push_back(wxPoint(Nodes[nodeidx]->Coords[x].screenX, Nodes[nodeidx]->Coords[x].screenY));
     }
 }
 
 void Model::GetNodeCoords(int nodeidx, std::vector<wxPoint> &pts) {
+    EnsureNodes();
     if (nodeidx >= Nodes.size()) return;
     for (int x = 0; x < Nodes[nodeidx]->Coords.size(); x++) {
         pts.push_back(wxPoint(Nodes[nodeidx]->Coords[x].bufX, Nodes[nodeidx]->Coords[x].bufY));
@@ -3704,6 +3816,7 @@ static wxString AA(int x) {
 //add just the node#s to a choice list:
 //NO add parsed info to choice list or check list box:
 size_t Model::GetChannelCoords(wxArrayString& choices) { //wxChoice* choices1, wxCheckListBox* choices2, wxListBox* choices3)
+    EnsureNodes();
     //    if (choices1) choices1->Clear();
     //    if (choices2) choices2->Clear();
     //    if (choices3) choices3->Clear();
@@ -3731,6 +3844,7 @@ size_t Model::GetChannelCoords(wxArrayString& choices) { //wxChoice* choices1, w
 
 //get parsed node info:
 std::string Model::GetNodeXY(const std::string& nodenumstr) {
+    EnsureNodes();
     size_t NodeCount = GetNodeCount();
     try {
         int32_t nodenum = std::stod(nodenumstr);
@@ -4093,6 +4207,7 @@ bool Model::HitTest(ModelPreview* preview, glm::vec3& ray_origin, glm::vec3& ray
 }
 
 wxCursor Model::InitializeLocation(int &handle, wxCoord x, wxCoord y, ModelPreview* preview) {
+    EnsureNodes();
     return GetModelScreenLocation().InitializeLocation(handle, x, y, Nodes, preview);
 }
 
@@ -4137,6 +4252,7 @@ void Model::ApplyTransparency(xlColor& color, int transparency, int blackTranspa
 // display model using colors stored in each node
 // used when preview is running
 void Model::DisplayModelOnWindow(ModelPreview* preview, DrawGLUtils::xlAccumulator &sva, DrawGLUtils::xlAccumulator &tva, float& minx, float& miny, float& maxx, float& maxy, bool is_3d, const xlColor *c, bool allowSelected) {
+    EnsureNodes();
     if (!IsActive() && preview->IsNoCurrentModel()) { return; }
     size_t NodeCount = Nodes.size();
     xlColor color;
@@ -4258,6 +4374,7 @@ void Model::DisplayModelOnWindow(ModelPreview* preview, DrawGLUtils::xlAccumulat
 // display model using colors stored in each node
 // used when preview is running
 void Model::DisplayModelOnWindow(ModelPreview* preview, DrawGLUtils::xl3Accumulator &sva, DrawGLUtils::xl3Accumulator &tva, DrawGLUtils::xl3Accumulator& lva, bool is_3d, const xlColor *c, bool allowSelected, bool wiring, bool highlightFirst, int highlightpixel) {
+    EnsureNodes();
     if (!IsActive() && preview->IsNoCurrentModel()) { return; }
     size_t NodeCount = Nodes.size();
     xlColor color;
@@ -4422,8 +4539,205 @@ void Model::DisplayModelOnWindow(ModelPreview* preview, DrawGLUtils::xl3Accumula
     }
 }
 
+#pragma region Preview Vertex Cache
+void Model::GetPreviewProbe(float* probe) const
+{
+    static const float points[4][3] = { { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } };
+    for (int i = 0; i < 4; i++) {
+        probe[i * 3] = points[i][0];
+        probe[i * 3 + 1] = points[i][1];
+        probe[i * 3 + 2] = points[i][2];
+        GetModelScreenLocation().TranslatePoint(probe[i * 3], probe[i * 3 + 1], probe[i * 3 + 2]);
+    }
+}
+
+// Works out the vertices exactly the way DisplayModelOnWindow does but with marker colours so the
+// outer vertices of circle pixels can be told apart when the real colours are filled in
+void Model::BuildPreviewVertexCache(PreviewVertexCache& cache, bool is_3d, const float* probe)
+{
+    EnsureNodes();
+    ModelScreenLocation& screenLocation = GetModelScreenLocation();
+    screenLocation.UpdateBoundingBox(Nodes);
+
+    cache.valid = true;
+    cache.changeCount = changeCount;
+    cache.nodeCount = Nodes.size();
+    cache.pixelStyle = pixelStyle;
+    cache.pixelSize = pixelSize;
+    cache.transparency = transparency;
+    cache.blackTransparency = blackTransparency;
+    memcpy(cache.probe, probe, sizeof(cache.probe));
+    cache.coordsPerVertex = is_3d ? 3 : 2;
+    cache.nodes.clear();
+    cache.minx = cache.miny = std::numeric_limits<float>::max();
+    cache.maxx = cache.maxy = std::numeric_limits<float>::lowest();
+
+    DrawGLUtils::xlAccumulator va2;
+    DrawGLUtils::xl3Accumulator va3;
+    DrawGLUtils::xlAccumulator& va = is_3d ? va3 : va2;
+
+    const xlColor centre(255, 255, 255, 255);
+    const xlColor rim(0, 0, 0, 0);
+    const float radius = ((float)pixelSize) / 2.0f;
+
+    size_t NodeCount = Nodes.size();
+    int first = 0;
+    int last = NodeCount;
+    int buffFirst = -1;
+    int buffLast = -1;
+    bool left = true;
+
+    while (first < last) {
+        int n;
+        if (left) {
+            n = first;
+            first++;
+            if (NodeRenderOrder() == 1) {
+                if (buffFirst == -1) {
+                    buffFirst = Nodes[n]->Coords[0].bufX;
+                }
+                if (first < NodeCount && buffFirst != Nodes[first]->Coords[0].bufX) {
+                    left = false;
+                }
+            }
+        } else {
+            last--;
+            n = last;
+            if (buffLast == -1) {
+                buffLast = Nodes[n]->Coords[0].bufX;
+            }
+            if (last > 0 && buffFirst != Nodes[last - 1]->Coords[0].bufX) {
+                left = true;
+            }
+        }
+        cache.nodes.push_back({ (uint32_t)n, va.count });
+        size_t CoordCount = GetCoordCount(n);
+        for (size_t c2 = 0; c2 < CoordCount; c2++) {
+            float sx = Nodes[n]->Coords[c2].screenX;
+            float sy = Nodes[n]->Coords[c2].screenY;
+            float sz = Nodes[n]->Coords[c2].screenZ;
+            if (!is_3d) {
+                screenLocation.TranslatePoint(sx, sy, sz);
+                cache.minx = std::min(cache.minx, sx);
+                cache.miny = std::min(cache.miny, sy);
+                cache.maxx = std::max(cache.maxx, sx);
+                cache.maxy = std::max(cache.maxy, sy);
+                if (pixelStyle < 2) {
+                    va.AddVertex(sx, sy, centre);
+                } else {
+                    va.AddTrianglesCircle(sx, sy, radius, centre, rim);
+                }
+            } else {
+                if (pixelStyle < 2) {
+                    screenLocation.TranslatePoint(sx, sy, sz);
+                    va.AddVertex(sx, sy, sz, centre);
+                } else {
+                    va.AddTrianglesCircle(sx, sy, sz, radius, centre, rim,
+                                          [&screenLocation](float &x, float &y, float &z) {
+                                              screenLocation.TranslatePoint(x, y, z);
+                                          });
+                }
+            }
+        }
+    }
+
+    cache.vertices.assign(va.vertices, va.vertices + (size_t)va.count * va.coordsPerVertex);
+    cache.colors.resize((size_t)va.count * 4);
+    cache.edge.resize(va.count);
+    for (unsigned int i = 0; i < va.count; i++) {
+        cache.edge[i] = va.colors[i * 4 + 3] == 0 ? 1 : 0;
+    }
+}
+
+void Model::PreparePreviewFrame(const unsigned char* data, bool is_3d)
+{
+    EnsureNodes();
+    size_t NodeCount = Nodes.size();
+    for (size_t n = 0; n < NodeCount; ++n) {
+        SetNodeChannelValues(n, &data[NodeStartChannel(n)]);
+    }
+
+    PreviewVertexCache& cache = previewVertexCache[is_3d ? 1 : 0];
+
+    // the location matrices are recalculated on every draw so they must be current before we probe them
+    GetModelScreenLocation().PrepareToDraw(is_3d, false);
+    float probe[12];
+    GetPreviewProbe(probe);
+    if (!cache.valid || cache.changeCount != changeCount || cache.nodeCount != NodeCount ||
+        cache.pixelStyle != pixelStyle || cache.pixelSize != pixelSize ||
+        cache.transparency != transparency || cache.blackTransparency != blackTransparency ||
+        memcmp(cache.probe, probe, sizeof(probe)) != 0) {
+        BuildPreviewVertexCache(cache, is_3d, probe);
+    }
+
+    uint8_t* colors = cache.colors.data();
+    const uint32_t vertexCount = cache.edge.size();
+    xlColor color;
+    for (size_t i = 0; i < cache.nodes.size(); i++) {
+        uint32_t n = cache.nodes[i].first;
+        uint32_t start = cache.nodes[i].second;
+        uint32_t end = (i + 1 < cache.nodes.size()) ? cache.nodes[i + 1].second : vertexCount;
+
+        Nodes[n]->GetColor(color);
+        if (Nodes[n]->model->modelDimmingCurve != nullptr) {
+            Nodes[n]->model->modelDimmingCurve->reverse(color);
+        }
+        if (Nodes[n]->model->StrobeRate) {
+            // rand() is not safe to call from several threads at once
+            cache.strobeSeed ^= cache.strobeSeed << 13;
+            cache.strobeSeed ^= cache.strobeSeed >> 17;
+            cache.strobeSeed ^= cache.strobeSeed << 5;
+            if (cache.strobeSeed % 5 != 0) {
+                color = xlBLACK;
+            }
+        }
+        xlColor ccolor(color);
+        ApplyTransparency(ccolor, transparency, blackTransparency);
+        for (uint32_t v = start; v < end; v++) {
+            uint8_t* c = &colors[v * 4];
+            c[0] = ccolor.red;
+            c[1] = ccolor.green;
+            c[2] = ccolor.blue;
+            c[3] = (cache.edge[v] && pixelStyle != 2) ? 0 : ccolor.alpha;
+        }
+    }
+}
+
+void Model::DisplayPreviewFrame(ModelPreview* preview, DrawGLUtils::xlAccumulator& solidVa, DrawGLUtils::xlAccumulator& transparentVa, float& minx, float& miny, float& maxx, float& maxy, bool is_3d)
+{
+    if (!IsActive() && preview->IsNoCurrentModel()) { return; }
+
+    const PreviewVertexCache& cache = previewVertexCache[is_3d ? 1 : 0];
+    bool needTransparent = false;
+    if (pixelStyle == 3 || transparency != 0 || blackTransparency != 0) {
+        needTransparent = true;
+    }
+    DrawGLUtils::xlAccumulator& va = needTransparent ? transparentVa : solidVa;
+
+    unsigned int count = cache.edge.size();
+    if (count > 0 && va.coordsPerVertex == cache.coordsPerVertex) {
+        va.PreAlloc(count);
+        memcpy(&va.vertices[(size_t)va.count * va.coordsPerVertex], cache.vertices.data(), sizeof(float) * cache.vertices.size());
+        memcpy(&va.colors[(size_t)va.count * 4], cache.colors.data(), cache.colors.size());
+        va.count += count;
+
+        minx = std::min(minx, cache.minx);
+        miny = std::min(miny, cache.miny);
+        maxx = std::max(maxx, cache.maxx);
+        maxy = std::max(maxy, cache.maxy);
+    }
+
+    if (pixelStyle > 1) {
+        va.Finish(GL_TRIANGLES);
+    } else {
+        va.Finish(GL_POINTS, pixelStyle == 1 ? GL_POINT_SMOOTH : 0, preview->calcPixelSize(pixelSize));
+    }
+}
+#pragma endregion
+
 wxString Model::GetNodeNear(ModelPreview* preview, wxPoint pt)
 {
+    EnsureNodes();
     int w, h;
     preview->GetSize(&w, &h);
     float scaleX = float(w) * 0.95 / GetModelScreenLocation().RenderWi;
@@ -4476,6 +4790,7 @@ wxString Model::GetNodeNear(ModelPreview* preview, wxPoint pt)
 }
 
 void Model::DisplayEffectOnWindow(ModelPreview* preview, double pointSize) {
+    EnsureNodes();
     if (!IsActive() && preview->IsNoCurrentModel()) { return; }
     bool success = preview->StartDrawing(pointSize);
 
@@ -5917,6 +6232,7 @@ int Model::GetControllerPort(int string) const
 
 void Model::GetMinScreenXY(float& minx, float& miny) const
 {
+    EnsureNodes();
     if (Nodes.size() == 0)
     {
         minx = 0;
@@ -14,6 +14,8 @@
 #include <map>
 #include <vector>
 #include <list>
+#include <mutex>
+#include <atomic>
 
 #include "ModelScreenLocation.h"
 #include "../Color.h"
@@ -108,6 +110,9 @@ public:
     void SetPixelSize(int size) { pixelSize = size; } // temporarily changes pixel size
 
     virtual bool AllNodesAllocated() const { return true; }
+    // Some models (groups) defer building their nodes until something first needs them
+    void EnsureNodes() const { if (_nodesState != NODES_READY) BuildPendingNodes(); }
+    bool NodesPending() const { return _nodesState == NODES_PENDING; }
     static void ParseFaceInfo(wxXmlNode *fiNode, std::map<std::string, std::map<std::string, std::string> > &faceInfo);
     static void WriteFaceInfo(wxXmlNode *fiNode, const std::map<std::string, std::map<std::string, std::string> > &faceInfo);
     wxString SerialiseFace() const;
@@ -145,8 +150,8 @@ public:
     static const std::vector<std::string> DEFAULT_BUFFER_STYLES;
 
     virtual bool StrandsZigZagOnString() const { return false;};
-    int GetDefaultBufferWi() const {return BufferWi;}
-    int GetDefaultBufferHt() const {return BufferHt;}
+    int GetDefaultBufferWi() const { EnsureNodes(); return BufferWi; }
+    int GetDefaultBufferHt() const { EnsureNodes(); return BufferHt; }
     virtual bool IsDMXModel() const { return false; }
 
     void SetProperty(wxString property, wxString value, bool apply = false);
@@ -194,6 +199,12 @@ protected:
     std::vector<NodeBaseClassPtr> Nodes;
     const ModelManager &modelManager;
 
+    enum { NODES_READY, NODES_PENDING, NODES_BUILDING };
+    static std::recursive_mutex _nodesLock; // held while any deferred nodes are built or invalidated
+    mutable std::atomic_int _nodesState { NODES_READY };
+    virtual void BuildNodes() {}
+    void BuildPendingNodes() const;
+
     int FindNodeAtXY(int bufx, int bufy);
     virtual void InitModel();
     virtual int CalcCannelsPerString();
@@ -230,6 +241,9 @@ protected:
 
     std::vector<Model *> subModels;
     void ParseSubModel(wxXmlNode *subModelNode);
+    uint64_t CalcStructureSignature() const;
+    uint64_t _structureSignature = 0; // hash of the xml (bar StartChannel) the nodes were last built from
+    int32_t _builtStartChannel = -1; // resolved StartChannel the nodes were last built or shifted to, -1 if unknown
     void ColourClashingChains(wxPGProperty* p);
 
     std::vector<std::string> modelState;
@@ -301,6 +315,7 @@ public:
     std::string _pixelSpacing = "";
 
     void SetFromXml(wxXmlNode* ModelNode, bool zeroBased=false) override;
+    bool ShiftToStartChannel();
     virtual bool ModelRenamed(const std::string &oldName, const std::string &newName);
     uint32_t GetNodeCount() const;
     uint32_t GetChanCount() const;
@@ -327,6 +342,13 @@ public:
     virtual void DisplayModelOnWindow(ModelPreview* preview, DrawGLUtils::xl3Accumulator &solidVa3, DrawGLUtils::xl3Accumulator &transparentVa3, DrawGLUtils::xl3Accumulator& lva, bool is_3d = false, const xlColor *color =  NULL, bool allowSelected = false, bool wiring = false, bool highlightFirst = false, int highlightpixel = 0);
     virtual void DisplayEffectOnWindow(ModelPreview* preview, double pointSize);
     virtual int NodeRenderOrder() {return 0;}
+
+    // Used when the preview is playing a sequence. Vertex positions are cached for 2D and 3D and only
+    // recalculated when the model changes or moves so each frame only needs the node colours updated.
+    // PreparePreviewFrame only touches this model so it can be called for many models at once.
+    virtual bool SupportsPreviewVertexCache() const { return true; }
+    void PreparePreviewFrame(const unsigned char* data, bool is_3d);
+    void DisplayPreviewFrame(ModelPreview* preview, DrawGLUtils::xlAccumulator& solidVa, DrawGLUtils::xlAccumulator& transparentVa, float& minx, float& miny, float& maxx, float& maxy, bool is_3d);
     wxString GetNodeNear(ModelPreview* preview, wxPoint pt);
 
     virtual bool CleanupFileLocations(xLightsFrame* frame) override;
@@ -439,6 +461,31 @@ public:
 
 protected:
     unsigned int maxVertexCount;
+
+    struct PreviewVertexCache
+    {
+        bool valid = false;
+        unsigned long changeCount = 0;
+        size_t nodeCount = 0;
+        int pixelStyle = 0;
+        int pixelSize = 0;
+        int transparency = 0;
+        int blackTransparency = 0;
+        float probe[12] = {}; // where the model location puts a few fixed points ... catches moves that dont change the change count
+        unsigned int coordsPerVertex = 2;
+        std::vector<float> vertices;
+        std::vector<uint8_t> colors;
+        std::vector<uint8_t> edge; // 1 for the outer vertices of a circle pixel
+        std::vector<std::pair<uint32_t, uint32_t>> nodes; // node, first vertex ... in draw order
+        float minx = 0;
+        float miny = 0;
+        float maxx = 0;
+        float maxy = 0;
+        uint32_t strobeSeed = 1;
+    };
+    PreviewVertexCache previewVertexCache[2]; // 2D, 3D
+    void GetPreviewProbe(float* probe) const;
+    void BuildPreviewVertexCache(PreviewVertexCache& cache, bool is_3d, const float* probe);
 };
 
 template <class ScreenLocation>
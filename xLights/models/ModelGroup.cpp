@@ -384,7 +384,11 @@ int ModelGroup::GetYCentreOffset() const
     return wxAtoi(ModelXml->GetAttribute("YCentreOffset", "0"));
 }
 
+// Only the list of models is worked out here ... building the group's nodes means copying every node of
+// every model in it so that is left until something first needs them. See BuildNodes.
 bool ModelGroup::Reset(bool zeroBased) {
+    modelManager.StopWarmUp();
+    std::lock_guard<std::recursive_mutex> lock(_nodesLock);
     this->zeroBased = zeroBased;
     selected = false;
     name = ModelXml->GetAttribute("name").Trim(true).Trim(false).ToStdString();
@@ -393,9 +397,6 @@ bool ModelGroup::Reset(bool zeroBased) {
     StringType = "RGB Nodes";
 
     layout_group = ModelXml->GetAttribute("LayoutGroup", "Unassigned");
-    int gridSize = wxAtoi(ModelXml->GetAttribute("GridSize", "400"));
-    int offsetX = wxAtoi(ModelXml->GetAttribute("XCentreOffset", "0"));
-    int offsetY = wxAtoi(ModelXml->GetAttribute("YCentreOffset", "0"));
     std::string layout = ModelXml->GetAttribute("layout", "minimalGrid").ToStdString();
     defaultBufferStyle = layout;
     if (layout.compare(0, 9, "Per Model") == 0) {
@@ -409,18 +410,17 @@ bool ModelGroup::Reset(bool zeroBased) {
         defaultBufferStyle = HORIZ_PER_MODEL;
     }
     Nodes.clear();
+    _nodesState = NODES_READY;
     models.clear();
     modelNames.clear();
     changeCount = 0;
     wxArrayString mn = wxSplit(ModelXml->GetAttribute("models"), ',');
-    int nc = 0;
     for (int x = 0; x < mn.size(); x++) {
         Model *c = modelManager.GetModel(mn[x].Trim(true).Trim(false).ToStdString());
         if (c != nullptr) {
             modelNames.push_back(c->GetFullName());
             models.push_back(c);
             changeCount += c->GetChangeCount();
-            nc += c->GetNodeCount();
         }
         else if (mn[x] == "")
         {
@@ -433,6 +433,20 @@ bool ModelGroup::Reset(bool zeroBased) {
         }
     }
 
+    _nodesState = NODES_PENDING;
+    return true;
+}
+
+void ModelGroup::BuildNodes() {
+    int gridSize = wxAtoi(ModelXml->GetAttribute("GridSize", "400"));
+    int offsetX = wxAtoi(ModelXml->GetAttribute("XCentreOffset", "0"));
+    int offsetY = wxAtoi(ModelXml->GetAttribute("YCentreOffset", "0"));
+    bool minimal = ModelXml->GetAttribute("layout", "minimalGrid") != "grid";
+
+    size_t nc = 0;
+    for (Model *c : models) {
+        nc += c->GetNodeCount();
+    }
     if (nc) {
         Nodes.reserve(nc);
     }
@@ -442,8 +456,6 @@ bool ModelGroup::Reset(bool zeroBased) {
         LoadRenderBufferNodes(c, "Per Preview No Offset", "2D", Nodes, bw, bh);
     }
 
-    bool minimal = layout != "grid";
-
     //now have all the nodes for all the models
     float minx = 99999;
     float maxx = -1;
@@ -572,12 +584,11 @@ bool ModelGroup::Reset(bool zeroBased) {
 
     screenLocation.SetRenderSize(maxx - nminx + 1, maxy - nminy + 1);
     screenLocation.SetPosition(BufferWi / 2.0f, BufferHt / 2.0f);
-
-    return true;
 }
 
 void ModelGroup::ResetModels()
 {
+    std::lock_guard<std::recursive_mutex> lock(_nodesLock);
     models.clear();
     wxArrayString mn = wxSplit(ModelXml->GetAttribute("models"), ',');
     for (int x = 0; x < mn.size(); x++) {
@@ -62,10 +62,17 @@ class ModelGroup : public ModelWithScreenLocation<BoxedScreenLocation>
 
         virtual int GetNumStrands() const override { return 0;}
 
+        // the group's size and position come from its nodes
+        virtual const ModelScreenLocation &GetModelScreenLocation() const override { EnsureNodes(); return screenLocation; }
+        virtual ModelScreenLocation &GetModelScreenLocation() override { EnsureNodes(); return screenLocation; }
+        virtual const ModelScreenLocation &GetBaseObjectScreenLocation() const override { EnsureNodes(); return screenLocation; }
+        virtual ModelScreenLocation &GetBaseObjectScreenLocation() override { EnsureNodes(); return screenLocation; }
+
         bool Reset(bool zeroBased = false);
         void ResetModels();
     protected:
         static std::vector<std::string> GROUP_BUFFER_STYLES;
+        virtual void BuildNodes() override;
 
     private:
         bool CheckForChanges() const;
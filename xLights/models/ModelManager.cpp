@@ -67,8 +67,51 @@ ModelManager::~ModelManager() {
     clear();
 }
 
+// Model groups build their nodes on first use. Once the layout is loaded we build them on a
+// background thread so the first render or preview does not pay for it. Anything that deletes,
+// replaces or rebuilds models (SetFromXml, group resets, start channel recalcs) must stop this first.
+void ModelManager::StartWarmUp()
+{
+    StopWarmUp();
+
+    std::list<Model*> pending;
+    {
+        std::lock_guard<std::recursive_mutex> lock(_modelMutex);
+        for (const auto& it : models) {
+            if (it.second != nullptr && it.second->NodesPending()) {
+                pending.push_back(it.second);
+            }
+        }
+    }
+    if (pending.empty()) return;
+
+    std::lock_guard<std::mutex> lock(_warmUpMutex);
+    _warmUpCancel = false;
+    _warmUpThread = std::thread([this, pending]() {
+        static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+        wxStopWatch timer;
+        int count = 0;
+        for (const auto& it : pending) {
+            if (_warmUpCancel) break;
+            it->EnsureNodes();
+            ++count;
+        }
+        logger_base.info("Model group nodes built for %d of %d groups in the background in %ldms.", count, (int)pending.size(), timer.Time());
+    });
+}
+
+void ModelManager::StopWarmUp() const
+{
+    std::lock_guard<std::mutex> lock(_warmUpMutex);
+    if (_warmUpThread.joinable() && _warmUpThread.get_id() != std::this_thread::get_id()) {
+        _warmUpCancel = true;
+        _warmUpThread.join();
+    }
+}
+
 void ModelManager::clear()
 {
+    StopWarmUp();
     std::lock_guard<std::recursive_mutex> _lock(_modelMutex);
     for (auto& it : models) {
         if (it.second != nullptr) {
@@ -124,6 +167,7 @@ Model *ModelManager::operator[](const std::string &name) const {
 }
 
 bool ModelManager::Rename(const std::string &oldName, const std::string &newName) {
+    StopWarmUp();
     auto on = Trim(oldName);
     auto nn = Trim(newName);
     Model *model = GetModel(on);
@@ -257,6 +301,7 @@ uint32_t ModelManager::GetLastChannel() const {
 void ModelManager::ResetModelGroups() const
 {
     // This goes through all the model groups which hold model pointers and ensure their model pointers are correct
+    StopWarmUp();
     std::lock_guard<std::recursive_mutex> lock(_modelMutex);
     for (const auto& it : models) {
         if (it.second != nullptr && it.second->GetDisplayAs() == "ModelGroup") {
@@ -359,69 +404,65 @@ void ModelManager::AddModelGroups(wxXmlNode* n, int w, int h, const std::string&
 
 bool ModelManager::RecalcStartChannels() const {
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+    StopWarmUp();
     std::lock_guard<std::recursive_mutex> lock(_modelMutex);
 
     wxStopWatch sw;
     bool changed = false;
-    std::set<std::string> modelsDone;
+    int rebuilt = 0;
 
     for (const auto& it : models) {
         it.second->CouldComputeStartChannel = false;
     }
 
-    // first go through all models whose start channels are not dependent on other models
+    // models whose structure is unchanged just have their channels moved, everything else is rebuilt
+    auto recalc = [&changed, &rebuilt](Model* m) {
+        auto oldsc = m->GetFirstChannel();
+        if (!m->ShiftToStartChannel()) {
+            m->SetFromXml(m->GetModelXml());
+            rebuilt++;
+        }
+        if (oldsc != m->GetFirstChannel()) {
+            changed = true;
+        }
+    };
+
+    // work out what each model depends on so we can process them in dependency order
+    std::map<std::string, std::list<Model*>> dependents;
+    std::list<Model*> ready;
     for (const auto& it : models) {
         if (it.second->GetDisplayAs() != "ModelGroup")
         {
+            std::string sc = Trim(it.second->ModelStartChannel);
             char first = '0';
-            if (Trim(it.second->ModelStartChannel) != "") first = Trim(it.second->ModelStartChannel)[0];
-            if (first != '>' && first != '@')
+            if (sc != "") first = sc[0];
+            if (first == '>' || first == '@')
             {
-                modelsDone.emplace(it.first);
-                auto oldsc = it.second->GetFirstChannel();
-                it.second->SetFromXml(it.second->GetModelXml());
-                if (oldsc != it.second->GetFirstChannel())
-                {
-                    changed = true;
-                }
+                std::string dependsOn = Trim(sc.substr(1, sc.find(':') - 1));
+                dependents[dependsOn].push_back(it.second);
+            }
+            else
+            {
+                ready.push_back(it.second);
             }
         }
     }
 
-    // now go through all undone models that depend on something
-    bool workDone = false;
-    do
+    // a model becomes ready once the model it depends on is done ... anything in a cycle or depending
+    // on a missing model never becomes ready and is picked up below
+    while (!ready.empty())
     {
-        workDone = false;
+        Model* m = ready.front();
+        ready.pop_front();
+        recalc(m);
 
-        for (const auto& it : models) {
-            if (it.second->GetDisplayAs() != "ModelGroup")
-            {
-                char first = '0';
-                if (Trim(it.second->ModelStartChannel) != "") first = Trim(it.second->ModelStartChannel)[0];
-                if ((first == '>' || first == '@') && !it.second->CouldComputeStartChannel)
-                {
-                    std::string dependsOn = Trim(Trim(it.second->ModelStartChannel).substr(1, Trim(it.second->ModelStartChannel).find(':') - 1));
-                    if (modelsDone.find(dependsOn) != modelsDone.end())
-                    {
-                        // the depends on model is done
-                        modelsDone.emplace(it.first);
-                        auto oldsc = it.second->GetFirstChannel();
-                        it.second->SetFromXml(it.second->GetModelXml());
-                        if (oldsc != it.second->GetFirstChannel())
-                        {
-                            changed = true;
-                        }
-                        if (it.second->CouldComputeStartChannel)
-                        {
-                            workDone = true;
-                        }
-                    }
-                }
-            }
+        auto d = dependents.find(m->GetName());
+        if (d != dependents.end())
+        {
+            ready.splice(ready.end(), d->second);
+            dependents.erase(d);
         }
-
-    } while (workDone);
+    }
 
     // now process anything unprocessed
     int countInvalid = 0;
@@ -430,12 +471,7 @@ bool ModelManager::RecalcStartChannels() const {
             char first = '0';
             if (Trim(it.second->ModelStartChannel) != "") first = Trim(it.second->ModelStartChannel)[0];
             if ((first == '>' || first == '@') && !it.second->CouldComputeStartChannel) {
-                modelsDone.emplace(it.first);
-                auto oldsc = it.second->GetFirstChannel();
-                it.second->SetFromXml(it.second->GetModelXml());
-                if (oldsc != it.second->GetFirstChannel()) {
-                    changed = true;
-                }
+                recalc(it.second);
             }
             if (!it.second->CouldComputeStartChannel) {
                 countInvalid++;
@@ -446,7 +482,7 @@ bool ModelManager::RecalcStartChannels() const {
     ResetModelGroups();
 
     long end = sw.Time();
-    logger_base.debug("RecalcStartChannels takes %ldms.", end);
+    logger_base.debug("RecalcStartChannels takes %ldms, %d models rebuilt.", end, rebuilt);
 
     if (countInvalid > 0) {
         DisplayStartChannelCalcWarning();
@@ -834,12 +870,16 @@ bool ModelManager::ReworkStartChannel() const
 }
 
 bool ModelManager::LoadGroups(wxXmlNode* groupNode, int previewW, int previewH) {
+    static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    StopWarmUp();
     this->groupNode = groupNode;
     bool changed = false;
+    wxStopWatch timer;
 
     std::list<wxXmlNode*> toBeDone;
     std::list<std::string> allModels;
-    std::lock_guard<std::recursive_mutex> lock(_modelMutex);
+    std::unique_lock<std::recursive_mutex> lock(_modelMutex);
 
     // do all the models without embedded groups first or where the model order means everything exists
     for (wxXmlNode* e = groupNode->GetChildren(); e != nullptr; e = e->GetNext()) {
@@ -914,6 +954,13 @@ bool ModelManager::LoadGroups(wxXmlNode* groupNode, int previewW, int previewH)
         models[model->name] = model;
         model->SetLayoutGroup(it->GetAttribute("LayoutGroup", "Unassigned").ToStdString());
     }
+    logger_base.info("Model groups loaded in %ldms.", timer.Time());
+
+    // The warm up thread never takes the model lock, only Model::_nodesLock while it builds each group, so
+    // holding this lock would not protect it. It is kept safe by everything that deletes, replaces or
+    // rebuilds models calling StopWarmUp first.
+    lock.unlock();
+    StartWarmUp();
 
     return changed;
 }
@@ -1265,6 +1312,7 @@ void ModelManager::AddModel(Model *model) {
     // Lock before we add models ... this is required because LoadModels loads this in parallel
 
     if (model != nullptr) {
+        StopWarmUp();
         std::lock_guard<std::recursive_mutex> _lock(_modelMutex);
         auto it = models.find(model->name);
         if (it != models.end()) {
@@ -1326,6 +1374,7 @@ std::string ModelManager::GetModelsOnChannels(uint32_t start, uint32_t end, int
 }
 
 void ModelManager::Delete(const std::string &name) {
+    StopWarmUp();
 
     if( xlights->CurrentSeqXmlFile != nullptr )
     {
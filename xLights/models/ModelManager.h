@@ -15,6 +15,7 @@
 #include <vector>
 #include <mutex>
 #include <atomic>
+#include <thread>
 
 #include "ObjectManager.h"
 
@@ -80,7 +81,11 @@ class ModelManager : public ObjectManager
         Model *createAndAddModel(wxXmlNode *node, int previewW, int previewH);
         std::string GetModelsOnChannels(uint32_t start, uint32_t end, int perLine) const;
 
+        // Stops and joins the background group node build. Call before changing or replacing any model
+        void StopWarmUp() const;
+
     private:
+        void StartWarmUp();
 
     wxXmlNode *layoutsNode = nullptr;
     OutputManager* _outputManager = nullptr;
@@ -90,5 +95,8 @@ class ModelManager : public ObjectManager
     std::map<std::string, Model *> models;
     mutable std::recursive_mutex _modelMutex;
     std::atomic<bool> _modelsLoading;
+    mutable std::mutex _warmUpMutex;
+    mutable std::thread _warmUpThread;
+    mutable std::atomic_bool _warmUpCancel { false };
 };
 
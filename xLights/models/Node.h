@@ -134,6 +134,19 @@ public:
     uint32_t GetChanCount() const {
         return chanCnt;
     }
+    // direct access to the rgb values and channel offsets so the render output does not need a virtual
+    // call per node for plain rgb nodes
+    const uint8_t *GetRawColor() const {
+        return c;
+    }
+    void SetRawColor(uint8_t r, uint8_t g, uint8_t b) {
+        c[0] = r;
+        c[1] = g;
+        c[2] = b;
+    }
+    const uint8_t *GetChannelOffsets() const {
+        return offsets;
+    }
     bool IsVisible() const {
         return !Coords.empty();
     }
@@ -61,7 +61,7 @@ void DMXOutput::EndFrame(int suppressFrames) {
 
     if (_changed || NeedToOutput(suppressFrames)) {
         if (_serial != nullptr) {
-            _serial->Write((char *)_data, _datalen);
+            WriteFrame(_data, _datalen);
         }
         FrameOutput();
     }
@@ -260,6 +260,8 @@ void LOROptimisedOutput::SetManyChannels(int32_t channel, unsigned char* data, s
 
     if (!_enabled || _serial == nullptr || !_ok) return;
 
+    // only changes are sent so a frame cannot be replaced by a newer one once handed to the writer ...
+    // skipping here is safe as _lastSent is untouched and the next frame picks up the changes
     if (!TxEmpty()) {
         logger_base.debug("    LOROptimisedOutput: SetManyChannels skipped due to transmit buffer stackup");
         return;
@@ -407,9 +409,9 @@ void LOROptimisedOutput::SetManyChannels(int32_t channel, unsigned char* data, s
             }
 
             if (_serial != nullptr && frame_changed) {
-                _serial->Write((char*)d, idx);
-                // After we output we dont want to close too early as that causes crashes
-                SetDontDieUntil(wxGetUTCTimeMillis() + MINIMUM_MILLIS_AFTER_WRITE_BEFORE_CLOSE);
+                // After we output we dont want to close too early as that causes crashes ... the writer holds
+                // the port open for this long after the write completes
+                WriteMessage(d, idx, MINIMUM_MILLIS_AFTER_WRITE_BEFORE_CLOSE);
                 total_bytes_sent += idx;
             }
 
@@ -461,9 +463,8 @@ void LOROptimisedOutput::AllOff() {
             d[idx++] = 0x0;
 
             if (_serial != nullptr) {
-                _serial->Write((char*)d, idx);
                 // After we output we dont want to close too early as that causes crashes
-                SetDontDieUntil(wxGetUTCTimeMillis() + MINIMUM_MILLIS_AFTER_WRITE_BEFORE_CLOSE);
+                WriteMessage(d, idx, MINIMUM_MILLIS_AFTER_WRITE_BEFORE_CLOSE);
             }
             controller_channels_to_process -= channels_per_pass;
             unit_id++;
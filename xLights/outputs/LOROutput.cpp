@@ -83,6 +83,11 @@ void LOROutput::ResetFrame() {
     _lastheartbeat = -1;
 }
 
+void LOROutput::ResendAll() {
+    memset(_lastSent, 0xFF, sizeof(_lastSent));
+    memset(_notSentCount, 0xF0, sizeof(_notSentCount));
+}
+
 void LOROutput::SendHeartbeat() const {
 
     if (!_enabled || _serial == nullptr || !_ok) return;
@@ -94,7 +99,7 @@ void LOROutput::SendHeartbeat() const {
     d[3] = 0x56;
     d[4] = 0;
     if (_serial != nullptr) {
-        _serial->Write((char*)d, 5);
+        WriteMessage(d, 5);
     }
 }
 #pragma endregion 
@@ -118,7 +123,7 @@ void LOROutput::SetOneChannel(int32_t channel, unsigned char data) {
         d[5] = 0;
 
         if (_serial != nullptr) {
-            _serial->Write((char *)d, 6);
+            WriteMessage(d, 6);
             _lastSent[channel] = data;
         }
     }
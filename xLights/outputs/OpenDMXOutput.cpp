@@ -51,9 +51,9 @@ void OpenDMXOutput::EndFrame(int suppressFrames) {
 
     if (_changed || NeedToOutput(suppressFrames)) {
         if (_serial != nullptr) {
-            _serial->SendBreak();  // sends a 1 millisecond break
-            wxMilliSleep(1);      // mark after break (MAB) - 1 millisecond is overkill (8 microseconds is the minimum dmx requirement)
-            _serial->Write((char *)_data, 513);
+            // the writer sends a 1 millisecond break and mark after break (MAB) before the data
+            // 1 millisecond is overkill (8 microseconds is the minimum dmx requirement)
+            WriteFrame(_data, 513, true);
             FrameOutput();
         }
     }
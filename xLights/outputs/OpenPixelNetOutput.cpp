@@ -69,11 +69,9 @@ void OpenPixelNetOutput::EndFrame(int suppressFrames) {
 
     if (_changed || NeedToOutput(suppressFrames)) {
         if (_serial != nullptr) {
-            if (_serial->WaitingToWrite() == 0) {
-                memcpy(&_serialBuffer[6], _data, sizeof(_data));
-                _serial->Write((char *)_serialBuffer, sizeof(_serialBuffer));
-                FrameOutput();
-            }
+            memcpy(&_serialBuffer[6], _data, sizeof(_data));
+            WriteFrame(_serialBuffer, sizeof(_serialBuffer));
+            FrameOutput();
         }
     }
     else {
@@ -1057,6 +1057,8 @@ bool OutputManager::StartOutput() {
 
     static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
 
+    _dataGeneration++;
+
     if (_outputting) return false;
     if (!_outputCriticalSection.TryEnter()) return false;
 
@@ -1106,6 +1108,8 @@ void OutputManager::StopOutput() {
 
     static log4cpp::Category& logger_base = log4cpp::Category::getInstance(std::string("log_base"));
 
+    _dataGeneration++;
+
     if (!_outputting) return;
     if (!_outputCriticalSection.TryEnter()) return;
 
@@ -1155,6 +1159,7 @@ void OutputManager::StartFrame(long msec) {
 
 void OutputManager::ResetFrame() {
 
+    _dataGeneration++;
     if (!_outputting) return;
     if (!_outputCriticalSection.TryEnter()) return;
 
@@ -1216,6 +1221,7 @@ void OutputManager::SendHeartbeat() {
 // channel here is zero based
 void OutputManager::SetOneChannel(int32_t channel, unsigned char data) {
 
+    _dataGeneration++;
     int32_t sc = 0;
     Output* output = GetOutput(channel + 1, sc);
     if (output != nullptr) {
@@ -1228,6 +1234,7 @@ void OutputManager::SetOneChannel(int32_t channel, unsigned char data) {
 // channel here is zero based
 void OutputManager::SetManyChannels(int32_t channel, unsigned char* data, size_t size) {
 
+    _dataGeneration++;
     if (size == 0) return;
 
     int32_t stch;
@@ -1265,6 +1272,7 @@ void OutputManager::SetManyChannels(int32_t channel, unsigned char* data, size_t
 
 void OutputManager::AllOff(bool send) {
 
+    _dataGeneration++;
     if (!_outputCriticalSection.TryEnter()) return;
 
     for (const auto& it : GetAllOutputs()) {
@@ -12,6 +12,7 @@
 
 #include <wx/thread.h>
 
+#include <atomic>
 #include <list>
 #include <string>
 #include <map>
@@ -40,6 +41,7 @@ class OutputManager
     int _suppressFrames = 0;
     bool _parallelTransmission = false;
     bool _outputting = false; // true if we are currently sending out data
+    std::atomic<uint32_t> _dataGeneration { 0 }; // bumped whenever the outputs' channel data may have been changed, read from other threads
     bool _didConvert = false;
     std::string _globalFPPProxy;
     wxCriticalSection _outputCriticalSection; // used to protect areas that must be single threaded
@@ -196,6 +198,8 @@ public:
     void SetOneChannel(int32_t channel, unsigned char data);
     void SetManyChannels(int32_t channel, unsigned char* data, size_t size);
     void AllOff(bool send = true);
+    // if this is unchanged the outputs still hold exactly what was last set through SetManyChannels
+    uint32_t GetDataGeneration() const { return _dataGeneration; }
     #pragma endregion 
 
     #pragma region Test Presets
@@ -48,7 +48,7 @@ void RenardOutput::EndFrame(int suppressFrames)
     {
         if (_serial != nullptr)
         {
-            _serial->Write((char *)&_data[0], _datalen);
+            WriteFrame(&_data[0], _datalen);
             FrameOutput();
         }
     }
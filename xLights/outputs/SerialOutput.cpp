@@ -9,6 +9,8 @@
  * License: https://github.com/smeighan/xLights/blob/master/License.txt
  **************************************************************/
 
+#include <algorithm>
+
 #include <wx/xml/xml.h>
 #include <wx/msgdlg.h>
 
@@ -27,6 +29,127 @@
 
 #include <log4cpp/Category.hh>
 
+#pragma region Serial Writer
+SerialWriter::SerialWriter(SerialPort* serial) : _serial(serial) {
+
+    _thread = std::thread(&SerialWriter::Run, this);
+}
+
+SerialWriter::~SerialWriter() {
+
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        _stop = true;
+    }
+    _signal.notify_all();
+    if (_thread.joinable()) _thread.join();
+}
+
+void SerialWriter::Queue(const uint8_t* data, size_t len, bool frame, bool sendBreak, int holdMS) {
+
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        if (frame && !_pending.empty() && _pending.back().frame) {
+            // the port has not caught up ... the newer frame replaces the one still waiting
+            _pendingBytes -= _pending.back().data.size();
+            _pending.pop_back();
+            _stats.dropped++;
+        }
+        else if (!frame) {
+            // the port is stalled or gone ... drop the oldest changes rather than grow forever, the output
+            // resends everything once the port takes data again
+            while (!_pending.empty() && _pendingBytes + len > MAX_PENDING_MESSAGE_BYTES) {
+                _pendingBytes -= _pending.front().data.size();
+                _pending.pop_front();
+                _stats.dropped++;
+                _resend = true;
+            }
+        }
+        _pending.emplace_back();
+        Packet& p = _pending.back();
+        p.data.assign(data, data + len);
+        p.frame = frame;
+        p.sendBreak = sendBreak;
+        p.holdMS = holdMS;
+        p.queued = std::chrono::steady_clock::now();
+        _pendingBytes += len;
+    }
+    _signal.notify_all();
+}
+
+void SerialWriter::Run() {
+
+    std::unique_lock<std::mutex> lock(_lock);
+    while (true) {
+        _signal.wait(lock, [this] { return _stop || !_pending.empty(); });
+        if (_stop) break;
+
+        Packet p = std::move(_pending.front());
+        _pending.pop_front();
+        _pendingBytes -= p.data.size();
+        _writing = true;
+        lock.unlock();
+
+        if (p.sendBreak) {
+            _serial->SendBreak();  // sends a 1 millisecond break
+            wxMilliSleep(1);       // mark after break (MAB)
+        }
+        _serial->Write((char*)p.data.data(), p.data.size());
+        auto written = std::chrono::steady_clock::now();
+        double latency = std::chrono::duration<double, std::milli>(written - p.queued).count();
+
+        lock.lock();
+        _writing = false;
+        if (p.holdMS > 0) {
+            _holdUntil = std::max(_holdUntil, written + std::chrono::milliseconds(p.holdMS));
+        }
+        _stats.written++;
+        _totalLatencyMS += latency;
+        _stats.avgLatencyMS = _totalLatencyMS / _stats.written;
+        if (latency > _stats.maxLatencyMS) _stats.maxLatencyMS = latency;
+    }
+}
+
+void SerialWriter::Purge() {
+
+    std::unique_lock<std::mutex> lock(_lock);
+    _pending.clear();
+    _pendingBytes = 0;
+}
+
+size_t SerialWriter::PendingBytes() const {
+
+    std::unique_lock<std::mutex> lock(_lock);
+    return _pendingBytes;
+}
+
+bool SerialWriter::IsIdle() const {
+
+    std::unique_lock<std::mutex> lock(_lock);
+    return _pending.empty() && !_writing;
+}
+
+bool SerialWriter::IsHeld() const {
+
+    std::unique_lock<std::mutex> lock(_lock);
+    return _writing || std::chrono::steady_clock::now() < _holdUntil;
+}
+
+bool SerialWriter::TakeResend() {
+
+    std::unique_lock<std::mutex> lock(_lock);
+    bool resend = _resend && _pending.empty();
+    if (resend) _resend = false;
+    return resend;
+}
+
+SerialWriterStats SerialWriter::GetStats() const {
+
+    std::unique_lock<std::mutex> lock(_lock);
+    return _stats;
+}
+#pragma endregion
+
 #pragma region Private Functions
 void SerialOutput::Save(wxXmlNode* node) {
 
@@ -43,6 +166,16 @@ void SerialOutput::Save(wxXmlNode* node) {
 
     Output::Save(node);
 }
+
+void SerialOutput::WriteFrame(const uint8_t* data, size_t len, bool sendBreak) const {
+
+    if (_writer != nullptr) _writer->WriteFrame(data, len, sendBreak);
+}
+
+void SerialOutput::WriteMessage(const uint8_t* data, size_t len, int holdMS) const {
+
+    if (_writer != nullptr) _writer->WriteMessage(data, len, holdMS);
+}
 #pragma endregion
 
 #pragma region Constructors and Destructors
@@ -75,6 +208,7 @@ SerialOutput::SerialOutput() : Output() {
 
 SerialOutput::~SerialOutput() {
 
+    if (_writer != nullptr) delete _writer;
     if (_serial != nullptr) delete _serial;
 }
 
@@ -245,14 +379,21 @@ std::string SerialOutput::GetLongDescription() const {
 }
 
 size_t SerialOutput::TxNonEmptyCount() const {
-    return (_serial != nullptr) ? _serial->WaitingToWrite() : 0;
+    if (_serial == nullptr) return 0;
+    return _serial->WaitingToWrite() + (_writer != nullptr ? _writer->PendingBytes() : 0);
 }
 
 bool SerialOutput::TxEmpty() const {
+    if (_writer != nullptr && !_writer->IsIdle()) return false;
     if (_serial != nullptr) return (_serial->WaitingToWrite() == 0);
     return true;
 }
 
+SerialWriterStats SerialOutput::GetWriteStats() const {
+    if (_writer != nullptr) return _writer->GetStats();
+    return SerialWriterStats();
+}
+
 Output::PINGSTATE SerialOutput::Ping() const {
 
     if (_serial != nullptr && _ok) {
@@ -337,6 +478,7 @@ bool SerialOutput::Open() {
             }
         }
         else {
+            _writer = new SerialWriter(_serial);
             logger_base.debug("    Serial port %s open.", (const char *)_commPort.c_str());
         }
     }
@@ -350,10 +492,12 @@ void SerialOutput::Close() {
 
     if (_serial != nullptr) {
         // throw away any pending data
+        if (_writer != nullptr) _writer->Purge();
         _serial->Purge();
 
-        // wait until the die time has passed
-        while (wxGetUTCTimeMillis() < _dieTime) {
+        // wait until the die time has passed ... for messages written by the writer thread it counts from
+        // when the write finished
+        while (wxGetUTCTimeMillis() < _dieTime || (_writer != nullptr && _writer->IsHeld())) {
             wxMilliSleep(5);
         }
 
@@ -364,6 +508,14 @@ void SerialOutput::Close() {
             i++;
         }
 
+        if (_writer != nullptr) {
+            auto stats = _writer->GetStats();
+            logger_base.debug("    Serial port %s wrote %llu, dropped %llu frames. Write latency avg %.1fms max %.1fms.", (const char*)_commPort.c_str(),
+                (unsigned long long)stats.written, (unsigned long long)stats.dropped, stats.avgLatencyMS, stats.maxLatencyMS);
+            delete _writer;
+            _writer = nullptr;
+        }
+
         _serial->Close();
         delete _serial;
         _serial = nullptr;
@@ -387,5 +539,10 @@ void SerialOutput::StartFrame(long msec) {
     }
 
     _timer_msec = msec;
+
+    if (_writer != nullptr && _writer->TakeResend()) {
+        logger_base.debug("SerialOutput: %s dropped changes while backed up, resending all channels.", (const char *)_commPort.c_str());
+        ResendAll();
+    }
 }
 #pragma endregion
@@ -13,12 +13,78 @@
 #include "Output.h"
 #include "serial.h"
 
+#include <chrono>
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct SerialWriterStats
+{
+    uint64_t written = 0;
+    uint64_t dropped = 0;     // frames replaced by a newer frame, or messages dropped from a backed up queue, before the port got to them
+    double avgLatencyMS = 0;  // from hand over to the write completing
+    double maxLatencyMS = 0;
+};
+
+// Owns the writing to a serial port on its own thread so a slow port never holds up the frame loop.
+// Frames are latest wins ... if the port has not got to a frame when the next one arrives the old
+// one is dropped. Messages are for protocols which send changes only and are sent in order, but if the
+// port stops taking data the oldest are dropped to stay within MAX_PENDING_MESSAGE_BYTES and the output
+// is told to resend everything once it catches up.
+class SerialWriter
+{
+    struct Packet
+    {
+        std::vector<uint8_t> data;
+        bool frame = false;
+        bool sendBreak = false;
+        int holdMS = 0;
+        std::chrono::steady_clock::time_point queued;
+    };
+
+    // a few seconds of LOR changes at 57600 baud
+    static const size_t MAX_PENDING_MESSAGE_BYTES = 32 * 1024;
+
+    SerialPort* _serial = nullptr;
+    std::thread _thread;
+    mutable std::mutex _lock;
+    std::condition_variable _signal;
+    std::list<Packet> _pending;
+    size_t _pendingBytes = 0;
+    bool _writing = false;
+    bool _stop = false;
+    bool _resend = false;
+    std::chrono::steady_clock::time_point _holdUntil;
+    SerialWriterStats _stats;
+    double _totalLatencyMS = 0;
+
+    void Run();
+    void Queue(const uint8_t* data, size_t len, bool frame, bool sendBreak, int holdMS);
+
+public:
+    SerialWriter(SerialPort* serial);
+    virtual ~SerialWriter();
+
+    void WriteFrame(const uint8_t* data, size_t len, bool sendBreak = false) { Queue(data, len, true, sendBreak, 0); }
+    // holdMS keeps the port from being closed for that long after this message is actually written
+    void WriteMessage(const uint8_t* data, size_t len, int holdMS = 0) { Queue(data, len, false, false, holdMS); }
+    void Purge();
+    size_t PendingBytes() const;
+    bool IsIdle() const;
+    bool IsHeld() const;
+    bool TakeResend();
+    SerialWriterStats GetStats() const;
+};
+
 class SerialOutput : public Output
 {
 protected:
 
     #pragma region Member Variables
     SerialPort* _serial = nullptr;
+    SerialWriter* _writer = nullptr;
     char _serialConfig[4];
     wxLongLong _dieTime = 0;
     #pragma endregion
@@ -26,6 +92,10 @@ protected:
     #pragma region Private Functions
     virtual void Save(wxXmlNode* node) override;
     void SetDontDieUntil(wxLongLong dieTime) { _dieTime = dieTime; }
+    void WriteFrame(const uint8_t* data, size_t len, bool sendBreak = false) const;
+    void WriteMessage(const uint8_t* data, size_t len, int holdMS = 0) const;
+    // called when queued changes were dropped so the controller no longer has what was last sent
+    virtual void ResendAll() {}
     #pragma endregion
 
 public:
@@ -56,6 +126,7 @@ public:
 
     virtual size_t TxNonEmptyCount() const override;
     virtual bool TxEmpty() const override;
+    SerialWriterStats GetWriteStats() const;
 
     int GetId() const { return _universe; }
     void SetId(int id) { if (_universe != id) { _universe = id; _dirty = true; } }
@@ -24,7 +24,7 @@ void xxxSerialOutput::SendHeartbeat() const {
     d[2] = 0x00;
     d[3] = 0x81;
     if (_serial != nullptr) {
-        _serial->Write((char*)d, 4);
+        WriteMessage(d, 4);
     }
 }
 #pragma endregion
@@ -72,6 +72,13 @@ void xxxSerialOutput::ResetFrame() {
     _lastheartbeat = -1;
 }
 
+void xxxSerialOutput::ResendAll() {
+
+    memset(_lastSent, 0xFF, sizeof(_lastSent));
+    memset(_notSentCount, 0xF0, sizeof(_notSentCount));
+    _changed = true;
+}
+
 void xxxSerialOutput::EndFrame(int suppressFrames) {
 
     if (!_enabled || _suspend || _serial == nullptr || !_ok) return;
@@ -109,7 +116,7 @@ void xxxSerialOutput::EndFrame(int suppressFrames) {
                             d[4] = mask;
                             d[5] = 0x81;
 
-                            _serial->Write((char*)d, 6);
+                            WriteMessage(d, 6);
                         }
 					}			
 				}
@@ -151,7 +158,7 @@ void xxxSerialOutput::SetOneChannel(int32_t channel, unsigned char data) {
 		d[5] = 0x81;
 
         if (_serial != nullptr) {
-            _serial->Write((char *)d, 6);
+            WriteMessage(d, 6);
             _lastSent[channel] = data;
         }
     }
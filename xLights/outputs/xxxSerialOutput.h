@@ -56,6 +56,7 @@ public:
     #pragma region Frame Handling
     virtual void EndFrame(int suppressFrames) override;
     virtual void ResetFrame() override;
+    virtual void ResendAll() override;
     #pragma endregion 
 
     #pragma region Data Setting
@@ -28,6 +28,7 @@ const long OtherSettingsPanel::ID_TEXTCTRL1 = wxNewId();
 const long OtherSettingsPanel::ID_CHECKBOX1 = wxNewId();
 const long OtherSettingsPanel::ID_CHECKBOX2 = wxNewId();
 const long OtherSettingsPanel::ID_CHECKBOX3 = wxNewId();
+const long OtherSettingsPanel::ID_CHECKBOX4 = wxNewId();
 //*)
 
 BEGIN_EVENT_TABLE(OtherSettingsPanel,wxPanel)
@@ -52,6 +53,10 @@ OtherSettingsPanel::OtherSettingsPanel(wxWindow* parent,xLightsFrame *f,wxWindow
 	HardwareVideoDecodingCheckBox = new wxCheckBox(this, ID_CHECKBOX1, _("Hardware Video Decoding"), wxDefaultPosition, wxDefaultSize, 0, wxDefaultValidator, _T("ID_CHECKBOX1"));
 	HardwareVideoDecodingCheckBox->SetValue(false);
 	GridBagSizer1->Add(HardwareVideoDecodingCheckBox, wxGBPosition(1, 0), wxGBSpan(1, 2), wxALL|wxALIGN_LEFT|wxALIGN_CENTER_VERTICAL, 5);
+	HighQualityNoteFiltersCheckBox = new wxCheckBox(this, ID_CHECKBOX4, _("High Quality Audio Note Filters"), wxDefaultPosition, wxDefaultSize, 0, wxDefaultValidator, _T("ID_CHECKBOX4"));
+	HighQualityNoteFiltersCheckBox->SetValue(false);
+	HighQualityNoteFiltersCheckBox->SetToolTip(_("Use sharper 1025 tap filters for effects that react to a note range. Audio effects may react differently to existing sequences."));
+	GridBagSizer1->Add(HighQualityNoteFiltersCheckBox, wxGBPosition(2, 0), wxGBSpan(1, 2), wxALL|wxALIGN_LEFT|wxALIGN_CENTER_VERTICAL, 5);
 	StaticBoxSizer1 = new wxStaticBoxSizer(wxHORIZONTAL, this, _("Packaging Sequences"));
 	GridBagSizer2 = new wxGridBagSizer(0, 0);
 	ExcludePresetsCheckBox = new wxCheckBox(this, ID_CHECKBOX2, _("Exclude Presets"), wxDefaultPosition, wxDefaultSize, 0, wxDefaultValidator, _T("ID_CHECKBOX2"));
@@ -61,7 +66,7 @@ OtherSettingsPanel::OtherSettingsPanel(wxWindow* parent,xLightsFrame *f,wxWindow
 	ExcludeAudioCheckBox->SetValue(false);
 	GridBagSizer2->Add(ExcludeAudioCheckBox, wxGBPosition(1, 0), wxDefaultSpan, wxALL|wxALIGN_LEFT|wxALIGN_CENTER_VERTICAL, 5);
 	StaticBoxSizer1->Add(GridBagSizer2, 1, wxALL|wxALIGN_CENTER_HORIZONTAL|wxALIGN_CENTER_VERTICAL, 0);
-	GridBagSizer1->Add(StaticBoxSizer1, wxGBPosition(2, 0), wxGBSpan(1, 2), wxALL|wxALIGN_LEFT, 0);
+	GridBagSizer1->Add(StaticBoxSizer1, wxGBPosition(3, 0), wxGBSpan(1, 2), wxALL|wxALIGN_LEFT, 0);
 	SetSizer(GridBagSizer1);
 	GridBagSizer1->Fit(this);
 	GridBagSizer1->SetSizeHints(this);
@@ -71,6 +76,7 @@ OtherSettingsPanel::OtherSettingsPanel(wxWindow* parent,xLightsFrame *f,wxWindow
 	Connect(ID_CHECKBOX1,wxEVT_COMMAND_CHECKBOX_CLICKED,(wxObjectEventFunction)&OtherSettingsPanel::OnHardwareVideoDecodingCheckBoxClick);
 	Connect(ID_CHECKBOX2,wxEVT_COMMAND_CHECKBOX_CLICKED,(wxObjectEventFunction)&OtherSettingsPanel::OnExcludePresetsCheckBoxClick);
 	Connect(ID_CHECKBOX3,wxEVT_COMMAND_CHECKBOX_CLICKED,(wxObjectEventFunction)&OtherSettingsPanel::OnExcludeAudioCheckBoxClick);
+	Connect(ID_CHECKBOX4,wxEVT_COMMAND_CHECKBOX_CLICKED,(wxObjectEventFunction)&OtherSettingsPanel::OnHighQualityNoteFiltersCheckBoxClick);
 	//*)
     
     
@@ -88,6 +94,7 @@ bool OtherSettingsPanel::TransferDataFromWindow() {
     frame->SetExcludeAudioFromPackagedSequences(ExcludeAudioCheckBox->IsChecked());
     frame->SetExcludePresetsFromPackagedSequences(ExcludePresetsCheckBox->IsChecked());
     frame->SetHardwareVideoAccelerated(HardwareVideoDecodingCheckBox->IsChecked());
+    frame->SetHighQualityNoteFilters(HighQualityNoteFiltersCheckBox->IsChecked());
     frame->SetUserEMAIL(eMailTextControl->GetValue());
     return true;
 }
@@ -95,6 +102,7 @@ bool OtherSettingsPanel::TransferDataToWindow() {
     ExcludeAudioCheckBox->SetValue(frame->ExcludeAudioFromPackagedSequences());
     ExcludePresetsCheckBox->SetValue(frame->ExcludePresetsFromPackagedSequences());
     HardwareVideoDecodingCheckBox->SetValue(frame->HardwareVideoAccelerated());
+    HighQualityNoteFiltersCheckBox->SetValue(frame->HighQualityNoteFilters());
     eMailTextControl->SetValue(frame->UserEMAIL());
     return true;
 }
@@ -121,6 +129,13 @@ void OtherSettingsPanel::OnHardwareVideoDecodingCheckBoxClick(wxCommandEvent& ev
     }
 }
 
+void OtherSettingsPanel::OnHighQualityNoteFiltersCheckBoxClick(wxCommandEvent& event)
+{
+    if (wxPreferencesEditor::ShouldApplyChangesImmediately()) {
+        TransferDataFromWindow();
+    }
+}
+
 void OtherSettingsPanel::OneMailTextControlTextEnter(wxCommandEvent& event)
 {
     if (wxPreferencesEditor::ShouldApplyChangesImmediately()) {
@@ -31,6 +31,7 @@ class OtherSettingsPanel: public wxPanel
 		wxCheckBox* ExcludeAudioCheckBox;
 		wxCheckBox* ExcludePresetsCheckBox;
 		wxCheckBox* HardwareVideoDecodingCheckBox;
+		wxCheckBox* HighQualityNoteFiltersCheckBox;
 		wxTextCtrl* eMailTextControl;
 		//*)
 
@@ -44,6 +45,7 @@ class OtherSettingsPanel: public wxPanel
 		static const long ID_CHECKBOX1;
 		static const long ID_CHECKBOX2;
 		static const long ID_CHECKBOX3;
+		static const long ID_CHECKBOX4;
 		//*)
 
 	private:
@@ -53,6 +55,7 @@ class OtherSettingsPanel: public wxPanel
 		void OnExcludeAudioCheckBoxClick(wxCommandEvent& event);
 		void OnExcludePresetsCheckBoxClick(wxCommandEvent& event);
 		void OnHardwareVideoDecodingCheckBoxClick(wxCommandEvent& event);
+		void OnHighQualityNoteFiltersCheckBoxClick(wxCommandEvent& event);
 		void OneMailTextControlTextEnter(wxCommandEvent& event);
 		//*)
 
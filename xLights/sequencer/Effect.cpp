@@ -18,6 +18,7 @@
 #include "../ValueCurve.h"
 #include "../UtilClasses.h"
 #include "../RenderCache.h"
+#include "../RenderBuffer.h"
 #include "../models/Model.h"
 #include "../xLightsMain.h"
 #include "../xLightsApp.h"
@@ -171,8 +172,21 @@ void Effect::ParseColorMap(const SettingsMap &mPaletteMap, xlColorVector &mColor
 
 #pragma region Constructors and Destructors
 
+std::shared_ptr<SettingsMap> Effect::ParseSettings(const std::string &settings)
+{
+    auto map = std::make_shared<SettingsMap>();
+    map->Parse(settings);
+    return map;
+}
+
 Effect::Effect(EffectLayer* parent,int id, const std::string & name, const std::string &settings, const std::string &palette,
                int startTimeMS, int endTimeMS, int Selected, bool Protected)
+    : Effect(parent, id, name, ParseSettings(settings), palette, startTimeMS, endTimeMS, Selected, Protected)
+{
+}
+
+Effect::Effect(EffectLayer* parent,int id, const std::string & name, const std::shared_ptr<SettingsMap> &settings, const std::string &palette,
+               int startTimeMS, int endTimeMS, int Selected, bool Protected, bool fixBuffer)
     : mParentLayer(parent), mID(id), mEffectIndex(-1), mName(nullptr),
       mStartTime(startTimeMS), mEndTime(endTimeMS), mSelected(Selected), mTagged(false), mProtected(Protected), mCache(nullptr)
 {
@@ -180,10 +194,10 @@ Effect::Effect(EffectLayer* parent,int id, const std::string & name, const std::
 
     mColorMask = xlColor::NilColor();
     mEffectIndex = (parent->GetParentElement() == nullptr) ? -1 : parent->GetParentElement()->GetSequenceElements()->GetEffectManager().GetEffectIndex(name);
-    mSettings.Parse(settings);
+    mSettings = (settings == nullptr) ? std::make_shared<SettingsMap>() : settings;
 
     Element* parentElement = parent->GetParentElement();
-    if (parentElement != nullptr)
+    if (parentElement != nullptr && fixBuffer)
     {
         Model* model = parentElement->GetSequenceElements()->GetXLightsFrame()->AllModels[parentElement->GetModelName()];
         FixBuffer(model);
@@ -193,13 +207,13 @@ Effect::Effect(EffectLayer* parent,int id, const std::string & name, const std::
     //  settings["key"] == "test val"
     // code which as a side effect creates a blank value under the key
     // an example of this is fix to issue #622
-    if (mSettings.Get("T_CHOICE_Out_Transition_Type", "XXX") == "")
+    if (mSettings->Get("T_CHOICE_Out_Transition_Type", "XXX") == "")
     {
-        mSettings.erase("T_CHOICE_Out_Transition_Type");
+        MutableSettings().erase("T_CHOICE_Out_Transition_Type");
     }
-    if (mSettings.Get("Converted", "XXX") == "")
+    if (mSettings->Get("Converted", "XXX") == "")
     {
-        mSettings.erase("Converted");
+        MutableSettings().erase("Converted");
     }
 
     // check for any other odd looking blank settings
@@ -238,6 +252,7 @@ Effect::~Effect()
         mCache->Delete();
         mCache = nullptr;
     }
+    ClearCheckpoints();
     if (mName != nullptr)
     {
         delete mName;
@@ -327,9 +342,9 @@ void Effect::SetEffectName(const std::string & name)
 wxString Effect::GetDescription() const
 {
     std::unique_lock<std::recursive_mutex> lock(settingsLock);
-    if (mSettings.Contains("X_Effect_Description"))
+    if (mSettings->Contains("X_Effect_Description"))
     {
-        return mSettings["X_Effect_Description"];
+        return (*mSettings)["X_Effect_Description"];
     }
     return "";
 }
@@ -376,19 +391,25 @@ void Effect::ConvertTo(int effectIndex)
     if (effectIndex != mEffectIndex)
     {
         SetEffectIndex(effectIndex);
+
+        std::string palette;
+        std::string effectText = xLightsApp::GetFrame()->GetEffectTextFromWindows(palette);
+
+        std::unique_lock<std::recursive_mutex> lock(settingsLock);
         SettingsMap newSettings;
         // remove any E_ settings as the effect type has changed
-        for (const auto& it : mSettings)
+        for (const auto& it : *mSettings)
         {
             if (!StartsWith(it.first, "E_"))
             {
                 newSettings[it.first] = it.second;
             }
         }
-        mSettings = newSettings;
-
-        std::string palette;
-        std::string effectText = xLightsApp::GetFrame()->GetEffectTextFromWindows(palette);
+        if (mSettings.use_count() > 1)
+        {
+            mSettings = std::make_shared<SettingsMap>();
+        }
+        *mSettings = newSettings;
 
         auto es = wxSplit(effectText, ',');
         for (auto it: es)
@@ -398,7 +419,7 @@ void Effect::ConvertTo(int effectIndex)
                 auto sv = wxSplit(it, '=');
                 if (sv.size()==2)
                 {
-                    mSettings[sv[0]] = sv[1];
+                    (*mSettings)[sv[0]] = sv[1];
                 }
             }
         }
@@ -408,7 +429,7 @@ void Effect::ConvertTo(int effectIndex)
 bool Effect::IsLocked() const
 {
     std::unique_lock<std::recursive_mutex> lock(settingsLock);
-    return mSettings.Contains("X_Effect_Locked");
+    return mSettings->Contains("X_Effect_Locked");
 }
 
 void Effect::SetLocked(bool lock)
@@ -416,11 +437,11 @@ void Effect::SetLocked(bool lock)
     std::unique_lock<std::recursive_mutex> getlock(settingsLock);
     if (lock)
     {
-        mSettings["X_Effect_Locked"] = "True";
+        MutableSettings()["X_Effect_Locked"] = "True";
     }
     else
     {
-        mSettings.erase("X_Effect_Locked");
+        MutableSettings().erase("X_Effect_Locked");
     }
 }
 
@@ -432,12 +453,13 @@ void Effect::IncrementChangeCount()
         mCache->Delete();
         mCache = nullptr;
     }
+    ClearCheckpoints();
 }
 
 std::string Effect::GetSettingsAsString() const
 {
     std::unique_lock<std::recursive_mutex> lock(settingsLock);
-    return mSettings.AsString();
+    return mSettings->AsString();
 }
 
 void Effect::SetSettings(const std::string &settings, bool keepxsettings)
@@ -447,7 +469,7 @@ void Effect::SetSettings(const std::string &settings, bool keepxsettings)
     SettingsMap x;
     if (keepxsettings)
     {
-        for (const auto& it : mSettings)
+        for (const auto& it : *mSettings)
         {
             if (it.first.size() > 2 && it.first[0] == 'X' && it.first[1] == '_')
             {
@@ -455,12 +477,17 @@ void Effect::SetSettings(const std::string &settings, bool keepxsettings)
             }
         }
     }
-    mSettings.Parse(settings);
+    // dont parse into a map other effects are still using
+    if (mSettings.use_count() > 1)
+    {
+        mSettings = std::make_shared<SettingsMap>();
+    }
+    mSettings->Parse(settings);
     if (keepxsettings)
     {
         for (const auto& it : x)
         {
-            mSettings[it.first] = it.second;
+            (*mSettings)[it.first] = it.second;
         }
     }
     IncrementChangeCount();
@@ -471,7 +498,7 @@ void Effect::PressButton(RenderableEffect* re, const std::string& id)
     bool changed = false;
     if (StartsWith(id, "E_"))
     {
-        changed = re->PressButton(id, mPaletteMap, mSettings);
+        changed = re->PressButton(id, mPaletteMap, MutableSettings());
     }
     else
     {
@@ -499,37 +526,38 @@ void Effect::ApplySetting(const std::string& id, const std::string& value, Value
     }
     else
     {
+        SettingsMap& settings = MutableSettings();
         if (vc != nullptr && vc->IsActive())
         {
-            mSettings[vcid] = vc->Serialise();
+            settings[vcid] = vc->Serialise();
         }
         else
         {
-            mSettings.erase(vcid);
+            settings.erase(vcid);
 
             wxString wid = id;
 
             if (wid.Contains("FILEPICKER")) {
                 wxString realid = wid.substr(0, wid.Length() - 3);
                 if (wid.EndsWith("_FN")) {
-                    mSettings[realid] = value;
+                    settings[realid] = value;
                 } else if (wid.EndsWith("_PN")) {
-                    if (mSettings.Contains(realid) && mSettings.Get(realid, "") != "") {
-                        wxString origName = mSettings[realid];
+                    if (settings.Contains(realid) && settings.Get(realid, "") != "") {
+                        wxString origName = settings[realid];
                         wxFileName fn(origName, origName[1] == ':' ? wxPATH_WIN : wxPATH_UNIX);
                         fn.SetPath(value);
                         wxString newName = fn.GetFullPath();
-                        mSettings[realid] = newName;
+                        settings[realid] = newName;
                     }
                 }
                 else if (wid.EndsWith("_SF")) {
-                    if (mSettings.Contains(realid) && mSettings.Get(realid, "") != "") {
+                    if (settings.Contains(realid) && settings.Get(realid, "") != "") {
 
                         // This moves through all possible options to locate the file relative to the provided show folder.
                         // This will be the deepest path possible ... so if the file exists in multiple locations it will find the 
                         // deepest valid path
                         // This only updates the path if we find the file ... if not found there will be no errors but it will log the issue
-                        wxString origName = mSettings[realid];
+                        wxString origName = settings[realid];
 
                         wxFileName fn(origName, origName[1] == ':' ? wxPATH_WIN : wxPATH_UNIX);
 
@@ -544,28 +572,34 @@ void Effect::ApplySetting(const std::string& id, const std::string& value, Value
                             pth += file;
                             if (wxFile::Exists(pth))                                 {
                                 // found it
-                                mSettings[realid] = pth;
+                                settings[realid] = pth;
                                 break;
                             }
                         }
-                        if (origName == mSettings[realid] && !wxFile::Exists(origName))                             {
+                        if (origName == settings[realid] && !wxFile::Exists(origName))                             {
                             logger_base.warn("Unable to correct show folder '%s' : '%s' to '%s'", (const char*)realid.c_str(), (const char*)origName.c_str(), (const char*)value.c_str());
                         }
                     }
                 }
             } else {
-                mSettings[id] = value;
+                settings[id] = value;
             }
         }
     }
     IncrementChangeCount();
 }
 
+std::shared_ptr<const SettingsMap> Effect::GetSettingsSnapshot() const
+{
+    std::unique_lock<std::recursive_mutex> lock(settingsLock);
+    return mSettings;
+}
+
 void Effect::CopySettingsMap(SettingsMap &target, bool stripPfx) const
 {
     std::unique_lock<std::recursive_mutex> lock(settingsLock);
 
-    for (std::map<std::string,std::string>::const_iterator it=mSettings.begin(); it!=mSettings.end(); ++it)
+    for (std::map<std::string,std::string>::const_iterator it=mSettings->begin(); it!=mSettings->end(); ++it)
     {
         std::string name = it->first;
         if (stripPfx && name[1] == '_')
@@ -585,30 +619,45 @@ void Effect::CopySettingsMap(SettingsMap &target, bool stripPfx) const
     }
 }
 
+// Settings parsed once at load are shared between effects so take a private copy before changing them
+SettingsMap &Effect::MutableSettings()
+{
+    std::unique_lock<std::recursive_mutex> lock(settingsLock);
+    if (mSettings.use_count() > 1)
+    {
+        mSettings = std::make_shared<SettingsMap>(*mSettings);
+    }
+    return *mSettings;
+}
+
 // When an effect is copied between model types the buffer may not be supported so make it valid
 void Effect::FixBuffer(const Model* m)
 {
     if (m == nullptr) return;
 
-    auto styles = m->GetBufferStyles();
-    auto style = mSettings.Get("B_CHOICE_BufferStyle", "Default");
+    FixBuffer(m->GetBufferStyles());
+}
+
+void Effect::FixBuffer(const std::vector<std::string>& styles)
+{
+    auto style = mSettings->Get("B_CHOICE_BufferStyle", "Default");
 
     if (std::find(styles.begin(), styles.end(), style) == styles.end())
     {
         if (style.substr(0, 9) == "Per Model")
         {
-            mSettings["B_CHOICE_BufferStyle"] = style.substr(10);
+            MutableSettings()["B_CHOICE_BufferStyle"] = style.substr(10);
         }
         else
         {
-            mSettings["B_CHOICE_BufferStyle"] = "Default";
+            MutableSettings()["B_CHOICE_BufferStyle"] = "Default";
         }
     }
 }
 
 bool Effect::IsPersistent() const
 {
-    return mSettings.GetBool("B_CHECKBOX_OverlayBkg", false);
+    return mSettings->GetBool("B_CHECKBOX_OverlayBkg", false);
 }
 
 std::string Effect::GetPaletteAsString() const
@@ -716,3 +765,56 @@ void Effect::PurgeCache(bool deleteCache) {
         mCache = nullptr;
     }
 }
+
+void Effect::ClearCheckpoints() {
+    std::unique_lock<std::recursive_mutex> lock(settingsLock);
+    for (const auto& it : mCheckpoints) {
+        for (const auto& cp : it.second.second) {
+            auto checkpoint = cp.second.lock();
+            if (checkpoint != nullptr) {
+                EffectCheckpointBudget::Instance().Remove(checkpoint);
+            }
+        }
+    }
+    mCheckpoints.clear();
+}
+
+void Effect::AddCheckpoint(int buffer, uint64_t key, int frame, EffectCheckpoint* checkpoint) {
+    std::unique_lock<std::recursive_mutex> lock(settingsLock);
+    auto& cp = mCheckpoints[buffer];
+    if (cp.first != key) {
+        // made with different settings so no longer any use
+        for (const auto& it : cp.second) {
+            auto old = it.second.lock();
+            if (old != nullptr) {
+                EffectCheckpointBudget::Instance().Remove(old);
+            }
+        }
+        cp.first = key;
+        cp.second.clear();
+    }
+    auto old = cp.second[frame].lock();
+    if (old != nullptr) {
+        EffectCheckpointBudget::Instance().Remove(old);
+    }
+    cp.second[frame] = EffectCheckpointBudget::Instance().Add(checkpoint);
+}
+
+std::shared_ptr<EffectCheckpoint> Effect::GetCheckpoint(int buffer, uint64_t key, int beforeFrame, int& frame) const {
+    std::unique_lock<std::recursive_mutex> lock(settingsLock);
+    auto it = mCheckpoints.find(buffer);
+    if (it == mCheckpoints.end() || it->second.first != key) return nullptr;
+
+    // nearest checkpoint at or before the frame which has not been dropped to stay within the budget
+    auto cp = it->second.second.upper_bound(beforeFrame);
+    while (cp != it->second.second.begin()) {
+        --cp;
+        auto checkpoint = cp->second.lock();
+        if (checkpoint != nullptr) {
+            EffectCheckpointBudget::Instance().Touch(checkpoint);
+            frame = cp->first;
+            return checkpoint;
+        }
+    }
+    return nullptr;
+}
@@ -13,8 +13,10 @@
 #include "wx/wx.h"
 
 #include <vector>
+#include <map>
 #include <string>
 #include <mutex>
+#include <memory>
 
 #include "../ColorCurve.h" // This needs to be here
 #include "../UtilClasses.h"
@@ -28,6 +30,7 @@ class RenderBuffer;
 class RenderCache;
 class Model;
 class RenderableEffect;
+class EffectCheckpoint;
 
 #define EFFECT_NOT_SELECTED     0
 #define EFFECT_LT_SELECTED      1
@@ -50,23 +53,34 @@ class Effect
     EffectLayer* mParentLayer = nullptr;
     xlColor mColorMask = xlBLACK;
     mutable std::recursive_mutex settingsLock;
-    SettingsMap mSettings;
+    std::shared_ptr<SettingsMap> mSettings; // may be shared with other effects loaded from the same settings string
     SettingsMap mPaletteMap;
     xlColorVector mColors;
     xlColorCurveVector mCC;
     DrawGLUtils::xlDisplayList background;
     RenderCacheItem *mCache = nullptr;
+    // per buffer ... the key the checkpoints were made with and the checkpoints by frame
+    // EffectCheckpointBudget owns the checkpoints and may drop any of them to stay within its memory budget
+    std::map<int, std::pair<uint64_t, std::map<int, std::weak_ptr<EffectCheckpoint>>>> mCheckpoints;
     wxLongLong _timeToDelete = 0;
 
     Effect() {}  //don't allow default or copy constructor
     Effect(const Effect &e) {}
     static void ParseColorMap(const SettingsMap &mPaletteMap, xlColorVector &mColors, xlColorCurveVector& mCC);
+    SettingsMap &MutableSettings();
+    void ClearCheckpoints();
 
 public:
     Effect(EffectLayer* parent, int id, const std::string & name, const std::string &settings, const std::string &palette,
         int startTimeMS, int endTimeMS, int Selected, bool Protected);
+    // fixBuffer false leaves the buffer style for the caller to check against buffer styles it has already looked up
+    Effect(EffectLayer* parent, int id, const std::string & name, const std::shared_ptr<SettingsMap> &settings, const std::string &palette,
+        int startTimeMS, int endTimeMS, int Selected, bool Protected, bool fixBuffer = true);
     virtual ~Effect();
 
+    // Parsed settings can be handed to any number of effects ... each one copies them before its first change
+    static std::shared_ptr<SettingsMap> ParseSettings(const std::string &settings);
+
     int GetID() const { return mID; }
     void SetID(int i) { mID = i; }
 
@@ -112,9 +126,13 @@ public:
     void SetSettings(const std::string &settings, bool keepxsettings);
     void ApplySetting(const std::string& id, const std::string& value, ValueCurve* vc, const std::string& vcid);
     void PressButton(RenderableEffect* re, const std::string& id);
-    const SettingsMap &GetSettings() const { return mSettings; }
+    const SettingsMap &GetSettings() const { return *mSettings; }
+    // use this rather than GetSettings off the main thread ... holding it keeps the map alive if the main
+    // thread replaces it, and the main thread copies a map that is held elsewhere before changing it
+    std::shared_ptr<const SettingsMap> GetSettingsSnapshot() const;
     void CopySettingsMap(SettingsMap &target, bool stripPfx = false) const;
     void FixBuffer(const Model* m);
+    void FixBuffer(const std::vector<std::string>& styles);
     bool IsPersistent() const;
 
     const xlColorVector &GetPalette() const { return mColors; }
@@ -126,7 +144,7 @@ public:
     void CopyPalette(xlColorVector &target, xlColorCurveVector& newcc) const;
 
     /* Do NOT call these on any thread other than the main thread */
-    SettingsMap &GetSettings() { return mSettings; }
+    SettingsMap &GetSettings() { return MutableSettings(); }
     xlColorVector &GetPalette() { return mColors; }
     SettingsMap &GetPaletteMap() { return mPaletteMap; }
     void PaletteMapUpdated();
@@ -151,6 +169,10 @@ public:
     bool GetFrame(RenderBuffer &buffer, RenderCache &renderCache);
     void AddFrame(RenderBuffer &buffer, RenderCache &renderCache);
     void PurgeCache(bool deleteCachefile = false);
+
+    // snapshots of a stateful effect so a render starting part way through it does not have to start over
+    void AddCheckpoint(int buffer, uint64_t key, int frame, EffectCheckpoint* checkpoint);
+    std::shared_ptr<EffectCheckpoint> GetCheckpoint(int buffer, uint64_t key, int beforeFrame, int& frame) const;
 };
 
 bool operator<(const Effect &e1, const Effect &e2);
@@ -179,6 +179,12 @@ void EffectLayer::RemoveAllEffects(UndoManager *undo_mgr)
 
 Effect* EffectLayer::AddEffect(int id, const std::string &n, const std::string &settings, const std::string &palette,
                                int startTimeMS, int endTimeMS, int Selected, bool Protected, bool suppress_sort)
+{
+    return AddEffect(id, n, Effect::ParseSettings(settings), palette, startTimeMS, endTimeMS, Selected, Protected, suppress_sort);
+}
+
+Effect* EffectLayer::AddEffect(int id, const std::string &n, const std::shared_ptr<SettingsMap> &settings, const std::string &palette,
+                               int startTimeMS, int endTimeMS, int Selected, bool Protected, bool suppress_sort, bool fixBuffer)
 {
     std::unique_lock<std::recursive_mutex> locker(lock);
     std::string name(n);
@@ -212,7 +218,7 @@ Effect* EffectLayer::AddEffect(int id, const std::string &n, const std::string &
     // make sure they dont hang over the left side
     if (startTimeMS < 0) startTimeMS = 0;
 
-    Effect *e = new Effect(this, id, name, settings, palette, startTimeMS, endTimeMS, Selected, Protected);
+    Effect *e = new Effect(this, id, name, settings, palette, startTimeMS, endTimeMS, Selected, Protected, fixBuffer);
     wxASSERT(e != nullptr);
     mEffects.push_back(e);
     if (!suppress_sort)
@@ -1319,7 +1325,7 @@ std::list<std::string> EffectLayer::GetFileReferences(EffectManager& em) const
 
     for (int k = 0; k < GetEffectCount(); k++)
     {
-        Effect* ef = GetEffect(k);
+        const Effect* ef = GetEffect(k);
 
         if (ef->GetEffectIndex() >= 0)
         {
@@ -1337,7 +1343,7 @@ std::list<std::string> EffectLayer::GetFacesUsed(EffectManager& em) const
 
     for (int k = 0; k < GetEffectCount(); k++)
     {
-        Effect* ef = GetEffect(k);
+        const Effect* ef = GetEffect(k);
 
         if (ef->GetEffectIndex() >= 0)
         {
@@ -15,6 +15,7 @@
 #include <string>
 #include <list>
 #include <mutex>
+#include <memory>
 #include "Effect.h"
 #include "UndoManager.h"
 #include "../effects/EffectManager.h"
@@ -37,6 +38,8 @@ class EffectLayer
 
         Effect *AddEffect(int id, const std::string &name, const std::string &settings, const std::string &palette,
                           int startTimeMS, int endTimeMS, int Selected, bool Protected, bool suppress_sort = false);
+        Effect *AddEffect(int id, const std::string &name, const std::shared_ptr<SettingsMap> &settings, const std::string &palette,
+                          int startTimeMS, int endTimeMS, int Selected, bool Protected, bool suppress_sort = false, bool fixBuffer = true);
         Effect* GetEffect(int index) const;
         Effect* GetEffectByTime(int ms);
         Effect* GetEffectFromID(int id);
@@ -120,9 +123,9 @@ class EffectLayer
 
         void CleanupAfterRender();
         void NumberEffects();
+        void SortEffects();
     protected:
     private:
-        void SortEffects();
         void PlayEffect(Effect* effect);
 
         static std::atomic_int exclusive_index;
@@ -27,6 +27,7 @@
 #include "../SequenceViewManager.h"
 #include "../JukeboxPanel.h"
 #include "../TraceLog.h"
+#include "../Parallel.h"
 
 #include <log4cpp/Category.hh>
 
@@ -639,73 +640,81 @@ void SequenceElements::MoveElement(int index,int destinationIndex)
     SortElements();
 }
 
+static std::string FixEffectFileSettings(const std::string& settings)
+{
+    if (settings.find("E_FILEPICKER_Pictures_Filename") != std::string::npos)
+    {
+        return FixEffectFileParameter("E_FILEPICKER_Pictures_Filename", settings, "").ToStdString();
+    }
+    else if (settings.find("E_FILEPICKER_Glediator_Filename") != std::string::npos)
+    {
+        return FixEffectFileParameter("E_FILEPICKER_Glediator_Filename", settings, "").ToStdString();
+    }
+    return settings;
+}
+
+// Effects referencing the same EffectDB entry share one parsed settings map which each
+// effect only copies if it changes it.
+// This is called on multiple threads at once ... one element per thread
 int SequenceElements::LoadEffects(EffectLayer *effectLayer,
     const std::string &type,
-    wxXmlNode *effectLayerNode,
+    const SequenceFileNode &effectLayerNode,
     const std::vector<std::string> & effectStrings,
-    const std::vector<std::string> & colorPalettes) {
+    const std::vector<std::shared_ptr<SettingsMap>> & parsedEffectStrings,
+    const std::vector<std::string> & colorPalettes,
+    const std::vector<std::string> * bufferStyles) {
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
 
     int loaded = 0;
-    for (wxXmlNode* effect = effectLayerNode->GetChildren(); effect != nullptr; effect = effect->GetNext())
+    for (const auto& effect : effectLayerNode.children)
     {
-        if (effect->GetName() == STR_EFFECT)
+        if (effect.name == STR_EFFECT)
         {
             std::string effectName;
             std::string settings;
+            std::shared_ptr<SettingsMap> parsedSettings;
             int id = 0;
             long palette = -1;
 
             // Start time
-            double startTime;
-            effect->GetAttribute(STR_STARTTIME).ToDouble(&startTime);
+            double startTime = std::strtod(effect.GetAttribute(STR_STARTTIME).c_str(), nullptr);
             startTime = TimeLine::RoundToMultipleOfPeriod(startTime, mFrequency);
             // End time
-            double endTime;
-            effect->GetAttribute(STR_ENDTIME).ToDouble(&endTime);
+            double endTime = std::strtod(effect.GetAttribute(STR_ENDTIME).c_str(), nullptr);
             endTime = TimeLine::RoundToMultipleOfPeriod(endTime, mFrequency);
             // Protected
-            bool bProtected = effect->GetAttribute(STR_PROTECTED) == '1' ? true : false;
+            bool bProtected = effect.GetAttribute(STR_PROTECTED) == "1";
             if (type != STR_TIMING)
             {
                 // Name
-                effectName = effect->GetAttribute(STR_NAME);
+                effectName = effect.GetAttribute(STR_NAME);
                 // ID
-                id = wxAtoi(effect->GetAttribute(STR_ID, STR_ZERO));
-                if (effect->GetAttribute(STR_REF) != STR_EMPTY) {
-                    int ref = wxAtoi(effect->GetAttribute(STR_REF));
-                    if (ref >= effectStrings.size())
+                id = std::atoi(effect.GetAttribute(STR_ID, STR_ZERO).c_str());
+                std::string ref = effect.GetAttribute(STR_REF);
+                if (ref != STR_EMPTY) {
+                    int r = std::atoi(ref.c_str());
+                    if (r >= effectStrings.size())
                     {
                         logger_base.warn("Effect string not found for effect %s between %d and %d. Settings ignored.", (const char *)effectName.c_str(), (int)startTime, (int)endTime);
                         settings = "";
                     }
                     else
                     {
-                        settings = effectStrings[ref];
+                        parsedSettings = parsedEffectStrings[r];
                     }
                 }
                 else {
-                    settings = effect->GetNodeContent();
-                }
-
-                if (settings.find("E_FILEPICKER_Pictures_Filename") != std::string::npos)
-                {
-                    settings = FixEffectFileParameter("E_FILEPICKER_Pictures_Filename", settings, "");
-                }
-                else if (settings.find("E_FILEPICKER_Glediator_Filename") != std::string::npos)
-                {
-                    settings = FixEffectFileParameter("E_FILEPICKER_Glediator_Filename", settings, "");
+                    settings = FixEffectFileSettings(effect.content);
                 }
 
-                wxString tmp;
-                if (effect->GetAttribute(STR_PALETTE, &tmp)) {
-                    tmp.ToLong(&palette);
+                if (effect.HasAttribute(STR_PALETTE)) {
+                    palette = std::strtol(effect.GetAttribute(STR_PALETTE).c_str(), nullptr, 10);
                 }
             }
             else
             {
                 // store timing labels in name attribute
-                effectName = effect->GetAttribute(STR_LABEL);
+                effectName = effect.GetAttribute(STR_LABEL);
 
             }
             std::string pal = STR_EMPTY;
@@ -713,20 +722,31 @@ int SequenceElements::LoadEffects(EffectLayer *effectLayer,
             {
                 pal = colorPalettes[palette];
             }
-            effectLayer->AddEffect(id, effectName, settings, pal,
-                startTime, endTime, EFFECT_NOT_SELECTED, bProtected);
+            if (parsedSettings == nullptr)
+            {
+                parsedSettings = Effect::ParseSettings(settings);
+            }
+            // the buffer styles were looked up before loading started, the model manager is not touched from here
+            Effect* e = effectLayer->AddEffect(id, effectName, parsedSettings, pal,
+                startTime, endTime, EFFECT_NOT_SELECTED, bProtected, true, false);
+            if (e != nullptr && bufferStyles != nullptr)
+            {
+                e->FixBuffer(*bufferStyles);
+            }
         }
-        else if (effect->GetName() == STR_NODE && effectLayerNode->GetName() == STR_STRAND) {
+        else if (effect.name == STR_NODE && effectLayerNode.name == STR_STRAND) {
             StrandElement *se = (StrandElement*)effectLayer->GetParentElement();
-            EffectLayer* neffectLayer = se->GetNodeLayer(wxAtoi(effect->GetAttribute(STR_INDEX)), true);
-            if (effect->GetAttribute(STR_NAME, STR_EMPTY) != STR_EMPTY) {
-                ((NodeLayer*)neffectLayer)->SetName(effect->GetAttribute(STR_NAME).ToStdString());
+            EffectLayer* neffectLayer = se->GetNodeLayer(std::atoi(effect.GetAttribute(STR_INDEX).c_str()), true);
+            if (effect.GetAttribute(STR_NAME) != STR_EMPTY) {
+                ((NodeLayer*)neffectLayer)->SetName(effect.GetAttribute(STR_NAME));
             }
 
-            LoadEffects(neffectLayer, type, effect, effectStrings, colorPalettes);
+            LoadEffects(neffectLayer, type, effect, effectStrings, parsedEffectStrings, colorPalettes, bufferStyles);
         }
         loaded++;
     }
+    // sort once rather than after every effect
+    effectLayer->SortEffects();
     return loaded;
 }
 
@@ -741,6 +761,7 @@ bool SequenceElements::LoadSequencerFile(xLightsXmlFile& xml_file, const wxStrin
 
     wxXmlNode* root = seqDocument.GetRoot();
     std::vector<std::string> effectStrings;
+    std::vector<std::shared_ptr<SettingsMap>> parsedEffectStrings;
     std::vector<std::string> colorPalettes;
     TraceLog::AddTraceMessage("About to clear sequence");
     Clear();
@@ -831,6 +852,13 @@ bool SequenceElements::LoadSequencerFile(xLightsXmlFile& xml_file, const wxStrin
                     effectStrings.push_back(elementNode->GetNodeContent().ToStdString());
                 }
             }
+
+            // parse every shared settings string up front so the effect loading threads only ever read them
+            parsedEffectStrings.clear();
+            parsedEffectStrings.resize(effectStrings.size());
+            parallel_for(0, effectStrings.size(), [&effectStrings, &parsedEffectStrings](int i) {
+                parsedEffectStrings[i] = Effect::ParseSettings(FixEffectFileSettings(effectStrings[i]));
+            }, 500);
         }
         else if (e->GetName() == "ColorPalettes")
         {
@@ -854,17 +882,24 @@ bool SequenceElements::LoadSequencerFile(xLightsXmlFile& xml_file, const wxStrin
             {
                 if (elementNode->GetName() == STR_ELEMENT)
                 {
-                    for (wxXmlNode* effectLayerNode = elementNode->GetChildren(); effectLayerNode != nullptr; effectLayerNode = effectLayerNode->GetNext())
+                    for (const auto& effectLayerNode : xml_file.GetElementEffects(elementNode))
                     {
-                        for (wxXmlNode* effect = effectLayerNode->GetChildren(); effect != nullptr; effect = effect->GetNext())
-                        {
-                            count++;
-                        }
+                        count += effectLayerNode.children.size();
                     }
                 }
             }
 
-            int loaded = 0;
+            // Layers are created here on this thread. The effects are then created one element per thread.
+            struct LayerLoad
+            {
+                EffectLayer* layer;
+                const SequenceFileNode* node;
+                std::string type;
+                const std::vector<std::string>* bufferStyles;
+            };
+            std::vector<std::vector<LayerLoad>> elementLoads;
+            std::map<Element*, size_t> elementLoadIndex;
+
             for (wxXmlNode* elementNode = e->GetChildren(); elementNode != NULL; elementNode = elementNode->GetNext())
             {
                 if (elementNode->GetName() == STR_ELEMENT)
@@ -907,20 +942,28 @@ bool SequenceElements::LoadSequencerFile(xLightsXmlFile& xml_file, const wxStrin
                         }
                         else
                         {
-                            for (wxXmlNode* effectLayerNode = elementNode->GetChildren(); effectLayerNode != nullptr; effectLayerNode = effectLayerNode->GetNext())
+                            // an element listed twice must still be loaded by a single thread
+                            auto eli = elementLoadIndex.find(element);
+                            if (eli == elementLoadIndex.end())
+                            {
+                                eli = elementLoadIndex.insert({ element, elementLoads.size() }).first;
+                                elementLoads.push_back({});
+                            }
+                            std::string type = elementNode->GetAttribute(STR_TYPE).ToStdString();
+                            // neither the model lookup nor the buffer styles are safe to use from the loading threads
+                            // so both are resolved here, every layer of an element belongs to the element's model
+                            Model* model = xframe->AllModels[element->GetModelName()];
+                            const std::vector<std::string>* bufferStyles = model == nullptr ? nullptr : &model->GetBufferStyles();
+                            for (const auto& effectLayerNode : xml_file.GetElementEffects(elementNode))
                             {
                                 EffectLayer* effectLayer = nullptr;
-                                if (effectLayerNode->GetName() == STR_EFFECTLAYER) {
+                                if (effectLayerNode.name == STR_EFFECTLAYER) {
                                     effectLayer = element->AddEffectLayer();
                                 }
-                                else if (effectLayerNode->GetName() == STR_SUBMODEL_EFFECTLAYER) {
-                                    wxString name = effectLayerNode->GetAttribute("name").Trim(true).Trim(false);
-                                    if (name != effectLayerNode->GetAttribute("name")) {
-                                        effectLayerNode->DeleteAttribute("name");
-                                        effectLayerNode->AddAttribute("name", name);
-                                    }
-                                    int layer = wxAtoi(effectLayerNode->GetAttribute("layer", "0"));
-                                    SubModelElement *se = dynamic_cast<ModelElement*>(element)->GetSubModel(name.ToStdString(), true);
+                                else if (effectLayerNode.name == STR_SUBMODEL_EFFECTLAYER) {
+                                    std::string name = Trim(effectLayerNode.GetAttribute("name"));
+                                    int layer = std::atoi(effectLayerNode.GetAttribute("layer", "0").c_str());
+                                    SubModelElement *se = dynamic_cast<ModelElement*>(element)->GetSubModel(name, true);
                                     wxASSERT(se != nullptr);
                                     while (layer >= se->GetEffectLayerCount()) {
                                         se->AddEffectLayer();
@@ -929,14 +972,14 @@ bool SequenceElements::LoadSequencerFile(xLightsXmlFile& xml_file, const wxStrin
                                 }
                                 else {
                                     if (dynamic_cast<ModelElement*>(element) != nullptr) {
-                                        StrandElement* se = dynamic_cast<ModelElement*>(element)->GetStrand(wxAtoi(effectLayerNode->GetAttribute(STR_INDEX)), true);
-                                        int layer = wxAtoi(effectLayerNode->GetAttribute("layer", "0"));
+                                        StrandElement* se = dynamic_cast<ModelElement*>(element)->GetStrand(std::atoi(effectLayerNode.GetAttribute(STR_INDEX).c_str()), true);
+                                        int layer = std::atoi(effectLayerNode.GetAttribute("layer", "0").c_str());
                                         while (layer >= se->GetEffectLayerCount()) {
                                             se->AddEffectLayer();
                                         }
                                         effectLayer = se->GetEffectLayer(layer);
-                                        if (effectLayerNode->GetAttribute(STR_NAME, STR_EMPTY) != STR_EMPTY) {
-                                            se->SetName(effectLayerNode->GetAttribute(STR_NAME).Trim(true).Trim(false).ToStdString());
+                                        if (effectLayerNode.GetAttribute(STR_NAME) != STR_EMPTY) {
+                                            se->SetName(Trim(effectLayerNode.GetAttribute(STR_NAME)));
                                         }
                                     }
                                     else                                         {
@@ -944,10 +987,7 @@ bool SequenceElements::LoadSequencerFile(xLightsXmlFile& xml_file, const wxStrin
                                     }
                                 }
                                 if (effectLayer != nullptr) {
-                                    loaded += LoadEffects(effectLayer, elementNode->GetAttribute(STR_TYPE).ToStdString(), effectLayerNode, effectStrings, colorPalettes);
-                                    if (count) {
-                                        GetXLightsFrame()->SetStatusText(wxString::Format("Effects Loaded: %i%%.", loaded * 100 / count));
-                                    }
+                                    elementLoads[eli->second].push_back({ effectLayer, &effectLayerNode, type, bufferStyles });
                                 }
                                 else
                                 {
@@ -962,9 +1002,29 @@ bool SequenceElements::LoadSequencerFile(xLightsXmlFile& xml_file, const wxStrin
                     }
                 }
             }
+
+            // load in batches so we can still show progress
+            std::atomic_int loaded(0);
+            const int batchSize = std::max(1, (int)elementLoads.size() / 20);
+            for (int batch = 0; batch < elementLoads.size(); batch += batchSize)
+            {
+                int batchEnd = std::min(batch + batchSize, (int)elementLoads.size());
+                parallel_for(batch, batchEnd, [this, &elementLoads, &effectStrings, &parsedEffectStrings, &colorPalettes, &loaded](int i) {
+                    for (const auto& it : elementLoads[i])
+                    {
+                        loaded += LoadEffects(it.layer, it.type, *it.node, effectStrings, parsedEffectStrings, colorPalettes, it.bufferStyles);
+                    }
+                });
+                if (count) {
+                    GetXLightsFrame()->SetStatusText(wxString::Format("Effects Loaded: %i%%.", loaded * 100 / count));
+                }
+            }
         }
         TraceLog::PopTraceContext();
     }
+    // the effects now live in the elements
+    xml_file.ReleaseElementEffects();
+
     for (size_t x = 0; x < GetElementCount(); x++) {
         Element *el = GetElement(x);
         if (el->GetEffectLayerCount() == 0) {
@@ -17,11 +17,13 @@
 #include <set>
 #include <string>
 #include <mutex>
+#include <atomic>
 #include "wx/xml/xml.h"
 #include "wx/filename.h"
 #include "UndoManager.h"
 
 class xLightsXmlFile;  // forward declaration needed due to circular dependency
+struct SequenceFileNode;
 class SequenceViewManager;
 class TimeLine;
 
@@ -202,9 +204,11 @@ protected:
 private:
     int LoadEffects(EffectLayer *layer,
         const std::string &type,
-        wxXmlNode *effectLayerNode,
+        const SequenceFileNode &effectLayerNode,
         const std::vector<std::string> & effectStrings,
-        const std::vector<std::string> & colorPalettes);
+        const std::vector<std::shared_ptr<SettingsMap>> & parsedEffectStrings,
+        const std::vector<std::string> & colorPalettes,
+        const std::vector<std::string> * bufferStyles);
     static bool SortElementsByIndex(const Element *element1, const Element *element2)
     {
         return (element1->GetIndex() < element2->GetIndex());
@@ -243,7 +247,7 @@ private:
 
     // mFirstVisibleModelRow=0 is first model row not the row in Row_Information struct.
     int mFirstVisibleModelRow;
-    unsigned int mChangeCount;
+    std::atomic_uint mChangeCount; // effects on different elements are loaded in parallel
     unsigned int mMasterViewChangeCount;
     UndoManager undo_mgr;
 
@@ -842,18 +842,18 @@ void xLightsFrame::Scrub(wxCommandEvent& event)
         int nn = playModel->GetNodeCount();
         for (int node = 0; node < nn; node++) {
             int start = playModel->NodeStartChannel(node);
-            playModel->SetNodeChannelValues(node, &SeqData[frame][start]);
+            playModel->SetNodeChannelValues(node, SeqData.GetFrame(frame)[start]);
         }
     }
     TimerOutput(frame);
     if (playModel != nullptr) {
         playModel->DisplayEffectOnWindow(_modelPreviewPanel, mPointSize);
     }
-    _housePreviewPanel->GetModelPreview()->Render(&SeqData[frame][0]);
+    _housePreviewPanel->GetModelPreview()->Render(SeqData.GetFrame(frame)[0]);
     for (auto it = PreviewWindows.begin(); it != PreviewWindows.end(); ++it) {
         ModelPreview* preview = *it;
         if (preview->GetActive()) {
-            preview->Render(&SeqData[frame][0]);
+            preview->Render(SeqData.GetFrame(frame)[0]);
         }
     }
 }
@@ -2343,18 +2343,18 @@ void xLightsFrame::TimerRgbSeq(long msec)
         int nn = playModel->GetNodeCount();
         for (int node = 0; node < nn; node++) {
             int start = playModel->NodeStartChannel(node);
-            playModel->SetNodeChannelValues(node, &SeqData[frame][start]);
+            playModel->SetNodeChannelValues(node, SeqData.GetFrame(frame)[start]);
         }
     }
     TimerOutput(frame);
     if (playModel != nullptr) {
         playModel->DisplayEffectOnWindow(_modelPreviewPanel, mPointSize);
     }
-    _housePreviewPanel->GetModelPreview()->Render(&SeqData[frame][0]);
+    _housePreviewPanel->GetModelPreview()->Render(SeqData.GetFrame(frame)[0]);
     for (auto it = PreviewWindows.begin(); it != PreviewWindows.end(); ++it) {
         ModelPreview* preview = *it;
         if( preview->GetActive() ) {
-            preview->Render(&SeqData[frame][0]);
+            preview->Render(SeqData.GetFrame(frame)[0]);
         }
     }
 }
@@ -691,6 +691,8 @@ bool xLightsApp::OnInit()
 //TODO: maybe use wxCmdLineParser instead?
 //do this before instantiating xLightsFrame so it can use info gathered here
     wxString unrecog, info;
+    wxArrayString convertFiles; // sequences to convert with --convert rather than open
+    wxArrayString roundTripFiles; // sequences to check with --roundtrip rather than open
 
     static const wxCmdLineEntryDesc cmdLineDesc [] =
     {
@@ -702,6 +704,12 @@ bool xLightsApp::OnInit()
         { wxCMD_LINE_OPTION, "g", "opengl", "specify OpenGL version" },
         { wxCMD_LINE_SWITCH, "w", "wipe", "wipe settings clean" },
         { wxCMD_LINE_SWITCH, "o", "on", "turn on output to lights" },
+        { wxCMD_LINE_OPTION, "j", "threads", "number of render threads to use", wxCMD_LINE_VAL_NUMBER },
+        { wxCMD_LINE_OPTION, "t", "timing", "write a render timing report to this file, JSON if it ends in .json otherwise text (with -r)" },
+        { wxCMD_LINE_OPTION, "b", "benchmark", "benchmark all effects, check layer blur and roto zoom against the code they replaced (debug builds), time rand() against the buffer random generator across threads, write a JSON report to this file and exit" },
+        { wxCMD_LINE_OPTION, "", "baseline", "effect benchmark report to compare the output hashes and times against, recorded if it does not exist or has no results (with -b)" },
+        { wxCMD_LINE_SWITCH, "", "convert", "convert the sequence files to fseq files in the fseq folder and exit" },
+        { wxCMD_LINE_SWITCH, "", "roundtrip", "check the sequence files load and save without changing their effects and exit" },
 #ifdef __LINUX__
         { wxCMD_LINE_SWITCH, "x", "xschedule", "run xschedule" },
         { wxCMD_LINE_SWITCH, "a", "xsmsdaemon", "run xsmsdaemon" },
@@ -806,6 +814,13 @@ bool xLightsApp::OnInit()
         } else if (!showDir.IsNull()) {
             mediaDir = showDir;
         }
+        if (parser.Found("j", &renderThreads)) {
+            logger_base.info("-j: Render threads set to %d.", (int)renderThreads);
+            info += wxString::Format(_("Using %d render threads\n"), (int)renderThreads);
+        }
+        if (parser.Found("t", &renderReport)) {
+            logger_base.info("-t: Render timing report will be written to %s.", (const char *)renderReport.c_str());
+        }
         for (size_t x = 0; x < parser.GetParamCount(); x++) {
             wxString sequenceFile = parser.GetParam(x);
             if (x == 0) {
@@ -821,9 +836,17 @@ bool xLightsApp::OnInit()
                     if (showDir == old) showDir = "";
                 }
             }
-            sequenceFiles.push_back(sequenceFile);
+            if (parser.Found("convert")) {
+                convertFiles.push_back(sequenceFile);
+            }
+            else if (parser.Found("roundtrip")) {
+                roundTripFiles.push_back(sequenceFile);
+            }
+            else {
+                sequenceFiles.push_back(sequenceFile);
+            }
         }
-        if (!parser.Found("r") && !parser.Found("o") && !info.empty())
+        if (!parser.Found("r") && !parser.Found("o") && !parser.Found("b") && !parser.Found("convert") && !parser.Found("roundtrip") && !info.empty())
         {
             DisplayInfo(info); //give positive feedback*/
         }
@@ -856,6 +879,24 @@ bool xLightsApp::OnInit()
         topFrame->CallAfter(&xLightsFrame::OpenRenderAndSaveSequences, sequenceFiles, true);
     }
 
+    wxString benchmarkReport;
+    if (parser.Found("b", &benchmarkReport)) {
+        wxString baseline;
+        parser.Found("baseline", &baseline);
+        logger_base.info("-b: Effect benchmark report will be written to %s.", (const char *)benchmarkReport.c_str());
+        topFrame->CallAfter(&xLightsFrame::RunEffectBenchmark, benchmarkReport, baseline, true);
+    }
+
+    if (parser.Found("convert")) {
+        logger_base.info("--convert: Converting %d sequences to fseq.", (int)convertFiles.size());
+        topFrame->CallAfter(&xLightsFrame::ConvertSequencesToFSEQ, convertFiles, true);
+    }
+
+    if (parser.Found("roundtrip")) {
+        logger_base.info("--roundtrip: Checking %d sequences load and save unchanged.", (int)roundTripFiles.size());
+        topFrame->CallAfter(&xLightsFrame::CheckSequenceRoundTrip, roundTripFiles, true);
+    }
+
     if (parser.Found("o"))
     {
         logger_base.info("-o: Turning on output to lights");
@@ -874,6 +915,12 @@ bool xLightsApp::OnInit()
     return wxsOK;
 }
 
+int xLightsApp::OnRun() {
+    int rc = wxApp::OnRun();
+    // command line modes report failures through the exit code so scripts can check it
+    return rc != 0 ? rc : exitCode;
+}
+
 void xLightsApp::OnFatalException() {
     handleCrash(nullptr);
 }
@@ -901,4 +948,7 @@ bool xLightsApp::WantDebug = false;
 wxString xLightsApp::DebugPath;
 wxString xLightsApp::mediaDir;
 wxString xLightsApp::showDir;
+long xLightsApp::renderThreads = 0;
+wxString xLightsApp::renderReport;
+int xLightsApp::exitCode = 0;
 wxArrayString xLightsApp::sequenceFiles;
@@ -30,6 +30,7 @@ class xLightsApp : public wxApp
 
 public:
     virtual bool OnInit() override;
+    virtual int OnRun() override;
     static xLightsFrame* GetFrame() { return __frame; }
     static bool WantDebug; //debug flag from command-line -DJ
     static wxString DebugPath; //path name for debug log file -DJ
@@ -37,6 +38,9 @@ public:
     static wxString mediaDir;
     static wxArrayString sequenceFiles;
     static xLightsFrame* __frame;
+    static long renderThreads; // render thread count from the command line, 0 for the default
+    static wxString renderReport; // file to write the batch render timing report to
+    static int exitCode; // process exit code, set by command line modes that exit when done
 
     #ifdef __WXOSX__
     virtual void MacOpenFiles(const wxArrayString &fileNames) override;
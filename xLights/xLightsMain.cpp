@@ -1334,6 +1334,10 @@ xLightsFrame::xLightsFrame(wxWindow* parent, wxWindowID id) : mSequenceElements(
 
     config->Read("xLightsFSEQVersion", &_fseqVersion, 2);
 
+    config->Read("xLightsHighQualityNoteFilters", &_highQualityNoteFilters, false);
+    AudioManager::SetHighQualityNoteFilters(_highQualityNoteFilters);
+    logger_base.debug("High Quality Note Filters: %s.", _highQualityNoteFilters ? "true" : "false");
+
     config->Read("xLightsPlayVolume", &playVolume, 100);
     MenuItem_LoudVol->Check(playVolume == 100);
     MenuItem_MedVol->Check(playVolume == 66);
@@ -1697,6 +1701,9 @@ xLightsFrame::xLightsFrame(wxWindow* parent, wxWindowID id) : mSequenceElements(
     if (threadCount < 20) {
         threadCount = 20;
     }
+    if (xLightsApp::renderThreads > 0) {
+        threadCount = xLightsApp::renderThreads;
+    }
     jobPool.Start(threadCount);
 
     if (!xLightsApp::sequenceFiles.IsEmpty())
@@ -4034,6 +4041,7 @@ void xLightsFrame::SetRenderCacheFolder(bool useShow, const std::string& folder)
 
     SetXmlSetting("renderCacheDir", renderCacheDirectory);
     UnsavedRgbEffectsChanges = true;
+    AudioManager::SetFrameDataCacheFolder(renderCacheDirectory);
 
     logger_base.debug("Render Cache directory set to : %s.", (const char*)renderCacheDirectory.c_str());
 }
@@ -7516,7 +7524,24 @@ void xLightsFrame::TimerOutput(int period)
 {
     if (CheckBoxLightOutput->IsChecked())
     {
-        _outputManager.SetManyChannels(0, &SeqData[period][0], SeqData.NumChannels());
+        // SetManyChannels does not modify the data but predates const
+        unsigned char* data = const_cast<unsigned char*>(SeqData.GetFrame(period)[0]);
+        unsigned int changeCount = SeqData.GetChangeCount(period);
+        if (period > 0 && (unsigned int)period < SeqData.NumFrames() && period == _lastOutputFrame + 1 &&
+            _lastOutputSerial == SeqData.GetSerial() &&
+            _lastOutputChangeCount == SeqData.GetChangeCount(_lastOutputFrame) &&
+            _lastOutputGeneration == _outputManager.GetDataGeneration()) {
+            // the outputs still hold the previous frame exactly so only send what differs from it
+            SeqData.ForEachChangedRange(period, [this, data](unsigned int start, unsigned int count) {
+                _outputManager.SetManyChannels(start, &data[start], count);
+            });
+        } else {
+            _outputManager.SetManyChannels(0, data, SeqData.NumChannels());
+        }
+        _lastOutputFrame = period;
+        _lastOutputSerial = SeqData.GetSerial();
+        _lastOutputChangeCount = changeCount;
+        _lastOutputGeneration = _outputManager.GetDataGeneration();
     }
 }
 
@@ -9943,6 +9968,14 @@ void xLightsFrame::SetHardwareVideoAccelerated(bool b)
     config->Write("xLightsVideoReaderAccelerated", VideoReader::IsHardwareAcceleratedVideo());
 }
 
+void xLightsFrame::SetHighQualityNoteFilters(bool b)
+{
+    _highQualityNoteFilters = b;
+    AudioManager::SetHighQualityNoteFilters(_highQualityNoteFilters);
+    wxConfigBase* config = wxConfigBase::Get();
+    config->Write("xLightsHighQualityNoteFilters", _highQualityNoteFilters);
+}
+
 void xLightsFrame::OnMenuItemBulkControllerUploadSelected(wxCommandEvent& event)
 {
     MultiControllerUploadDialog dlg(this);
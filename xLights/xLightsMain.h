@@ -108,6 +108,7 @@ class ZCPPOutput;
 class UDControllerPort;
 class Model;
 class ControllerEthernet;
+class LMSFile;
 
 // max number of most recently used show directories on the File menu
 #define MRUD_LENGTH 4
@@ -403,7 +404,7 @@ public:
     bool ImportSuperStar(Element *el, wxXmlDocument &doc, int x_size, int y_size,
                          int x_offset, int y_offset,
                          int imageResizeType, const wxSize &modelSize, const wxString& layerBlend);
-    bool ImportLMS(wxXmlDocument &doc, const wxFileName &filename);
+    bool ImportLMS(LMSFile &lms, const wxFileName &filename);
     bool ImportLPE(wxXmlDocument &doc, const wxFileName &filename);
     bool ImportVixen3(const wxFileName &filename);
     bool ImportS5(wxXmlDocument &doc, const wxFileName &filename);
@@ -958,6 +959,7 @@ public:
     bool _excludePresetsFromPackagedSequences = true;
     bool _excludeAudioFromPackagedSequences = true;
     bool _hwVideoAccleration = false;
+    bool _highQualityNoteFilters = false;
     bool _showACLights = false;
     bool _showACRamps = false;
     wxString _enableRenderCache;
@@ -1042,6 +1044,9 @@ public:
     bool HardwareVideoAccelerated() const { return _hwVideoAccleration; }
     void SetHardwareVideoAccelerated(bool b);
 
+    bool HighQualityNoteFilters() const { return _highQualityNoteFilters; }
+    void SetHighQualityNoteFilters(bool b);
+
     const wxString &UserEMAIL() const { return _userEmail;}
     void SetUserEMAIL(const wxString &e);
 
@@ -1186,6 +1191,21 @@ public:
     unsigned int modelsChangeCount;
     bool _renderMode;
 
+    // per sequence result of a batch render, used for the command line timing report
+    struct BatchRenderResult {
+        std::string file;
+        bool ok = false;
+        long loadMS = 0;
+        long renderMS = 0;
+        long saveMS = 0;
+        int frames = 0;
+    };
+    std::vector<BatchRenderResult> _batchRenderResults;
+    void FinishBatchRender(bool cancelled, bool exitOnDone);
+    void RunEffectBenchmark(const wxString& reportFile, const wxString& baselineFile, bool exitOnDone);
+    void ConvertSequencesToFSEQ(const wxArrayString& files, bool exitOnDone);
+    void CheckSequenceRoundTrip(const wxArrayString& files, bool exitOnDone);
+
     void SuspendAutoSave(bool dosuspend) { _suspendAutoSave = dosuspend; }
     void ClearLastPeriod();
     void WriteVirFile(const wxString& filename, long numChans, unsigned int startFrame, unsigned int endFrame, SeqDataType *dataBuf); //       Vixen *.vir
@@ -1297,6 +1317,11 @@ protected:
     void ShowPreviewTime(long ElapsedMSec);
     void PreviewOutput(int period);
     void TimerOutput(int period);
+    // what TimerOutput last sent, so a following frame only needs the channels that changed
+    int _lastOutputFrame = -1;
+    unsigned int _lastOutputSerial = 0;
+    unsigned int _lastOutputChangeCount = 0;
+    uint32_t _lastOutputGeneration = 0;
     void UpdateChannelNames();
     void StopNow();
     bool ShowFolderIsInBackup(const std::string showdir);
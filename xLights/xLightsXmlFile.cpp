@@ -20,6 +20,7 @@
 #include <zstd.h>
 
 #include "../include/spxml-0.5/spxmlparser.hpp"
+#include "../include/spxml-0.5/spxmlevent.hpp"
 
 #include "xLightsXmlFile.h"
 #include "xLightsMain.h"
@@ -36,8 +37,6 @@
 
 #define string_format wxString::Format
 
-//     #define USE_COMPRESSION
-
 
 const wxString xLightsXmlFile::ERASE_MODE = "<rendered: erase-mode>";
 const wxString xLightsXmlFile::CANVAS_MODE = "<rendered: canvas-mode>";
@@ -835,6 +834,7 @@ void xLightsXmlFile::DeleteTimingSection(const std::string & section)
                     if (attr == "timing") {
                         element->GetAttribute("name", &attr);
                         if (attr == section) {
+                            elementEffects.erase(element);
                             e->RemoveChild(element);
                             delete element;
                             element = nullptr;
@@ -884,7 +884,7 @@ void xLightsXmlFile::CreateNew()
     version_string = xlights_version_string;
 }
 
-bool xLightsXmlFile::Open(const wxString& ShowDir, bool ignore_audio)
+bool xLightsXmlFile::Open(const wxString& ShowDir, bool ignore_audio, bool streamEffects)
 {
     if( !FileExists() )
         return false;
@@ -897,7 +897,7 @@ bool xLightsXmlFile::Open(const wxString& ShowDir, bool ignore_audio)
     }
     else if( IsXmlSequence(*this) )
     {
-        return LoadSequence(ShowDir, ignore_audio);
+        return LoadSequence(ShowDir, ignore_audio, streamEffects);
     }
     return false;
 }
@@ -1115,12 +1115,213 @@ void xLightsXmlFile::ConvertToFixedPointTiming()
     }
 }
 
-bool xLightsXmlFile::LoadSequence(const wxString& ShowDir, bool ignore_audio)
+bool SequenceFileNode::HasAttribute(const std::string& attr) const
+{
+    for (const auto& it : attributes) {
+        if (it.first == attr) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string SequenceFileNode::GetAttribute(const std::string& attr, const std::string& def) const
+{
+    for (const auto& it : attributes) {
+        if (it.first == attr) {
+            return it.second;
+        }
+    }
+    return def;
+}
+
+// Gives the same std::string wxXmlNode's wxString::ToStdString would have
+static std::string FromXmlUTF8(const char* s)
+{
+    for (const char* c = s; *c; c++) {
+        if (*c & 0x80) {
+            return wxString::FromUTF8(s).ToStdString();
+        }
+    }
+    return s;
+}
+
+static SequenceFileNode ToSequenceFileNode(wxXmlNode* node)
+{
+    SequenceFileNode n;
+    n.name = node->GetName().ToStdString();
+    for (wxXmlAttribute* attr = node->GetAttributes(); attr != nullptr; attr = attr->GetNext()) {
+        n.attributes.push_back({ attr->GetName().ToStdString(), attr->GetValue().ToStdString() });
+    }
+    for (wxXmlNode* child = node->GetChildren(); child != nullptr; child = child->GetNext()) {
+        if (child->GetType() == wxXML_ELEMENT_NODE) {
+            n.children.push_back(ToSequenceFileNode(child));
+        }
+        else if (child->GetType() == wxXML_TEXT_NODE || child->GetType() == wxXML_CDATA_SECTION_NODE) {
+            n.content += child->GetContent().ToStdString();
+        }
+    }
+    return n;
+}
+
+// Elements in files which were loaded into the document (older or compressed files) are converted on first use
+const std::vector<SequenceFileNode>& xLightsXmlFile::GetElementEffects(wxXmlNode* element)
+{
+    auto it = elementEffects.find(element);
+    if (it == elementEffects.end()) {
+        it = elementEffects.insert({ element, std::vector<SequenceFileNode>() }).first;
+        for (wxXmlNode* child = element->GetChildren(); child != nullptr; child = child->GetNext()) {
+            if (child->GetType() == wxXML_ELEMENT_NODE) {
+                it->second.push_back(ToSequenceFileNode(child));
+            }
+        }
+    }
+    return it->second;
+}
+
+#define SEQUENCE_READ_BLOCK_SIZE 1024 * 1024
+
+// Reads the sequence with the pull parser. Everything but the effects goes into seqDocument as it always has.
+// The contents of the ElementEffects elements are kept as SequenceFileNodes for SequenceElements to load.
+bool xLightsXmlFile::StreamSequence()
+{
+    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
+
+    wxFile file(GetFullPath());
+    if (!file.IsOpened()) {
+        return false;
+    }
+
+    SP_XmlPullParser parser;
+    std::vector<char> bytes(SEQUENCE_READ_BLOCK_SIZE);
+
+    wxXmlNode* root = nullptr;
+    std::vector<std::pair<wxXmlNode*, wxXmlNode*>> docStack; // the document nodes we are in and the last child added to each
+    std::vector<SequenceFileNode*> effectStack;                // the effect nodes we are in
+    bool done = false;
+    bool ok = true;
+
+    while (!done && ok) {
+        SP_XmlPullEvent* event = parser.getNext();
+        if (event == nullptr) {
+            if (parser.getError() != nullptr) {
+                logger_base.warn("LoadSequence: Streaming load error %s.", parser.getError());
+                ok = false;
+                break;
+            }
+            size_t read = file.Read(bytes.data(), bytes.size());
+            if (read == 0 || read == (size_t)wxInvalidOffset) {
+                break;
+            }
+            parser.append(bytes.data(), read);
+            continue;
+        }
+
+        switch (event->getEventType()) {
+        case SP_XmlPullEvent::eEndDocument:
+            done = true;
+            break;
+        case SP_XmlPullEvent::eDocDecl: {
+            // the document's encoding is left to wxXmlDocument
+            const char* encoding = ((SP_XmlDocDeclEvent*)event)->getEncoding();
+            if (encoding != nullptr && *encoding != 0 && wxString(encoding).Lower() != "utf-8") {
+                logger_base.info("LoadSequence: %s encoded sequence cannot be streamed.", encoding);
+                ok = false;
+            }
+        }
+        break;
+        case SP_XmlPullEvent::eStartTag: {
+            SP_XmlStartTagEvent* stagEvent = (SP_XmlStartTagEvent*)event;
+            SequenceFileNode* node = nullptr;
+            if (!effectStack.empty()) {
+                effectStack.back()->children.emplace_back();
+                node = &effectStack.back()->children.back();
+            }
+            else if (docStack.size() == 3 && docStack[1].first->GetName() == "ElementEffects" && docStack[2].first->GetName() == "Element") {
+                auto& body = elementEffects[docStack[2].first];
+                body.emplace_back();
+                node = &body.back();
+            }
+
+            if (node != nullptr) {
+                node->name = stagEvent->getName();
+                node->attributes.reserve(stagEvent->getAttrCount());
+                for (int i = 0; i < stagEvent->getAttrCount(); i++) {
+                    const char* value = nullptr;
+                    const char* name = stagEvent->getAttr(i, &value);
+                    node->attributes.push_back({ name, FromXmlUTF8(value) });
+                }
+                effectStack.push_back(node);
+            }
+            else {
+                wxXmlNode* n = new wxXmlNode(wxXML_ELEMENT_NODE, wxString::FromUTF8(stagEvent->getName()));
+                for (int i = 0; i < stagEvent->getAttrCount(); i++) {
+                    const char* value = nullptr;
+                    const char* name = stagEvent->getAttr(i, &value);
+                    n->AddAttribute(wxString::FromUTF8(name), wxString::FromUTF8(value));
+                }
+                if (docStack.empty()) {
+                    delete root;
+                    root = n;
+                }
+                else {
+                    docStack.back().first->InsertChildAfter(n, docStack.back().second);
+                    docStack.back().second = n;
+                }
+                docStack.push_back({ n, nullptr });
+            }
+        }
+        break;
+        case SP_XmlPullEvent::eEndTag:
+            if (!effectStack.empty()) {
+                effectStack.pop_back();
+            }
+            else if (!docStack.empty()) {
+                docStack.pop_back();
+            }
+            break;
+        case SP_XmlPullEvent::eCData: {
+            const char* text = ((SP_XmlCDataEvent*)event)->getText();
+            if (!effectStack.empty()) {
+                effectStack.back()->content += FromXmlUTF8(text);
+            }
+            else if (!docStack.empty()) {
+                wxXmlNode* n = new wxXmlNode(wxXML_TEXT_NODE, "text", wxString::FromUTF8(text));
+                docStack.back().first->InsertChildAfter(n, docStack.back().second);
+                docStack.back().second = n;
+            }
+        }
+        break;
+        default:
+            break;
+        }
+        delete event;
+    }
+
+    if (!ok || !done || root == nullptr || !docStack.empty()) {
+        delete root;
+        elementEffects.clear();
+        return false;
+    }
+    seqDocument.SetRoot(root);
+    return true;
+}
+
+bool xLightsXmlFile::LoadSequence(const wxString& ShowDir, bool ignore_audio, bool streamEffects)
 {
     static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
     logger_base.info("LoadSequence: Loading sequence " + GetFullPath());
 
-	if (!seqDocument.Load(GetFullPath()))
+    elementEffects.clear();
+    // files that still need their times corrected are converted in the document
+    bool loaded = false;
+    if (streamEffects && !NeedsTimesCorrected()) {
+        loaded = StreamSequence();
+        if (!loaded) {
+            logger_base.warn("LoadSequence: Streaming load failed, loading the whole document.");
+        }
+    }
+	if (!loaded && !seqDocument.Load(GetFullPath()))
 	{
 		logger_base.error("LoadSequence: XML file load failed.");
 		return false;
@@ -2665,41 +2866,161 @@ bool xLightsXmlFile::Save()
     return seqDocument.Save(GetFullPath());
 }
 
+#define SEQUENCE_WRITE_BLOCK_SIZE 1024 * 1024
+
+static bool IsUTF8(const std::string& s)
+{
+    for (size_t i = 0; i < s.size();) {
+        unsigned char c = s[i];
+        int follow = c < 0x80 ? 0 : (c & 0xE0) == 0xC0 ? 1 : (c & 0xF0) == 0xE0 ? 2 : (c & 0xF8) == 0xF0 ? 3 : -1;
+        if (follow < 0 || (follow == 1 && c < 0xC2) || i + follow >= s.size()) {
+            return false;
+        }
+        for (int j = 1; j <= follow; j++) {
+            if ((s[i + j] & 0xC0) != 0x80) {
+                return false;
+            }
+        }
+        i += follow + 1;
+    }
+    return true;
+}
+
+// The loader hands back std::strings through ToStdString, so in the local (libc) encoding, but settings built
+// from utf8_str() are already UTF-8. Those are written as they are rather than encoded a second time, anything
+// else is converted from the local encoding, falling back to Latin-1 rather than losing the text.
+static std::string ToXmlUTF8(const std::string& s)
+{
+    if (IsUTF8(s)) {
+        return s;
+    }
+    wxString ws(s.c_str(), wxConvLibc);
+    if (ws.empty()) {
+        ws = wxString(s.c_str(), wxConvISO8859_1);
+    }
+    return std::string(ws.utf8_str());
+}
+
+// Escapes markup the way wxXmlDocument::Save does. Control characters XML 1.0 can't hold even as character
+// references are dropped, a file containing them could not be read back.
+static void AppendXmlEscaped(std::string& out, const std::string& s, bool attribute)
+{
+    for (char c : s) {
+        if ((unsigned char)c < 0x20 && c != '\t' && c != '\n' && c != '\r') {
+            continue;
+        }
+        switch (c) {
+        case '<':
+            out += "&lt;";
+            break;
+        case '>':
+            out += "&gt;";
+            break;
+        case '&':
+            out += "&amp;";
+            break;
+        case '\r':
+            out += "&#xD;";
+            break;
+        case '"':
+            out += attribute ? "&quot;" : "\"";
+            break;
+        case '\t':
+            out += attribute ? "&#x9;" : "\t";
+            break;
+        case '\n':
+            out += attribute ? "&#xA;" : "\n";
+            break;
+        default:
+            out += c;
+            break;
+        }
+    }
+}
+
+static void AppendXmlAttribute(std::string& out, const char* name, const std::string& value)
+{
+    out += ' ';
+    out += name;
+    out += "=\"";
+    AppendXmlEscaped(out, ToXmlUTF8(value), true);
+    out += '"';
+}
+
+static void OpenXmlElement(std::string& out, int indent, const char* name)
+{
+    out += '\n';
+    out.append(indent, ' ');
+    out += '<';
+    out += name;
+}
+
+// ends the start tag, returns where the children start so CloseXmlElement can tell if there were any
+static size_t StartXmlChildren(std::string& out)
+{
+    out += '>';
+    return out.size();
+}
+
+static void CloseXmlElement(std::string& out, size_t childrenStart, int indent, const char* name)
+{
+    if (out.size() == childrenStart) {
+        out.pop_back();
+        out += "/>";
+        return;
+    }
+    out += '\n';
+    out.append(indent, ' ');
+    out += "</";
+    out += name;
+    out += '>';
+}
+
 void xLightsXmlFile::WriteEffects(EffectLayer *layer,
-                                  wxXmlNode *effect_layer_node,
+                                  std::string &body,
+                                  int indent,
                                   StringIntMap &colorPalettes,
                                   wxXmlNode* colorPalette_node,
                                   StringIntMap &effectStrings,
-                                  wxXmlNode* effectDB_Node) {
+                                  std::string &effectDB) {
     int num_effects = layer->GetEffectCount();
     for(int k = 0; k < num_effects; ++k)
     {
         Effect* effect = layer->GetEffect(k);
-        wxString effectString = effect->GetSettingsAsString();
+        std::string settings = effect->GetSettingsAsString();
+        wxString effectString = settings;
         int size = effectStrings.size();
         int ref = effectStrings[effectString] - 1;
         if (ref == -1) {
             ref = size;
             effectStrings[effectString] = ref + 1;
-            AddChildXmlNode(effectDB_Node, "Effect", effectString);
+            OpenXmlElement(effectDB, 4, "Effect");
+            size_t children = StartXmlChildren(effectDB);
+            AppendXmlEscaped(effectDB, ToXmlUTF8(settings), false);
+            if (effectDB.size() == children) {
+                effectDB.pop_back();
+                effectDB += "/>";
+            } else {
+                effectDB += "</Effect>";
+            }
         }
 
 
         // Add effect node
-        wxXmlNode* effect_node = AddChildXmlNode(effect_layer_node, "Effect");
-        effect_node->AddAttribute("ref", string_format("%d", ref));
-        effect_node->AddAttribute("name", XmlSafe(effect->GetEffectName()));
+        OpenXmlElement(body, indent, "Effect");
+        AppendXmlAttribute(body, "ref", std::to_string(ref));
+        AppendXmlAttribute(body, "name", XmlSafe(effect->GetEffectName()));
         if (effect->GetProtected()) {
-            effect_node->AddAttribute("protected", "1");
+            AppendXmlAttribute(body, "protected", "1");
         }
         if (effect->GetSelected()) {
-            effect_node->AddAttribute("selected", "1");
+            AppendXmlAttribute(body, "selected", "1");
         }
         if (effect->GetID()) {
-            effect_node->AddAttribute("id", string_format("%d", effect->GetID()));
+            AppendXmlAttribute(body, "id", std::to_string(effect->GetID()));
         }
-        effect_node->AddAttribute("startTime", string_format("%d", effect->GetStartTimeMS()));
-        effect_node->AddAttribute("endTime", string_format("%d", effect->GetEndTimeMS()));
+        AppendXmlAttribute(body, "startTime", std::to_string(effect->GetStartTimeMS()));
+        AppendXmlAttribute(body, "endTime", std::to_string(effect->GetEndTimeMS()));
         wxString palette = effect->GetPaletteAsString();
         if (palette != "") {
             size = colorPalettes.size();
@@ -2709,11 +3030,94 @@ void xLightsXmlFile::WriteEffects(EffectLayer *layer,
                 colorPalettes[palette] = pref + 1;
                 AddChildXmlNode(colorPalette_node, "ColorPalette", palette);
             }
-            effect_node->AddAttribute("palette", string_format("%d", pref));
+            AppendXmlAttribute(body, "palette", std::to_string(pref));
         }
+        body += "/>";
     }
 }
 
+// Writes the document in the layout wxXmlDocument::Save uses. Elements in elementBodies get their
+// effects from there, they were never added to the document.
+static void WriteXmlNode(wxOutputStream& file, std::string& out, const wxXmlNode* node, int indent,
+                         const std::map<const wxXmlNode*, std::string>& elementBodies)
+{
+    switch (node->GetType()) {
+    case wxXML_TEXT_NODE:
+        AppendXmlEscaped(out, std::string(node->GetContent().utf8_str()), false);
+        break;
+    case wxXML_CDATA_SECTION_NODE:
+        out += "<![CDATA[";
+        out += node->GetContent().utf8_str();
+        out += "]]>";
+        break;
+    case wxXML_COMMENT_NODE:
+        out += "<!--";
+        out += node->GetContent().utf8_str();
+        out += "-->";
+        break;
+    case wxXML_ELEMENT_NODE: {
+        std::string name(node->GetName().utf8_str());
+        out += '<';
+        out += name;
+        for (wxXmlAttribute* attr = node->GetAttributes(); attr != nullptr; attr = attr->GetNext()) {
+            out += ' ';
+            out += attr->GetName().utf8_str();
+            out += "=\"";
+            AppendXmlEscaped(out, std::string(attr->GetValue().utf8_str()), true);
+            out += '"';
+        }
+        auto body = elementBodies.find(node);
+        if (body != elementBodies.end() && !body->second.empty()) {
+            out += '>';
+            out += body->second;
+            out += '\n';
+            out.append(indent, ' ');
+            out += "</" + name + ">";
+        }
+        else if (node->GetChildren() != nullptr) {
+            out += '>';
+            const wxXmlNode* prev = nullptr;
+            for (const wxXmlNode* child = node->GetChildren(); child != nullptr; child = child->GetNext()) {
+                if (child->GetType() != wxXML_TEXT_NODE) {
+                    out += '\n';
+                    out.append(indent + 2, ' ');
+                }
+                WriteXmlNode(file, out, child, indent + 2, elementBodies);
+                prev = child;
+            }
+            if (prev != nullptr && prev->GetType() != wxXML_TEXT_NODE) {
+                out += '\n';
+                out.append(indent, ' ');
+            }
+            out += "</" + name + ">";
+        }
+        else {
+            out += "/>";
+        }
+        if (out.size() > SEQUENCE_WRITE_BLOCK_SIZE) {
+            file.Write(out.data(), out.size());
+            out.clear();
+        }
+    }
+    break;
+    default:
+        break;
+    }
+}
+
+bool xLightsXmlFile::WriteSequence(const std::map<const wxXmlNode*, std::string>& elementBodies) const
+{
+    wxFileOutputStream file(GetFullPath());
+    if (!file.IsOk()) {
+        return false;
+    }
+    std::string out = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+    WriteXmlNode(file, out, seqDocument.GetRoot(), 0, elementBodies);
+    out += '\n';
+    bool ok = file.Write(out.data(), out.size()).IsOk();
+    return file.Close() && ok;
+}
+
 void xLightsXmlFile::AddJukebox(wxXmlNode* node)
 {
     wxXmlNode* root = seqDocument.GetRoot();
@@ -2734,12 +3138,14 @@ void xLightsXmlFile::AddJukebox(wxXmlNode* node)
 // function used to save sequence data
 void xLightsXmlFile::Save( SequenceElements& seq_elements)
 {
+    static log4cpp::Category &logger_base = log4cpp::Category::getInstance(std::string("log_base"));
     wxXmlNode* root = seqDocument.GetRoot();
 
     root->DeleteAttribute("ModelBlending");
     root->AddAttribute("ModelBlending", seq_elements.SupportsModelBlending() ? "true" : "false");
     
     // Delete nodes that will be replaced
+    elementEffects.clear();
     for(wxXmlNode* e=root->GetChildren(); e!=nullptr; )
     {
         if( e->GetName() == "DisplayElements" ||
@@ -2799,6 +3205,10 @@ void xLightsXmlFile::Save( SequenceElements& seq_elements)
         }
     }
 
+    // the effects are written straight to the file rather than being added to the document first
+    std::map<const wxXmlNode*, std::string> elementBodies;
+    std::string& effectDB = elementBodies[effectDB_Node];
+
     int num_elements = seq_elements.GetElementCount();
     for(int i = 0; i < num_elements; ++i)
     {
@@ -2822,6 +3232,7 @@ void xLightsXmlFile::Save( SequenceElements& seq_elements)
         wxXmlNode* element_effects_node = AddChildXmlNode(elements_node, "Element");
         element_effects_node->AddAttribute("type", element->GetType() == ElementType::ELEMENT_TYPE_TIMING ? "timing" : "model");
         element_effects_node->AddAttribute("name", element->GetName());
+        std::string& body = elementBodies[element_effects_node];
 
         if ( element->GetType() == ElementType::ELEMENT_TYPE_TIMING ) {
             TimingElement *tm = dynamic_cast<TimingElement *>(element);
@@ -2835,7 +3246,8 @@ void xLightsXmlFile::Save( SequenceElements& seq_elements)
                 for (int j = 0; j < num_layers; ++j) {
                     EffectLayer* layer = tm->GetEffectLayer(j);
                     // Add layer node
-                    wxXmlNode* effect_layer_node = AddChildXmlNode(element_effects_node, "EffectLayer");
+                    OpenXmlElement(body, 6, "EffectLayer");
+                    size_t layerChildren = StartXmlChildren(body);
 
                     // Add effects
                     int num_effects = layer->GetEffectCount();
@@ -2843,19 +3255,27 @@ void xLightsXmlFile::Save( SequenceElements& seq_elements)
                     {
                         Effect* effect = layer->GetEffect(k);
                         // Add effect node
-                        wxXmlNode* effect_node = AddChildXmlNode(effect_layer_node, "Effect", effect->GetSettingsAsString());
-
-                        effect_node->AddAttribute("label", effect->GetEffectName());
+                        OpenXmlElement(body, 8, "Effect");
+                        AppendXmlAttribute(body, "label", effect->GetEffectName());
                         if (effect->GetProtected()) {
-                            effect_node->AddAttribute("protected", "1");
+                            AppendXmlAttribute(body, "protected", "1");
                         }
                         if (effect->GetSelected()) {
-                            effect_node->AddAttribute("selected", "1");
+                            AppendXmlAttribute(body, "selected", "1");
+                        }
+                        AppendXmlAttribute(body, "startTime", std::to_string(effect->GetStartTimeMS()));
+                        AppendXmlAttribute(body, "endTime", std::to_string(effect->GetEndTimeMS()));
+                        size_t effectChildren = StartXmlChildren(body);
+                        AppendXmlEscaped(body, ToXmlUTF8(effect->GetSettingsAsString()), false);
+                        if (body.size() == effectChildren) {
+                            body.pop_back();
+                            body += "/>";
+                        }
+                        else {
+                            body += "</Effect>";
                         }
-                        effect_node->AddAttribute("startTime", string_format("%d", effect->GetStartTimeMS()));
-                        effect_node->AddAttribute("endTime", string_format("%d", effect->GetEndTimeMS()));
                     }
-
+                    CloseXmlElement(body, layerChildren, 6, "EffectLayer");
                 }
             }
         } else if ( element->GetType() == ElementType::ELEMENT_TYPE_MODEL) {
@@ -2865,42 +3285,54 @@ void xLightsXmlFile::Save( SequenceElements& seq_elements)
                 EffectLayer* layer = me->GetEffectLayer(j);
 
                 // Add layer node
-                wxXmlNode* effect_layer_node = AddChildXmlNode(element_effects_node, "EffectLayer");
-                WriteEffects(layer, effect_layer_node, colorPalettes,
+                OpenXmlElement(body, 6, "EffectLayer");
+                size_t layerChildren = StartXmlChildren(body);
+                WriteEffects(layer, body, 8, colorPalettes,
                              colorPalette_node,
                              effectStrings,
-                             effectDB_Node);
+                             effectDB);
+                CloseXmlElement(body, layerChildren, 6, "EffectLayer");
             }
 
             int num_strands = me->GetSubModelAndStrandCount();
             for (int strand = 0; strand < num_strands; strand++) {
                 SubModelElement *se = me->GetSubModel(strand);
                 num_layers = se->GetEffectLayerCount();
-                wxXmlNode* effect_layer_node = nullptr;
 
                 StrandElement *strEl = dynamic_cast<StrandElement*>(se);
+                // Node layers go in the strand's layer 0 element so that is only closed once they are written
+                std::string strandLayer0;
+                size_t strandLayer0Children = 0;
+                std::string strandLayers;
+                bool nodesAfterLayers = false;
                 for(int j = 0; j < num_layers; ++j)
                 {
                     EffectLayer* layer = se->GetEffectLayer(j);
 
                     if (layer->GetEffectCount() != 0) {
-                        wxXmlNode *eln = AddChildXmlNode(element_effects_node, strEl == nullptr ? "SubModelEffectLayer" : "Strand");
+                        bool isLayer0 = strEl != nullptr && j == 0;
+                        std::string& out = isLayer0 ? strandLayer0 : strandLayers;
+                        const char* tag = strEl == nullptr ? "SubModelEffectLayer" : "Strand";
+                        OpenXmlElement(out, 6, tag);
                         if (strEl != nullptr) {
-                            eln->AddAttribute("index", string_format("%d", strEl->GetStrand()));
-                            if (j == 0) {
-                                effect_layer_node = eln;
-                            }
+                            AppendXmlAttribute(out, "index", std::to_string(strEl->GetStrand()));
                         }
                         if (j > 0) {
-                            eln->AddAttribute("layer", string_format("%d", j));
+                            AppendXmlAttribute(out, "layer", std::to_string(j));
                         }
                         if (se->GetName() != "") {
-                            eln->AddAttribute("name", se->GetName());
+                            AppendXmlAttribute(out, "name", se->GetName());
                         }
-                        WriteEffects(layer, eln, colorPalettes,
+                        size_t layerChildren = StartXmlChildren(out);
+                        WriteEffects(layer, out, 8, colorPalettes,
                                      colorPalette_node,
                                      effectStrings,
-                                     effectDB_Node);
+                                     effectDB);
+                        if (isLayer0) {
+                            strandLayer0Children = layerChildren;
+                        } else {
+                            CloseXmlElement(out, layerChildren, 6, tag);
+                        }
                     }
                 }
                 if (strEl != nullptr) {
@@ -2910,62 +3342,48 @@ void xLightsXmlFile::Save( SequenceElements& seq_elements)
                         if (nlayer->GetEffectCount() == 0) {
                             continue;
                         }
-                        if (effect_layer_node == nullptr) {
-                            effect_layer_node = AddChildXmlNode(element_effects_node, "Strand");
-                            effect_layer_node->AddAttribute("index", string_format("%d", strEl->GetStrand()));
+                        if (strandLayer0.empty()) {
+                            // no layer 0 effects so the nodes get a strand element after the other layers
+                            OpenXmlElement(strandLayer0, 6, "Strand");
+                            AppendXmlAttribute(strandLayer0, "index", std::to_string(strEl->GetStrand()));
                             if (se->GetName() != "") {
-                                effect_layer_node->AddAttribute("name", se->GetName());
+                                AppendXmlAttribute(strandLayer0, "name", se->GetName());
                             }
+                            strandLayer0Children = StartXmlChildren(strandLayer0);
+                            nodesAfterLayers = true;
                         }
-                        wxXmlNode* neffect_layer_node = AddChildXmlNode(effect_layer_node, "Node");
-                        neffect_layer_node->AddAttribute("index", string_format("%d", n));
+                        OpenXmlElement(strandLayer0, 8, "Node");
+                        AppendXmlAttribute(strandLayer0, "index", std::to_string(n));
                         if (nlayer->GetName() != "") {
-                            neffect_layer_node->AddAttribute("name", nlayer->GetName());
+                            AppendXmlAttribute(strandLayer0, "name", nlayer->GetName());
                         }
-                        WriteEffects(nlayer, neffect_layer_node, colorPalettes,
+                        size_t nodeChildren = StartXmlChildren(strandLayer0);
+                        WriteEffects(nlayer, strandLayer0, 10, colorPalettes,
                                      colorPalette_node,
                                      effectStrings,
-                                     effectDB_Node);
+                                     effectDB);
+                        CloseXmlElement(strandLayer0, nodeChildren, 8, "Node");
                     }
                 }
-
+                if (!strandLayer0.empty()) {
+                    CloseXmlElement(strandLayer0, strandLayer0Children, 6, "Strand");
+                }
+                if (nodesAfterLayers) {
+                    body += strandLayers;
+                    body += strandLayer0;
+                } else {
+                    body += strandLayer0;
+                    body += strandLayers;
+                }
             }
         }
     }
     UpdateVersion();
-    
-#ifdef USE_COMPRESSION
-    for(wxXmlNode* e=root->GetChildren(); e!=nullptr; e=e->GetNext()) {
-        wxString name = e->GetName();
-        if (name == "ColorPalettes" || name == "EffectDB" || name == "ElementEffects") {
-            wxXmlDocument doc;
 
-            wxXmlNode *next = e->GetNext();
-            root->RemoveChild(e);
-
-            doc.SetRoot(e);
-            wxMemoryOutputStream out;
-            doc.Save(out, wxXML_NO_INDENTATION);
-            
-            int max = out.GetOutputStreamBuffer()->Tell();
-            uint8_t *outBuf = new uint8_t[max];
-            int outSize = ZSTD_compress(outBuf, max,
-                                        out.GetOutputStreamBuffer()->GetBufferStart(), max,
-                                        1);
-            // Manipulate data.....
-            wxString b64 = wxBase64Encode(outBuf, outSize);
-            delete [] outBuf;
-            wxXmlNode *newNode = new wxXmlNode(wxXML_ELEMENT_NODE, "CompressedData");
-            newNode->AddChild(new wxXmlNode(wxXML_TEXT_NODE, "", b64));
-            newNode->AddAttribute("size", std::to_string(max));
-            root->InsertChild(newNode, next);
-            
-            e = newNode;
-        }
+    if (!WriteSequence(elementBodies))
+    {
+        logger_base.error("Save: Failed to write %s.", (const char*)GetFullPath().c_str());
     }
-#endif
-    
-    seqDocument.Save(GetFullPath());
 }
 
 bool xLightsXmlFile::TimingAlreadyExists(const std::string & section, xLightsFrame* xLightsParent)
@@ -10,6 +10,10 @@
  * License: https://github.com/smeighan/xLights/blob/master/License.txt
  **************************************************************/
 
+#include <map>
+#include <string>
+#include <vector>
+
 #include <wx/filename.h>
 #include <wx/xml/xml.h>
 #include "sequencer/SequenceElements.h"
@@ -22,6 +26,19 @@ class xLightsFrame;
 
 WX_DECLARE_STRING_HASH_MAP( int, StringIntMap );
 
+// The effects of one ElementEffects/Element as read from the sequence file. These make up most of a
+// sequence so they are kept out of the wxXmlDocument and only live until SequenceElements has loaded them.
+struct SequenceFileNode
+{
+    std::string name;
+    std::vector<std::pair<std::string, std::string>> attributes;
+    std::string content;
+    std::vector<SequenceFileNode> children;
+
+    bool HasAttribute(const std::string& attr) const;
+    std::string GetAttribute(const std::string& attr, const std::string& def = "") const;
+};
+
 class xLightsXmlFile : public wxFileName
 {
     public:
@@ -57,11 +74,14 @@ class xLightsXmlFile : public wxFileName
         static const wxString ERASE_MODE;
         static const wxString CANVAS_MODE;
 
-        bool Open(const wxString& ShowDir, bool ignore_audio=false);
+        // streamEffects false loads the whole file into the document, the round trip check uses it to compare the two
+        bool Open(const wxString& ShowDir, bool ignore_audio=false, bool streamEffects=true);
 
         void AddJukebox(wxXmlNode* node);
         void Save( SequenceElements& elements);
         wxXmlDocument& GetXmlDocument() { return seqDocument; }
+        const std::vector<SequenceFileNode>& GetElementEffects(wxXmlNode* element);
+        void ReleaseElementEffects() { elementEffects.clear(); }
         DataLayerSet& GetDataLayers() { return mDataLayers; }
 
         const wxString &GetVersion() const { return version_string; };
@@ -163,9 +183,12 @@ class xLightsXmlFile : public wxFileName
         bool sequence_loaded = false;  // flag to indicate the sequencer has been loaded with this xml data
         DataLayerSet mDataLayers;
 		AudioManager* audio = nullptr;
+        std::map<wxXmlNode*, std::vector<SequenceFileNode>> elementEffects; // keyed by the ElementEffects/Element node
 
         void CreateNew();
-        bool LoadSequence(const wxString& ShowDir, bool ignore_audio=false);
+        bool LoadSequence(const wxString& ShowDir, bool ignore_audio=false, bool streamEffects=true);
+        bool StreamSequence();
+        bool WriteSequence(const std::map<const wxXmlNode*, std::string>& elementBodies) const;
         bool LoadV3Sequence();
         bool Save();
         bool SaveCopy() const;
@@ -203,9 +226,10 @@ class xLightsXmlFile : public wxFileName
         static wxString InsertMissing(wxString str, wxString missing_array, bool INSERT);
 
         void WriteEffects(EffectLayer *layer,
-                          wxXmlNode *effect_layer_node,
+                          std::string &body,
+                          int indent,
                           StringIntMap &colorPalettes,
                           wxXmlNode* colorPalette_node,
                           StringIntMap &effectStrings,
-                          wxXmlNode* effectDB_Node);
+                          std::string &effectDB);
 };